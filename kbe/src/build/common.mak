@@ -128,6 +128,11 @@ ifndef DISABLE_WATCHERS
 CPPFLAGS += -DENABLE_WATCHERS
 endif
 
+# Use the hierarchical timing wheel (common/timing_wheel.h) instead of the binary heap for timers
+ifdef USE_TIMING_WHEEL
+CPPFLAGS += -DKBE_USE_TIMING_WHEEL
+endif
+
 ifdef USE_PYTHON
 USE_KBE_PYTHON = 1
 KBE_INCLUDES += -I $(KBE_ROOT)/kbe/src/lib/python/Include
@@ -49,7 +49,7 @@ dispatcher_(dispatcher),
 networkInterface_(ninterface),
 pTCPPacketSender_(NULL),
 pTCPPacketReceiver_(NULL),
-pBlowfishFilter_(NULL),
+pEncryptionFilter_(NULL),
 threadPool_(),
 entryScript_(),
 state_(C_STATE_INIT)
@@ -70,7 +70,7 @@ state_(C_STATE_INIT)
 ClientApp::~ClientApp()
 {
 	EntityCallAbstract::resetCallHooks();
-	SAFE_RELEASE(pBlowfishFilter_);
+	SAFE_RELEASE(pEncryptionFilter_);
 }
 
 //-------------------------------------------------------------------------------------		
@@ -91,7 +91,7 @@ void ClientApp::reset(void)
 
 	SAFE_RELEASE(pTCPPacketSender_);
 	SAFE_RELEASE(pTCPPacketReceiver_);
-	SAFE_RELEASE(pBlowfishFilter_);
+	SAFE_RELEASE(pEncryptionFilter_);
 
 	ClientObjectBase::reset();
 }
@@ -401,11 +401,14 @@ void ClientApp::handleGameTick()
 					(*pBundle) << KBEVersion::versionString();
 					(*pBundle) << KBEVersion::scriptVersionString();
 
-					if(Network::g_channelExternalEncryptType == 1)
+					// һ(loginapp)Ĺ ѹܶҪ¿ʼ
+					pServerChannel_->pFilter(NULL);
+
+					// ֵ֧ļ(2)벻ͬ ͿյԿ
+					pEncryptionFilter_ = Network::createClientEncryptionFilter(Network::g_channelExternalEncryptType);
+					if(pEncryptionFilter_)
 					{
-						pBlowfishFilter_ = new Network::BlowfishFilter();
-						(*pBundle).appendBlob(pBlowfishFilter_->key());
-						pServerChannel_->pFilter(NULL);
+						(*pBundle).appendBlob(pEncryptionFilter_->key());
 					}
 					else
 					{
@@ -651,10 +654,11 @@ bool ClientApp::login(std::string accountName, std::string passwd, std::string d
 		(*pBundle) << KBEVersion::versionString();
 		(*pBundle) << KBEVersion::scriptVersionString();
 
-		if(Network::g_channelExternalEncryptType == 1)
+		// ֵ֧ļ(2)벻ͬ ͿյԿ
+		pEncryptionFilter_ = Network::createClientEncryptionFilter(Network::g_channelExternalEncryptType);
+		if(pEncryptionFilter_)
 		{
-			pBlowfishFilter_ = new Network::BlowfishFilter();
-			(*pBundle).appendBlob(pBlowfishFilter_->key());
+			(*pBundle).appendBlob(pEncryptionFilter_->key());
 		}
 		else
 		{
@@ -675,10 +679,17 @@ void ClientApp::onHelloCB_(Network::Channel* pChannel, const std::string& verInf
 		const std::string& scriptVerInfo, const std::string& protocolMD5, const std::string& entityDefMD5, 
 		COMPONENT_TYPE componentType)
 {
-	if(Network::g_channelExternalEncryptType == 1)
+	if(pEncryptionFilter_)
+	{
+		pServerChannel_->pFilter(pEncryptionFilter_);
+		pEncryptionFilter_ = NULL;
+	}
+
+	// ѹڼ֮ǰ ܹѹ֮
+	if(Network::g_channelExternalCompressThreshold > 0)
 	{
-		pServerChannel_->pFilter(pBlowfishFilter_);
-		pBlowfishFilter_ = NULL;
+		pServerChannel_->pFilter(new Network::CompressionFilter(Network::g_channelExternalCompressThreshold,
+			pServerChannel_->pFilter()));
 	}
 
 	if(componentType == LOGINAPP_TYPE)
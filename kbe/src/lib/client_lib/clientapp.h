@@ -14,6 +14,7 @@
 #include "common/timer.h"
 #include "network/interfaces.h"
 #include "network/encryption_filter.h"
+#include "network/compression_filter.h"
 #include "network/event_dispatcher.h"
 #include "network/network_interface.h"
 #include "thread/threadpool.h"
@@ -245,7 +246,7 @@ protected:
 	
 	Network::TCPPacketSender*								pTCPPacketSender_;
 	Network::TCPPacketReceiver*								pTCPPacketReceiver_;
-	Network::BlowfishFilter*								pBlowfishFilter_;
+	Network::EncryptionFilter*								pEncryptionFilter_;
 
 	// ̳߳
 	thread::ThreadPool										threadPool_;
@@ -263,6 +263,13 @@ bool Config::loadConfig(std::string fileName)
 			Network::g_channelExternalEncryptType = xml->getValInt(childnode);
 		}
 
+		childnode = xml->enterNode(rootNode, "compressThreshold");
+		if (childnode)
+		{
+			int threshold = xml->getValInt(childnode);
+			Network::g_channelExternalCompressThreshold = threshold > 0 ? (uint32)threshold : 0;
+		}
+
 		TiXmlNode* rudpChildnode = xml->enterNode(rootNode, "reliableUDP");
 		if (rudpChildnode)
 		{
@@ -20,6 +20,9 @@ namespace KBEngine{
 #define OBJECT_POOL_INIT_SIZE			16
 #define OBJECT_POOL_INIT_MAX_SIZE		OBJECT_POOL_INIT_SIZE * 1024
 
+// ̻߳ÿؽĶ ػ泬ʱ黹һ
+#define OBJECT_POOL_THREAD_CACHE_BATCH	32
+
 // ÿ5Ӽһ
 #define OBJECT_POOL_REDUCING_TIME_OUT	300 * stampsPerSecondD()
 
@@ -45,6 +48,9 @@ public:
 	һЩǳƵı 磺MemoryStream, Bundle, TCPPacketȵ
 	ضͨ˷ֵЧԤǰһЩ󻺴õʱֱӴӶ
 	ȡһδʹõĶ󼴿ɡ
+
+	Ҫڶ߳ʹʱenableThreadCache ÿ߳ڱػдȡ
+	ֻбػΪջ߹ʱżذ һ̴߳һ̻߳ա
 */
 template< typename T, typename THREADMUTEX = KBEngine::thread::ThreadMutexNull >
 class ObjectPool
@@ -56,6 +62,7 @@ public:
 		objects_(),
 		max_(OBJECT_POOL_INIT_MAX_SIZE),
 		isDestroyed_(false),
+		threadCached_(false),
 		pMutex_(new THREADMUTEX()),
 		name_(name),
 		total_allocs_(0),
@@ -69,6 +76,7 @@ public:
 		objects_(),
 		max_((max == 0 ? 1 : max)),
 		isDestroyed_(false),
+		threadCached_(false),
 		pMutex_(new THREADMUTEX()),
 		name_(name),
 		total_allocs_(0),
@@ -86,6 +94,14 @@ public:
 	
 	void destroy()
 	{
+		// ̵߳ıػ߳̽ʱ黹 ٺ黹Ķֱɾ
+		if(threadCached_)
+		{
+			ThreadCache& cache = threadCache();
+			flushThreadCache(cache, 0);
+			cache.pPool = NULL;
+		}
+
 		pMutex_->lockMutex();
 
 		isDestroyed_ = true;
@@ -121,6 +137,24 @@ public:
 		return pMutex_;
 	}
 
+	/**
+		̱߳ػ棬 ֮ؿڶ߳ʹ
+		߳ʹó֮ǰã ÿֻһؿ(水ʹ̱߳)
+	*/
+	void enableThreadCache()
+	{
+		if(threadCached_)
+			return;
+
+		pMutex(new KBEngine::thread::ThreadMutex());
+		threadCached_ = true;
+	}
+
+	bool isThreadCached() const
+	{
+		return threadCached_;
+	}
+
 	void assignObjs(unsigned int preAssignVal = OBJECT_POOL_INIT_SIZE)
 	{
 		for(unsigned int i=0; i<preAssignVal; ++i)
@@ -140,6 +174,9 @@ public:
 	template<typename T1>
 	T* createObject(const std::string& logPoint)
 	{
+		if(threadCached_)
+			return createFromThreadCache(logPoint);
+
 		pMutex_->lockMutex();
 
 		while(true)
@@ -171,6 +208,9 @@ public:
 	*/
 	T* createObject(const std::string& logPoint)
 	{
+		if(threadCached_)
+			return createFromThreadCache(logPoint);
+
 		pMutex_->lockMutex();
 
 		while(true)
@@ -201,6 +241,12 @@ public:
 	*/
 	void reclaimObject(T* obj)
 	{
+		if(threadCached_)
+		{
+			reclaimToThreadCache(obj);
+			return;
+		}
+
 		pMutex_->lockMutex();
 		reclaimObject_(obj);
 		pMutex_->unlockMutex();
@@ -211,6 +257,16 @@ public:
 	*/
 	void reclaimObject(std::list<T*>& objs)
 	{
+		if(threadCached_)
+		{
+			typename std::list< T* >::iterator iter = objs.begin();
+			for(; iter != objs.end(); ++iter)
+				reclaimToThreadCache((*iter));
+
+			objs.clear();
+			return;
+		}
+
 		pMutex_->lockMutex();
 
 		typename std::list< T* >::iterator iter = objs.begin();
@@ -229,6 +285,16 @@ public:
 	*/
 	void reclaimObject(std::vector< T* >& objs)
 	{
+		if(threadCached_)
+		{
+			typename std::vector< T* >::iterator iter = objs.begin();
+			for(; iter != objs.end(); ++iter)
+				reclaimToThreadCache((*iter));
+
+			objs.clear();
+			return;
+		}
+
 		pMutex_->lockMutex();
 
 		typename std::vector< T* >::iterator iter = objs.begin();
@@ -247,6 +313,17 @@ public:
 	*/
 	void reclaimObject(std::queue<T*>& objs)
 	{
+		if(threadCached_)
+		{
+			while(!objs.empty())
+			{
+				reclaimToThreadCache(objs.front());
+				objs.pop();
+			}
+
+			return;
+		}
+
 		pMutex_->lockMutex();
 
 		while(!objs.empty())
@@ -308,7 +385,18 @@ protected:
 			obj->onReclaimObject();
 			obj->isEnabledPoolObject(false);
 			obj->poolObjectCreatePoint("");
+		}
 
+		putObject_(obj);
+	}
+
+	/**
+		Ѿ״̬ĶŻس
+	*/
+	void putObject_(T* obj)
+	{
+		if(obj != NULL)
+		{
 			if(size() >= max_ || isDestroyed_)
 			{
 				delete obj;
@@ -352,6 +440,123 @@ protected:
 		}
 	}
 
+	/**
+		̱߳ػ
+	*/
+	struct ThreadCache
+	{
+		ThreadCache():
+			pPool(NULL),
+			objects(),
+			logPoints()
+		{
+		}
+
+		// ߳̽ʱ黹ж
+		~ThreadCache()
+		{
+			if(pPool)
+				pPool->flushThreadCache(*this, 0);
+		}
+
+		ObjectPool* pPool;
+		std::vector<T*> objects;
+
+		// ̴߳յļ仯 ؽʱϲlogPoints_
+		std::map<std::string, int> logPoints;
+	};
+
+	ThreadCache& threadCache()
+	{
+		static thread_local ThreadCache cache;
+
+		if(cache.pPool == NULL)
+			cache.pPool = this;
+
+		return cache;
+	}
+
+	T* createFromThreadCache(const std::string& logPoint)
+	{
+		ThreadCache& cache = threadCache();
+
+		if(cache.objects.empty())
+		{
+			pMutex_->lockMutex();
+
+			if(obj_count_ < OBJECT_POOL_THREAD_CACHE_BATCH)
+				assignObjs(OBJECT_POOL_THREAD_CACHE_BATCH - (unsigned int)obj_count_);
+
+			for(size_t i = 0; i < OBJECT_POOL_THREAD_CACHE_BATCH; ++i)
+			{
+				cache.objects.push_back(static_cast<T*>(*objects_.begin()));
+				objects_.pop_front();
+				--obj_count_;
+			}
+
+			flushLogPoints(cache);
+			pMutex_->unlockMutex();
+		}
+
+		T* t = cache.objects.back();
+		cache.objects.pop_back();
+
+		++cache.logPoints[logPoint];
+		t->poolObjectCreatePoint(logPoint);
+		t->onEabledPoolObject();
+		t->isEnabledPoolObject(true);
+		return t;
+	}
+
+	void reclaimToThreadCache(T* obj)
+	{
+		if(obj == NULL)
+			return;
+
+		ThreadCache& cache = threadCache();
+
+		--cache.logPoints[obj->poolObjectCreatePoint()];
+
+		// ״̬
+		obj->onReclaimObject();
+		obj->isEnabledPoolObject(false);
+		obj->poolObjectCreatePoint("");
+
+		cache.objects.push_back(obj);
+
+		if(cache.objects.size() >= OBJECT_POOL_THREAD_CACHE_BATCH * 2)
+			flushThreadCache(cache, OBJECT_POOL_THREAD_CACHE_BATCH);
+	}
+
+	/**
+		ػгkeepĶ󻹸
+	*/
+	void flushThreadCache(ThreadCache& cache, size_t keep)
+	{
+		pMutex_->lockMutex();
+
+		while(cache.objects.size() > keep)
+		{
+			putObject_(cache.objects.back());
+			cache.objects.pop_back();
+		}
+
+		flushLogPoints(cache);
+		pMutex_->unlockMutex();
+	}
+
+	void flushLogPoints(ThreadCache& cache)
+	{
+		std::map<std::string, int>::iterator iter = cache.logPoints.begin();
+		for(; iter != cache.logPoints.end(); ++iter)
+		{
+			if(iter->second != 0)
+				logPoints_[iter->first].count += iter->second;
+		}
+
+		cache.logPoints.clear();
+	}
+
 protected:
 	OBJECTS objects_;
 
@@ -359,6 +564,9 @@ protected:
 
 	bool isDestroyed_;
 
+	// Ƿ̱߳ػ
+	bool threadCached_;
+
 	// һЩԭбҪ
 	// 磺dbmgr߳logcellappмnavmesh̻߳صµlog
 	THREADMUTEX* pMutex_;
@@ -100,7 +100,7 @@ protected:
 class TimersBase
 {
 public:
-	virtual void onCancel() = 0;
+	virtual void onCancel(TimeBase* pTime) = 0;
 };
 
 template<class TIME_STAMP>
@@ -134,7 +134,7 @@ private:
 	Container container_;
 
 	void purgeCancelledTimes();
-	void onCancel();
+	void onCancel(TimeBase* pTime);
 
 	class Time : public TimeBase
 	{
@@ -219,10 +219,21 @@ private:
 
 };
 
-typedef TimersT<uint32> Timers;
-typedef TimersT<uint64> Timers64;
 }
 
 #include "timer.inl"
+#include "timing_wheel.h"
+
+namespace KBEngine
+{
+// ʱKBE_USE_TIMING_WHEELʹʱִʵֵĶʱ
+#ifdef KBE_USE_TIMING_WHEEL
+typedef TimingWheelT<uint32> Timers;
+typedef TimingWheelT<uint64> Timers64;
+#else
+typedef TimersT<uint32> Timers;
+typedef TimersT<uint64> Timers64;
+#endif
+}
 
 #endif // KBE_TIMER_H
@@ -27,7 +27,7 @@ TimerHandle TimersT< TIME_STAMP >::add( TimeStamp startTime,
 }
 
 template <class TIME_STAMP>
-void TimersT< TIME_STAMP >::onCancel()
+void TimersT< TIME_STAMP >::onCancel(TimeBase* pTime)
 {
 	++numCancelled_;
 
@@ -225,7 +225,7 @@ inline void TimeBase::cancel()
 		pHandler_ = NULL;
 	}
 
-	owner_.onCancel();
+	owner_.onCancel(this);
 }
 
 
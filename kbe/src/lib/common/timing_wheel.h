@@ -0,0 +1,151 @@
+// Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
+#ifndef KBE_TIMING_WHEEL_H
+#define KBE_TIMING_WHEEL_H
+
+// 由timer.h包含， 依赖其中的TimerHandle、TimeBase与TimersBase
+
+namespace KBEngine
+{
+
+/**
+	分层时间轮
+	与TimersT拥有相同的接口， 添加与取消定时器都是O(1)的， 不需要堆的调整与对已取消定时器的周期性清理。
+
+	时间被量化为tick(见timingWheelGranularity)， 第0层每个槽对应一个tick，
+	更高层的每个槽对应下一层转一圈的时长， 当低一层转完一圈时将上一层当前槽内的定时器重新分配到下层。
+	定时器在其到期时间向上取整的tick处触发， 因此不会早于到期时间触发， 最多晚一个tick。
+*/
+template<class TIME_STAMP>
+class TimingWheelT : public TimersBase
+{
+public:
+	typedef TIME_STAMP TimeStamp;
+
+	TimingWheelT();
+	virtual ~TimingWheelT();
+
+	inline uint32 size() const	{ return size_; }
+	inline bool empty() const	{ return size_ == 0; }
+
+	int	process(TimeStamp now);
+	bool legal( TimerHandle handle ) const;
+	TIME_STAMP nextExp( TimeStamp now ) const;
+	void clear( bool shouldCallCancel = true );
+
+	bool getTimerInfo( TimerHandle handle,
+					TimeStamp& time,
+					TimeStamp&	interval,
+					void *&	pUser ) const;
+
+	TimerHandle	add(TimeStamp startTime, TimeStamp interval,
+						TimerHandler* pHandler, void * pUser);
+
+private:
+	enum
+	{
+		WHEEL_ROOT_BITS = 8,
+		WHEEL_BITS = 6,
+		WHEEL_LEVELS = 4,
+
+		WHEEL_ROOT_SIZE = 1 << WHEEL_ROOT_BITS,
+		WHEEL_SIZE = 1 << WHEEL_BITS,
+		WHEEL_ROOT_MASK = WHEEL_ROOT_SIZE - 1,
+		WHEEL_MASK = WHEEL_SIZE - 1,
+
+		EXPIRED_SLOT = 0,
+		NUM_SLOTS = 1 + WHEEL_ROOT_SIZE + (WHEEL_LEVELS - 1) * WHEEL_SIZE
+	};
+
+	// 时间轮所能表示的最大tick跨度， 超出的定时器先放在最高层， 重新分配时再计算位置
+	static const uint64 MAX_WHEEL_TICKS =
+		(uint64)1 << (WHEEL_ROOT_BITS + (WHEEL_LEVELS - 1) * WHEEL_BITS);
+
+	// 一次需要推进的tick过多时直接重建时间轮， 而不是逐个tick推进
+	static const uint64 REBUILD_WHEEL_TICKS = (uint64)1 << (WHEEL_ROOT_BITS + WHEEL_BITS);
+
+	void onCancel(TimeBase* pTime);
+
+	class Time : public TimeBase
+	{
+	public:
+		Time( TimersBase & owner, TimeStamp startTime, TimeStamp interval,
+			TimerHandler * pHandler, void * pUser );
+
+		TIME_STAMP time() const			{ return time_; }
+		TIME_STAMP interval() const		{ return interval_; }
+
+		void triggerTimer();
+
+		bool isLinked() const			{ return ppSlot_ != NULL; }
+
+	private:
+		friend class TimingWheelT;
+
+		TimeStamp			time_;
+		TimeStamp			interval_;
+
+		// 所在槽的链表
+		Time **				ppSlot_;
+		Time *				pPrev_;
+		Time *				pNext_;
+
+		Time( const Time & );
+		Time & operator=( const Time & );
+	};
+
+	uint64 toTick(TimeStamp time) const;
+
+	void link(Time* pTime);
+	void unlink(Time* pTime);
+	void cascade(int level, uint32 index);
+	int processSlot(Time** ppSlot);
+	void rebuild(uint64 tick);
+	void releaseCancelledTimes();
+
+	Time** slot(int level, uint32 index)
+	{
+		return level == 0 ? &slots_[EXPIRED_SLOT + 1 + index] :
+			&slots_[EXPIRED_SLOT + 1 + WHEEL_ROOT_SIZE + (level - 1) * WHEEL_SIZE + index];
+	}
+
+	// 所有的槽， 第一个槽存放已经过期而尚未被触发的定时器， 然后依次是每一层的槽
+	Time *			slots_[NUM_SLOTS];
+
+	// 下一个需要处理的tick
+	uint64			currTick_;
+
+	// 每个tick对应的时间长度
+	TimeStamp		granularity_;
+
+	uint32			size_;
+
+	Time * 			pProcessingNode_;
+	TimeStamp 		lastProcessTime_;
+
+	// 已取消的定时器， 在下一次process时释放
+	Time *			pCancelledTimes_;
+
+	TimingWheelT( const TimingWheelT & );
+	TimingWheelT & operator=( const TimingWheelT & );
+};
+
+/**
+	时间轮中每个tick的时长
+	Timers以游戏tick为单位， Timers64以timestamp()为单位， 后者量化到毫秒
+*/
+inline uint32 timingWheelGranularity(uint32)
+{
+	return 1;
+}
+
+inline uint64 timingWheelGranularity(uint64)
+{
+	uint64 granularity = stampsPerSecond() / 1000;
+	return granularity > 0 ? granularity : 1;
+}
+
+}
+
+#include "timing_wheel.inl"
+
+#endif // KBE_TIMING_WHEEL_H
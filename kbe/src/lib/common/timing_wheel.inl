@@ -0,0 +1,406 @@
+// Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
+
+namespace KBEngine {
+
+template<class TIME_STAMP>
+TimingWheelT<TIME_STAMP>::TimingWheelT():
+	currTick_(0),
+	granularity_(timingWheelGranularity(TIME_STAMP(0))),
+	size_(0),
+	pProcessingNode_( NULL ),
+	lastProcessTime_( 0 ),
+	pCancelledTimes_( NULL )
+{
+	memset(slots_, 0, sizeof(slots_));
+}
+
+template<class TIME_STAMP>
+TimingWheelT<TIME_STAMP>::~TimingWheelT()
+{
+	this->clear();
+}
+
+template <class TIME_STAMP>
+uint64 TimingWheelT< TIME_STAMP >::toTick(TimeStamp time) const
+{
+	// 向上取整， 保证定时器不会早于到期时间被触发
+	return ((uint64)time + granularity_ - 1) / granularity_;
+}
+
+template <class TIME_STAMP>
+TimerHandle TimingWheelT< TIME_STAMP >::add( TimeStamp startTime,
+		TimeStamp interval, TimerHandler * pHandler, void * pUser )
+{
+	Time * pTime = new Time( *this, startTime, interval, pHandler, pUser );
+	link( pTime );
+	++size_;
+	return TimerHandle( pTime );
+}
+
+template <class TIME_STAMP>
+void TimingWheelT< TIME_STAMP >::link(Time* pTime)
+{
+	uint64 tick = toTick(pTime->time());
+
+	uint64 delta = tick - currTick_;
+	if (tick >= currTick_ && delta >= MAX_WHEEL_TICKS)
+	{
+		delta = MAX_WHEEL_TICKS - 1;
+		tick = currTick_ + delta;
+	}
+
+	Time** ppSlot = NULL;
+
+	if (tick < currTick_)
+	{
+		// 已经过期， 下一次process时立即触发
+		ppSlot = &slots_[EXPIRED_SLOT];
+	}
+	else if (delta < WHEEL_ROOT_SIZE)
+	{
+		ppSlot = slot(0, (uint32)(tick & WHEEL_ROOT_MASK));
+	}
+	else
+	{
+		int level = 1;
+		while (delta >= ((uint64)1 << (WHEEL_ROOT_BITS + level * WHEEL_BITS)))
+			++level;
+
+		ppSlot = slot(level,
+			(uint32)((tick >> (WHEEL_ROOT_BITS + (level - 1) * WHEEL_BITS)) & WHEEL_MASK));
+	}
+
+	pTime->ppSlot_ = ppSlot;
+	pTime->pPrev_ = NULL;
+	pTime->pNext_ = *ppSlot;
+
+	if (*ppSlot)
+		(*ppSlot)->pPrev_ = pTime;
+
+	*ppSlot = pTime;
+}
+
+template <class TIME_STAMP>
+void TimingWheelT< TIME_STAMP >::unlink(Time* pTime)
+{
+	if (pTime->pPrev_)
+		pTime->pPrev_->pNext_ = pTime->pNext_;
+	else
+		*pTime->ppSlot_ = pTime->pNext_;
+
+	if (pTime->pNext_)
+		pTime->pNext_->pPrev_ = pTime->pPrev_;
+
+	pTime->ppSlot_ = NULL;
+	pTime->pPrev_ = NULL;
+	pTime->pNext_ = NULL;
+}
+
+template <class TIME_STAMP>
+void TimingWheelT< TIME_STAMP >::onCancel(TimeBase* pTimeBase)
+{
+	Time* pTime = static_cast<Time*>(pTimeBase);
+
+	// 正在被处理或清理的定时器已经不在时间轮中， 由调用者负责释放
+	if (!pTime->isLinked())
+		return;
+
+	unlink(pTime);
+	--size_;
+
+	// 取消可能发生在pTime自身的回调之中， 因此延迟释放
+	pTime->pNext_ = pCancelledTimes_;
+	pCancelledTimes_ = pTime;
+}
+
+template <class TIME_STAMP>
+void TimingWheelT< TIME_STAMP >::releaseCancelledTimes()
+{
+	while (pCancelledTimes_)
+	{
+		Time* pTime = pCancelledTimes_;
+		pCancelledTimes_ = pTime->pNext_;
+		delete pTime;
+	}
+}
+
+template <class TIME_STAMP>
+void TimingWheelT< TIME_STAMP >::clear(bool shouldCallCancel)
+{
+	int maxLoopCount = (int)size_;
+
+	for (uint32 i = 0; i < NUM_SLOTS; ++i)
+	{
+		Time** ppSlot = &slots_[i];
+
+		while (*ppSlot)
+		{
+			Time * pTime = *ppSlot;
+			unlink(pTime);
+			--size_;
+
+			if (!pTime->isCancelled() && shouldCallCancel)
+			{
+				pTime->cancel();
+
+				if (--maxLoopCount == 0)
+				{
+					shouldCallCancel = false;
+				}
+			}
+
+			delete pTime;
+		}
+	}
+
+	releaseCancelledTimes();
+
+	// 取消回调中可能添加了新的定时器
+	if (size_ > 0)
+	{
+		this->clear(false);
+	}
+
+	size_ = 0;
+}
+
+template <class TIME_STAMP>
+void TimingWheelT< TIME_STAMP >::cascade(int level, uint32 index)
+{
+	Time** ppSlot = slot(level, index);
+	Time* pTime = *ppSlot;
+	*ppSlot = NULL;
+
+	while (pTime)
+	{
+		Time* pNext = pTime->pNext_;
+		link(pTime);
+		pTime = pNext;
+	}
+}
+
+template <class TIME_STAMP>
+void TimingWheelT< TIME_STAMP >::rebuild(uint64 tick)
+{
+	Time* pTimes = NULL;
+
+	for (uint32 i = 0; i < NUM_SLOTS; ++i)
+	{
+		Time* pTime = slots_[i];
+		slots_[i] = NULL;
+
+		while (pTime)
+		{
+			Time* pNext = pTime->pNext_;
+			pTime->pNext_ = pTimes;
+			pTimes = pTime;
+			pTime = pNext;
+		}
+	}
+
+	currTick_ = tick;
+
+	while (pTimes)
+	{
+		Time* pNext = pTimes->pNext_;
+		link(pTimes);
+		pTimes = pNext;
+	}
+}
+
+template <class TIME_STAMP>
+int TimingWheelT< TIME_STAMP >::processSlot(Time** ppSlot)
+{
+	int numFired = 0;
+
+	while (*ppSlot)
+	{
+		Time * pTime = pProcessingNode_ = *ppSlot;
+		unlink(pTime);
+
+		if (!pTime->isCancelled())
+		{
+			++numFired;
+			pTime->triggerTimer();
+		}
+
+		if (!pTime->isCancelled())
+		{
+			// 间隔小于一个tick的定时器会被放回当前槽， 与TimersT一样在本次process中追赶触发
+			link( pTime );
+		}
+		else
+		{
+			delete pTime;
+			--size_;
+		}
+	}
+
+	pProcessingNode_ = NULL;
+	return numFired;
+}
+
+template <class TIME_STAMP>
+int TimingWheelT< TIME_STAMP >::process(TimeStamp now)
+{
+	int numFired = 0;
+
+	releaseCancelledTimes();
+
+	uint64 nowTick = (uint64)now / granularity_;
+
+	if (size_ == 0)
+	{
+		if (currTick_ <= nowTick)
+			currTick_ = nowTick + 1;
+	}
+	else if (nowTick >= currTick_ + REBUILD_WHEEL_TICKS)
+	{
+		rebuild(nowTick);
+	}
+
+	numFired += processSlot(&slots_[EXPIRED_SLOT]);
+
+	while (currTick_ <= nowTick)
+	{
+		uint32 index = (uint32)(currTick_ & WHEEL_ROOT_MASK);
+
+		// 第0层转完一圈， 将上层当前槽内的定时器重新分配到下层
+		if (index == 0)
+		{
+			for (int level = 1; level < WHEEL_LEVELS; ++level)
+			{
+				uint32 levelIndex = (uint32)((currTick_ >> (WHEEL_ROOT_BITS + (level - 1) * WHEEL_BITS)) & WHEEL_MASK);
+				cascade(level, levelIndex);
+
+				if (levelIndex != 0)
+					break;
+			}
+		}
+
+		numFired += processSlot(slot(0, index));
+		++currTick_;
+	}
+
+	lastProcessTime_ = now;
+	return numFired;
+}
+
+template <class TIME_STAMP>
+bool TimingWheelT< TIME_STAMP >::legal(TimerHandle handle) const
+{
+	Time * pTime = static_cast< Time* >( handle.time() );
+
+	if (pTime == NULL)
+	{
+		return false;
+	}
+
+	if (pTime == pProcessingNode_)
+	{
+		return true;
+	}
+
+	for (uint32 i = 0; i < NUM_SLOTS; ++i)
+	{
+		for (Time * pIter = slots_[i]; pIter; pIter = pIter->pNext_)
+		{
+			if (pIter == pTime)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+template <class TIME_STAMP>
+TIME_STAMP TimingWheelT< TIME_STAMP >::nextExp(TimeStamp now) const
+{
+	if (size_ == 0)
+	{
+		return 0;
+	}
+
+	// 只查找第0层在本圈内剩余的槽， 找不到时返回本圈结束的时间，
+	// 这是下一次到期时间的下限， 调用者最多被提前唤醒一次
+	if (slots_[EXPIRED_SLOT])
+	{
+		return 0;
+	}
+
+	uint64 tick = currTick_;
+	uint64 endTick = (currTick_ | WHEEL_ROOT_MASK) + 1;
+
+	for (; tick < endTick; ++tick)
+	{
+		if (slots_[EXPIRED_SLOT + 1 + (tick & WHEEL_ROOT_MASK)])
+			break;
+	}
+
+	TimeStamp expTime = (TimeStamp)(tick * granularity_);
+	if (now >= expTime)
+	{
+		return 0;
+	}
+
+	return expTime - now;
+}
+
+template <class TIME_STAMP>
+bool TimingWheelT< TIME_STAMP >::getTimerInfo( TimerHandle handle,
+					TimeStamp &			time,
+					TimeStamp &			interval,
+					void * &			pUser ) const
+{
+	Time * pTime = static_cast< Time * >( handle.time() );
+
+	if (!pTime->isCancelled())
+	{
+		time = pTime->time();
+		interval = pTime->interval();
+		pUser = pTime->getUserData();
+
+		return true;
+	}
+
+	return false;
+}
+
+template <class TIME_STAMP>
+TimingWheelT< TIME_STAMP >::Time::Time( TimersBase & owner,
+		TimeStamp startTime, TimeStamp interval,
+		TimerHandler * _pHandler, void * _pUser ) :
+	TimeBase(owner, _pHandler, _pUser),
+	time_(startTime),
+	interval_(interval),
+	ppSlot_(NULL),
+	pPrev_(NULL),
+	pNext_(NULL)
+{
+}
+
+template <class TIME_STAMP>
+void TimingWheelT< TIME_STAMP >::Time::triggerTimer()
+{
+	if (!this->isCancelled())
+	{
+		state_ = TIME_EXECUTING;
+
+		pHandler_->handleTimeout( TimerHandle( this ), pUserData_ );
+
+		if ((interval_ == 0) && !this->isCancelled())
+		{
+			this->cancel();
+		}
+	}
+
+	if (!this->isCancelled())
+	{
+		time_ += interval_;
+		state_ = TIME_PENDING;
+	}
+}
+
+}
@@ -35,7 +35,8 @@ public:
 	DBInterface(const char* name) :
 	db_port_(3306),
 	db_numConnections_(1),
-	lastquery_()
+	lastquery_(),
+	numWrittenRows_(0)
 	{
 		strncpy(name_, name, MAX_NAME - 1);
 		int dbIndex = g_kbeSrvConfig.dbInterfaceName2dbInterfaceIndex(this->name());
@@ -139,6 +140,12 @@ public:
 	*/
 	virtual const std::string& lastquery() const{ return lastquery_; }
 
+	/**
+		дʵʱ롢ɾ ִֻд̷߳
+	*/
+	uint32 numWrittenRows() const{ return numWrittenRows_; }
+	void onRowsWritten(uint32 num){ numWrittenRows_ += num; }
+
 protected:
 	char name_[MAX_BUF];									// ݿӿڵ
 	char db_type_[MAX_BUF];									// ݿ
@@ -150,6 +157,7 @@ protected:
 	uint16 db_numConnections_;								// ݿ
 	std::string lastquery_;									// һβѯ
 	uint16 dbIndex_;										// Ӧݿӿ
+	uint32 numWrittenRows_;									// д
 };
 
 /*
@@ -61,6 +61,18 @@ DBID EntityTable::writeTable(DBInterface* pdbi, DBID dbid, int8 shouldAutoLoad,
 	return dbid;
 }
 
+//-------------------------------------------------------------------------------------
+uint32 EntityTable::writeTables(DBInterface* pdbi, std::vector<ENTITY_WRITE_DATA>& datas, ScriptDefModule* pModule)
+{
+	std::vector<ENTITY_WRITE_DATA>::iterator iter = datas.begin();
+	for(; iter != datas.end(); ++iter)
+	{
+		iter->dbid = writeTable(pdbi, iter->dbid, iter->shouldAutoLoad, iter->s, pModule);
+	}
+
+	return (uint32)datas.size();
+}
+
 //-------------------------------------------------------------------------------------
 bool EntityTable::removeEntity(DBInterface* pdbi, DBID dbid, ScriptDefModule* pModule)
 {
@@ -301,6 +313,15 @@ DBID EntityTables::writeEntity(DBInterface* pdbi, DBID dbid, int8 shouldAutoLoad
 	return pTable->writeTable(pdbi, dbid, shouldAutoLoad, s, pModule);
 }
 
+//-------------------------------------------------------------------------------------
+uint32 EntityTables::writeEntities(DBInterface* pdbi, std::vector<ENTITY_WRITE_DATA>& datas, ScriptDefModule* pModule)
+{
+	EntityTable* pTable = this->findTable(pModule->getName());
+	KBE_ASSERT(pTable != NULL);
+
+	return pTable->writeTables(pdbi, datas, pModule);
+}
+
 //-------------------------------------------------------------------------------------
 bool EntityTables::removeEntity(DBInterface* pdbi, DBID dbid, ScriptDefModule* pModule)
 {
@@ -72,6 +72,23 @@ struct ACCOUNT_INFOS
 	uint64 deadline;
 };
 
+/**
+	дentityʱÿentity
+*/
+struct ENTITY_WRITE_DATA
+{
+	ENTITY_WRITE_DATA(DBID id, int8 autoLoad, MemoryStream* pStream):
+	dbid(id),
+	shouldAutoLoad(autoLoad),
+	s(pStream)
+	{
+	}
+
+	DBID dbid;
+	int8 shouldAutoLoad;
+	MemoryStream* s;
+};
+
 /**
 	άentityݿеıеһֶ
 */
@@ -229,6 +246,12 @@ public:
 	*/
 	virtual DBID writeTable(DBInterface* pdbi, DBID dbid, int8 shouldAutoLoad, MemoryStream* s, ScriptDefModule* pModule);
 
+	/**
+		ͬ͵Ķentity ÿһdbidΪдĽ
+		дʹõ
+	*/
+	virtual uint32 writeTables(DBInterface* pdbi, std::vector<ENTITY_WRITE_DATA>& datas, ScriptDefModule* pModule);
+
 	/**
 		ݿɾentity
 	*/
@@ -329,6 +352,11 @@ public:
 	*/
 	DBID writeEntity(DBInterface* pdbi, DBID dbid, int8 shouldAutoLoad, MemoryStream* s, ScriptDefModule* pModule);
 
+	/**
+		дͬ͵Ķentityݿ
+	*/
+	uint32 writeEntities(DBInterface* pdbi, std::vector<ENTITY_WRITE_DATA>& datas, ScriptDefModule* pModule);
+
 	/**
 		ݿɾentity
 	*/
@@ -75,6 +75,8 @@ public:
 		inTransaction_ = value;
 	}
 
+	bool inTransaction() const			{ return inTransaction_; }
+
 	bool hasLostConnection() const		{ return hasLostConnection_; }
 	void hasLostConnection( bool v )	{ hasLostConnection_ = v; }
 
@@ -15,12 +15,16 @@ namespace mysql {
 static std::string SQL_START_TRANSACTION = "START TRANSACTION";
 static std::string SQL_ROLLBACK = "ROLLBACK";
 static std::string SQL_COMMIT = "COMMIT";
+static std::string SQL_SAVEPOINT = "SAVEPOINT kbe_transaction";
+static std::string SQL_ROLLBACK_SAVEPOINT = "ROLLBACK TO SAVEPOINT kbe_transaction";
+static std::string SQL_RELEASE_SAVEPOINT = "RELEASE SAVEPOINT kbe_transaction";
 
 //-------------------------------------------------------------------------------------
 DBTransaction::DBTransaction(DBInterface* pdbi, bool autostart):
 	pdbi_(pdbi),
 	committed_(false),
-	autostart_(autostart)
+	autostart_(autostart),
+	nested_(false)
 {
 	if(autostart)
 		start();
@@ -38,6 +42,14 @@ void DBTransaction::start()
 {
 	committed_ = false;
 
+	// ʱԱǶף ϵĴ
+	nested_ = static_cast<DBInterfaceMysql*>(pdbi_)->inTransaction();
+	if(nested_)
+	{
+		pdbi_->query(SQL_SAVEPOINT, false);
+		return;
+	}
+
 	try
 	{
 		pdbi_->query(SQL_START_TRANSACTION, false);
@@ -63,7 +75,7 @@ void DBTransaction::end()
 			WARNING_MSG( "DBTransaction::~DBTransaction: "
 					"Rolling back\n" );
 
-			pdbi_->query(SQL_ROLLBACK, false);
+			pdbi_->query(nested_ ? SQL_ROLLBACK_SAVEPOINT : SQL_ROLLBACK, false);
 		}
 		catch (DBException & e)
 		{
@@ -74,6 +86,12 @@ void DBTransaction::end()
 		}
 	}
 
+	if(nested_)
+	{
+		nested_ = false;
+		return;
+	}
+
 	static_cast<DBInterfaceMysql*>(pdbi_)->inTransaction(false);
 }
 
@@ -88,6 +106,13 @@ void DBTransaction::commit()
 {
 	KBE_ASSERT(!committed_);
 
+	if(nested_)
+	{
+		pdbi_->query(SQL_RELEASE_SAVEPOINT, false);
+		committed_ = true;
+		return;
+	}
+
 	uint64 startTime = timestamp();
 
 	try
@@ -8,6 +8,8 @@ class DBInterface;
 namespace mysql {
 
 /**
+	Ѵʱ(DBThreadΪÿ)ԱǶף
+	δύʱֻع
  */
 class DBTransaction
 {
@@ -28,6 +30,7 @@ private:
 	DBInterface* pdbi_;
 	bool committed_;
 	bool autostart_;
+	bool nested_;
 };
 
 }
@@ -5,6 +5,8 @@
 #include "read_entity_helper.h"
 #include "write_entity_helper.h"
 #include "remove_entity_helper.h"
+#include "db_exception.h"
+#include "db_transaction.h"
 #include "entitydef/scriptdef_module.h"
 #include "entitydef/property.h"
 #include "entitydef/entitydef.h"
@@ -763,6 +765,16 @@ void EntityTableMysql::entityShouldAutoLoad(DBInterface* pdbi, DBID dbid, bool s
 DBID EntityTableMysql::writeTable(DBInterface* pdbi, DBID dbid, int8 shouldAutoLoad, MemoryStream* s, ScriptDefModule* pModule)
 {
 	mysql::DBContext context;
+	if(!getWriteSqlContext(pdbi, dbid, s, pModule, context))
+		return dbid;
+
+	return writeContext(pdbi, shouldAutoLoad, context);
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityTableMysql::getWriteSqlContext(DBInterface* pdbi, DBID dbid, MemoryStream* s, ScriptDefModule* pModule, 
+	mysql::DBContext& context)
+{
 	context.parentTableName = "";
 	context.parentTableDBID = 0;
 	context.dbid = dbid;
@@ -779,17 +791,23 @@ DBID EntityTableMysql::writeTable(DBInterface* pdbi, DBID dbid, int8 shouldAutoL
 		if(pTableItem == NULL)
 		{
 			ERROR_MSG(fmt::format("EntityTable::writeTable: not found item[{}].\n", child_pid));
-			return dbid;
+			return false;
 		}
 		
 		static_cast<EntityTableItemMysqlBase*>(pTableItem)->getWriteSqlItem(pdbi, s, context);
 	};
 
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+DBID EntityTableMysql::writeContext(DBInterface* pdbi, int8 shouldAutoLoad, mysql::DBContext& context)
+{
 	if(!WriteEntityHelper::writeDB(context.dbid > 0 ? TABLE_OP_UPDATE : TABLE_OP_INSERT, 
 		pdbi, context))
 		return 0;
 
-	dbid = context.dbid;
+	DBID dbid = context.dbid;
 
 	// dbidΪ0洢ʧܷ
 	if(dbid <= 0)
@@ -802,6 +820,128 @@ DBID EntityTableMysql::writeTable(DBInterface* pdbi, DBID dbid, int8 shouldAutoL
 	return dbid;
 }
 
+//-------------------------------------------------------------------------------------
+uint32 EntityTableMysql::writeTables(DBInterface* pdbi, std::vector<ENTITY_WRITE_DATA>& datas, ScriptDefModule* pModule)
+{
+	uint32 numStatements = 0;
+
+	// عҪ¶ȡд
+	std::vector<DBID> dbids;
+	std::vector<size_t> rposs;
+	dbids.reserve(datas.size());
+	rposs.reserve(datas.size());
+
+	for(size_t i = 0; i < datas.size(); ++i)
+	{
+		dbids.push_back(datas[i].dbid);
+		rposs.push_back(datas[i].s->rpos());
+	}
+
+	{
+		mysql::DBTransaction transaction(pdbi);
+		bool ret = false;
+
+		try
+		{
+			ret = writeBatchTables(pdbi, datas, pModule, numStatements);
+		}
+		catch (DBException & e)
+		{
+			// DBThread
+			if(e.isLostConnection() || e.shouldRetry())
+				throw;
+
+			WARNING_MSG(fmt::format("EntityTableMysql::writeTables({}): batch write failed, writing {} entities one by one. Exception: {}\n", 
+				pModule->getName(), datas.size(), e.what()));
+		}
+
+		if(ret)
+		{
+			transaction.commit();
+			return numStatements;
+		}
+	}
+
+	for(size_t i = 0; i < datas.size(); ++i)
+	{
+		ENTITY_WRITE_DATA& data = datas[i];
+		data.s->rpos(rposs[i]);
+		data.dbid = writeTable(pdbi, dbids[i], data.shouldAutoLoad, data.s, pModule);
+		++numStatements;
+	}
+
+	return numStatements;
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityTableMysql::writeBatchTables(DBInterface* pdbi, std::vector<ENTITY_WRITE_DATA>& datas, ScriptDefModule* pModule, 
+	uint32& numStatements)
+{
+	std::vector< KBEShared_ptr<mysql::DBContext> > contexts;
+	contexts.reserve(datas.size());
+
+	// дֶͬentityϲΪһ䣬 дʱÿֶһ
+	std::map< std::string, std::vector<size_t> > batchs;
+
+	for(size_t i = 0; i < datas.size(); ++i)
+	{
+		ENTITY_WRITE_DATA& data = datas[i];
+
+		KBEShared_ptr<mysql::DBContext> pContext(new mysql::DBContext());
+		contexts.push_back(pContext);
+
+		if(!getWriteSqlContext(pdbi, data.dbid, data.s, pModule, *pContext))
+			continue;
+
+		// µentityҪܵõdbid д
+		if(data.dbid <= 0 || pContext->items.size() == 0)
+		{
+			data.dbid = writeContext(pdbi, data.shouldAutoLoad, *pContext);
+			++numStatements;
+
+			if(data.dbid <= 0)
+				return false;
+
+			continue;
+		}
+
+		batchs[WriteEntityHelper::getWriteSqlItemsKey(*pContext)].push_back(i);
+	}
+
+	std::map< std::string, std::vector<size_t> >::iterator iter = batchs.begin();
+	for(; iter != batchs.end(); ++iter)
+	{
+		std::vector<size_t>& indexs = iter->second;
+
+		std::vector<mysql::DBContext*> batchContexts;
+		batchContexts.reserve(indexs.size());
+
+		for(size_t i = 0; i < indexs.size(); ++i)
+			batchContexts.push_back(contexts[indexs[i]].get());
+
+		SqlStatementBatchUpdate sqlcmd(pdbi, pModule->getName(), batchContexts);
+		++numStatements;
+
+		if(!sqlcmd.query())
+			return false;
+
+		pdbi->onRowsWritten((uint32)batchContexts.size());
+
+		for(size_t i = 0; i < indexs.size(); ++i)
+		{
+			ENTITY_WRITE_DATA& data = datas[indexs[i]];
+
+			WriteEntityHelper::writeChildDB(TABLE_OP_UPDATE, pdbi, *batchContexts[i]);
+
+			// ʵǷԶ
+			if(data.shouldAutoLoad > -1)
+				entityShouldAutoLoad(pdbi, data.dbid, data.shouldAutoLoad > 0);
+		}
+	}
+
+	return true;
+}
+
 //-------------------------------------------------------------------------------------
 bool EntityTableMysql::removeEntity(DBInterface* pdbi, DBID dbid, ScriptDefModule* pModule)
 {
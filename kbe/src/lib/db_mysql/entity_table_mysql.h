@@ -555,6 +555,12 @@ public:
 
 	DBID writeTable(DBInterface* pdbi, DBID dbid, int8 shouldAutoLoad, MemoryStream* s, ScriptDefModule* pModule);
 
+	/**
+		ͬ͵Ķentity ѴڵentityݰдֶκϲΪһд
+		һд룬 ʧعд
+	*/
+	virtual uint32 writeTables(DBInterface* pdbi, std::vector<ENTITY_WRITE_DATA>& datas, ScriptDefModule* pModule);
+
 	/**
 		ݿɾentity
 	*/
@@ -590,7 +596,20 @@ public:
 	void init_db_item_name();
 
 protected:
-	
+	/**
+		нҪд
+	*/
+	bool getWriteSqlContext(DBInterface* pdbi, DBID dbid, MemoryStream* s, ScriptDefModule* pModule, 
+		mysql::DBContext& context);
+
+	DBID writeContext(DBInterface* pdbi, int8 shouldAutoLoad, mysql::DBContext& context);
+
+	/**
+		ϲдһentity дֶͬentityϲΪһupdate
+		κʧܷfalse ɵ߻ع
+	*/
+	bool writeBatchTables(DBInterface* pdbi, std::vector<ENTITY_WRITE_DATA>& datas, ScriptDefModule* pModule, 
+		uint32& numStatements);
 };
 
 
@@ -199,6 +199,85 @@ public:
 protected:
 };
 
+class SqlStatementBatchUpdate : public SqlStatement
+{
+public:
+	/**
+		ͬһ϶ѴеĸºϲΪһ䣬 contextֶҪһ
+		뵥updateһ ѱɾвᱻд
+	*/
+	SqlStatementBatchUpdate(DBInterface* pdbi, std::string tableName, 
+		const std::vector<mysql::DBContext*>& contexts) :
+	  SqlStatement(pdbi, tableName, 0, 0, contexts.front()->items)
+	{
+		if(tableItemDatas_.size() == 0)
+		{
+			sqlstr_ = "";
+			return;
+		}
+
+		// update tbl_Account set sm_accountName=case id when 1 then "xxx" when 2 then "xxx" end 
+		// where id in (1,2);
+		sqlstr_ = "update " ENTITY_TABLE_PERFIX "_";
+		sqlstr_ += tableName;
+		sqlstr_ += " set ";
+
+		std::vector<std::string> strdbids;
+		strdbids.reserve(contexts.size());
+
+		std::vector<mysql::DBContext*>::const_iterator iter = contexts.begin();
+		for(; iter != contexts.end(); ++iter)
+		{
+			char strdbid[MAX_BUF];
+			kbe_snprintf(strdbid, MAX_BUF, "%" PRDBID, (*iter)->dbid);
+			strdbids.push_back(strdbid);
+		}
+
+		for(size_t i = 0; i < tableItemDatas_.size(); ++i)
+		{
+			if(i > 0)
+				sqlstr_ += ",";
+
+			sqlstr_ += tableItemDatas_[i]->sqlkey;
+			sqlstr_ += "=case " TABLE_ID_CONST_STR;
+
+			for(size_t j = 0; j < contexts.size(); ++j)
+			{
+				KBEShared_ptr<mysql::DBContext::DB_ITEM_DATA> pSotvs = contexts[j]->items[i];
+
+				sqlstr_ += " when ";
+				sqlstr_ += strdbids[j];
+				sqlstr_ += " then ";
+
+				if(pSotvs->extraDatas.size() > 0)
+					sqlstr_ += pSotvs->extraDatas;
+				else
+					sqlstr_ += pSotvs->sqlval;
+			}
+
+			sqlstr_ += " end";
+		}
+
+		sqlstr_ += " where " TABLE_ID_CONST_STR " in (";
+
+		for(size_t j = 0; j < strdbids.size(); ++j)
+		{
+			if(j > 0)
+				sqlstr_ += ",";
+
+			sqlstr_ += strdbids[j];
+		}
+
+		sqlstr_ += ")";
+	}
+
+	virtual ~SqlStatementBatchUpdate()
+	{
+	}
+
+protected:
+};
+
 class SqlStatementQuery : public SqlStatement
 {
 public:
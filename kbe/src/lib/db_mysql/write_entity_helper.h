@@ -69,9 +69,60 @@ public:
 
 			ret = pSqlcmd->query();
 			context.dbid = pSqlcmd->dbid();
+
+			if(ret && pSqlcmd->sql().size() > 0)
+				pdbi->onRowsWritten(1);
+
 			delete pSqlcmd;
 		}
 
+		writeChildDB(optype, pdbi, context);
+		return ret;
+	}
+
+	/**
+		contextдıֶΣ ͬcontextԺϲΪһд
+	*/
+	static std::string getWriteSqlItemsKey(const mysql::DBContext& context)
+	{
+		std::string key = context.tableName;
+
+		mysql::DBContext::DB_ITEM_DATAS::const_iterator iter = context.items.begin();
+		for(; iter != context.items.end(); ++iter)
+		{
+			key += ",";
+			key += (*iter)->sqlkey;
+		}
+
+		return key;
+	}
+
+	/**
+		ӱѴڵĶкϲΪһ£ ʧи
+		ֵûб仯mysqlд
+	*/
+	static void batchUpdateChildDB(DBInterface* pdbi, std::vector<mysql::DBContext*>& contexts)
+	{
+		if(contexts.size() > 1)
+		{
+			SqlStatementBatchUpdate sqlcmd(pdbi, contexts.front()->tableName, contexts);
+			if(sqlcmd.query())
+			{
+				pdbi->onRowsWritten((uint32)contexts.size());
+				return;
+			}
+		}
+
+		std::vector<mysql::DBContext*>::iterator iter = contexts.begin();
+		for(; iter != contexts.end(); ++iter)
+			writeDB(TABLE_OP_UPDATE, pdbi, *(*iter));
+	}
+
+	/**
+		ӱݸµУ ҪѾд(context.dbidȷ)
+	*/
+	static void writeChildDB(DB_TABLE_OP optype, DBInterface* pdbi, mysql::DBContext& context)
+	{
 		if(optype == TABLE_OP_INSERT)
 		{
 			// ʼеӱ
@@ -195,6 +246,9 @@ public:
 			// Ҫմ˱ ѭNѾҵdbid ʹӱеӱҲЧɾ
 			if(!context.isEmpty)
 			{
+				// Ѵڵʱ ûӱаֶκϲΪһ
+				KBEUnordered_map< std::string, std::vector<mysql::DBContext*> > batchUpdates;
+
 				// ʼеӱ
 				mysql::DBContext::DB_RW_CONTEXTS::iterator iter1 = context.optable.begin();
 				for(; iter1 != context.optable.end(); ++iter1)
@@ -224,9 +278,19 @@ public:
 						}
 					}
 
+					if(wbox.dbid > 0 && wbox.optable.size() == 0 && wbox.items.size() > 0)
+					{
+						batchUpdates[getWriteSqlItemsKey(wbox)].push_back(&wbox);
+						continue;
+					}
+
 					// ӱ
 					writeDB(optype, pdbi, wbox);
 				}
+
+				KBEUnordered_map< std::string, std::vector<mysql::DBContext*> >::iterator batchiter = batchUpdates.begin();
+				for(; batchiter != batchUpdates.end(); ++batchiter)
+					batchUpdateChildDB(pdbi, batchiter->second);
 			}
 			
 			// ɾ
@@ -257,6 +321,8 @@ public:
 				bool ret = pdbi->query(sqlstr.c_str(), sqlstr.size(), false);
 				KBE_ASSERT(ret);
 
+				pdbi->onRowsWritten((uint32)tabiter->second.size());
+
 				mysql::DBContext::DB_RW_CONTEXTS::iterator iter1 = context.optable.begin();
 				for(; iter1 != context.optable.end(); ++iter1)
 				{
@@ -279,7 +345,6 @@ public:
 				}
 			}
 		}
-		return ret;
 	}
 
 protected:
@@ -115,6 +115,94 @@ bool DataType::initialize(XML* xml, TiXmlNode* node)
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+bool DataType::isChangeTrackable()
+{
+	switch (type())
+	{
+	case DATA_TYPE_DIGIT:
+	case DATA_TYPE_STRING:
+	case DATA_TYPE_UNICODE:
+	case DATA_TYPE_ENTITYCALL:
+		return true;
+	case DATA_TYPE_FIXEDARRAY:
+		return static_cast<FixedArrayType*>(this)->getDataType()->isChangeTrackable();
+	case DATA_TYPE_FIXEDDICT:
+		{
+			// implĹ̶ֵڽűûԶĶ
+			FixedDictType* pFixedDictType = static_cast<FixedDictType*>(this);
+			if (pFixedDictType->hasImpl())
+				return false;
+
+			FixedDictType::FIXEDDICT_KEYTYPE_MAP& keyTypes = pFixedDictType->getKeyTypes();
+			FixedDictType::FIXEDDICT_KEYTYPE_MAP::iterator iter = keyTypes.begin();
+			for (; iter != keyTypes.end(); ++iter)
+			{
+				if (!iter->second->dataType->isChangeTrackable())
+					return false;
+			}
+
+			return true;
+		}
+	default:
+		break;
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+DataOwner::ON_CHANGED_FUNC DataOwner::onChangedFunc_ = NULL;
+
+//-------------------------------------------------------------------------------------
+bool DataOwner::claim(PyObject* pyValue, ENTITY_ID entityID, ENTITY_PROPERTY_UID utype)
+{
+	DataOwner* pOwner = NULL;
+
+	if (PyObject_TypeCheck(pyValue, FixedArray::getScriptType()))
+		pOwner = &static_cast<FixedArray*>(pyValue)->owner();
+	else if (PyObject_TypeCheck(pyValue, FixedDict::getScriptType()))
+		pOwner = &static_cast<FixedDict*>(pyValue)->owner();
+	else
+		return true;
+
+	bool ret = true;
+
+	if (pOwner->entityID_ == 0)
+	{
+		pOwner->entityID_ = entityID;
+		pOwner->utype_ = utype;
+	}
+	else if (pOwner->entityID_ != entityID || pOwner->utype_ != utype)
+	{
+		ret = false;
+	}
+
+	if (PyObject_TypeCheck(pyValue, FixedArray::getScriptType()))
+	{
+		std::vector<PyObject*>& values = static_cast<FixedArray*>(pyValue)->getValues();
+		for (size_t i = 0; i < values.size(); ++i)
+		{
+			if (!claim(values[i], entityID, utype))
+				ret = false;
+		}
+	}
+	else
+	{
+		PyObject* key = NULL;
+		PyObject* value = NULL;
+		Py_ssize_t pos = 0;
+
+		while (PyDict_Next(static_cast<FixedDict*>(pyValue)->getDictObject(), &pos, &key, &value))
+		{
+			if (!claim(value, entityID, utype))
+				ret = false;
+		}
+	}
+
+	return ret;
+}
+
 //-------------------------------------------------------------------------------------
 UInt64Type::UInt64Type(DATATYPE_UID did):
 DataType(did)
@@ -37,6 +37,45 @@ namespace script {
 	}
 }
 
+/**
+	FIXED_DICTARRAYʵ
+	baseappϳ־ûԵ޸ʱͨص֪ͨʵҪд()
+*/
+class DataOwner
+{
+public:
+	typedef void(*ON_CHANGED_FUNC)(ENTITY_ID entityID, ENTITY_PROPERTY_UID utype);
+
+	DataOwner():
+	entityID_(0),
+	utype_(0)
+	{
+	}
+
+	void onDataChanged() const
+	{
+		if (entityID_ > 0 && onChangedFunc_)
+			onChangedFunc_(entityID_, utype_);
+	}
+
+	ENTITY_ID entityID() const { return entityID_; }
+	ENTITY_PROPERTY_UID utype() const { return utype_; }
+
+	/**
+		ԼǶ׵ĳʵ
+		Ѿʵʱfalse Щ޸ʱ֪ͨ
+	*/
+	static bool claim(PyObject* pyValue, ENTITY_ID entityID, ENTITY_PROPERTY_UID utype);
+
+	static void onChangedFunc(ON_CHANGED_FUNC func) { onChangedFunc_ = func; }
+
+private:
+	ENTITY_ID entityID_;
+	ENTITY_PROPERTY_UID utype_;
+
+	static ON_CHANGED_FUNC onChangedFunc_;
+};
+
 class DataType : public RefCountable
 {
 public:	
@@ -80,6 +119,13 @@ public:
 	INLINE const char* aliasName(void) const;
 
 	virtual DATATYPE type() const{ return DATA_TYPE_UNKONWN; }
+
+	/**
+		͵ݵ޸Ƿܱٵ(ֵFIXED_DICTARRAY޸)
+		VECTORBLOB(MemoryStream)PYTHON͵ĶԱűֱ޸ģ ޷
+	*/
+	bool isChangeTrackable();
+
 protected:
 	DATATYPE_UID id_;
 	std::string aliasName_;
@@ -215,6 +215,12 @@ PyObject* FixedArray::createNewItemFromObj(PyObject* pyItem)
 	return _dataType->createNewItemFromObj(pyItem);
 }
 
+//-------------------------------------------------------------------------------------
+void FixedArray::onDataChanged()
+{
+	owner_.onDataChanged();
+}
+
 //-------------------------------------------------------------------------------------
 PyObject* FixedArray::__py_append(PyObject* self, PyObject* args, PyObject* kwargs)
 {
@@ -364,6 +370,7 @@ PyObject* FixedArray::__py_clear(PyObject* self, PyObject* args, PyObject* kwarg
 	}
 
 	values.clear();
+	ary->onDataChanged();
 	S_Return;
 }
 
@@ -59,14 +59,24 @@ public:
 
 	virtual PyObject* createNewItemFromObj(PyObject* pyItem);
 
+	/** 
+		ݸı֪ͨ 
+	*/
+	virtual void onDataChanged();
+
 	/** 
 		ö 
 	*/
 	PyObject* tp_repr();
 	PyObject* tp_str();
 
+	DataOwner& owner() { return owner_; }
+
 protected:
 	FixedArrayType* _dataType;
+
+	// ʵ
+	DataOwner owner_;
 } ;
 
 }
@@ -36,6 +36,7 @@ SCRIPT_METHOD_DECLARE("has_key",					has_key,				METH_VARARGS,		0)
 SCRIPT_METHOD_DECLARE("keys",						keys,					METH_VARARGS,		0)
 SCRIPT_METHOD_DECLARE("values",						values,					METH_VARARGS,		0)
 SCRIPT_METHOD_DECLARE("items",						items,					METH_VARARGS,		0)
+SCRIPT_METHOD_DECLARE("update",						update,					METH_VARARGS,		0)
 SCRIPT_METHOD_DECLARE_END()
 
 
@@ -305,6 +306,9 @@ int FixedDict::mp_ass_subscript(PyObject* self, PyObject* key, PyObject* value)
 	// PyDict_SetItemҪ
 	Py_DECREF(val1);
 
+	if (ret == 0)
+		fixedDict->owner_.onDataChanged();
+
 	return ret;
 }
 
@@ -383,6 +387,33 @@ PyObject* FixedDict::update(PyObject* args)
 	S_Return; 
 }
 
+//-------------------------------------------------------------------------------------
+PyObject* FixedDict::__py_update(PyObject* self, PyObject* args)
+{
+	PyObject* pyVal = NULL;
+	if (!PyArg_ParseTuple(args, "O", &pyVal))
+		return NULL;
+
+	if (!PyDict_Check(pyVal))
+	{
+		PyErr_SetString(PyExc_TypeError, "FixedDict::update: arg not is dict!");
+		return NULL;
+	}
+
+	// keyͣ fixedDict[key] = valueһ
+	PyObject* key = NULL;
+	PyObject* value = NULL;
+	Py_ssize_t pos = 0;
+
+	while (PyDict_Next(pyVal, &pos, &key, &value))
+	{
+		if (mp_ass_subscript(self, key, value) != 0)
+			return NULL;
+	}
+
+	S_Return; 
+}
+
 //-------------------------------------------------------------------------------------
 PyObject* FixedDict::tp_str()
 {
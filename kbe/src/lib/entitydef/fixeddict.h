@@ -70,6 +70,7 @@ public:
 		ֵݵԼ 
 	*/
 	PyObject* update(PyObject* args);
+	static PyObject* __py_update(PyObject* self, PyObject* args);
 
 	/** 
 		ö 
@@ -79,8 +80,13 @@ public:
 
 	bool isSameType(PyObject* pyValue);
 
+	DataOwner& owner() { return owner_; }
+
 protected:
 	FixedDictType* _dataType;
+
+	// ʵ
+	DataOwner owner_;
 } ;
 
 }
@@ -180,20 +180,33 @@ public:
 	ScopedProfile(ProfileVal & profile, const char * filename, int lineNum) :
 		profile_(profile),
 		filename_(filename),
-		lineNum_(lineNum)
+		lineNum_(lineNum),
+		enabled_(threadEnabled())
 	{
-		profile_.start();
+		if (enabled_)
+			profile_.start();
 	}
 
 	~ScopedProfile()
 	{
-		profile_.stop(filename_, lineNum_);
+		if (enabled_)
+			profile_.stop(filename_, lineNum_);
+	}
+
+	/**
+		profileĵջ̰߳ȫģ ߳(߳)йرͳ
+	*/
+	static bool& threadEnabled()
+	{
+		static thread_local bool enabled = true;
+		return enabled;
 	}
 
 private:
 	ProfileVal& profile_;
 	const char* filename_;
 	int lineNum_;
+	bool enabled_;
 
 };
 
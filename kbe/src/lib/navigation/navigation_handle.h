@@ -41,6 +41,11 @@ public:
 
 	virtual NavigationHandle::NAV_TYPE type() const{ return NAV_UNKNOWN; }
 
+	/**
+		Ƿ߳ͬʱѯ ʱ첽ѯ˻صִ߳
+	*/
+	virtual bool isThreadSafe() const{ return false; }
+
 	virtual int findStraightPath(int layer, const Position3D& start, const Position3D& end, std::vector<Position3D>& paths) = 0;
 
 	virtual int findRandomPointAroundCircle(int layer, const Position3D& centerPos,
@@ -18,7 +18,8 @@ static float frand()
 //-------------------------------------------------------------------------------------
 NavMeshHandle::NavMeshHandle():
 NavigationHandle(),
-navmeshLayer()
+navmeshLayer(),
+queryMutex_()
 {
 }
 
@@ -28,8 +29,12 @@ NavMeshHandle::~NavMeshHandle()
 	std::map<int, NavmeshLayer>::iterator iter = navmeshLayer.begin();
 	for(; iter != navmeshLayer.end(); ++iter)
 	{
+		// pNavmeshQuery也在空闲列表中
+		std::vector<dtNavMeshQuery*>::iterator qiter = iter->second.freeQuerys.begin();
+		for(; qiter != iter->second.freeQuerys.end(); ++qiter)
+			dtFreeNavMeshQuery((*qiter));
+
 		dtFreeNavMesh(iter->second.pNavmesh);
-		dtFreeNavMeshQuery(iter->second.pNavmeshQuery);
 	}
 	
 	DEBUG_MSG(fmt::format("NavMeshHandle::~NavMeshHandle(): ({}) is destroyed!\n", resPath));
@@ -45,8 +50,10 @@ int NavMeshHandle::findStraightPath(int layer, const Position3D& start, const Po
 		return NAV_ERROR;
 	}
 
-	dtNavMeshQuery* navmeshQuery = iter->second.pNavmeshQuery;
-	// dtNavMesh* 
+	ScopedQuery query(*this, iter->second);
+	dtNavMeshQuery* navmeshQuery = query.get();
+	if(navmeshQuery == NULL)
+		return NAV_ERROR;
 
 	float spos[3];
 	spos[0] = start.x;
@@ -126,7 +133,10 @@ int NavMeshHandle::findRandomPointAroundCircle(int layer, const Position3D& cent
 		return NAV_ERROR;
 	}
 
-	dtNavMeshQuery* navmeshQuery = iter->second.pNavmeshQuery;
+	ScopedQuery query(*this, iter->second);
+	dtNavMeshQuery* navmeshQuery = query.get();
+	if(navmeshQuery == NULL)
+		return NAV_ERROR;
 
 	dtQueryFilter filter;
 	filter.setIncludeFlags(0xffff);
@@ -341,7 +351,10 @@ int NavMeshHandle::raycast(int layer, const Position3D& start, const Position3D&
 		return NAV_ERROR;
 	}
 
-	dtNavMeshQuery* navmeshQuery = iter->second.pNavmeshQuery;
+	ScopedQuery query(*this, iter->second);
+	dtNavMeshQuery* navmeshQuery = query.get();
+	if(navmeshQuery == NULL)
+		return NAV_ERROR;
 
 	float hitPoint[3];
 
@@ -403,6 +416,42 @@ int NavMeshHandle::raycast(int layer, const Position3D& start, const Position3D&
 	return 1;
 }
 
+//-------------------------------------------------------------------------------------
+dtNavMeshQuery* NavMeshHandle::acquireQuery(NavmeshLayer& layer)
+{
+	{
+		KBEngine::thread::ThreadGuard tg(&queryMutex_);
+
+		if(layer.freeQuerys.size() > 0)
+		{
+			dtNavMeshQuery* pNavmeshQuery = layer.freeQuerys.back();
+			layer.freeQuerys.pop_back();
+			return pNavmeshQuery;
+		}
+	}
+
+	// 所有的查询对象都被其他线程占用
+	dtNavMeshQuery* pNavmeshQuery = dtAllocNavMeshQuery();
+	if(pNavmeshQuery == NULL || dtStatusFailed(pNavmeshQuery->init(layer.pNavmesh, 1024)))
+	{
+		ERROR_MSG(fmt::format("NavMeshHandle::acquireQuery({}): init navmeshQuery error!\n", resPath));
+		dtFreeNavMeshQuery(pNavmeshQuery);
+		return NULL;
+	}
+
+	return pNavmeshQuery;
+}
+
+//-------------------------------------------------------------------------------------
+void NavMeshHandle::releaseQuery(NavmeshLayer& layer, dtNavMeshQuery* pNavmeshQuery)
+{
+	if(pNavmeshQuery == NULL)
+		return;
+
+	KBEngine::thread::ThreadGuard tg(&queryMutex_);
+	layer.freeQuerys.push_back(pNavmeshQuery);
+}
+
 //-------------------------------------------------------------------------------------
 NavigationHandle* NavMeshHandle::create(std::string resPath, const std::map< int, std::string >& params)
 {
@@ -632,12 +681,13 @@ bool NavMeshHandle::_create(int layer, const std::string& resPath, const std::st
 	fclose(fp);
 	SAFE_RELEASE_ARRAY(data);
 
-	dtNavMeshQuery* pMavmeshQuery = new dtNavMeshQuery();
+	dtNavMeshQuery* pMavmeshQuery = dtAllocNavMeshQuery();
 
 	pMavmeshQuery->init(mesh, 1024);
 	pNavMeshHandle->resPath = resPath;
 	pNavMeshHandle->navmeshLayer[layer].pNavmeshQuery = pMavmeshQuery;
 	pNavMeshHandle->navmeshLayer[layer].pNavmesh = mesh;
+	pNavMeshHandle->navmeshLayer[layer].freeQuerys.push_back(pMavmeshQuery);
 	
 	uint32 tileCount = 0;
 	uint32 nodeCount = 0;
@@ -4,6 +4,7 @@
 #define KBE_NAVIGATEMESHHANDLE_H
 
 #include "navigation/navigation_handle.h"
+#include "thread/threadmutex.h"
 
 #include "DetourNavMeshBuilder.h"
 #include "DetourNavMeshQuery.h"
@@ -46,6 +47,35 @@ namespace KBEngine {
 		{
 			dtNavMesh* pNavmesh;
 			dtNavMeshQuery* pNavmeshQuery;
+
+			// 空闲的查询对象， dtNavMesh只读共享， 每个正在查询的线程各占用一个dtNavMeshQuery
+			std::vector<dtNavMeshQuery*> freeQuerys;
+		};
+
+		/**
+			在查询期间占用layer的一个查询对象
+		*/
+		class ScopedQuery
+		{
+		public:
+			ScopedQuery(NavMeshHandle& navMeshHandle, NavmeshLayer& navmeshLayer):
+			navMeshHandle_(navMeshHandle),
+			navmeshLayer_(navmeshLayer),
+			pNavmeshQuery_(navMeshHandle.acquireQuery(navmeshLayer))
+			{
+			}
+
+			~ScopedQuery()
+			{
+				navMeshHandle_.releaseQuery(navmeshLayer_, pNavmeshQuery_);
+			}
+
+			dtNavMeshQuery* get() const { return pNavmeshQuery_; }
+
+		private:
+			NavMeshHandle& navMeshHandle_;
+			NavmeshLayer& navmeshLayer_;
+			dtNavMeshQuery* pNavmeshQuery_;
 		};
 
 	public:
@@ -61,6 +91,14 @@ namespace KBEngine {
 
 		virtual NavigationHandle::NAV_TYPE type() const { return NAV_MESH; }
 
+		virtual bool isThreadSafe() const { return true; }
+
+		/**
+			取出一个空闲的查询对象， 没有则创建一个新的
+		*/
+		dtNavMeshQuery* acquireQuery(NavmeshLayer& layer);
+		void releaseQuery(NavmeshLayer& layer, dtNavMeshQuery* pNavmeshQuery);
+
 		static NavigationHandle* create(std::string resPath, const std::map< int, std::string >& params);
 		static bool _create(int layer, const std::string& resPath, const std::string& res, NavMeshHandle* pNavMeshHandle);
 
@@ -82,6 +120,8 @@ namespace KBEngine {
 
 		/* Determines if two segment cross on xz-plane. */
 		bool isSegSegCross2D(const float* p1, const float *p2, const float* q1, const float* q2);
+
+		thread::ThreadMutex queryMutex_;
 };
 
 }
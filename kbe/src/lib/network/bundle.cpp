@@ -7,6 +7,7 @@
 #include "network/channel.h"
 #include "helper/profile.h"
 #include "network/packet_sender.h"
+#include "network/compression_filter.h"
 
 #ifndef CODE_INLINE
 #include "bundle.inl"
@@ -53,7 +54,7 @@ size_t Bundle::getPoolObjectBytes()
 	size_t bytes = sizeof(pCurrMsgHandler_) + sizeof(isTCPPacket_) + sizeof(pCurrPacket_) + sizeof(packetMaxSize_) +
 		sizeof(currMsgLengthPos_) + sizeof(currMsgHandlerLength_) + sizeof(currMsgLength_) + 
 		sizeof(currMsgPacketCount_) + sizeof(currMsgID_) + sizeof(numMessages_) + sizeof(pChannel_)
-		+ (packets_.size() * sizeof(Packet*));
+		+ (packets_.size() * sizeof(Packet*)) + (trackedMessages_.size() * sizeof(TrackedMessages::value_type));
 
 	return bytes;
 }
@@ -77,7 +78,8 @@ Bundle::Bundle(Channel * pChannel, ProtocolType pt):
 	packets_(),
 	isTCPPacket_(pt == PROTOCOL_TCP),
 	packetMaxSize_(0),
-	pCurrMsgHandler_(NULL)
+	pCurrMsgHandler_(NULL),
+	trackedMessages_()
 {
 	_calcPacketMaxSize();
 	 newPacket();
@@ -134,21 +136,154 @@ void Bundle::copy(const Bundle& bundle)
 	_calcPacketMaxSize();
 }
 
+//-------------------------------------------------------------------------------------
+void Bundle::seal()
+{
+	if(sealed())
+		return;
+
+	finiMessage(true);
+}
+
+//-------------------------------------------------------------------------------------
+void Bundle::share(const Bundle& bundle)
+{
+	KBE_ASSERT(bundle.sealed());
+
+	// ½bundleһհ
+	clear(true);
+
+	isTCPPacket_ = bundle.isTCPPacket_;
+	packets_.reserve(bundle.packets_.size());
+
+	Packets::const_iterator iter = bundle.packets_.begin();
+	for (; iter != bundle.packets_.end(); ++iter)
+	{
+		// İĳһbundle
+		(*iter)->addSharer();
+		(*iter)->pBundle(NULL);
+		packets_.push_back((*iter));
+	}
+
+	numMessages_ = bundle.numMessages_;
+	_calcPacketMaxSize();
+}
+
+//-------------------------------------------------------------------------------------
+void Bundle::appendShared(const Bundle& bundle)
+{
+	KBE_ASSERT(bundle.sealed());
+
+	// Ͳͬʱܹ ֻܿ
+	if(isTCPPacket_ != bundle.isTCPPacket_)
+	{
+		Packets::const_iterator iter = bundle.packets_.begin();
+		for (; iter != bundle.packets_.end(); ++iter)
+			append((*iter)->data() + (*iter)->rpos(), (int)(*iter)->length());
+
+		return;
+	}
+
+	if(pCurrPacket_)
+	{
+		packets_.push_back(pCurrPacket_);
+		currMsgPacketCount_++;
+		pCurrPacket_ = NULL;
+	}
+
+	Packets::const_iterator iter = bundle.packets_.begin();
+	for (; iter != bundle.packets_.end(); ++iter)
+	{
+		(*iter)->addSharer();
+		(*iter)->pBundle(NULL);
+		packets_.push_back((*iter));
+		currMsgPacketCount_++;
+		currMsgLength_ += (*iter)->length();
+	}
+
+	newPacket();
+}
+
+//-------------------------------------------------------------------------------------
+Packet* Bundle::unsharePacket(Packet*& pPacket)
+{
+	if(!pPacket->isShared())
+	{
+		pPacket->pBundle(this);
+		return pPacket;
+	}
+
+	Packet* pSharedPacket = pPacket;
+	MALLOC_PACKET(pPacket, isTCPPacket_);
+	pPacket->append(*static_cast<MemoryStream*>(pSharedPacket));
+	pPacket->messageID(pSharedPacket->messageID());
+	pPacket->pBundle(this);
+
+	RELEASE_PACKET(isTCPPacket_, pSharedPacket);
+	return pPacket;
+}
+
+//-------------------------------------------------------------------------------------
+void Bundle::broadcast(Bundle* pBundle, const std::vector<Channel*>& channels)
+{
+	if(channels.empty())
+	{
+		Bundle::reclaimPoolObject(pBundle);
+		return;
+	}
+
+	pBundle->seal();
+
+	size_t bytes = pBundle->packetsLength();
+
+	// pBundleͣ ڴ֮ǰʼճЩ ͨͬҲ
+	for(size_t i = 0; i < channels.size() - 1; ++i)
+	{
+		Bundle* pSharedBundle = Bundle::createPoolObject(OBJECTPOOL_POINT);
+		pSharedBundle->share(*pBundle);
+		channels[i]->send(pSharedBundle);
+
+		// ÿյͨͳһ
+		TrackedMessages::const_iterator iter = pBundle->trackedMessages_.begin();
+		for(; iter != pBundle->trackedMessages_.end(); ++iter)
+		{
+			NetworkStats::getSingleton().trackMessage(NetworkStats::SEND, *iter->first, iter->second);
+		}
+	}
+
+	channels.back()->send(pBundle);
+
+	NetworkStats::getSingleton().trackBroadcast((uint32)channels.size(), bytes);
+}
+
 //-------------------------------------------------------------------------------------
 void Bundle::_calcPacketMaxSize()
 {
 	// ʹopensslͨѶǱ֤һܱBlowfish::BLOCK_SIZE
 	// ڼһذʱҪֽ
+	// ѹڼ֮ǰÿϳ+ǣ Ҫȿ۳
+	int compressHeaderSize = g_channelExternalCompressThreshold > 0 ? CompressionFilter::HEADER_SIZE : 0;
+
 	if(g_channelExternalEncryptType == 1)
 	{
 		packetMaxSize_ = isTCPPacket_ ? (int)(TCPPacket::maxBufferSize() - ENCRYPTTION_WASTAGE_SIZE) :
 			(PACKET_MAX_SIZE_UDP - ENCRYPTTION_WASTAGE_SIZE);
 
+		packetMaxSize_ -= compressHeaderSize;
 		packetMaxSize_ -= packetMaxSize_ % KBEngine::KBEBlowfish::BLOCK_SIZE;
 	}
+	else if(g_channelExternalEncryptType > 1)
+	{
+		// AEADܲҪ䣬 ֻҪ֤ǩλ
+		packetMaxSize_ = isTCPPacket_ ? (int)(TCPPacket::maxBufferSize() - AEAD_ENCRYPTTION_WASTAGE_SIZE) :
+			(PACKET_MAX_SIZE_UDP - AEAD_ENCRYPTTION_WASTAGE_SIZE);
+
+		packetMaxSize_ -= compressHeaderSize;
+	}
 	else
 	{
 		packetMaxSize_ = isTCPPacket_ ? (int)TCPPacket::maxBufferSize() : PACKET_MAX_SIZE_UDP;
+		packetMaxSize_ -= compressHeaderSize;
 	}
 }
 
@@ -208,6 +343,9 @@ Packet* Bundle::newPacket()
 {
 	MALLOC_PACKET(pCurrPacket_, isTCPPacket_);
 	pCurrPacket_->pBundle(this);
+
+	// ԽϢ İҲ¼Ϣ(ѹͳ)
+	pCurrPacket_->messageID(currMsgID_);
 	return pCurrPacket_;
 }
 
@@ -225,15 +363,17 @@ void Bundle::clear(bool isRecl)
 	{
 		if(!isRecl)
 		{
-			delete (*iter);
+			if((*iter)->releaseShared())
+				delete (*iter);
 		}
 		else
 		{
-			RECLAIM_PACKET(isTCPPacket_, (*iter));
+			RELEASE_PACKET(isTCPPacket_, (*iter));
 		}
 	}
 	
 	packets_.clear();
+	trackedMessages_.clear();
 
 	pChannel_ = NULL;
 	numMessages_ = 0;
@@ -259,7 +399,7 @@ void Bundle::clearPackets()
 	Packets::iterator iter = packets_.begin();
 	for (; iter != packets_.end(); ++iter)
 	{
-		RECLAIM_PACKET(isTCPPacket_, (*iter));
+		RELEASE_PACKET(isTCPPacket_, (*iter));
 	}
 
 	packets_.clear();
@@ -329,6 +469,8 @@ void Bundle::finiMessage(bool isSend)
 		{
 			NetworkStats::getSingleton().trackMessage(NetworkStats::SEND, 
 									*pCurrMsgHandler_, currMsgLength_);
+
+			trackedMessages_.push_back(std::make_pair(pCurrMsgHandler_, currMsgLength_));
 		}
 	}
 
@@ -80,6 +80,12 @@ public:
 	virtual size_t getPoolObjectBytes();
 
 	typedef std::vector<Packet*> Packets;
+
+	// ѾͳƹϢ䳤
+	typedef std::vector< std::pair<const MessageHandler*, MessageLength1> > TrackedMessages;
+
+	// ϢССʱȹ
+	static const int32 SHARED_PAYLOAD_MIN_SIZE = 256;
 	
 	Bundle(Channel * pChannel = NULL, ProtocolType pt = PROTOCOL_TCP);
 	Bundle(const Bundle& bundle);
@@ -106,6 +112,35 @@ public:
 	
 	void copy(const Bundle& bundle);
 
+	/**
+		һϢѵǰб ֮д
+		ʱԶװ Ѿװbundleظ
+	*/
+	void seal();
+	INLINE bool sealed() const;
+
+	/**
+		ݣ һѷװbundleа() ڰͬһݷͨ
+	*/
+	void share(const Bundle& bundle);
+
+	/**
+		һѷװbundleİΪǰϢһý(ͬʱ)
+		֮дݷŵµİУ ÿͨϢͷͬϢͬ
+	*/
+	void appendShared(const Bundle& bundle);
+
+	/**
+		һİbundle˽еĿ Ҫ޸İ(¼ͽ)ʱ
+	*/
+	Packet* unsharePacket(Packet*& pPacket);
+
+	/**
+		ͬһbundle͸ͨ Ϣֻһ
+		ͨɵİ һ߻գ úpBundleʹ
+	*/
+	static void broadcast(Bundle* pBundle, const std::vector<Channel*>& channels);
+
 	INLINE int32 packetMaxSize() const;
 	int packetsSize() const;
 
@@ -635,6 +670,9 @@ private:
 	int32 packetMaxSize_;
 
 	const Network::MessageHandler* pCurrMsgHandler_;
+
+	// 㲥ʱսյͨͳ
+	TrackedMessages trackedMessages_;
 };
 
 }
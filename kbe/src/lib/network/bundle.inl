@@ -10,6 +10,11 @@ INLINE bool Bundle::empty() const
 	return packetsSize() == 0;
 }
 
+INLINE bool Bundle::sealed() const
+{
+	return pCurrPacket_ == NULL && !packets_.empty();
+}
+
 INLINE int Bundle::packetsSize() const
 {
 	size_t i = packets_.size();
@@ -79,7 +84,7 @@ INLINE int32 Bundle::lastPacketSpace()
 	if (packets_.size() > 0)
 	{
 		Packet* pPacket = packets_.back();
-		if (!pPacket->isEnabledPoolObject())
+		if (!pPacket->isEnabledPoolObject() || pPacket->isShared())
 			return 0;
 
 		return packetMaxSize() - (int32)pPacket->wpos();
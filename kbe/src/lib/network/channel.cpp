@@ -18,6 +18,8 @@
 #include "network/kcp_packet_sender.h"
 #include "network/kcp_packet_receiver.h"
 #include "network/kcp_packet_reader.h"
+#include "network/kcp_update_scheduler.h"
+#include "network/io_thread_pool.h"
 #include "network/tcp_packet.h"
 #include "network/udp_packet.h"
 #include "network/message_handler.h"
@@ -66,7 +68,7 @@ size_t Channel::getPoolObjectBytes()
 		+ sizeof(flags_) + sizeof(numPacketsSent_) + sizeof(numPacketsReceived_) + sizeof(numBytesSent_) + sizeof(numBytesReceived_)
 		+ sizeof(lastTickBytesReceived_) + sizeof(lastTickBytesSent_) + sizeof(pFilter_) + sizeof(pEndPoint_) + sizeof(pPacketReceiver_) + sizeof(pPacketSender_)
 		+ sizeof(proxyID_) + strextra_.size() + sizeof(channelType_)
-		+ sizeof(componentID_) + sizeof(pMsgHandlers_) + condemnReason_.size() + sizeof(kcpUpdateTimerHandle_) + sizeof(pKCP_) + sizeof(hasSetNextKcpUpdate_);
+		+ sizeof(componentID_) + sizeof(pMsgHandlers_) + condemnReason_.size() + sizeof(pKCP_) + sizeof(kcpUpdateBucket_) + sizeof(kcpUpdateIndex_) + sizeof(kcpUpdateTime_) + sizeof(queuedBytes_);
 
 	return bytes;
 }
@@ -121,9 +123,11 @@ Channel::Channel(NetworkInterface & networkInterface,
 	pMsgHandlers_(NULL),
 	flags_(0),
 	pKCP_(NULL),
-	kcpUpdateTimerHandle_(),
-	hasSetNextKcpUpdate_(false),
-	condemnReason_()
+	kcpUpdateBucket_(KCPUpdateScheduler::BUCKET_NONE),
+	kcpUpdateIndex_(0),
+	kcpUpdateTime_(0),
+	condemnReason_(),
+	queuedBytes_(0)
 {
 	this->clearBundle();
 	initialize(networkInterface, pEndPoint, traits, pt, spt, pFilter, id);
@@ -160,9 +164,11 @@ Channel::Channel():
 	pMsgHandlers_(NULL),
 	flags_(0),
 	pKCP_(NULL),
-	kcpUpdateTimerHandle_(),
-	hasSetNextKcpUpdate_(false),
-	condemnReason_()
+	kcpUpdateBucket_(KCPUpdateScheduler::BUCKET_NONE),
+	kcpUpdateIndex_(0),
+	kcpUpdateTime_(0),
+	condemnReason_(),
+	queuedBytes_(0)
 {
 	this->clearBundle();
 }
@@ -212,7 +218,12 @@ bool Channel::initialize(NetworkInterface & networkInterface,
 		KBE_ASSERT(pPacketReceiver_->type() == PacketReceiver::TCP_PACKET_RECEIVER);
 
 		// UDPҪע
-		pNetworkInterface_->dispatcher().registerReadFileDescriptor(*pEndPoint_, pPacketReceiver_);
+		// ߳ʱⲿͨȡ
+		if (!this->isExternal() || !pNetworkInterface_->pIOThreadPool() || 
+			!pNetworkInterface_->pIOThreadPool()->registerChannel(this))
+		{
+			pNetworkInterface_->dispatcher().registerReadFileDescriptor(*pEndPoint_, pPacketReceiver_);
+		}
 
 		// Ҫʱע
 		// pPacketSender_ = new TCPPacketSender(*pEndPoint_, *pNetworkInterface_);
@@ -381,7 +392,6 @@ bool Channel::init_kcp()
 		IKCP_LOG_IN_PROBE | IKCP_LOG_IN_WINS | IKCP_LOG_OUT_DATA | IKCP_LOG_OUT_ACK | IKCP_LOG_OUT_PROBE | IKCP_LOG_OUT_WINS);
 	*/
 
-	hasSetNextKcpUpdate_ = false;
 	addKcpUpdate();
 	return true;
 }
@@ -395,10 +405,8 @@ bool Channel::fina_kcp()
 	ikcp_release(pKCP_);
 	pKCP_ = NULL;
 
-	if (kcpUpdateTimerHandle_.isSet())
-		kcpUpdateTimerHandle_.cancel();
-
-	hasSetNextKcpUpdate_ = false;
+	if (pNetworkInterface_)
+		this->dispatcher().kcpUpdateScheduler().deregister(this);
 	return true;
 }
 
@@ -425,25 +433,9 @@ void Channel::addKcpUpdate(int64 microseconds)
 {
 	//AUTO_SCOPED_PROFILE("addKcpUpdate");
 
-	if (microseconds <= 1)
-	{
-		// sendȲ¶Ӻȡtimer
-		if (!hasSetNextKcpUpdate_)
-			hasSetNextKcpUpdate_ = true;
-		else
-			return;
-	}
-	else
-	{
-		hasSetNextKcpUpdate_ = false;
-	}
-
-	if (kcpUpdateTimerHandle_.isSet())
-	{
-		kcpUpdateTimerHandle_.cancel();
-	}
-
-	kcpUpdateTimerHandle_ = this->dispatcher().addTimer(microseconds, this, (void *)KCP_UPDATE);
+	// kcpͨɵͳһ£ Ѿ˸ĸʱԱ
+	// sendȲƵҲĿ
+	this->dispatcher().kcpUpdateScheduler().schedule(this, kbe_clock() + (uint32)(microseconds / 1000));
 }
 
 //-------------------------------------------------------------------------------------
@@ -460,11 +452,6 @@ void Channel::kcpUpdate()
 	{
 		addKcpUpdate(nextUpdateKcpTime * 1000);
 	}
-	else
-	{
-		kcpUpdateTimerHandle_.cancel();
-		hasSetNextKcpUpdate_ = false;
-	}
 }
 
 //-------------------------------------------------------------------------------------
@@ -541,6 +528,10 @@ void Channel::destroy()
 //-------------------------------------------------------------------------------------
 void Channel::clearState( bool warnOnDiscard /*=false*/ )
 {
+	// ȴϲ͵kcp˱ͨfd ͳرfd֮ǰ
+	if (protocoltype_ == PROTOCOL_UDP)
+		KCPPacketSender::flushOutputs();
+
 	clearBundle();
 
 	lastReceivedTime_ = timestamp();
@@ -564,7 +555,13 @@ void Channel::clearState( bool warnOnDiscard /*=false*/ )
 		if(pNetworkInterface_)
 		{
 			if(!this->isDestroyed())
-				pNetworkInterface_->dispatcher().deregisterReadFileDescriptor(*pEndPoint_);
+			{
+				if (!pNetworkInterface_->pIOThreadPool() || 
+					!pNetworkInterface_->pIOThreadPool()->deregisterChannel(this))
+				{
+					pNetworkInterface_->dispatcher().deregisterReadFileDescriptor(*pEndPoint_);
+				}
+			}
 		}
 	}
 
@@ -580,6 +577,9 @@ void Channel::clearState( bool warnOnDiscard /*=false*/ )
 		KBE_ASSERT(false);
 	}
 
+	if (sendBackpressure())
+		NetworkStats::getSingleton().trackSendBackpressure(false);
+
 	flags_ = 0;
 	pFilter_ = NULL;
 
@@ -625,10 +625,21 @@ void Channel::delayedSend()
 	this->networkInterface().delayedSend(*this);
 }
 
+//-------------------------------------------------------------------------------------
+void Channel::pFilter(PacketFilterPtr pFilter)
+{
+	// ߳ʹʱ ȵȴ䲻ʹþɵĹ
+	if (pNetworkInterface_ && pNetworkInterface_->pIOThreadPool())
+		pNetworkInterface_->pIOThreadPool()->onFilterChanged(this, pFilter.get());
+
+	pFilter_ = pFilter;
+}
+
 //-------------------------------------------------------------------------------------
 const char * Channel::c_str() const
 {
-	static char dodgyString[MAX_BUF * 2] = { "None" };
+	// ߳ҲͨϢ
+	static thread_local char dodgyString[MAX_BUF * 2] = { "None" };
 	char tdodgyString[MAX_BUF] = { 0 };
 
 	if (pEndPoint_ && !pEndPoint_->addr().isNone())
@@ -650,6 +661,24 @@ void Channel::clearBundle()
 	}
 
 	bundles_.clear();
+	queuedBytes_ = 0;
+}
+
+//-------------------------------------------------------------------------------------
+void Channel::pushBundle(Bundle* pBundle)
+{
+	bundles_.push_back(pBundle);
+	queuedBytes_ += pBundle->packetsLength();
+}
+
+//-------------------------------------------------------------------------------------
+void Channel::onQueuedPacketSent(uint32 bytes)
+{
+	// ܸı˰ĳȣ ܼɸ ʱ
+	if (bytes >= queuedBytes_ || bundles_.empty())
+		queuedBytes_ = 0;
+	else
+		queuedBytes_ -= bytes;
 }
 
 //-------------------------------------------------------------------------------------
@@ -666,11 +695,6 @@ void Channel::handleTimeout(TimerHandle, void * arg)
 
 			break;
 		}
-		case KCP_UPDATE:
-		{
-			kcpUpdate();
-			break;
-		}
 		default:
 			break;
 	}
@@ -710,8 +734,9 @@ void Channel::sendto(bool reliable, Bundle* pBundle)
 	if (pBundle)
 	{
 		pBundle->pChannel(this);
-		pBundle->finiMessage(true);
+		pBundle->seal();
 		bundles_.push_back(pBundle);
+		queuedBytes_ += pBundle->packetsLength();
 	}
 
 	uint32 bundleSize = (uint32)bundles_.size();
@@ -777,8 +802,9 @@ void Channel::send(Bundle* pBundle)
 	if (pBundle)
 	{
 		pBundle->pChannel(this);
-		pBundle->finiMessage(true);
+		pBundle->seal();
 		bundles_.push_back(pBundle);
+		queuedBytes_ += pBundle->packetsLength();
 	}
 
 	uint32 bundleSize = (uint32)bundles_.size();
@@ -820,6 +846,8 @@ void Channel::send(Bundle* pBundle)
 //-------------------------------------------------------------------------------------
 void Channel::sendCheck(uint32 bundleSize)
 {
+	checkSendWaterMarks();
+
 	if(this->isExternal())
 	{
 		if (Network::g_sendWindowMessagesOverflowCritical > 0 && bundleSize > Network::g_sendWindowMessagesOverflowCritical)
@@ -839,7 +867,7 @@ void Channel::sendCheck(uint32 bundleSize)
 
 		if (g_extSendWindowBytesOverflow > 0)
 		{
-			uint32 bundleBytes = bundlesLength();
+			uint32 bundleBytes = queuedBytes_;
 			if(bundleBytes >= g_extSendWindowBytesOverflow)
 			{
 				ERROR_MSG(fmt::format("Channel::sendCheck[{:p}]: external channel({}), bufferedBytes has overflowed({} > {}), Try adjusting the kbengine[_defs].xml->windowOverflow->send->bytes.\n",
@@ -870,7 +898,7 @@ void Channel::sendCheck(uint32 bundleSize)
 
 		if (g_intSendWindowBytesOverflow > 0)
 		{
-			uint32 bundleBytes = bundlesLength();
+			uint32 bundleBytes = queuedBytes_;
 			if (bundleBytes >= g_intSendWindowBytesOverflow)
 			{
 				WARNING_MSG(fmt::format("Channel::sendCheck[{:p}]: internal channel({}), bufferedBytes has overflowed({} > {}).\n",
@@ -880,6 +908,48 @@ void Channel::sendCheck(uint32 bundleSize)
 	}
 }
 
+//-------------------------------------------------------------------------------------
+void Channel::checkSendWaterMarks()
+{
+	uint32 highWater = this->isExternal() ? g_extSendWindowBytesHighWater : g_intSendWindowBytesHighWater;
+	if (highWater == 0)
+		return;
+
+	uint32 lowWater = this->isExternal() ? g_extSendWindowBytesLowWater : g_intSendWindowBytesLowWater;
+	if (lowWater >= highWater)
+		lowWater = highWater / 2;
+
+	if (bundles_.empty())
+		queuedBytes_ = 0;
+
+	uint32 bundleBytes = queuedBytes_;
+	NetworkStats::getSingleton().trackSendQueueBytes(bundleBytes);
+
+	if (!sendBackpressure())
+	{
+		if (bundleBytes < highWater || condemn() > 0 || isDestroyed())
+			return;
+
+		flags_ |= FLAG_SEND_BACKPRESSURE;
+
+		WARNING_MSG(fmt::format("Channel::checkSendWaterMarks[{:p}]: {} channel({}), bufferedBytes has reached the high-water mark({} >= {}).\n",
+			(void*)this, (this->isExternal() ? "external" : "internal"), this->c_str(), bundleBytes, highWater));
+	}
+	else
+	{
+		if (bundleBytes > lowWater)
+			return;
+
+		flags_ &= ~FLAG_SEND_BACKPRESSURE;
+
+		DEBUG_MSG(fmt::format("Channel::checkSendWaterMarks[{:p}]: {} channel({}), bufferedBytes has dropped below the low-water mark({} <= {}).\n",
+			(void*)this, (this->isExternal() ? "external" : "internal"), this->c_str(), bundleBytes, lowWater));
+	}
+
+	NetworkStats::getSingleton().trackSendBackpressure(sendBackpressure());
+	pNetworkInterface_->onChannelBackpressure(this, sendBackpressure());
+}
+
 //-------------------------------------------------------------------------------------
 void Channel::stopSend()
 {
@@ -907,6 +977,9 @@ void Channel::onSendCompleted()
 {
 	KBE_ASSERT(bundles_.size() == 0 && sending());
 	stopSend();
+
+	if (sendBackpressure())
+		checkSendWaterMarks();
 }
 
 //-------------------------------------------------------------------------------------
@@ -985,6 +1058,19 @@ void Channel::onPacketReceived(int bytes)
 
 //-------------------------------------------------------------------------------------
 void Channel::addReceiveWindow(Packet* pPacket)
+{
+	trackReceiveWindow();
+
+	KBE_ASSERT(KBEngine::Network::MessageHandlers::pMainMessageHandlers);
+
+	{
+		AUTO_SCOPED_PROFILE("processRecvMessages");
+		processPackets(KBEngine::Network::MessageHandlers::pMainMessageHandlers, pPacket);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void Channel::trackReceiveWindow()
 {
 	++lastTickBufferedReceives_; 
 
@@ -1016,18 +1102,15 @@ void Channel::addReceiveWindow(Packet* pPacket)
 			}
 		}
 	}
-
-	KBE_ASSERT(KBEngine::Network::MessageHandlers::pMainMessageHandlers);
-
-	{
-		AUTO_SCOPED_PROFILE("processRecvMessages");
-		processPackets(KBEngine::Network::MessageHandlers::pMainMessageHandlers, pPacket);
-	}
 }
 
 //-------------------------------------------------------------------------------------
 void Channel::condemn(const std::string& reason, bool waitSendCompletedDestroy)
 {
+	// ߳в޸ͨ ߳
+	if (IOThreadPool::deferCondemn(this, reason, waitSendCompletedDestroy))
+		return;
+
 	if (condemnReason_.size() == 0)
 		condemnReason_ = reason;
 
@@ -1048,6 +1131,13 @@ bool Channel::handshake(Packet* pPacket)
 			int sslVersion = KB_SSL::isSSLProtocal(pPacket);
 			if (sslVersion != -1)
 			{
+				// sslĶдͬһ̣߳ ˻ص߳̽
+				if (pNetworkInterface_->pIOThreadPool() && 
+					pNetworkInterface_->pIOThreadPool()->deregisterChannel(this))
+				{
+					pNetworkInterface_->dispatcher().registerReadFileDescriptor(*pEndPoint_, pPacketReceiver_);
+				}
+
 				// ۳ɹʧܶtrueⲿݰȴ
 				pEndPoint_->setupSSL(sslVersion, pPacket);
 
@@ -1224,6 +1314,7 @@ Bundle* Channel::createSendBundle()
 		{
 			// ȴӶɾ
 			bundles_.pop_back();
+			onQueuedPacketSent(pBundle->packetsLength());
 			pBundle->pChannel(this);
 			pBundle->pCurrMsgHandler(NULL);
 			pBundle->currMsgPacketCount(0);
@@ -31,6 +31,8 @@ class PacketSender;
 
 class Channel : public TimerHandler, public PoolObject
 {
+	friend class KCPUpdateScheduler;
+
 public:
 	typedef KBEShared_ptr< SmartPoolObject< Channel > > SmartPoolObjectPtr;
 	static SmartPoolObjectPtr createSmartPoolObj(const std::string& logPoint);
@@ -68,6 +70,7 @@ public:
 		FLAG_CONDEMN_AND_WAIT_DESTROY	= 0x00000008,	// ƵѾòϷݷϺر
 		FLAG_CONDEMN_AND_DESTROY		= 0x00000010,	// ƵѾòϷر
 		FLAG_CONDEMN					= FLAG_CONDEMN_AND_WAIT_DESTROY | FLAG_CONDEMN_AND_DESTROY,
+		FLAG_SEND_BACKPRESSURE			= 0x00000020,	// ݳ˸ˮλ δ䵽ˮλ
 	};
 
 public:
@@ -95,7 +98,7 @@ public:
 	void stopInactivityDetection();
 
 	PacketFilterPtr pFilter() const { return pFilter_; }
-	void pFilter(PacketFilterPtr pFilter) { pFilter_ = pFilter; }
+	void pFilter(PacketFilterPtr pFilter);
 
 	void destroy();
 	bool isDestroyed() const { return (flags_ & FLAG_DESTROYED) > 0; }
@@ -121,7 +124,7 @@ public:
 
 	int32 bundlesLength();
 
-	INLINE void pushBundle(Bundle* pBundle);
+	void pushBundle(Bundle* pBundle);
 	
 	bool sending() const;
 	void stopSend();
@@ -130,6 +133,18 @@ public:
 	void sendto(bool reliable = true, Bundle* pBundle = NULL);
 	void sendCheck(uint32 bundleSize);
 
+	/**
+		ݵĸߵˮλ ״̬ıʱ֪ͨNetworkInterface::onChannelBackpressure
+	*/
+	void checkSendWaterMarks();
+	bool sendBackpressure() const { return (flags_ & FLAG_SEND_BACKPRESSURE) > 0; }
+
+	/**
+		Ͷеֽ(bundlesLengthͬҪ) ʱۼӣ ɷȥ
+	*/
+	uint32 queuedBytes() const { return queuedBytes_; }
+	void onQueuedPacketSent(uint32 bytes);
+
 	void delayedSend();
 	bool waitSend();
 
@@ -164,6 +179,7 @@ public:
 	void updateLastReceivedTime() { lastReceivedTime_ = timestamp(); }
 
 	void addReceiveWindow(Packet* pPacket);
+	void trackReceiveWindow();
 
 	uint64 inactivityExceptionPeriod() const { return inactivityExceptionPeriod_; }
 
@@ -246,8 +262,7 @@ private:
 
 	enum TimeOutType
 	{
-		TIMEOUT_INACTIVITY_CHECK = 0,
-		KCP_UPDATE = 1
+		TIMEOUT_INACTIVITY_CHECK = 0
 	};
 
 	virtual void handleTimeout(TimerHandle, void * pUser);
@@ -306,10 +321,15 @@ private:
 	uint32						flags_;
 
 	ikcpcb*						pKCP_;
-	TimerHandle					kcpUpdateTimerHandle_;
-	bool						hasSetNextKcpUpdate_;
+
+	// KCPUpdateSchedulerеλԤĸʱ
+	int32						kcpUpdateBucket_;
+	uint32						kcpUpdateIndex_;
+	uint32						kcpUpdateTime_;
 
 	std::string					condemnReason_;
+
+	uint32						queuedBytes_;
 };
 
 }
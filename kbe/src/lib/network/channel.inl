@@ -40,10 +40,5 @@ INLINE void Channel::pPacketSender(PacketSender* pPacketSender)
 	pPacketSender_ = pPacketSender;
 }
 
-INLINE void Channel::pushBundle(Bundle* pBundle)
-{
-	bundles_.push_back(pBundle);
-}
-
 }
 }
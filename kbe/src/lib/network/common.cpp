@@ -12,6 +12,7 @@
 #include "network/tcp_packet_receiver.h"
 #include "network/udp_packet_receiver.h"
 #include "network/address.h"
+#include "network/network_stats.h"
 #include "helper/watcher.h"
 
 namespace KBEngine { 
@@ -23,6 +24,8 @@ float g_channelExternalTimeout = 60.f;
 
 int8 g_channelExternalEncryptType = 0;
 
+uint32 g_channelExternalCompressThreshold = 0;
+
 uint32 g_SOMAXCONN = 5;
 
 // UDP
@@ -37,6 +40,21 @@ uint32						g_rudp_mtu = 0;
 bool						g_rudp_congestionControl = false;
 bool						g_rudp_nodelay = true;
 
+// ϲͣ TCPʹwritevUDPʹsendmmsg
+bool						g_vectoredSend = true;
+
+// գ UDPʹrecvmmsg
+bool						g_batchedRecv = true;
+
+// ¼poller io_uringʱʹepoll
+std::string					g_eventPoller = "epoll";
+
+// ⲿͨ߳ 0Ϊ߳н
+uint32						g_extIOThreads = 0;
+
+// ⲿTCPsocket(SO_REUSEPORT) 0Ϊÿ߳һ
+uint32						g_extTcpListeners = 1;
+
 const char*					UDP_HELLO = "62a559f3fa7748bc22f8e0766019d498";
 const char*					UDP_HELLO_ACK = "1432ad7c829170a76dd31982c3501eca";
 
@@ -60,6 +78,12 @@ uint32						g_extSendWindowBytesOverflow = 65535;
 uint32						g_intSentWindowBytesOverflow = 0;
 uint32						g_extSentWindowBytesOverflow = 0;
 
+// ֽˮλʱ֪ͨϲ㽵ͷƵʣ 䵽ˮλʱָ 0Ϊ
+uint32						g_intSendWindowBytesHighWater = 0;
+uint32						g_extSendWindowBytesHighWater = 0;
+uint32						g_intSendWindowBytesLowWater = 0;
+uint32						g_extSendWindowBytesLowWater = 0;
+
 // ͨͳʱ
 uint32						g_intReSendInterval = 10;
 uint32						g_intReSendRetries = 0;
@@ -76,6 +100,34 @@ bool initializeWatcher()
 	WATCH_OBJECT("network/numPacketsReceived", g_numPacketsReceived);
 	WATCH_OBJECT("network/numBytesSent", g_numBytesSent);
 	WATCH_OBJECT("network/numBytesReceived", g_numBytesReceived);
+	WATCH_OBJECT("network/numSendSyscalls", &NetworkStats::getSingleton(), &NetworkStats::numSendSyscalls);
+	WATCH_OBJECT("network/numSendSyscallsSaved", &NetworkStats::getSingleton(), &NetworkStats::numSendSyscallsSaved);
+	WATCH_OBJECT("network/numSendSyscallErrors", &NetworkStats::getSingleton(), &NetworkStats::numSendSyscallErrors);
+	WATCH_OBJECT("network/numSendPacketsDropped", &NetworkStats::getSingleton(), &NetworkStats::numSendPacketsDropped);
+	WATCH_OBJECT("network/numRecvSyscalls", &NetworkStats::getSingleton(), &NetworkStats::numRecvSyscalls);
+	WATCH_OBJECT("network/numRecvSyscallsSaved", &NetworkStats::getSingleton(), &NetworkStats::numRecvSyscallsSaved);
+	WATCH_OBJECT("network/numKcpUpdates", &NetworkStats::getSingleton(), &NetworkStats::numKcpUpdates);
+	WATCH_OBJECT("network/numKcpUpdateBatches", &NetworkStats::getSingleton(), &NetworkStats::numKcpUpdateBatches);
+	WATCH_OBJECT("network/kcpUpdateSlippage", &NetworkStats::getSingleton(), &NetworkStats::kcpUpdateSlippage);
+	WATCH_OBJECT("network/kcpUpdateMaxSlippage", &NetworkStats::getSingleton(), &NetworkStats::kcpUpdateMaxSlippage);
+	WATCH_OBJECT("network/numIOThreadPackets", &NetworkStats::getSingleton(), &NetworkStats::numIOThreadPackets);
+	WATCH_OBJECT("network/numIOThreadWakeups", &NetworkStats::getSingleton(), &NetworkStats::numIOThreadWakeups);
+	WATCH_OBJECT("network/numAccepted", &NetworkStats::getSingleton(), &NetworkStats::numAccepted);
+	WATCH_OBJECT("network/maxAcceptBatch", &NetworkStats::getSingleton(), &NetworkStats::maxAcceptBatch);
+	WATCH_OBJECT("network/listenOverflows", &NetworkStats::getSingleton(), &NetworkStats::listenOverflows);
+	WATCH_OBJECT("network/listenDrops", &NetworkStats::getSingleton(), &NetworkStats::listenDrops);
+	WATCH_OBJECT("network/numCompressBytes", &NetworkStats::getSingleton(), &NetworkStats::numCompressBytes);
+	WATCH_OBJECT("network/numCompressedBytes", &NetworkStats::getSingleton(), &NetworkStats::numCompressedBytes);
+	WATCH_OBJECT("network/numFragmentBytesCopied", &NetworkStats::getSingleton(), &NetworkStats::numFragmentBytesCopied);
+	WATCH_OBJECT("network/numFragmentMessages", &NetworkStats::getSingleton(), &NetworkStats::numFragmentMessages);
+	WATCH_OBJECT("network/numBroadcasts", &NetworkStats::getSingleton(), &NetworkStats::numBroadcasts);
+	WATCH_OBJECT("network/numBroadcastChannels", &NetworkStats::getSingleton(), &NetworkStats::numBroadcastChannels);
+	WATCH_OBJECT("network/numBroadcastBytes", &NetworkStats::getSingleton(), &NetworkStats::numBroadcastBytes);
+	WATCH_OBJECT("network/numWebSocketPayloadBytes", &NetworkStats::getSingleton(), &NetworkStats::numWebSocketPayloadBytes);
+	WATCH_OBJECT("network/numWebSocketCopiedBytes", &NetworkStats::getSingleton(), &NetworkStats::numWebSocketCopiedBytes);
+	WATCH_OBJECT("network/numSendBackpressures", &NetworkStats::getSingleton(), &NetworkStats::numSendBackpressures);
+	WATCH_OBJECT("network/numBackpressuredChannels", &NetworkStats::getSingleton(), &NetworkStats::numBackpressuredChannels);
+	WATCH_OBJECT("network/maxSendQueueBytes", &NetworkStats::getSingleton(), &NetworkStats::maxSendQueueBytes);
 	
 	std::vector<MessageHandlers*>::iterator iter = MessageHandlers::messageHandlers().begin();
 	for(; iter != MessageHandlers::messageHandlers().end(); ++iter)
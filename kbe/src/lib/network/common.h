@@ -37,6 +37,9 @@ extern uint32 g_extReSendRetries;
 // ⲿͨ
 extern int8 g_channelExternalEncryptType;
 
+// ⲿͨѹİСֵ 0Ϊѹ
+extern uint32 g_channelExternalCompressThreshold;
+
 // listenֵ
 extern uint32 g_SOMAXCONN;
 
@@ -56,6 +59,21 @@ extern uint32 g_rudp_missAcksResend;
 extern bool g_rudp_congestionControl;
 extern bool g_rudp_nodelay;
 
+// ϲ(writev/sendmmsg)
+extern bool g_vectoredSend;
+
+// UDPݱ(recvmmsg)
+extern bool g_batchedRecv;
+
+// ¼poller, epollio_uring(Linux)
+extern std::string g_eventPoller;
+
+// ⲿͨ߳(Linux) 0Ϊ߳н
+extern uint32 g_extIOThreads;
+
+// ⲿTCPsocket(SO_REUSEPORT Linux) 0Ϊÿ߳һ
+extern uint32 g_extTcpListeners;
+
 // Certificate file required for HTTPS/WSS/SSL communication
 extern std::string g_sslCertificate;
 extern std::string g_sslPrivateKey;
@@ -76,12 +94,18 @@ namespace tcp{
 // ܶ洢Ϣռֽ(+)
 #define ENCRYPTTION_WASTAGE_SIZE			(1 + 7)
 
+// AEADܶ洢Ϣռֽ(+֤ǩ)
+#define AEAD_ENCRYPTTION_WASTAGE_SIZE		(2 + 16)
+
 #define PACKET_MAX_SIZE						1500
 #ifndef PACKET_MAX_SIZE_TCP
 #define PACKET_MAX_SIZE_TCP					1460
 #endif
 #define PACKET_MAX_SIZE_UDP					1472
 
+// ʱһϵͳȡݱ
+#define UDP_RECV_BATCH_SIZE					32
+
 typedef uint16								PacketLength;				// 65535
 #define PACKET_LENGTH_SIZE					sizeof(PacketLength)
 
@@ -326,6 +350,14 @@ const char * reasonToString(Reason reason)
 }																											\
 
 
+// ܱbundleİ һ߲Ż
+#define RELEASE_PACKET(isTCPPacket, pPacket)																\
+{																											\
+	if((pPacket)->releaseShared())																			\
+		RECLAIM_PACKET(isTCPPacket, pPacket);																\
+}																											\
+
+
 // Ϸѡtrace_packetʹãһϢ
 #define TRACE_MESSAGE_PACKET(isrecv, pPacket, pCurrMsgHandler, length, addr, readPacketHead)				\
 	if(Network::g_trace_packet > 0)																			\
@@ -420,6 +452,12 @@ extern uint32						g_extSendWindowBytesOverflow;
 extern uint32						g_intSentWindowBytesOverflow;
 extern uint32						g_extSentWindowBytesOverflow;
 
+// ֽĸߵˮλ
+extern uint32						g_intSendWindowBytesHighWater;
+extern uint32						g_extSendWindowBytesHighWater;
+extern uint32						g_intSendWindowBytesLowWater;
+extern uint32						g_extSendWindowBytesLowWater;
+
 bool initializeWatcher();
 bool initialize();
 void finalise(void);
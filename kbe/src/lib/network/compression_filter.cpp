@@ -0,0 +1,384 @@
+// Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
+
+#include "compression_filter.h"
+#include "helper/profile.h"
+#include "helper/debug_helper.h"
+#include "network/tcp_packet.h"
+#include "network/udp_packet.h"
+#include "network/channel.h"
+#include "network/message_handler.h"
+#include "network/network_stats.h"
+#include "network/packet_sender.h"
+
+#include "zlib.h"
+
+namespace KBEngine {
+namespace Network
+{
+
+// Z_SYNC_FLUSH在每个包的末尾产生的空块， 发送时去掉， 解压时补上
+static const uint8 SYNC_FLUSH_TAIL[4] = { 0x00, 0x00, 0xff, 0xff };
+
+//-------------------------------------------------------------------------------------
+CompressionFilter::CompressionFilter(uint32 threshold, PacketFilterPtr pNextFilter, MessageHandlers* pMsgHandlers):
+threshold_(threshold),
+pNextFilter_(pNextFilter),
+pMsgHandlers_(pMsgHandlers),
+pDeflateStream_(NULL),
+pInflateStream_(NULL),
+deflateFailed_(false),
+filteredReceiver_(*this),
+pPacket_(NULL),
+packetLen_(0)
+{
+}
+
+//-------------------------------------------------------------------------------------
+CompressionFilter::~CompressionFilter()
+{
+	if(pPacket_)
+	{
+		RECLAIM_PACKET(pPacket_->isTCPPacket(), pPacket_);
+		pPacket_ = NULL;
+	}
+
+	if(pDeflateStream_)
+	{
+		deflateEnd((z_stream*)pDeflateStream_);
+		delete (z_stream*)pDeflateStream_;
+	}
+
+	if(pInflateStream_)
+	{
+		inflateEnd((z_stream*)pInflateStream_);
+		delete (z_stream*)pInflateStream_;
+	}
+}
+
+//-------------------------------------------------------------------------------------
+bool CompressionFilter::initDeflate()
+{
+	if(pDeflateStream_)
+		return true;
+
+	z_stream* pStream = new z_stream;
+	memset(pStream, 0, sizeof(z_stream));
+
+	// 使用最快的压缩级别， 负的窗口大小表示不带zlib头的raw deflate
+	if(deflateInit2(pStream, Z_BEST_SPEED, Z_DEFLATED, -WINDOW_BITS, MEM_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK)
+	{
+		ERROR_MSG("CompressionFilter::initDeflate: deflateInit2 failed!\n");
+		delete pStream;
+		return false;
+	}
+
+	pDeflateStream_ = pStream;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool CompressionFilter::initInflate()
+{
+	if(pInflateStream_)
+		return true;
+
+	z_stream* pStream = new z_stream;
+	memset(pStream, 0, sizeof(z_stream));
+
+	if(inflateInit2(pStream, -WINDOW_BITS) != Z_OK)
+	{
+		ERROR_MSG("CompressionFilter::initInflate: inflateInit2 failed!\n");
+		delete pStream;
+		return false;
+	}
+
+	pInflateStream_ = pStream;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+Reason CompressionFilter::send(Channel * pChannel, PacketSender& sender, Packet * pPacket, int userarg)
+{
+	// 已经处理过的包(部分发送后重发)不再压缩
+	if(!pPacket->encrypted())
+	{
+		AUTO_SCOPED_PROFILE("compressSend")
+		compress(pPacket);
+
+		// 交给下一个过滤器加密， 没有加密时由这里标记已处理
+		if(!pNextFilter_)
+			pPacket->encrypted(true);
+	}
+
+	if(pNextFilter_)
+		return pNextFilter_->send(pChannel, sender, pPacket, userarg);
+
+	return sender.processFilterPacket(pChannel, pPacket, userarg);
+}
+
+//-------------------------------------------------------------------------------------
+void CompressionFilter::compress(Packet * pPacket)
+{
+	int dataLen = (int)pPacket->wpos();
+
+	if(dataLen >= (int)threshold_ && !deflateFailed_ && initDeflate())
+	{
+		z_stream* pStream = (z_stream*)pDeflateStream_;
+
+		Packet * pOutPacket = NULL;
+		MALLOC_PACKET(pOutPacket, pPacket->isTCPPacket());
+
+		size_t outCapacity = HEADER_SIZE + dataLen + 64;
+		pOutPacket->data_resize(outCapacity);
+
+		pStream->next_in = pPacket->data();
+		pStream->avail_in = dataLen;
+
+		size_t outLen = HEADER_SIZE;
+		int ret = Z_OK;
+
+		// Z_SYNC_FLUSH时输出缓冲区没有被填满说明已经全部输出
+		do
+		{
+			if(outCapacity - outLen < 64)
+			{
+				outCapacity *= 2;
+				pOutPacket->data_resize(outCapacity);
+			}
+
+			pStream->next_out = pOutPacket->data() + outLen;
+			pStream->avail_out = (uInt)(outCapacity - outLen);
+
+			ret = deflate(pStream, Z_SYNC_FLUSH);
+			outLen = outCapacity - pStream->avail_out;
+		} while(ret == Z_OK && pStream->avail_out == 0);
+
+		if((ret == Z_OK || ret == Z_BUF_ERROR) && pStream->avail_in == 0 &&
+			outLen >= HEADER_SIZE + sizeof(SYNC_FLUSH_TAIL) &&
+			memcmp(pOutPacket->data() + outLen - sizeof(SYNC_FLUSH_TAIL), SYNC_FLUSH_TAIL, sizeof(SYNC_FLUSH_TAIL)) == 0)
+		{
+			outLen -= sizeof(SYNC_FLUSH_TAIL);
+
+			NetworkStats::getSingleton().trackCompression(pMsgHandlers_ ? pMsgHandlers_->find(pPacket->messageID()) : NULL,
+				dataLen, (uint32)(outLen - HEADER_SIZE));
+
+			pOutPacket->wpos(0);
+			(*pOutPacket) << (PacketLength)(outLen - PACKET_LENGTH_SIZE);
+			(*pOutPacket) << (uint8)FLAG_DEFLATE;
+			pOutPacket->wpos((int)outLen);
+
+			pPacket->swap(*(static_cast<KBEngine::MemoryStream*>(pOutPacket)));
+			RECLAIM_PACKET(pPacket->isTCPPacket(), pOutPacket);
+			return;
+		}
+
+		// 对端还没有收到这个包的任何压缩数据， 关闭压缩后原样发送仍然可以正确解析
+		ERROR_MSG(fmt::format("CompressionFilter::compress: deflate failed({}), compression disabled!\n", ret));
+		deflateFailed_ = true;
+		RECLAIM_PACKET(pPacket->isTCPPacket(), pOutPacket);
+	}
+
+	// 不压缩， 包头留出长度与标记的位置
+	pPacket->data_resize(HEADER_SIZE + dataLen);
+	memmove(pPacket->data() + HEADER_SIZE, pPacket->data(), dataLen);
+
+	pPacket->wpos(0);
+	(*pPacket) << (PacketLength)(dataLen + 1);
+	(*pPacket) << (uint8)FLAG_RAW;
+	pPacket->wpos(HEADER_SIZE + dataLen);
+}
+
+//-------------------------------------------------------------------------------------
+Reason CompressionFilter::recv(Channel * pChannel, PacketReceiver & receiver, Packet * pPacket)
+{
+	if(pNextFilter_)
+	{
+		// 先由下一个过滤器解密， 解出的包再经过filteredReceiver_解压
+		filteredReceiver_.pReceiver(&receiver);
+		return pNextFilter_->recv(pChannel, filteredReceiver_, pPacket);
+	}
+
+	return decompressRecv(pChannel, receiver, pPacket);
+}
+
+//-------------------------------------------------------------------------------------
+Reason CompressionFilter::decompressRecv(Channel * pChannel, PacketReceiver & receiver, Packet * pPacket)
+{
+	while(pPacket || pPacket_)
+	{
+		AUTO_SCOPED_PROFILE("compressRecv")
+
+		if(pPacket_)
+		{
+			if(pPacket)
+			{
+				pPacket_->append(pPacket->data() + pPacket->rpos(), pPacket->length());
+				RECLAIM_PACKET(pPacket->isTCPPacket(), pPacket);
+			}
+
+			pPacket = pPacket_;
+		}
+
+		if(packetLen_ <= 0)
+		{
+			// 如果满足一个最小包则尝试解包, 否则缓存这个包待与下一个包合并然后解包
+			if(pPacket->length() < HEADER_SIZE)
+			{
+				if(pPacket_ == NULL)
+					pPacket_ = pPacket;
+
+				return receiver.processFilteredPacket(pChannel, NULL);
+			}
+
+			(*pPacket) >> packetLen_;
+
+			if(packetLen_ <= 0)
+			{
+				ERROR_MSG(fmt::format("CompressionFilter::recv: invalid packet length, addr={}\n",
+					pChannel->c_str()));
+
+				if(pPacket_ == pPacket)
+					pPacket_ = NULL;
+
+				RECLAIM_PACKET(pPacket->isTCPPacket(), pPacket);
+				pChannel->condemn("CompressionFilter::recv: invalid packet length");
+				return REASON_GENERAL_NETWORK;
+			}
+		}
+
+		// 如果包是完整的下面流程会解压， 如果有多余的内容需要将其剪裁出来待与下一个包合并
+		if(pPacket->length() > packetLen_)
+		{
+			Packet* pRemainPacket = NULL;
+			MALLOC_PACKET(pRemainPacket, pPacket->isTCPPacket());
+			int currLen = pPacket->rpos() + packetLen_;
+			pRemainPacket->append(pPacket->data() + currLen, pPacket->wpos() - currLen);
+			pPacket->wpos(currLen);
+			pPacket_ = pRemainPacket;
+		}
+		else if(pPacket->length() == packetLen_)
+		{
+			if(pPacket_ != NULL && pPacket_ == pPacket)
+				pPacket_ = NULL;
+		}
+		else
+		{
+			if(pPacket_ == NULL)
+				pPacket_ = pPacket;
+
+			return receiver.processFilteredPacket(pChannel, NULL);
+		}
+
+		uint8 flag = 0;
+		(*pPacket) >> flag;
+
+		PacketLength dataLen = packetLen_ - 1;
+		packetLen_ = 0;
+
+		if(flag == FLAG_DEFLATE)
+		{
+			Packet* pOutPacket = decompress(pPacket, dataLen);
+			RECLAIM_PACKET(pPacket->isTCPPacket(), pPacket);
+
+			if(pOutPacket == NULL)
+			{
+				ERROR_MSG(fmt::format("CompressionFilter::recv: inflate failed, addr={}\n",
+					pChannel->c_str()));
+
+				if(pPacket_)
+				{
+					RECLAIM_PACKET(pPacket_->isTCPPacket(), pPacket_);
+					pPacket_ = NULL;
+				}
+
+				pChannel->condemn("CompressionFilter::recv: inflate failed");
+				return REASON_GENERAL_NETWORK;
+			}
+
+			pPacket = pOutPacket;
+		}
+
+		Reason ret = receiver.processFilteredPacket(pChannel, pPacket);
+		if(ret != REASON_SUCCESS)
+		{
+			if(pPacket_)
+			{
+				RECLAIM_PACKET(pPacket_->isTCPPacket(), pPacket_);
+				pPacket_ = NULL;
+			}
+
+			return ret;
+		}
+
+		pPacket = NULL;
+	}
+
+	return REASON_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------
+Packet* CompressionFilter::decompress(Packet * pPacket, PacketLength dataLen)
+{
+	if(!initInflate())
+		return NULL;
+
+	z_stream* pStream = (z_stream*)pInflateStream_;
+
+	Packet * pOutPacket = NULL;
+	MALLOC_PACKET(pOutPacket, pPacket->isTCPPacket());
+
+	size_t outCapacity = KBE_MAX((size_t)dataLen * 4, pOutPacket->size());
+	pOutPacket->data_resize(outCapacity);
+
+	size_t outLen = 0;
+
+	// 先解压包中的数据， 再补上发送时去掉的空块
+	for(int i = 0; i < 2; ++i)
+	{
+		if(i == 0)
+		{
+			pStream->next_in = pPacket->data() + pPacket->rpos();
+			pStream->avail_in = dataLen;
+		}
+		else
+		{
+			pStream->next_in = const_cast<uint8*>(SYNC_FLUSH_TAIL);
+			pStream->avail_in = sizeof(SYNC_FLUSH_TAIL);
+		}
+
+		// 输入已经用完但是输出缓冲区被填满时可能还有数据没有输出
+		do
+		{
+			if(outCapacity - outLen < 256)
+			{
+				if(outCapacity >= MAX_INFLATE_SIZE)
+				{
+					RECLAIM_PACKET(pOutPacket->isTCPPacket(), pOutPacket);
+					return NULL;
+				}
+
+				outCapacity = KBE_MIN(outCapacity * 2, (size_t)MAX_INFLATE_SIZE);
+				pOutPacket->data_resize(outCapacity);
+			}
+
+			pStream->next_out = pOutPacket->data() + outLen;
+			pStream->avail_out = (uInt)(outCapacity - outLen);
+
+			int ret = inflate(pStream, Z_SYNC_FLUSH);
+			outLen = outCapacity - pStream->avail_out;
+
+			if(ret != Z_OK && ret != Z_BUF_ERROR)
+			{
+				RECLAIM_PACKET(pOutPacket->isTCPPacket(), pOutPacket);
+				return NULL;
+			}
+		} while(pStream->avail_in > 0 || pStream->avail_out == 0);
+	}
+
+	pOutPacket->wpos((int)outLen);
+	return pOutPacket;
+}
+
+//-------------------------------------------------------------------------------------
+}
+}
@@ -0,0 +1,113 @@
+// Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
+
+#ifndef KBE_COMPRESSION_FILTER_H
+#define KBE_COMPRESSION_FILTER_H
+
+#include "network/packet_filter.h"
+#include "network/packet_receiver.h"
+
+namespace KBEngine {
+namespace Network
+{
+class MessageHandlers;
+
+/**
+	外部通道的压缩过滤器(channelCommon/compressThreshold > 0时开启)
+	大于阈值的包使用zlib流式压缩(raw deflate， Z_SYNC_FLUSH)， 整个连接共享一个压缩窗口，
+	包含实体属性、脚本协议等重复内容的下行数据即使被拆成多个包也能得到较好的压缩率。
+	每个包的格式为: 长度(PacketLength) + 标记(uint8) + 数据
+	压缩在加密之前进行， 加密过滤器作为下一个过滤器串联在后面。
+*/
+class CompressionFilter : public PacketFilter
+{
+public:
+	enum
+	{
+		FLAG_RAW = 0,
+		FLAG_DEFLATE = 1
+	};
+
+	// 每个包额外占用的字节(长度+标记)
+	static const int HEADER_SIZE = PACKET_LENGTH_SIZE + 1;
+
+	// 压缩窗口， 每个通道的压缩流占用约(1 << (WINDOW_BITS + 2)) + (1 << (MEM_LEVEL + 9))字节
+	static const int WINDOW_BITS = 12;
+	static const int MEM_LEVEL = 5;
+
+	// 解压后一个包的最大长度
+	static const int MAX_INFLATE_SIZE = 65535;
+
+	/**
+		pMsgHandlers用于按消息统计压缩率(发出的消息所在的协议)， 可以为NULL
+	*/
+	CompressionFilter(uint32 threshold, PacketFilterPtr pNextFilter = NULL, MessageHandlers* pMsgHandlers = NULL);
+	virtual ~CompressionFilter();
+
+	virtual Reason send(Channel * pChannel, PacketSender& sender, Packet * pPacket, int userarg);
+
+	virtual Reason recv(Channel * pChannel, PacketReceiver & receiver, Packet * pPacket);
+
+	PacketFilterPtr pNextFilter() const { return pNextFilter_; }
+
+private:
+	/**
+		下一个过滤器(解密)处理完的包经由这里解压， 再交给真正的接收器
+	*/
+	class FilteredReceiver : public PacketReceiver
+	{
+	public:
+		FilteredReceiver(CompressionFilter& filter):
+		PacketReceiver(),
+		filter_(filter),
+		pReceiver_(NULL)
+		{
+		}
+
+		virtual Reason processFilteredPacket(Channel* pChannel, Packet * pPacket)
+		{
+			return filter_.decompressRecv(pChannel, *pReceiver_, pPacket);
+		}
+
+		void pReceiver(PacketReceiver* pReceiver) { pReceiver_ = pReceiver; }
+
+	protected:
+		virtual bool processRecv(bool expectingPacket) { return false; }
+		virtual RecvState checkSocketErrors(int len, bool expectingPacket) { return RECV_STATE_BREAK; }
+
+		CompressionFilter& filter_;
+		PacketReceiver* pReceiver_;
+	};
+
+	Reason decompressRecv(Channel * pChannel, PacketReceiver & receiver, Packet * pPacket);
+
+	void compress(Packet * pPacket);
+
+	/**
+		解压一个完整的包， rpos指向数据， 失败返回NULL
+	*/
+	Packet* decompress(Packet * pPacket, PacketLength dataLen);
+
+	bool initDeflate();
+	bool initInflate();
+
+	uint32 threshold_;
+	PacketFilterPtr pNextFilter_;
+	MessageHandlers* pMsgHandlers_;
+
+	// z_stream， 第一次需要时创建
+	void * pDeflateStream_;
+	void * pInflateStream_;
+
+	// 压缩出错后不再压缩， 之后的包都不压缩发送
+	bool deflateFailed_;
+
+	FilteredReceiver filteredReceiver_;
+
+	Packet * pPacket_;
+	Network::PacketLength packetLen_;
+};
+
+}
+}
+
+#endif // KBE_COMPRESSION_FILTER_H
@@ -10,6 +10,9 @@
 #include "network/packet_receiver.h"
 #include "network/packet_sender.h"
 
+#include "openssl/evp.h"
+#include "openssl/rand.h"
+
 namespace KBEngine { 
 namespace Network
 {
@@ -53,7 +56,7 @@ Reason BlowfishFilter::send(Channel * pChannel, PacketSender& sender, Packet * p
 		{
 			WARNING_MSG(fmt::format("BlowfishFilter::send: "
 				"Dropping packet to {} due to invalid filter\n",
-				pChannel->addr().c_str()));
+				pChannel->c_str()));
 
 			return REASON_GENERAL_NETWORK;
 		}
@@ -117,7 +120,7 @@ Reason BlowfishFilter::recv(Channel * pChannel, PacketReceiver & receiver, Packe
 		{
 			WARNING_MSG(fmt::format("BlowfishFilter::recv: "
 				"Dropping packet to {} due to invalid filter\n",
-				pChannel->addr().c_str()));
+				pChannel->c_str()));
 
 			return REASON_GENERAL_NETWORK;
 		}
@@ -318,6 +321,409 @@ void BlowfishFilter::decrypt(Packet * pInPacket, Packet * pOutPacket)
 	}
 }
 
+//-------------------------------------------------------------------------------------
+static const EVP_CIPHER* aeadCipher(int8 type, size_t keySize)
+{
+	switch(type)
+	{
+	case AEADFilter::ENCRYPT_AES_GCM:
+		if(keySize == 16)
+			return EVP_aes_128_gcm();
+		else if(keySize == 32)
+			return EVP_aes_256_gcm();
+		break;
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+	case AEADFilter::ENCRYPT_CHACHA20_POLY1305:
+		if(keySize == 32)
+			return EVP_chacha20_poly1305();
+		break;
+#endif
+	default:
+		break;
+	};
+
+	return NULL;
+}
+
+//-------------------------------------------------------------------------------------
+AEADFilter::AEADFilter(int8 type, const std::string& key):
+type_(type),
+key_(key),
+isGood_(false),
+pEncryptCtx_(NULL),
+pDecryptCtx_(NULL),
+sendDirection_(0),
+recvDirection_(0),
+sendSeq_(0),
+recvSeq_(0),
+pPacket_(NULL),
+packetLen_(0)
+{
+	isGood_ = init(true);
+}
+
+//-------------------------------------------------------------------------------------
+AEADFilter::AEADFilter(int8 type):
+type_(type),
+key_(type == ENCRYPT_CHACHA20_POLY1305 ? 32 : DEFAULT_KEY_SIZE, 0),
+isGood_(false),
+pEncryptCtx_(NULL),
+pDecryptCtx_(NULL),
+sendDirection_(0),
+recvDirection_(0),
+sendSeq_(0),
+recvSeq_(0),
+pPacket_(NULL),
+packetLen_(0)
+{
+	RAND_bytes((unsigned char*)const_cast<char *>(key_.c_str()), (int)key_.size());
+	isGood_ = init(false);
+}
+
+//-------------------------------------------------------------------------------------
+AEADFilter::~AEADFilter()
+{
+	if(pPacket_)
+	{
+		RECLAIM_PACKET(pPacket_->isTCPPacket(), pPacket_);
+		pPacket_ = NULL;
+	}
+
+	if(pEncryptCtx_)
+		EVP_CIPHER_CTX_free((EVP_CIPHER_CTX*)pEncryptCtx_);
+
+	if(pDecryptCtx_)
+		EVP_CIPHER_CTX_free((EVP_CIPHER_CTX*)pDecryptCtx_);
+}
+
+//-------------------------------------------------------------------------------------
+bool AEADFilter::isSupported(int8 type)
+{
+	if(type == ENCRYPT_AES_GCM)
+		return true;
+
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+	if(type == ENCRYPT_CHACHA20_POLY1305)
+		return true;
+#endif
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+bool AEADFilter::init(bool isServer)
+{
+	const EVP_CIPHER* pCipher = aeadCipher(type_, key_.size());
+	if(pCipher == NULL)
+	{
+		ERROR_MSG(fmt::format("AEADFilter::init: unsupported encrypt_type({}) or key size({})!\n",
+			(int)type_, key_.size()));
+
+		return false;
+	}
+
+	// ʹòͬnonce ͬһԿnonceظ
+	sendDirection_ = isServer ? 1 : 2;
+	recvDirection_ = isServer ? 2 : 1;
+
+	EVP_CIPHER_CTX* pEncryptCtx = EVP_CIPHER_CTX_new();
+	EVP_CIPHER_CTX* pDecryptCtx = EVP_CIPHER_CTX_new();
+	pEncryptCtx_ = pEncryptCtx;
+	pDecryptCtx_ = pDecryptCtx;
+
+	// ԿֻһΣ ֮ÿֻnonce
+	if(EVP_EncryptInit_ex(pEncryptCtx, pCipher, NULL, NULL, NULL) != 1 ||
+		EVP_CIPHER_CTX_ctrl(pEncryptCtx, EVP_CTRL_GCM_SET_IVLEN, NONCE_SIZE, NULL) != 1 ||
+		EVP_EncryptInit_ex(pEncryptCtx, NULL, NULL, (const unsigned char*)key_.data(), NULL) != 1 ||
+		EVP_DecryptInit_ex(pDecryptCtx, pCipher, NULL, NULL, NULL) != 1 ||
+		EVP_CIPHER_CTX_ctrl(pDecryptCtx, EVP_CTRL_GCM_SET_IVLEN, NONCE_SIZE, NULL) != 1 ||
+		EVP_DecryptInit_ex(pDecryptCtx, NULL, NULL, (const unsigned char*)key_.data(), NULL) != 1)
+	{
+		ERROR_MSG(fmt::format("AEADFilter::init: EVP init failed, encrypt_type={}!\n", (int)type_));
+		return false;
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void AEADFilter::makeNonce(uint8* nonce, uint8 direction, uint64 seq) const
+{
+	memset(nonce, 0, NONCE_SIZE);
+	nonce[0] = direction;
+
+	for(int i = 0; i < 8; ++i)
+		nonce[NONCE_SIZE - 1 - i] = (uint8)(seq >> (i * 8));
+}
+
+//-------------------------------------------------------------------------------------
+Reason AEADFilter::send(Channel * pChannel, PacketSender& sender, Packet * pPacket, int userarg)
+{
+	if(!pPacket->encrypted())
+	{
+		AUTO_SCOPED_PROFILE("encryptSend")
+
+		if (!isGood_)
+		{
+			WARNING_MSG(fmt::format("AEADFilter::send: "
+				"Dropping packet to {} due to invalid filter\n",
+				pChannel->c_str()));
+
+			return REASON_GENERAL_NETWORK;
+		}
+
+		encrypt(pPacket, pPacket);
+
+		if (Network::g_trace_packet > 0 && Network::g_trace_encrypted_packet)
+		{
+			if (Network::g_trace_packet_use_logfile)
+				DebugHelper::getSingleton().changeLogger("packetlogs");
+
+			DEBUG_MSG(fmt::format("<==== AEADFilter::send: encryptedLen={}, seq={}\n",
+				pPacket->length(), sendSeq_ - 1));
+
+			switch (Network::g_trace_packet)
+			{
+			case 1:
+				pPacket->hexlike();
+				break;
+			case 2:
+				pPacket->textlike();
+				break;
+			default:
+				pPacket->print_storage();
+				break;
+			};
+
+			if (Network::g_trace_packet_use_logfile)
+				DebugHelper::getSingleton().changeLogger(COMPONENT_NAME_EX(g_componentType));
+		}
+	}
+
+	return sender.processFilterPacket(pChannel, pPacket, userarg);
+}
+
+//-------------------------------------------------------------------------------------
+Reason AEADFilter::recv(Channel * pChannel, PacketReceiver & receiver, Packet * pPacket)
+{
+	while(pPacket || pPacket_)
+	{
+		AUTO_SCOPED_PROFILE("encryptRecv")
+
+		if (!isGood_)
+		{
+			WARNING_MSG(fmt::format("AEADFilter::recv: "
+				"Dropping packet to {} due to invalid filter\n",
+				pChannel->c_str()));
+
+			return REASON_GENERAL_NETWORK;
+		}
+
+		if(pPacket_)
+		{
+			if(pPacket)
+			{
+				pPacket_->append(pPacket->data() + pPacket->rpos(), pPacket->length());
+				RECLAIM_PACKET(pPacket->isTCPPacket(), pPacket);
+			}
+
+			pPacket = pPacket_;
+		}
+
+		if(packetLen_ <= 0)
+		{
+			// һСԽ, 򻺴һϲȻ
+			if(pPacket->length() < (PACKET_LENGTH_SIZE + TAG_SIZE))
+			{
+				if(pPacket_ == NULL)
+					pPacket_ = pPacket;
+
+				return receiver.processFilteredPacket(pChannel, NULL);
+			}
+
+			(*pPacket) >> packetLen_;
+
+			if(packetLen_ < TAG_SIZE)
+			{
+				ERROR_MSG(fmt::format("AEADFilter::recv: invalid packet length({}), addr={}\n",
+					packetLen_, pChannel->c_str()));
+
+				if(pPacket_ == pPacket)
+					pPacket_ = NULL;
+
+				RECLAIM_PACKET(pPacket->isTCPPacket(), pPacket);
+				pChannel->condemn("AEADFilter::recv: invalid packet length");
+				return REASON_GENERAL_NETWORK;
+			}
+		}
+
+		// ̻ܣ жҪóһϲ
+		if(pPacket->length() > packetLen_)
+		{
+			Packet* pRemainPacket = NULL;
+			MALLOC_PACKET(pRemainPacket, pPacket->isTCPPacket());
+			int currLen = pPacket->rpos() + packetLen_;
+			pRemainPacket->append(pPacket->data() + currLen, pPacket->wpos() - currLen);
+			pPacket->wpos(currLen);
+			pPacket_ = pRemainPacket;
+		}
+		else if(pPacket->length() == packetLen_)
+		{
+			if(pPacket_ != NULL && pPacket_ == pPacket)
+				pPacket_ = NULL;
+		}
+		else
+		{
+			if(pPacket_ == NULL)
+				pPacket_ = pPacket;
+
+			return receiver.processFilteredPacket(pChannel, NULL);
+		}
+
+		if(Network::g_trace_packet > 0 && Network::g_trace_encrypted_packet)
+		{
+			if(Network::g_trace_packet_use_logfile)
+				DebugHelper::getSingleton().changeLogger("packetlogs");
+
+			DEBUG_MSG(fmt::format("====> AEADFilter::recv: encryptedLen={}, seq={}\n",
+				packetLen_, recvSeq_));
+
+			switch(Network::g_trace_packet)
+			{
+			case 1:
+				pPacket->hexlike();
+				break;
+			case 2:
+				pPacket->textlike();
+				break;
+			default:
+				pPacket->print_storage();
+				break;
+			};
+
+			if(Network::g_trace_packet_use_logfile)
+				DebugHelper::getSingleton().changeLogger(COMPONENT_NAME_EX(g_componentType));
+		}
+
+		if(!decryptFrame(pPacket, packetLen_))
+		{
+			ERROR_MSG(fmt::format("AEADFilter::recv: authentication failed, addr={}, seq={}\n",
+				pChannel->c_str(), recvSeq_));
+
+			RECLAIM_PACKET(pPacket->isTCPPacket(), pPacket);
+
+			if(pPacket_)
+			{
+				RECLAIM_PACKET(pPacket_->isTCPPacket(), pPacket_);
+				pPacket_ = NULL;
+			}
+
+			packetLen_ = 0;
+			pChannel->condemn("AEADFilter::recv: authentication failed");
+			return REASON_GENERAL_NETWORK;
+		}
+
+		packetLen_ = 0;
+
+		Reason ret = receiver.processFilteredPacket(pChannel, pPacket);
+		if(ret != REASON_SUCCESS)
+		{
+			if(pPacket_)
+			{
+				RECLAIM_PACKET(pPacket_->isTCPPacket(), pPacket_);
+				pPacket_ = NULL;
+			}
+
+			return ret;
+		}
+
+		pPacket = NULL;
+	}
+
+	return REASON_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------
+void AEADFilter::encrypt(Packet * pInPacket, Packet * pOutPacket)
+{
+	// ԭؼܣ Ҫٷһ
+	if(pInPacket != pOutPacket)
+		pOutPacket->append(pInPacket->data() + pInPacket->rpos(), pInPacket->length());
+
+	EVP_CIPHER_CTX* pCtx = (EVP_CIPHER_CTX*)pEncryptCtx_;
+
+	int dataLen = (int)pOutPacket->wpos();
+	PacketLength frameLen = (PacketLength)(dataLen + TAG_SIZE);
+
+	// ͷȵλã β֤ǩλ
+	pOutPacket->data_resize(PACKET_LENGTH_SIZE + dataLen + TAG_SIZE);
+	memmove(pOutPacket->data() + PACKET_LENGTH_SIZE, pOutPacket->data(), dataLen);
+
+	pOutPacket->wpos(0);
+	(*pOutPacket) << frameLen;
+
+	uint8 nonce[NONCE_SIZE];
+	makeNonce(nonce, sendDirection_, sendSeq_++);
+
+	uint8* pData = pOutPacket->data() + PACKET_LENGTH_SIZE;
+	int outLen = 0;
+
+	EVP_EncryptInit_ex(pCtx, NULL, NULL, NULL, nonce);
+	EVP_EncryptUpdate(pCtx, NULL, &outLen, pOutPacket->data(), PACKET_LENGTH_SIZE);
+	EVP_EncryptUpdate(pCtx, pData, &outLen, pData, dataLen);
+	EVP_EncryptFinal_ex(pCtx, pData + dataLen, &outLen);
+	EVP_CIPHER_CTX_ctrl(pCtx, EVP_CTRL_GCM_GET_TAG, TAG_SIZE, pData + dataLen);
+
+	pOutPacket->wpos(PACKET_LENGTH_SIZE + dataLen + TAG_SIZE);
+	pOutPacket->encrypted(true);
+}
+
+//-------------------------------------------------------------------------------------
+void AEADFilter::decrypt(Packet * pInPacket, Packet * pOutPacket)
+{
+	if(pInPacket != pOutPacket)
+		pOutPacket->append(pInPacket->data() + pInPacket->rpos(), pInPacket->length());
+
+	if(pOutPacket->length() < (PACKET_LENGTH_SIZE + TAG_SIZE))
+		return;
+
+	PacketLength frameLen = 0;
+	(*pOutPacket) >> frameLen;
+
+	if(frameLen > pOutPacket->length() || !decryptFrame(pOutPacket, frameLen))
+	{
+		ERROR_MSG("AEADFilter::decrypt: authentication failed!\n");
+	}
+}
+
+//-------------------------------------------------------------------------------------
+bool AEADFilter::decryptFrame(Packet * pPacket, PacketLength frameLen)
+{
+	EVP_CIPHER_CTX* pCtx = (EVP_CIPHER_CTX*)pDecryptCtx_;
+
+	int dataLen = frameLen - TAG_SIZE;
+	uint8* pData = pPacket->data() + pPacket->rpos();
+
+	uint8 nonce[NONCE_SIZE];
+	makeNonce(nonce, recvDirection_, recvSeq_++);
+
+	int outLen = 0;
+
+	// Ϊ֤ݣ λ֮ǰ
+	if(EVP_DecryptInit_ex(pCtx, NULL, NULL, NULL, nonce) != 1 ||
+		EVP_DecryptUpdate(pCtx, NULL, &outLen, pData - PACKET_LENGTH_SIZE, PACKET_LENGTH_SIZE) != 1 ||
+		EVP_DecryptUpdate(pCtx, pData, &outLen, pData, dataLen) != 1 ||
+		EVP_CIPHER_CTX_ctrl(pCtx, EVP_CTRL_GCM_SET_TAG, TAG_SIZE, pData + dataLen) != 1 ||
+		EVP_DecryptFinal_ex(pCtx, pData + dataLen, &outLen) <= 0)
+	{
+		return false;
+	}
+
+	// ȥ֤ǩ rposָ
+	pPacket->wpos((int)(pPacket->rpos() + dataLen));
+	return true;
+}
+
 //-------------------------------------------------------------------------------------
 
 } 
@@ -21,6 +21,16 @@ public:
 
 	virtual void encrypt(Packet * pInPacket, Packet * pOutPacket) = 0;
 	virtual void decrypt(Packet * pInPacket, Packet * pOutPacket) = 0;
+
+	/**
+		ͻhelloз͸˵Կ
+	*/
+	virtual const std::string& key() const = 0;
+
+	/**
+		ԿЧʱΪfalse ʱᶪеİ
+	*/
+	virtual bool isGood() const = 0;
 };
 
 
@@ -39,6 +49,11 @@ public:
 
 	void encrypt(Packet * pInPacket, Packet * pOutPacket);
 	void decrypt(Packet * pInPacket, Packet * pOutPacket);
+
+	virtual const Key& key() const { return KBEBlowfish::key(); }
+
+	virtual bool isGood() const { return KBEBlowfish::isGood(); }
+
 private:
 	Packet * pPacket_;
 	Network::PacketLength packetLen_;
@@ -47,6 +62,80 @@ private:
 
 typedef SmartPointer<BlowfishFilter> BlowfishFilterPtr;
 
+/**
+	AEADܹ(OpenSSL EVP) ڰĻԭؼӽܣ Ҫڶ밴
+	ENCRYPT_AES_GCM: AES-GCM Կ16ֽΪAES-128 32ֽΪAES-256(AES-NIʱӲ)
+	ENCRYPT_CHACHA20_POLY1305: ChaCha20-Poly1305(ҪOpenSSL 1.1.0+) ûAES-NIĿͻ˸
+
+	ÿĸʽΪ: (PacketLength Ϊ֤) +  + ֤ǩ(16ֽ)
+	nonceΪ4ֽڵķǼ8ֽڵİţ ˫԰˳ ڰд䣬
+	Ҫײ㰴˳ɿ(TCPKCP) κһ۸Ļ߶ʧᵼ֤ʧܡ
+*/
+class AEADFilter : public EncryptionFilter
+{
+public:
+	enum
+	{
+		ENCRYPT_AES_GCM = 3,
+		ENCRYPT_CHACHA20_POLY1305 = 4
+	};
+
+	static const int TAG_SIZE = 16;
+	static const int NONCE_SIZE = 12;
+	static const int DEFAULT_KEY_SIZE = 16;
+
+	/**
+		ʹÿͻ˷Կ
+	*/
+	AEADFilter(int8 type, const std::string& key);
+
+	/**
+		ͻԿ
+	*/
+	AEADFilter(int8 type);
+
+	virtual ~AEADFilter();
+
+	static bool isSupported(int8 type);
+
+	virtual Reason send(Channel * pChannel, PacketSender& sender, Packet * pPacket, int userarg);
+
+	virtual Reason recv(Channel * pChannel, PacketReceiver & receiver, Packet * pPacket);
+
+	void encrypt(Packet * pInPacket, Packet * pOutPacket);
+	void decrypt(Packet * pInPacket, Packet * pOutPacket);
+
+	virtual const std::string& key() const { return key_; }
+
+	virtual bool isGood() const { return isGood_; }
+
+private:
+	bool init(bool isServer);
+
+	void makeNonce(uint8* nonce, uint8 direction, uint64 seq) const;
+
+	/**
+		һİ rposָģ ֤ʧܷfalse
+	*/
+	bool decryptFrame(Packet * pPacket, PacketLength frameLen);
+
+	int8 type_;
+	std::string key_;
+	bool isGood_;
+
+	// EVP_CIPHER_CTX
+	void * pEncryptCtx_;
+	void * pDecryptCtx_;
+
+	uint8 sendDirection_;
+	uint8 recvDirection_;
+	uint64 sendSeq_;
+	uint64 recvSeq_;
+
+	Packet * pPacket_;
+	Network::PacketLength packetLen_;
+};
+
 inline EncryptionFilter* createEncryptionFilter(int8 type, const std::string& datas)
 {
 	EncryptionFilter* pEncryptionFilter = NULL;
@@ -55,6 +144,32 @@ inline EncryptionFilter* createEncryptionFilter(int8 type, const std::string& da
 	case 1:
 		pEncryptionFilter = new BlowfishFilter(datas);
 		break;
+	case AEADFilter::ENCRYPT_AES_GCM:
+	case AEADFilter::ENCRYPT_CHACHA20_POLY1305:
+		pEncryptionFilter = new AEADFilter(type, datas);
+		break;
+	default:
+		break;
+	}
+
+	return pEncryptionFilter;
+}
+
+/**
+	ͻ(bots)һʹԿĹ Կͨhello͸
+*/
+inline EncryptionFilter* createClientEncryptionFilter(int8 type)
+{
+	EncryptionFilter* pEncryptionFilter = NULL;
+	switch(type)
+	{
+	case 1:
+		pEncryptionFilter = new BlowfishFilter();
+		break;
+	case AEADFilter::ENCRYPT_AES_GCM:
+	case AEADFilter::ENCRYPT_CHACHA20_POLY1305:
+		pEncryptionFilter = new AEADFilter(type);
+		break;
 	default:
 		break;
 	}
@@ -56,6 +56,7 @@ public:
 	INLINE int setnonblocking(bool nonblocking);
 	INLINE int setbroadcast(bool broadcast);
 	INLINE int setreuseaddr(bool reuseaddr);
+	INLINE int setreuseport(bool reuseport);
 	INLINE int setkeepalive(bool keepalive);
 	INLINE int setnodelay(bool nodelay = true);
 	INLINE int setlinger(uint16 onoff, uint16 linger);
@@ -72,6 +73,15 @@ public:
 	INLINE int send(const void * gramData, int gramSize);
 	void send(Bundle * pBundle);
 
+#if KBE_PLATFORM == PLATFORM_UNIX
+	/**
+		一次系统调用发送多个缓冲区(TCP)或多个数据报(UDP)
+	*/
+	INLINE int sendv(const struct iovec * iov, int iovcnt);
+	INLINE int sendmmsg(struct mmsghdr * msgvec, unsigned int vlen);
+	INLINE int recvmmsg(struct mmsghdr * msgvec, unsigned int vlen);
+#endif
+
 	INLINE int recv(void * gramData, int gramSize);
 	bool recvAll(void * gramData, int gramSize);
 	
@@ -144,6 +144,17 @@ INLINE int EndPoint::setreuseaddr(bool reuseaddr)
 		(char*)&val, sizeof(val));
 }
 
+INLINE int EndPoint::setreuseport(bool reuseport)
+{
+#if KBE_PLATFORM == PLATFORM_UNIX && defined(SO_REUSEPORT)
+	int val = reuseport ? 1 : 0;
+	return ::setsockopt(socket_, SOL_SOCKET, SO_REUSEPORT,
+		(char*)&val, sizeof(val));
+#else
+	return -1;
+#endif
+}
+
 INLINE int EndPoint::setlinger(uint16 onoff, uint16 linger)
 {
 	struct linger l = { 0 };
@@ -432,6 +443,24 @@ INLINE int EndPoint::send(const void * gramData, int gramSize)
 	return ::send(socket_, (char*)gramData, gramSize, 0);
 }
 
+#if KBE_PLATFORM == PLATFORM_UNIX
+INLINE int EndPoint::sendv(const struct iovec * iov, int iovcnt)
+{
+	KBE_ASSERT(!isSSL());
+	return ::writev(socket_, iov, iovcnt);
+}
+
+INLINE int EndPoint::sendmmsg(struct mmsghdr * msgvec, unsigned int vlen)
+{
+	return ::sendmmsg(socket_, msgvec, vlen, 0);
+}
+
+INLINE int EndPoint::recvmmsg(struct mmsghdr * msgvec, unsigned int vlen)
+{
+	return ::recvmmsg(socket_, msgvec, vlen, MSG_DONTWAIT, NULL);
+}
+#endif
+
 INLINE int EndPoint::recv(void * gramData, int gramSize)
 {
 	if (isSSL())
@@ -4,6 +4,8 @@
 #include "event_dispatcher.h"
 #include "network/event_poller.h"
 #include "network/error_reporter.h"
+#include "network/kcp_packet_sender.h"
+#include "network/kcp_update_scheduler.h"
 #include "helper/profile.h"
 
 #ifndef CODE_INLINE
@@ -24,8 +26,9 @@ EventDispatcher::EventDispatcher() :
 	lastStatisticsGathered_(0),
 	pTasks_(new Tasks),
 	pErrorReporter_(NULL),
-	pTimers_(new Timers64)
-	
+	pTimers_(new Timers64),
+	pPoller_(NULL),
+	pKCPUpdateScheduler_(new KCPUpdateScheduler)
 {
 	pPoller_ = EventPoller::create();
 	pErrorReporter_ = new ErrorReporter(*this);
@@ -37,6 +40,7 @@ EventDispatcher::~EventDispatcher()
 	SAFE_RELEASE(pErrorReporter_);
 	SAFE_RELEASE(pTasks_);
 	SAFE_RELEASE(pPoller_);
+	SAFE_RELEASE(pKCPUpdateScheduler_);
 	
 	if (!pTimers_->empty())
 	{
@@ -138,6 +142,12 @@ double EventDispatcher::calculateWait() const
 			pTimers_->nextExp(timestamp()) / stampsPerSecondD());
 	}
 
+	double kcpWait = pKCPUpdateScheduler_->nextExp();
+	if (kcpWait >= 0.0)
+	{
+		maxWait = std::min(maxWait, kcpWait);
+	}
+
 	return maxWait;
 }
 
@@ -154,6 +164,13 @@ void EventDispatcher::processTimers()
 	numTimerCalls_ += pTimers_->process(timestamp());
 }
 
+//-------------------------------------------------------------------------------------
+void EventDispatcher::processKCPUpdates()
+{
+	AUTO_SCOPED_PROFILE("kcpUpdates")
+	pKCPUpdateScheduler_->process();
+}
+
 //-------------------------------------------------------------------------------------
 void EventDispatcher::processStats()
 {
@@ -195,12 +212,17 @@ int EventDispatcher::processOnce(bool shouldIdle)
 
 	if(breakProcessing_ != EVENT_DISPATCHER_STATUS_BREAK_PROCESSING){
 		this->processTimers();
+		this->processKCPUpdates();
 	}
 
 	this->processStats();
 	
 	if(breakProcessing_ != EVENT_DISPATCHER_STATUS_BREAK_PROCESSING){
-		return this->processNetwork(shouldIdle);
+		// 定时器中产生的kcp输出必须在等待网络事件之前发出，网络事件处理中产生的输出在本轮结束时发出
+		KCPPacketSender::flushOutputs();
+		int ret = this->processNetwork(shouldIdle);
+		KCPPacketSender::flushOutputs();
+		return ret;
 	}
 
 	return 0;
@@ -15,6 +15,7 @@ namespace Network
 class DispatcherCoupling;
 class ErrorReporter;
 class EventPoller;
+class KCPUpdateScheduler;
 
 class EventDispatcher
 {
@@ -60,6 +61,8 @@ public:
 	INLINE EventPoller* createPoller();
 	EventPoller* pPoller(){ return pPoller_; }
 
+	KCPUpdateScheduler& kcpUpdateScheduler() { return *pKCPUpdateScheduler_; }
+
 	int processNetwork(bool shouldIdle);
 private:
 	TimerHandle addTimerCommon(int64 microseconds,
@@ -69,6 +72,7 @@ private:
 
 	void processTasks();
 	void processTimers();
+	void processKCPUpdates();
 	void processStats();
 	
 	double calculateWait() const;
@@ -89,6 +93,7 @@ protected:
 	ErrorReporter * pErrorReporter_;
 	Timers64* pTimers_;
 	EventPoller* pPoller_;
+	KCPUpdateScheduler* pKCPUpdateScheduler_;
 };
 
 
@@ -4,6 +4,7 @@
 #include "event_poller.h"
 #include "poller_select.h"
 #include "poller_epoll.h"
+#include "poller_iouring.h"
 #include "helper/profile.h"
 
 namespace KBEngine { 
@@ -182,6 +183,18 @@ int EventPoller::maxFD() const
 //-------------------------------------------------------------------------------------
 EventPoller * EventPoller::create()
 {
+#ifdef HAS_IO_URING
+	if (g_eventPoller == "io_uring")
+	{
+		IOUringPoller* pPoller = new IOUringPoller();
+		if (pPoller->isGood())
+			return pPoller;
+
+		WARNING_MSG("EventPoller::create: io_uring is not available, fall back to epoll!\n");
+		delete pPoller;
+	}
+#endif // HAS_IO_URING
+
 #ifdef HAS_EPOLL
 	return new EpollPoller();
 #else
@@ -8,6 +8,7 @@ namespace Network
 {
 class Channel;
 class MessageHandler;
+class Packet;
 
 /** ӿڽͨNetworkϢ
 */
@@ -16,6 +17,18 @@ class InputNotificationHandler
 public:
 	virtual ~InputNotificationHandler() {};
 	virtual int handleInputNotification(int fd) = 0;
+
+	/**
+		poller(io_uring)ǷֱӰݽյTCPPacketУ ٽhandleRecvCompletion
+		ÿύǰѯ
+	*/
+	virtual bool acceptsRecvCompletion() { return false; }
+
+	/**
+		pollerɵĽգ lenΪյֽ 0ΪԶ˹رգ Ϊ-errno
+		len0ʱpPacketɴգ ΪNULL
+	*/
+	virtual int handleRecvCompletion(int fd, Packet* pPacket, int len) { return 0; }
 };
 
 /** ӿڽͨNetworkϢ
@@ -43,6 +56,14 @@ public:
 	virtual void onChannelDeregister(Channel * pChannel) = 0;
 };
 
+/** ӿڽͨݳˮλ/䵽ˮλ֪ͨ
+*/
+class ChannelBackpressureHandler
+{
+public:
+	virtual void onChannelBackpressure(Channel * pChannel, bool isBackpressure) = 0;
+};
+
 /** ӿڼNetworkStats¼
 */
 class NetworkStatsHandler
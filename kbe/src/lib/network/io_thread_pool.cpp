@@ -0,0 +1,1037 @@
+// Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
+
+#include "io_thread_pool.h"
+#include "network/channel.h"
+#include "network/endpoint.h"
+#include "network/tcp_packet.h"
+#include "network/packet_filter.h"
+#include "network/packet_reader.h"
+#include "network/packet_receiver.h"
+#include "network/message_handler.h"
+#include "network/event_dispatcher.h"
+#include "network/network_interface.h"
+#include "network/network_stats.h"
+#include "network/error_reporter.h"
+#include "helper/profile.h"
+#include "thread/threadguard.h"
+#include <thread>
+
+#if KBE_PLATFORM == PLATFORM_UNIX
+#include <sys/epoll.h>
+#endif
+
+namespace KBEngine {
+namespace Network
+{
+
+/*
+	IO߳ΪĽ ˺ݰڴ˷ְ
+	ϢԼҪִ߳еĲд¼
+*/
+class IOThreadPool::Receiver : public PacketReceiver, public MessageSink
+{
+public:
+	Receiver(IOChannel& ioChannel, PacketFilter* pFilter, MemoryStream& records):
+	PacketReceiver(),
+	ioChannel_(ioChannel),
+	pFilter_(pFilter),
+	records_(records),
+	numPackets_(0)
+	{
+		KBE_ASSERT(IOThreadPool::pCurrentReceiver_ == NULL);
+		IOThreadPool::pCurrentReceiver_ = this;
+		ioChannel_.pPacketReader->pMessageSink(this);
+	}
+
+	virtual ~Receiver()
+	{
+		ioChannel_.pPacketReader->pMessageSink(NULL);
+		IOThreadPool::pCurrentReceiver_ = NULL;
+	}
+
+	Reason recv(TCPPacket* pPacket)
+	{
+		if (pFilter_)
+			return pFilter_->recv(ioChannel_.pChannel, *this, pPacket);
+
+		return processFilteredPacket(ioChannel_.pChannel, pPacket);
+	}
+
+	virtual Reason processFilteredPacket(Channel* pChannel, Packet* pPacket)
+	{
+		// ΪNULLʱ
+		if (pPacket == NULL)
+			return REASON_SUCCESS;
+
+		++numPackets_;
+
+		if (!ioChannel_.condemned)
+		{
+			PacketReader* pPacketReader = ioChannel_.pPacketReader;
+
+			try
+			{
+				pPacketReader->processMessages(ioChannel_.pMsgHandlers, pPacket);
+			}
+			catch (MemoryStreamException &)
+			{
+				Network::MessageHandler* pMsgHandler = ioChannel_.pMsgHandlers->find(pPacketReader->currMsgID());
+				WARNING_MSG(fmt::format("IOThreadPool::Receiver({}): packet invalid. currMsg=({}, id={}, len={}), currMsgLen={}\n",
+					pChannel->c_str()
+					, (pMsgHandler == NULL ? "unknown" : pMsgHandler->name)
+					, pPacketReader->currMsgID()
+					, (pMsgHandler == NULL ? -1 : pMsgHandler->msgLen)
+					, pPacketReader->currMsgLen()));
+
+				pPacketReader->currMsgID(0);
+				pPacketReader->currMsgLen(0);
+				condemn("Channel::processPackets: packet invalid!", false);
+			}
+		}
+
+		RECLAIM_PACKET(pPacket->isTCPPacket(), pPacket);
+		return REASON_SUCCESS;
+	}
+
+	virtual void onMessage(MessageHandler* pMsgHandler, MemoryStream* pStream, uint32 len, bool isFragment)
+	{
+		if (isFragment)
+		{
+			records_ << (uint8)RECORD_STREAM << (uint64)(uintptr_t)pMsgHandler << (uint64)(uintptr_t)pStream;
+		}
+		else
+		{
+			records_ << (uint8)RECORD_MESSAGE << (uint64)(uintptr_t)pMsgHandler << len;
+			records_.append(pStream->data() + pStream->rpos(), len);
+			pStream->read_skip(len);
+		}
+	}
+
+	virtual void onTrackMessage(MessageHandler* pMsgHandler, uint32 size)
+	{
+		records_ << (uint8)RECORD_TRACK << (uint64)(uintptr_t)pMsgHandler << size;
+	}
+
+	void condemn(const std::string& reason, bool waitSendCompletedDestroy)
+	{
+		if (ioChannel_.condemned)
+			return;
+
+		ioChannel_.condemned = true;
+		records_ << (uint8)RECORD_CONDEMN << reason << (uint8)(waitSendCompletedDestroy ? 1 : 0);
+	}
+
+	void send(const uint8* data, int size)
+	{
+		records_ << (uint8)RECORD_SEND << (uint32)size;
+		records_.append(data, size);
+	}
+
+	Channel* pChannel() const { return ioChannel_.pChannel; }
+	uint32 numPackets() const { return numPackets_; }
+
+protected:
+	virtual bool processRecv(bool expectingPacket) { return false; }
+	virtual PacketReceiver::RecvState checkSocketErrors(int len, bool expectingPacket) { return RECV_STATE_BREAK; }
+
+private:
+	IOChannel& ioChannel_;
+
+	// ȡ ߳滻ʱȴδ
+	PacketFilter* pFilter_;
+	MemoryStream& records_;
+	uint32 numPackets_;
+};
+
+thread_local IOThreadPool::Receiver* IOThreadPool::pCurrentReceiver_ = NULL;
+
+//-------------------------------------------------------------------------------------
+IOThreadPool::IOChannel::IOChannel():
+pChannel(NULL),
+pEndPoint(NULL),
+state(RECV_STATE_RAW),
+pendingPackets(),
+pFilter(NULL),
+pPacketReader(NULL),
+pMsgHandlers(NULL),
+condemned(false),
+inUse(false)
+{
+}
+
+//-------------------------------------------------------------------------------------
+IOThreadPool::IOThread::IOThread():
+pPool(NULL),
+tid(),
+epfd(-1),
+mutex(),
+channels(),
+head(0),
+tail(0)
+{
+}
+
+//-------------------------------------------------------------------------------------
+IOThreadPool::IOThreadPool(NetworkInterface& networkInterface):
+networkInterface_(networkInterface),
+threads_(),
+signalled_(false),
+running_(false)
+{
+	pipefds_[0] = pipefds_[1] = -1;
+}
+
+//-------------------------------------------------------------------------------------
+IOThreadPool::~IOThreadPool()
+{
+	finalise();
+
+	std::vector<IOThread*>::iterator iter = threads_.begin();
+	for (; iter != threads_.end(); ++iter)
+	{
+		IOThread* pThread = (*iter);
+
+		// ߳δȡߵ
+		uint32 tail = pThread->tail.load(std::memory_order_acquire);
+		for (uint32 i = pThread->head.load(std::memory_order_relaxed); i != tail; ++i)
+		{
+			Item& item = pThread->items[i & QUEUE_MASK];
+			if (item.pChannel == NULL)
+				continue;
+
+			if (item.pPacket)
+				TCPPacket::reclaimPoolObject(item.pPacket);
+
+			if (item.pRecords)
+			{
+				processRecords(NULL, *item.pRecords);
+				MemoryStream::reclaimPoolObject(item.pRecords);
+			}
+		}
+
+		std::map<int, IOChannel*>::iterator citer = pThread->channels.begin();
+		for (; citer != pThread->channels.end(); ++citer)
+		{
+			IOChannel* pIOChannel = citer->second;
+
+			std::vector<TCPPacket*>::iterator piter = pIOChannel->pendingPackets.begin();
+			for (; piter != pIOChannel->pendingPackets.end(); ++piter)
+				TCPPacket::reclaimPoolObject((*piter));
+
+			delete pIOChannel;
+		}
+
+		pThread->channels.clear();
+
+#if KBE_PLATFORM == PLATFORM_UNIX
+		if (pThread->epfd != -1)
+			::close(pThread->epfd);
+#endif
+
+		delete pThread;
+	}
+
+	threads_.clear();
+
+#if KBE_PLATFORM == PLATFORM_UNIX
+	if (pipefds_[0] != -1)
+	{
+		networkInterface_.dispatcher().deregisterReadFileDescriptor(pipefds_[0]);
+		::close(pipefds_[0]);
+		::close(pipefds_[1]);
+		pipefds_[0] = pipefds_[1] = -1;
+	}
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+bool IOThreadPool::initialize(uint32 numThreads)
+{
+	KBE_ASSERT(threads_.empty());
+
+#if KBE_PLATFORM == PLATFORM_UNIX
+	if (::pipe(pipefds_) != 0)
+	{
+		ERROR_MSG(fmt::format("IOThreadPool::initialize: create pipe error({})!\n", kbe_strerror()));
+		pipefds_[0] = pipefds_[1] = -1;
+		return false;
+	}
+
+	for (int i = 0; i < 2; ++i)
+	{
+		::fcntl(pipefds_[i], F_SETFL, ::fcntl(pipefds_[i], F_GETFL) | O_NONBLOCK);
+		::fcntl(pipefds_[i], F_SETFD, FD_CLOEXEC);
+	}
+
+	networkInterface_.dispatcher().registerReadFileDescriptor(pipefds_[0], this);
+
+	// IO߳йְᴴݰϢ ̻߳
+	TCPPacket::ObjPool().enableThreadCache();
+	MemoryStream::ObjPool().enableThreadCache();
+
+	running_ = true;
+
+	for (uint32 i = 0; i < numThreads; ++i)
+	{
+		IOThread* pThread = new IOThread();
+		pThread->pPool = this;
+		pThread->epfd = epoll_create1(EPOLL_CLOEXEC);
+
+		if (pThread->epfd == -1)
+		{
+			ERROR_MSG(fmt::format("IOThreadPool::initialize: epoll_create error({})!\n", kbe_strerror()));
+			delete pThread;
+			return false;
+		}
+
+		if (pthread_create(&pThread->tid, NULL, IOThreadPool::threadFunc, (void*)pThread) != 0)
+		{
+			ERROR_MSG("IOThreadPool::initialize: createThread error!\n");
+			::close(pThread->epfd);
+			delete pThread;
+			return false;
+		}
+
+		threads_.push_back(pThread);
+	}
+
+	INFO_MSG(fmt::format("IOThreadPool::initialize: {} io threads for external channels.\n", numThreads));
+	return true;
+#else
+	ERROR_MSG(fmt::format("IOThreadPool::initialize: io threads({}) are not supported on this platform!\n", numThreads));
+	return false;
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+void IOThreadPool::finalise()
+{
+	if (!running_)
+		return;
+
+	running_ = false;
+
+#if KBE_PLATFORM == PLATFORM_UNIX
+	// ߳ȴһepollʱ ͨб ֮עͨȻҵ
+	std::vector<IOThread*>::iterator iter = threads_.begin();
+	for (; iter != threads_.end(); ++iter)
+	{
+		void* status;
+		pthread_join((*iter)->tid, &status);
+	}
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+IOThreadPool::IOThread* IOThreadPool::findThread(int fd)
+{
+	return threads_[(uint32)fd % threads_.size()];
+}
+
+//-------------------------------------------------------------------------------------
+bool IOThreadPool::registerChannel(Channel* pChannel)
+{
+#if KBE_PLATFORM == PLATFORM_UNIX
+	EndPoint* pEndPoint = pChannel->pEndPoint();
+
+	if (!running_ || threads_.empty() || pEndPoint == NULL || pEndPoint->isSSL())
+		return false;
+
+	int fd = *pEndPoint;
+	IOThread* pThread = findThread(fd);
+
+	IOChannel* pIOChannel = new IOChannel();
+	pIOChannel->pChannel = pChannel;
+	pIOChannel->pEndPoint = pEndPoint;
+
+	{
+		thread::ThreadGuard tg(&pThread->mutex);
+		KBE_ASSERT(pThread->channels.find(fd) == pThread->channels.end());
+		pThread->channels[fd] = pIOChannel;
+	}
+
+	struct epoll_event ev;
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.fd = fd;
+
+	if (epoll_ctl(pThread->epfd, EPOLL_CTL_ADD, fd, &ev) < 0)
+	{
+		ERROR_MSG(fmt::format("IOThreadPool::registerChannel({}): epoll_ctl error({})!\n",
+			pChannel->c_str(), kbe_strerror()));
+
+		// δepoll IO̲߳ȡͨ
+		thread::ThreadGuard tg(&pThread->mutex);
+		pThread->channels.erase(fd);
+		delete pIOChannel;
+		return false;
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+bool IOThreadPool::deregisterChannel(Channel* pChannel)
+{
+#if KBE_PLATFORM == PLATFORM_UNIX
+	EndPoint* pEndPoint = pChannel->pEndPoint();
+
+	if (threads_.empty() || pEndPoint == NULL)
+		return false;
+
+	int fd = *pEndPoint;
+	IOThread* pThread = findThread(fd);
+	IOChannel* pIOChannel = NULL;
+
+	{
+		thread::ThreadGuard tg(&pThread->mutex);
+
+		std::map<int, IOChannel*>::iterator iter = pThread->channels.find(fd);
+		if (iter == pThread->channels.end() || iter->second->pChannel != pChannel)
+			return false;
+
+		pIOChannel = iter->second;
+		pThread->channels.erase(iter);
+	}
+
+	// ͨѾIO߳Ƴepoll ʱصĴԺ
+	epoll_ctl(pThread->epfd, EPOLL_CTL_DEL, fd, NULL);
+
+	// IO̴߳ڶȡݺ󲻻иͨݽУ
+	// δĲ֣ ͨϱ
+	waitIdle(pIOChannel);
+
+	uint32 tail = pThread->tail.load(std::memory_order_acquire);
+	for (uint32 i = pThread->head.load(std::memory_order_relaxed); i != tail; ++i)
+	{
+		Item& item = pThread->items[i & QUEUE_MASK];
+		if (item.pChannel != pChannel)
+			continue;
+
+		if (item.pPacket)
+			TCPPacket::reclaimPoolObject(item.pPacket);
+
+		if (item.pRecords)
+		{
+			processRecords(NULL, *item.pRecords);
+			MemoryStream::reclaimPoolObject(item.pRecords);
+		}
+
+		item.pChannel = NULL;
+		item.pPacket = NULL;
+		item.pRecords = NULL;
+	}
+
+	std::vector<TCPPacket*>::iterator piter = pIOChannel->pendingPackets.begin();
+	for (; piter != pIOChannel->pendingPackets.end(); ++piter)
+		TCPPacket::reclaimPoolObject((*piter));
+
+	delete pIOChannel;
+	return true;
+#else
+	return false;
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+void IOThreadPool::onFilterChanged(Channel* pChannel, PacketFilter* pFilter)
+{
+	EndPoint* pEndPoint = pChannel->pEndPoint();
+
+	if (threads_.empty() || pEndPoint == NULL)
+		return;
+
+	IOThread* pThread = findThread(*pEndPoint);
+	IOChannel* pIOChannel = NULL;
+
+	{
+		thread::ThreadGuard tg(&pThread->mutex);
+
+		std::map<int, IOChannel*>::iterator iter = pThread->channels.find(*pEndPoint);
+		if (iter == pThread->channels.end() || iter->second->pChannel != pChannel)
+			return;
+
+		pIOChannel = iter->second;
+		pIOChannel->pFilter = pFilter;
+	}
+
+	// ɵĹڷغܱͷ
+	waitIdle(pIOChannel);
+}
+
+//-------------------------------------------------------------------------------------
+bool IOThreadPool::deferCondemn(Channel* pChannel, const std::string& reason, bool waitSendCompletedDestroy)
+{
+	Receiver* pReceiver = pCurrentReceiver_;
+	if (pReceiver == NULL || pReceiver->pChannel() != pChannel)
+		return false;
+
+	pReceiver->condemn(reason, waitSendCompletedDestroy);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool IOThreadPool::deferSend(Channel* pChannel, const uint8* data, int size)
+{
+	Receiver* pReceiver = pCurrentReceiver_;
+	if (pReceiver == NULL || pReceiver->pChannel() != pChannel)
+		return false;
+
+	pReceiver->send(data, size);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void IOThreadPool::waitIdle(IOChannel* pIOChannel)
+{
+	// IO̴߳һζȡֻҪ̵ܶʱ
+	while (pIOChannel->inUse.load(std::memory_order_acquire))
+		std::this_thread::yield();
+}
+
+//-------------------------------------------------------------------------------------
+#if KBE_PLATFORM == PLATFORM_WIN32
+unsigned __stdcall IOThreadPool::threadFunc(void* arg)
+#else
+void* IOThreadPool::threadFunc(void* arg)
+#endif
+{
+	IOThread* pThread = static_cast<IOThread*>(arg);
+	pThread->pPool->run(pThread);
+
+#if KBE_PLATFORM == PLATFORM_WIN32
+	return 0;
+#else
+	return NULL;
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+void IOThreadPool::run(IOThread* pThread)
+{
+#if KBE_PLATFORM == PLATFORM_UNIX
+#if ENABLE_WATCHERS
+	// еprofileֻ߳ͳ
+	ScopedProfile::threadEnabled() = false;
+#endif
+
+	const int MAX_EVENTS = 64;
+	struct epoll_event events[MAX_EVENTS];
+	IOChannel* ioChannels[MAX_EVENTS];
+
+	// ûжݵİһʹ
+	TCPPacket* pPacket = NULL;
+	bool stalled = false;
+
+	while (running_)
+	{
+		//  ȴ߳ȡݣ ˮƽ¼һٴη
+		if (stalled)
+		{
+			KBEngine::sleep(1);
+			stalled = false;
+		}
+
+		int nfds = epoll_wait(pThread->epfd, events, MAX_EVENTS, 100);
+
+		if (nfds < 0)
+		{
+			if (errno != EINTR)
+			{
+				ERROR_MSG(fmt::format("IOThreadPool::run: epoll_wait error({})!\n", kbe_strerror()));
+				KBEngine::sleep(1);
+			}
+
+			continue;
+		}
+
+		// ֻȡͨΪʹУ ȡ봦У ߳עͨ
+		int numChannels = 0;
+
+		{
+			thread::ThreadGuard tg(&pThread->mutex);
+
+			for (int i = 0; i < nfds; ++i)
+			{
+				std::map<int, IOChannel*>::iterator iter = pThread->channels.find(events[i].data.fd);
+				if (iter == pThread->channels.end() || iter->second->pEndPoint == NULL)
+					continue;
+
+				iter->second->inUse.store(true, std::memory_order_relaxed);
+				ioChannels[numChannels++] = iter->second;
+			}
+		}
+
+		bool pushed = false;
+
+		for (int i = 0; i < numChannels; ++i)
+		{
+			IOChannel* pIOChannel = ioChannels[i];
+
+			if (!stalled)
+			{
+				if (pThread->tail.load(std::memory_order_relaxed) -
+					pThread->head.load(std::memory_order_acquire) >= QUEUE_SIZE)
+				{
+					stalled = true;
+				}
+				else if (recv(pThread, pIOChannel, pPacket))
+				{
+					pushed = true;
+				}
+			}
+
+			pIOChannel->inUse.store(false, std::memory_order_release);
+		}
+
+		if (pushed)
+			wakeup();
+	}
+
+	if (pPacket)
+		TCPPacket::reclaimPoolObject(pPacket);
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+bool IOThreadPool::recv(IOThread* pThread, IOChannel* pIOChannel, TCPPacket*& pPacket)
+{
+#if KBE_PLATFORM == PLATFORM_UNIX
+	if (pPacket == NULL)
+		pPacket = TCPPacket::createPoolObject(OBJECTPOOL_POINT);
+
+	int len = pPacket->recvFromEndPoint(*pIOChannel->pEndPoint);
+
+	Item item;
+	item.pChannel = pIOChannel->pChannel;
+	item.pPacket = NULL;
+	item.pRecords = NULL;
+	item.error = 0;
+	item.bytes = 0;
+	item.packets = 0;
+
+	if (len <= 0)
+	{
+		if (len < 0)
+		{
+			if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+				return false;
+
+			item.error = errno;
+		}
+
+		// ߳ͨ ڴ֮ǰٶȡ
+		epoll_ctl(pThread->epfd, EPOLL_CTL_DEL, *pIOChannel->pEndPoint, NULL);
+
+		{
+			thread::ThreadGuard tg(&pThread->mutex);
+			pIOChannel->pEndPoint = NULL;
+		}
+
+		return push(pThread, item);
+	}
+
+	TCPPacket* pRecvPacket = pPacket;
+	pPacket = NULL;
+
+	PacketFilter* pFilter = NULL;
+
+	{
+		thread::ThreadGuard tg(&pThread->mutex);
+
+		if (pIOChannel->state == RECV_STATE_RAW)
+		{
+			item.pPacket = pRecvPacket;
+		}
+		else if (pIOChannel->state == RECV_STATE_PENDING)
+		{
+			// ̴߳ʣݰһ
+			pIOChannel->pendingPackets.push_back(pRecvPacket);
+			return false;
+		}
+
+		pFilter = pIOChannel->pFilter;
+	}
+
+	if (item.pPacket)
+		return push(pThread, item);
+
+	// Ѿ¼٣ ̺߳ܿעͨ
+	if (pIOChannel->condemned)
+	{
+		TCPPacket::reclaimPoolObject(pRecvPacket);
+		return false;
+	}
+
+	MemoryStream* pRecords = MemoryStream::createPoolObject(OBJECTPOOL_POINT);
+
+	{
+		Receiver receiver(*pIOChannel, pFilter, *pRecords);
+		Reason ret = receiver.recv(pRecvPacket);
+
+		if (ret != REASON_SUCCESS)
+		{
+			WARNING_MSG(fmt::format("IOThreadPool::recv({}): filter error({})!\n",
+				pIOChannel->pChannel->c_str(), reasonToString(ret)));
+		}
+
+		item.packets = receiver.numPackets();
+	}
+
+	item.pRecords = pRecords;
+	item.bytes = len;
+	return push(pThread, item);
+#else
+	return false;
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+bool IOThreadPool::push(IOThread* pThread, const Item& item)
+{
+	uint32 tail = pThread->tail.load(std::memory_order_relaxed);
+	if (tail - pThread->head.load(std::memory_order_acquire) >= QUEUE_SIZE)
+		return false;
+
+	pThread->items[tail & QUEUE_MASK] = item;
+	pThread->tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void IOThreadPool::wakeup()
+{
+#if KBE_PLATFORM == PLATFORM_UNIX
+	// ̴֮߳ǰֻҪһ
+	if (signalled_.exchange(true))
+		return;
+
+	char c = 0;
+	if (::write(pipefds_[1], &c, 1) < 0 && errno != EAGAIN)
+	{
+		ERROR_MSG(fmt::format("IOThreadPool::wakeup: write error({})!\n", kbe_strerror()));
+	}
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+void IOThreadPool::processPacket(Channel* pChannel, TCPPacket* pPacket)
+{
+	if (pChannel->isDestroyed() || pChannel->condemn() > 0)
+	{
+		TCPPacket::reclaimPoolObject(pPacket);
+		return;
+	}
+
+	Reason ret = pChannel->pPacketReceiver()->processPacket(pChannel, pPacket);
+
+	if (ret != REASON_SUCCESS)
+		networkInterface_.dispatcher().errorReporter().reportException(ret, pChannel->addr());
+}
+
+//-------------------------------------------------------------------------------------
+void IOThreadPool::processRecords(Channel* pChannel, MemoryStream& records)
+{
+	while (records.length() > 0)
+	{
+		// Ϣʱܱͨ٣ ֮ļ¼ֻ
+		bool isGood = pChannel && !pChannel->isDestroyed() && pChannel->condemn() == 0;
+
+		uint8 type;
+		records >> type;
+
+		switch (type)
+		{
+		case RECORD_MESSAGE:
+		case RECORD_STREAM:
+			{
+				uint64 handler;
+				records >> handler;
+				MessageHandler* pMsgHandler = (MessageHandler*)(uintptr_t)handler;
+
+				MemoryStream* pStream = NULL;
+				size_t wpos = records.wpos();
+				size_t frpos = 0;
+				uint32 len = 0;
+
+				if (type == RECORD_STREAM)
+				{
+					uint64 stream;
+					records >> stream;
+					pStream = (MemoryStream*)(uintptr_t)stream;
+				}
+				else
+				{
+					records >> len;
+					frpos = records.rpos() + len;
+
+					// ʱЧȡλ ֹӿ
+					records.wpos(frpos);
+					pStream = &records;
+				}
+
+				if (isGood)
+				{
+					try
+					{
+						TRACE_MESSAGE_PACKET(true, pStream, pMsgHandler, pStream->length(), pChannel->c_str(), type == RECORD_MESSAGE);
+						pMsgHandler->handle(pChannel, *pStream);
+
+						// handlerûдһ
+						if (type == RECORD_MESSAGE && frpos != records.rpos())
+						{
+							WARNING_MSG(fmt::format("IOThreadPool::processRecords({}): rpos({}) invalid, expect={}. msgID={}, msglen={}.\n",
+								pMsgHandler->name.c_str(), records.rpos(), frpos, pMsgHandler->msgID, len));
+						}
+					}
+					catch (MemoryStreamException &)
+					{
+						WARNING_MSG(fmt::format("IOThreadPool::processRecords({}): packet invalid. currMsg=({}, id={}, len={})\n",
+							pChannel->c_str(), pMsgHandler->name, pMsgHandler->msgID, pMsgHandler->msgLen));
+
+						pChannel->condemn("Channel::processPackets: packet invalid!");
+					}
+				}
+
+				if (type == RECORD_STREAM)
+				{
+					MemoryStream::reclaimPoolObject(pStream);
+				}
+				else
+				{
+					records.wpos(wpos);
+					records.rpos(frpos);
+				}
+			}
+			break;
+
+		case RECORD_TRACK:
+			{
+				uint64 handler;
+				uint32 size;
+				records >> handler >> size;
+
+				if (pChannel)
+					NetworkStats::getSingleton().trackMessage(NetworkStats::RECV, *(MessageHandler*)(uintptr_t)handler, size);
+			}
+			break;
+
+		case RECORD_CONDEMN:
+			{
+				std::string reason;
+				uint8 waitSendCompletedDestroy;
+				records >> reason >> waitSendCompletedDestroy;
+
+				if (pChannel && !pChannel->isDestroyed())
+					pChannel->condemn(reason, waitSendCompletedDestroy > 0);
+			}
+			break;
+
+		case RECORD_SEND:
+			{
+				uint32 size;
+				records >> size;
+
+				int sendSize = isGood ? (int)size : 0;
+
+				while (sendSize > 0)
+				{
+					int ret = pChannel->pEndPoint()->send(records.data() + records.rpos() + (size - sendSize), sendSize);
+					if (ret <= 0)
+					{
+						ERROR_MSG(fmt::format("IOThreadPool::processRecords: send({}) error! addr={}, sendSize={}\n",
+							ret, pChannel->c_str(), sendSize));
+
+						break;
+					}
+
+					sendSize -= ret;
+				}
+
+				records.read_skip(size);
+			}
+			break;
+
+		default:
+			KBE_ASSERT(false && "IOThreadPool::processRecords: invalid record!");
+			break;
+		};
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void IOThreadPool::updateRecvState(IOThread* pThread, Channel* pChannel)
+{
+	if (!pChannel->hasHandshake() || pChannel->isDestroyed() || pChannel->condemn() > 0)
+		return;
+
+	EndPoint* pEndPoint = pChannel->pEndPoint();
+	if (pEndPoint == NULL || pEndPoint->isSSL())
+		return;
+
+	IOChannel* pIOChannel = NULL;
+
+	{
+		thread::ThreadGuard tg(&pThread->mutex);
+
+		std::map<int, IOChannel*>::iterator iter = pThread->channels.find(*pEndPoint);
+		if (iter == pThread->channels.end() || iter->second->pChannel != pChannel ||
+			iter->second->state != RECV_STATE_RAW)
+			return;
+
+		pIOChannel = iter->second;
+		pIOChannel->state = RECV_STATE_PENDING;
+	}
+
+	// ȴIO̴߳ڶȡݣ ֮󲻻δ˵ݰ
+	waitIdle(pIOChannel);
+
+	// ְ״̬Ȼ̣߳ Ȱ˳ʣݰ
+	uint32 tail = pThread->tail.load(std::memory_order_acquire);
+	for (uint32 i = pThread->head.load(std::memory_order_relaxed); i != tail; ++i)
+	{
+		Item& item = pThread->items[i & QUEUE_MASK];
+		if (item.pChannel != pChannel || item.pPacket == NULL)
+			continue;
+
+		TCPPacket* pPacket = item.pPacket;
+		item.pChannel = NULL;
+		item.pPacket = NULL;
+
+		processPacket(pChannel, pPacket);
+
+		// Ѿע pIOChannelɾ
+		if (pChannel->isDestroyed())
+			return;
+	}
+
+	// ٴڼIO߳ݴݰ ûʣʱIO߳
+	while (true)
+	{
+		std::vector<TCPPacket*> packets;
+
+		{
+			thread::ThreadGuard tg(&pThread->mutex);
+
+			if (pIOChannel->pendingPackets.empty())
+			{
+				if (pChannel->condemn() == 0)
+				{
+					pIOChannel->pFilter = pChannel->pFilter().get();
+					pIOChannel->pPacketReader = pChannel->pPacketReader();
+					pIOChannel->pMsgHandlers = pChannel->pMsgHandlers() ? pChannel->pMsgHandlers() :
+						MessageHandlers::pMainMessageHandlers;
+
+					pIOChannel->state = RECV_STATE_FRAMING;
+				}
+
+				break;
+			}
+
+			packets.swap(pIOChannel->pendingPackets);
+		}
+
+		std::vector<TCPPacket*>::iterator iter = packets.begin();
+		for (; iter != packets.end(); ++iter)
+		{
+			if (pChannel->isDestroyed())
+			{
+				TCPPacket::reclaimPoolObject((*iter));
+				continue;
+			}
+
+			processPacket(pChannel, (*iter));
+		}
+
+		if (pChannel->isDestroyed())
+			return;
+	}
+}
+
+//-------------------------------------------------------------------------------------
+int IOThreadPool::handleInputNotification(int fd)
+{
+#if KBE_PLATFORM == PLATFORM_UNIX
+	char buf[64];
+	while (::read(fd, buf, sizeof(buf)) > 0) {}
+#endif
+
+	// ȡݣ ֮дݻٴλ߳
+	signalled_.store(false);
+
+	uint32 numPackets = 0;
+
+	std::vector<IOThread*>::iterator iter = threads_.begin();
+	for (; iter != threads_.end(); ++iter)
+	{
+		IOThread* pThread = (*iter);
+
+		while (true)
+		{
+			uint32 head = pThread->head.load(std::memory_order_relaxed);
+			if (head == pThread->tail.load(std::memory_order_acquire))
+				break;
+
+			// Ϣʱעͨ޸ĶʣĲ֣ ȡٴ
+			Item item = pThread->items[head & QUEUE_MASK];
+			pThread->head.store(head + 1, std::memory_order_release);
+
+			Channel* pChannel = item.pChannel;
+			if (pChannel == NULL)
+				continue;
+
+			if (item.pPacket)
+			{
+				++numPackets;
+				processPacket(pChannel, item.pPacket);
+				updateRecvState(pThread, pChannel);
+			}
+			else if (item.pRecords)
+			{
+				numPackets += item.packets;
+
+				if (pChannel->isDestroyed() || pChannel->condemn() > 0)
+				{
+					processRecords(NULL, *item.pRecords);
+				}
+				else
+				{
+					pChannel->onPacketReceived((int)item.bytes);
+
+					for (uint32 i = 0; i < item.packets; ++i)
+						pChannel->trackReceiveWindow();
+
+					AUTO_SCOPED_PROFILE("processRecvMessages");
+					processRecords(pChannel, *item.pRecords);
+				}
+
+				MemoryStream::reclaimPoolObject(item.pRecords);
+			}
+			else
+			{
+				if (pChannel->isDestroyed() || pChannel->condemn() > 0)
+					continue;
+
+				std::string err = "disconnected";
+				if (item.error != 0)
+					err = fmt::format("IOThreadPool::handleInputNotification(): error={}\n", kbe_strerror(item.error));
+
+				pChannel->condemn(err);
+				pChannel->networkInterface().deregisterChannel(pChannel);
+				pChannel->destroy();
+				Network::Channel::reclaimPoolObject(pChannel);
+			}
+		}
+	}
+
+	if (numPackets > 0)
+		NetworkStats::getSingleton().trackIOThreadPackets(numPackets);
+
+	return 0;
+}
+
+}
+}
@@ -0,0 +1,209 @@
+// Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
+
+#ifndef KBE_IO_THREAD_POOL_H
+#define KBE_IO_THREAD_POOL_H
+
+#include "common/common.h"
+#include "common/memorystream.h"
+#include "network/interfaces.h"
+#include "thread/threadmutex.h"
+#include <atomic>
+
+namespace KBEngine {
+namespace Network
+{
+class Channel;
+class EndPoint;
+class NetworkInterface;
+class TCPPacket;
+class PacketFilter;
+class PacketReader;
+class MessageHandlers;
+
+/**
+	ⲿTCPͨ߳(channelCommon/externalIOThreads > 0ʱ Linux)
+	ͨļNIO̡߳ ֮ǰIOֻ߳ȡݣ ݰ̴֣߳
+	ɺ(ܡwebsocket)ϢְҲIOִ߳У ֻ߳յֺõϢϢ
+	űֵ̡߳ ݾÿ߳һĵߵн̣߳ ̡ͨܵ߳
+	Ȼ̣߳ ʹsslͨǰ˻ص̶߳ȡ
+*/
+class IOThreadPool : public InputNotificationHandler
+{
+public:
+	enum
+	{
+		// ÿ̵߳Ķгȣ ʱIO߳ͣȡ
+		QUEUE_SIZE = 4096,
+		QUEUE_MASK = QUEUE_SIZE - 1
+	};
+
+	IOThreadPool(NetworkInterface& networkInterface);
+	virtual ~IOThreadPool();
+
+	bool initialize(uint32 numThreads);
+	void finalise();
+
+	/**
+		IO߳̽ӹͨĶȡ ʧʱɵעᵽ߳
+	*/
+	bool registerChannel(Channel* pChannel);
+
+	/**
+		ͨIO̶߳ȡʱfalse
+		غIO̲߳ٷʸͨ ڸͨݱ
+	*/
+	bool deregisterChannel(Channel* pChannel);
+
+	/**
+		߳滻ͨĹʱã غIO̲߳ʹþɵĹ
+	*/
+	void onFilterChanged(Channel* pChannel, PacketFilter* pFilter);
+
+	/**
+		IO̴߳ͨʱ޸ͨ ͨ뷢ݼ¼ִ߳
+		IO߳ʱfalse ɵֱִ
+	*/
+	static bool deferCondemn(Channel* pChannel, const std::string& reason, bool waitSendCompletedDestroy);
+	static bool deferSend(Channel* pChannel, const uint8* data, int size);
+
+	uint32 numThreads() const { return (uint32)threads_.size(); }
+
+private:
+	enum RecvState
+	{
+		// ֮ǰ IOֻ߳ȡݰ
+		RECV_STATE_RAW = 0,
+
+		// ֣߳ ڴʣݰ IO̶߳ݰݴ
+		RECV_STATE_PENDING = 1,
+
+		// IOִ߳йϢְ
+		RECV_STATE_FRAMING = 2
+	};
+
+	enum RecordType
+	{
+		// Ϣݸڼ¼֮
+		RECORD_MESSAGE = 0,
+
+		// ԽϢ ¼Ϊָ
+		RECORD_STREAM = 1,
+
+		// Ϣͳ
+		RECORD_TRACK = 2,
+
+		RECORD_CONDEMN = 3,
+		RECORD_SEND = 4
+	};
+
+	struct IOChannel
+	{
+		IOChannel();
+
+		Channel* pChannel;
+
+		// ȡΪNULL
+		EndPoint* pEndPoint;
+
+		// mutex
+		RecvState state;
+		std::vector<TCPPacket*> pendingPackets;
+
+		// FRAMING״̬ʹã ߳ɺã ͨ
+		PacketFilter* pFilter;
+		PacketReader* pPacketReader;
+		MessageHandlers* pMsgHandlers;
+
+		// Ѿ¼٣ ֮ݶ ֻIO̷߳
+		bool condemned;
+
+		// IO߳ȡͨʱã ɺ
+		// ߳޸Ĺɾ֮ͨǰȴ
+		std::atomic<bool> inUse;
+	};
+
+	struct Item
+	{
+		Channel* pChannel;
+
+		// ֮ǰݰ
+		TCPPacket* pPacket;
+
+		// ְ֮õϢȼ¼
+		MemoryStream* pRecords;
+
+		// ϶ΪNULLʱʾȡӶϿ errorΪ(ϿΪ0)
+		int error;
+
+		// pRecordsӦȡֽ˺õİ
+		uint32 bytes;
+		uint32 packets;
+	};
+
+	struct IOThread
+	{
+		IOThread();
+
+		IOThreadPool* pPool;
+		THREAD_ID tid;
+		int epfd;
+
+		// channelsIOChannelбĲ֣ ڳʱϵͳ
+		thread::ThreadMutex mutex;
+		std::map<int, IOChannel*> channels;
+
+		// head߳޸ģ tailIO߳޸
+		std::atomic<uint32> head;
+		std::atomic<uint32> tail;
+		Item items[QUEUE_SIZE];
+	};
+
+	class Receiver;
+
+	virtual int handleInputNotification(int fd);
+
+	IOThread* findThread(int fd);
+
+#if KBE_PLATFORM == PLATFORM_WIN32
+	static unsigned __stdcall threadFunc(void* arg);
+#else
+	static void* threadFunc(void* arg);
+#endif
+
+	void run(IOThread* pThread);
+	bool recv(IOThread* pThread, IOChannel* pIOChannel, TCPPacket*& pPacket);
+	bool push(IOThread* pThread, const Item& item);
+	void wakeup();
+
+	static void waitIdle(IOChannel* pIOChannel);
+
+	void processPacket(Channel* pChannel, TCPPacket* pPacket);
+
+	/**
+		pChannelΪNULLʱֻռ¼е
+	*/
+	void processRecords(Channel* pChannel, MemoryStream& records);
+
+	/**
+		̴֮߳ǰݰã ʱְIO߳
+	*/
+	void updateRecvState(IOThread* pThread, Channel* pChannel);
+
+	NetworkInterface& networkInterface_;
+
+	std::vector<IOThread*> threads_;
+
+	// ̵߳Ĺܵ
+	int pipefds_[2];
+	std::atomic<bool> signalled_;
+
+	std::atomic<bool> running_;
+
+	// IO߳ڴͨ
+	static thread_local Receiver* pCurrentReceiver_;
+};
+
+}
+}
+
+#endif // KBE_IO_THREAD_POOL_H
@@ -16,11 +16,34 @@
 #include "network/error_reporter.h"
 #include "network/tcp_packet.h"
 #include "network/udp_packet.h"
+#include "network/network_stats.h"
 
 namespace KBEngine { 
 namespace Network
 {
 
+//-------------------------------------------------------------------------------------
+#if KBE_PLATFORM == PLATFORM_UNIX
+/**
+	等待合并发送的kcp输出， 通道销毁前会先发出所有输出， 因此这里可以直接引用通道
+*/
+struct KCPOutput
+{
+	Channel* pChannel;
+	sockaddr_in sin;
+	size_t offset;
+	size_t length;
+};
+
+// 缓存的输出超过此数量时立即发送
+static const size_t KCP_OUTPUTS_MAX = 256;
+
+static std::vector<KCPOutput> _g_kcpOutputs;
+static std::vector<char> _g_kcpOutputsBuffer;
+static std::vector<struct mmsghdr> _g_kcpOutputsMsgs;
+static std::vector<struct iovec> _g_kcpOutputsIovs;
+#endif
+
 //-------------------------------------------------------------------------------------
 static ObjectPool<KCPPacketSender> _g_objPool("KCPPacketSender");
 ObjectPool<KCPPacketSender>& KCPPacketSender::ObjPool()
@@ -104,6 +127,7 @@ Reason KCPPacketSender::processFilterPacket(Channel* pChannel, Packet * pPacket,
 	{
 		EndPoint* pEndpoint = pChannel->pEndPoint();
 		int retlen = pEndpoint->sendto((void*)(pPacket->data()), pPacket->length());
+		NetworkStats::getSingleton().trackSendSyscall(1);
 		bool sentCompleted = (retlen == (int)pPacket->length());
 
 		if (retlen > 0)
@@ -136,7 +160,31 @@ int KCPPacketSender::kcp_output(const char *buf, int len, ikcpcb *kcp, Channel*
 	//KBE_ASSERT(kcp == pChannel->pKCP());
 
 	EndPoint* pEndpoint = pChannel->pEndPoint();
+
+#if KBE_PLATFORM == PLATFORM_UNIX
+	if (g_vectoredSend)
+	{
+		KCPOutput output;
+		output.pChannel = pChannel;
+		output.sin.sin_family = AF_INET;
+		output.sin.sin_port = pEndpoint->addr().port;
+		output.sin.sin_addr.s_addr = pEndpoint->addr().ip;
+		output.offset = _g_kcpOutputsBuffer.size();
+		output.length = len;
+
+		_g_kcpOutputsBuffer.insert(_g_kcpOutputsBuffer.end(), buf, buf + len);
+		_g_kcpOutputs.push_back(output);
+
+		// 发送的字节数在flushOutputs中sendmmsg返回后再统计
+		if (_g_kcpOutputs.size() >= KCP_OUTPUTS_MAX)
+			flushOutputs();
+
+		return 0;
+	}
+#endif
+
 	int retlen = pEndpoint->sendto((void*)buf, len);
+	NetworkStats::getSingleton().trackSendSyscall(1);
 
 	bool sentCompleted = retlen == len;
 	pChannel->onPacketSent(retlen, sentCompleted);
@@ -145,6 +193,74 @@ int KCPPacketSender::kcp_output(const char *buf, int len, ikcpcb *kcp, Channel*
 	return sentCompleted ? 0 : -1;
 }
 
+//-------------------------------------------------------------------------------------
+void KCPPacketSender::flushOutputs()
+{
+#if KBE_PLATFORM == PLATFORM_UNIX
+	if (_g_kcpOutputs.empty())
+		return;
+
+	size_t size = _g_kcpOutputs.size();
+	_g_kcpOutputsMsgs.resize(size);
+	_g_kcpOutputsIovs.resize(size);
+
+	for (size_t i = 0; i < size; ++i)
+	{
+		KCPOutput& output = _g_kcpOutputs[i];
+
+		struct iovec& iov = _g_kcpOutputsIovs[i];
+		iov.iov_base = &_g_kcpOutputsBuffer[output.offset];
+		iov.iov_len = output.length;
+
+		struct mmsghdr& msg = _g_kcpOutputsMsgs[i];
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_hdr.msg_name = &output.sin;
+		msg.msg_hdr.msg_namelen = sizeof(output.sin);
+		msg.msg_hdr.msg_iov = &iov;
+		msg.msg_hdr.msg_iovlen = 1;
+	}
+
+	// 连续的同一个socket上的输出合并为一次sendmmsg
+	size_t begin = 0;
+	while (begin < size)
+	{
+		// 服务端的kcp通道共用监听的socket， 按socket合并， 使用第一个通道的EndPoint发送
+		EndPoint* pEndPoint = _g_kcpOutputs[begin].pChannel->pEndPoint();
+		KBESOCKET s = pEndPoint->socket();
+
+		size_t end = begin + 1;
+		while (end < size && _g_kcpOutputs[end].pChannel->pEndPoint()->socket() == s)
+			++end;
+
+		while (begin < end)
+		{
+			int sent = pEndPoint->sendmmsg(&_g_kcpOutputsMsgs[begin], (unsigned int)(end - begin));
+
+			// 发送失败的数据直接丢弃，由kcp的重传机制保证可靠性
+			if (sent <= 0)
+			{
+				NetworkStats::getSingleton().trackSendSyscall(1);
+				NetworkStats::getSingleton().trackSendSyscallError((uint32)(end - begin));
+				break;
+			}
+
+			NetworkStats::getSingleton().trackSendSyscall(sent);
+
+			for (int i = 0; i < sent; ++i, ++begin)
+			{
+				KCPOutput& output = _g_kcpOutputs[begin];
+				output.pChannel->onPacketSent((int)output.length, true);
+			}
+		}
+
+		begin = end;
+	}
+
+	_g_kcpOutputs.clear();
+	_g_kcpOutputsBuffer.clear();
+#endif
+}
+
 //-------------------------------------------------------------------------------------
 }
 }
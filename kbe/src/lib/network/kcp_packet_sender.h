@@ -35,6 +35,13 @@ public:
 
 	int kcp_output(const char *buf, int len, ikcpcb *kcp, Channel* pChannel);
 
+	/**
+		所有通道的kcp输出先缓存起来，由EventDispatcher在每轮处理后通过sendmmsg统一发出，
+		同一个socket上的多个通道只需要一次系统调用， 通道的发送统计在发出之后才更新
+		通道清理状态时也会调用， 保证缓存中不会残留已经销毁的通道
+	*/
+	static void flushOutputs();
+
 protected:
 	virtual void onSent(Packet* pPacket);
 	virtual Reason processFilterPacket(Channel* pChannel, Packet * pPacket, int userarg);
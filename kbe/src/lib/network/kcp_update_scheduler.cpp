@@ -0,0 +1,178 @@
+// Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
+
+#include "kcp_update_scheduler.h"
+#include "network/channel.h"
+#include "network/network_stats.h"
+
+namespace KBEngine {
+namespace Network
+{
+
+//-------------------------------------------------------------------------------------
+KCPUpdateScheduler::KCPUpdateScheduler():
+processing_(),
+currTime_(kbe_clock()),
+size_(0)
+{
+}
+
+//-------------------------------------------------------------------------------------
+KCPUpdateScheduler::~KCPUpdateScheduler()
+{
+}
+
+//-------------------------------------------------------------------------------------
+void KCPUpdateScheduler::schedule(Channel* pChannel, uint32 deadline)
+{
+	// 本轮会被更新， 更新后由通道自己重新安排
+	if (pChannel->kcpUpdateBucket_ == BUCKET_PROCESSING)
+		return;
+
+	if (pChannel->kcpUpdateBucket_ != BUCKET_NONE)
+	{
+		if ((int32)(deadline - pChannel->kcpUpdateTime_) >= 0)
+			return;
+
+		remove(pChannel);
+	}
+
+	// kbe_clock会回绕， 时间只能比较差值
+	uint32 bucketTime = deadline;
+	int32 delta = (int32)(deadline - currTime_);
+
+	if (delta < 0)
+		bucketTime = currTime_;
+	else if (delta >= NUM_BUCKETS)
+		bucketTime = currTime_ + NUM_BUCKETS - 1;
+
+	std::vector<Channel*>& bucket = buckets_[bucketTime & BUCKET_MASK];
+
+	pChannel->kcpUpdateBucket_ = (int32)(bucketTime & BUCKET_MASK);
+	pChannel->kcpUpdateIndex_ = (uint32)bucket.size();
+	pChannel->kcpUpdateTime_ = deadline;
+
+	bucket.push_back(pChannel);
+	++size_;
+}
+
+//-------------------------------------------------------------------------------------
+void KCPUpdateScheduler::remove(Channel* pChannel)
+{
+	std::vector<Channel*>& bucket = buckets_[pChannel->kcpUpdateBucket_];
+	KBE_ASSERT(pChannel->kcpUpdateIndex_ < bucket.size() && bucket[pChannel->kcpUpdateIndex_] == pChannel);
+
+	Channel* pBack = bucket.back();
+	bucket[pChannel->kcpUpdateIndex_] = pBack;
+	pBack->kcpUpdateIndex_ = pChannel->kcpUpdateIndex_;
+	bucket.pop_back();
+
+	pChannel->kcpUpdateBucket_ = BUCKET_NONE;
+	--size_;
+}
+
+//-------------------------------------------------------------------------------------
+void KCPUpdateScheduler::deregister(Channel* pChannel)
+{
+	if (pChannel->kcpUpdateBucket_ == BUCKET_NONE)
+		return;
+
+	if (pChannel->kcpUpdateBucket_ == BUCKET_PROCESSING)
+	{
+		processing_[pChannel->kcpUpdateIndex_] = NULL;
+		pChannel->kcpUpdateBucket_ = BUCKET_NONE;
+		return;
+	}
+
+	remove(pChannel);
+}
+
+//-------------------------------------------------------------------------------------
+int KCPUpdateScheduler::process()
+{
+	uint32 now = kbe_clock();
+
+	if (size_ == 0)
+	{
+		currTime_ = now;
+		return 0;
+	}
+
+	// 取出所有到期的槽， 最多转一圈， 超过一圈时所有的槽都已经被取出
+	int steps = 0;
+	while ((int32)(now - currTime_) >= 0 && steps < NUM_BUCKETS)
+	{
+		std::vector<Channel*>& bucket = buckets_[currTime_ & BUCKET_MASK];
+
+		std::vector<Channel*>::iterator iter = bucket.begin();
+		for (; iter != bucket.end(); ++iter)
+		{
+			(*iter)->kcpUpdateBucket_ = BUCKET_PROCESSING;
+			(*iter)->kcpUpdateIndex_ = (uint32)processing_.size();
+			processing_.push_back((*iter));
+		}
+
+		size_ -= bucket.size();
+		bucket.clear();
+
+		++currTime_;
+		++steps;
+	}
+
+	// 当前时间的槽保持打开， 本毫秒内新安排的更新在下一轮处理
+	currTime_ = now;
+
+	int numUpdated = 0;
+	uint64 totalSlippage = 0;
+	uint32 maxSlippage = 0;
+
+	for (size_t i = 0; i < processing_.size(); ++i)
+	{
+		Channel* pChannel = processing_[i];
+		if (pChannel == NULL)
+			continue;
+
+		pChannel->kcpUpdateBucket_ = BUCKET_NONE;
+
+		int32 slippage = (int32)(now - pChannel->kcpUpdateTime_);
+		if (slippage > 0)
+		{
+			totalSlippage += slippage;
+			if ((uint32)slippage > maxSlippage)
+				maxSlippage = slippage;
+		}
+
+		++numUpdated;
+		pChannel->kcpUpdate();
+	}
+
+	processing_.clear();
+
+	if (numUpdated > 0)
+		NetworkStats::getSingleton().trackKcpUpdates(numUpdated, totalSlippage, maxSlippage);
+
+	return numUpdated;
+}
+
+//-------------------------------------------------------------------------------------
+double KCPUpdateScheduler::nextExp() const
+{
+	if (size_ == 0)
+		return -1.0;
+
+	uint32 now = kbe_clock();
+
+	for (uint32 i = 0; i < NUM_BUCKETS; ++i)
+	{
+		uint32 t = currTime_ + i;
+		if (buckets_[t & BUCKET_MASK].empty())
+			continue;
+
+		int32 delta = (int32)(t - now);
+		return delta > 0 ? delta / 1000.0 : 0.0;
+	}
+
+	return -1.0;
+}
+
+}
+}
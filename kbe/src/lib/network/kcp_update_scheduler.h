@@ -0,0 +1,73 @@
+// Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
+
+#ifndef KBE_KCP_UPDATE_SCHEDULER_H
+#define KBE_KCP_UPDATE_SCHEDULER_H
+
+#include "common/common.h"
+
+namespace KBEngine {
+namespace Network
+{
+class Channel;
+
+/**
+	统一调度所有kcp通道的更新(ikcp_update)
+	通道按照下一次需要更新的时间(ikcp_check， kbe_clock毫秒)落入对应的槽中， 每个槽对应1毫秒，
+	EventDispatcher每轮处理时一次性更新所有到期的通道， 不再为每个通道添加与取消定时器。
+	超出槽总跨度的时间会被提前到最后一个槽， 到时重新检查即可。
+*/
+class KCPUpdateScheduler
+{
+public:
+	enum
+	{
+		NUM_BUCKETS = 1024,
+		BUCKET_MASK = NUM_BUCKETS - 1,
+
+		// 通道不在调度器中
+		BUCKET_NONE = -1,
+
+		// 通道已到期， 正在等待本轮更新
+		BUCKET_PROCESSING = NUM_BUCKETS
+	};
+
+	KCPUpdateScheduler();
+	~KCPUpdateScheduler();
+
+	/**
+		在deadline时更新通道， 已经安排了更早的更新则忽略
+	*/
+	void schedule(Channel* pChannel, uint32 deadline);
+
+	void deregister(Channel* pChannel);
+
+	/**
+		更新所有到期的通道， 返回更新的通道数量
+	*/
+	int process();
+
+	/**
+		距离下一次需要更新的时间(秒)， 没有需要更新的通道则返回-1
+	*/
+	double nextExp() const;
+
+	size_t size() const { return size_; }
+
+private:
+	void remove(Channel* pChannel);
+
+	std::vector<Channel*> buckets_[NUM_BUCKETS];
+
+	// 本轮到期的通道， 被注销的通道在这里置为NULL
+	std::vector<Channel*> processing_;
+
+	// 当前槽对应的时间， 之前的槽都已经处理过
+	uint32 currTime_;
+
+	size_t size_;
+};
+
+}
+}
+
+#endif // KBE_KCP_UPDATE_SCHEDULER_H
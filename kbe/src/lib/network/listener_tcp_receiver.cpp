@@ -13,6 +13,7 @@
 #include "network/network_interface.h"
 #include "network/packet_receiver.h"
 #include "network/error_reporter.h"
+#include "network/network_stats.h"
 
 namespace KBEngine { 
 namespace Network
@@ -34,6 +35,7 @@ ListenerTcpReceiver::~ListenerTcpReceiver()
 int ListenerTcpReceiver::handleInputNotification(int fd)
 {
 	int tickcount = 0;
+	uint32 numAccepted = 0;
 
 	while(tickcount ++ < 256)
 	{
@@ -53,6 +55,8 @@ int ListenerTcpReceiver::handleInputNotification(int fd)
 		}
 		else
 		{
+			++numAccepted;
+
 			Channel* pChannel = Network::Channel::createPoolObject(OBJECTPOOL_POINT);
 			bool ret = pChannel->initialize(networkInterface_, pNewEndPoint, traits_);
 			if(!ret)
@@ -62,7 +66,7 @@ int ListenerTcpReceiver::handleInputNotification(int fd)
 
 				pChannel->destroy();
 				Network::Channel::reclaimPoolObject(pChannel);
-				return 0;
+				break;
 			}
 
 			if(!networkInterface_.registerChannel(pChannel))
@@ -76,6 +80,9 @@ int ListenerTcpReceiver::handleInputNotification(int fd)
 		}
 	}
 
+	if (numAccepted > 0)
+		NetworkStats::getSingleton().trackAccepts(numAccepted);
+
 	return 0;
 }
 
@@ -26,6 +26,8 @@ msgID_(1),
 exposedMessages_(),
 name_(name)
 {
+	memset(handlerPages_, 0, sizeof(handlerPages_));
+
 	g_fm = Network::FixedMessages::getSingletonPtr();
 	if(g_fm == NULL)
 		g_fm = new Network::FixedMessages;
@@ -44,16 +46,23 @@ MessageHandlers::~MessageHandlers()
 		if(iter->second)
 			delete iter->second;
 	};
+
+	for (int i = 0; i < HANDLER_PAGE_COUNT; ++i)
+	{
+		SAFE_RELEASE_ARRAY(handlerPages_[i]);
+	}
 }
 
 //-------------------------------------------------------------------------------------
 MessageHandler::MessageHandler():
 pArgs(NULL),
-pMessageHandlers(NULL),
 send_size(0),
 send_count(0),
 recv_size(0),
-recv_count(0)
+recv_count(0),
+compress_size(0),
+compressed_size(0),
+pMessageHandlers(NULL)
 {
 }
 
@@ -119,10 +128,13 @@ bool MessageHandlers::initializeWatcher()
 		WATCH_OBJECT(buf, iter->second, &MessageHandler::recvsize);
 
 		kbe_snprintf(buf, MAX_BUF * 2, "network/messages/%s/recvCount", sname.c_str());
-		WATCH_OBJECT(buf, iter->second, &MessageHandler::recvsize);
+		WATCH_OBJECT(buf, iter->second, &MessageHandler::recvcount);
 
 		kbe_snprintf(buf, MAX_BUF * 2, "network/messages/%s/recvAvgSize", sname.c_str());
 		WATCH_OBJECT(buf, iter->second, &MessageHandler::recvavgsize);
+
+		kbe_snprintf(buf, MAX_BUF * 2, "network/messages/%s/compressRatio", sname.c_str());
+		WATCH_OBJECT(buf, iter->second, &MessageHandler::compressratio);
 	}
 
 	return true;
@@ -174,6 +186,7 @@ MessageHandler* MessageHandlers::add(std::string ihName, MessageArgs* args,
 	msgHandler->onInstall();
 
 	msgHandlers_[msgHandler->msgID] = msgHandler;
+	addToHandlerPages(msgHandler);
 	
 	if(msgLen == NETWORK_VARIABLE_MESSAGE)
 	{
@@ -349,15 +362,17 @@ std::string MessageHandlers::getDigestStr()
 }
 
 //-------------------------------------------------------------------------------------
-MessageHandler* MessageHandlers::find(MessageID msgID)
+void MessageHandlers::addToHandlerPages(MessageHandler* msgHandler)
 {
-	MessageHandlerMap::iterator iter = msgHandlers_.find(msgID);
-	if(iter != msgHandlers_.end())
+	MessageHandler**& pPage = handlerPages_[msgHandler->msgID >> HANDLER_PAGE_BITS];
+
+	if (pPage == NULL)
 	{
-		return iter->second;
-	};
-	
-	return NULL;
+		pPage = new MessageHandler*[HANDLER_PAGE_SIZE];
+		memset(pPage, 0, sizeof(MessageHandler*) * HANDLER_PAGE_SIZE);
+	}
+
+	pPage[msgHandler->msgID & HANDLER_PAGE_MASK] = msgHandler;
 }
 
 //-------------------------------------------------------------------------------------
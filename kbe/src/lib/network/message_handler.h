@@ -53,18 +53,24 @@ public:
 	MessageHandler();
 	virtual ~MessageHandler();
 
-	std::string name;
+	// ɷͳʱʵĳԱһ ͬһcache line
 	MessageID msgID;
-	MessageArgs* pArgs;
 	int32 msgLen;					// Ϊ-1Ϊǹ̶Ϣ
-	bool exposed;
-	MessageHandlers* pMessageHandlers;
+	MessageArgs* pArgs;
 
 	// stats
-	volatile mutable uint32 send_size;
-	volatile mutable uint32 send_count;
-	volatile mutable uint32 recv_size;
-	volatile mutable uint32 recv_count;
+	mutable uint32 send_size;
+	mutable uint32 send_count;
+	mutable uint32 recv_size;
+	mutable uint32 recv_count;
+
+	// ѹǰֽ
+	mutable uint32 compress_size;
+	mutable uint32 compressed_size;
+
+	bool exposed;
+	MessageHandlers* pMessageHandlers;
+	std::string name;
 
 	uint32 sendsize() const  { return send_size; }
 	uint32 sendcount() const  { return send_count; }
@@ -74,6 +80,9 @@ public:
 	uint32 recvcount() const  { return recv_count; }
 	uint32 recvavgsize() const  { return (recv_count <= 0) ? 0 : recv_size / recv_count; }
 
+	// ѹĴСռѹǰİٷֱ
+	uint32 compressratio() const  { return (compress_size <= 0) ? 100 : (uint32)((uint64)compressed_size * 100 / compress_size); }
+
 	/**
 		ĬϷΪϢ
 	*/
@@ -112,7 +121,14 @@ public:
 	
 	bool pushExposedMessage(std::string msgname);
 
-	MessageHandler* find(MessageID msgID);
+	/**
+		ϢIDֱhandler Ϣɷ·
+	*/
+	MessageHandler* find(MessageID msgID) const
+	{
+		MessageHandler** pPage = handlerPages_[msgID >> HANDLER_PAGE_BITS];
+		return pPage ? pPage[msgID & HANDLER_PAGE_MASK] : NULL;
+	}
 	
 	MessageID lastMsgID() {return msgID_ - 1;}
 
@@ -130,7 +146,23 @@ public:
 	}
 
 private:
+	void addToHandlerPages(MessageHandler* msgHandler);
+
+private:
+	enum
+	{
+		HANDLER_PAGE_BITS = 8,
+		HANDLER_PAGE_SIZE = 1 << HANDLER_PAGE_BITS,
+		HANDLER_PAGE_MASK = HANDLER_PAGE_SIZE - 1,
+		HANDLER_PAGE_COUNT = (1 << (sizeof(MessageID) * 8)) >> HANDLER_PAGE_BITS
+	};
+
 	MessageHandlerMap msgHandlers_;
+
+	// ϢID󲿷Сֵ ̶ϢIDֲڼϴ䣬
+	// ˰λҳ ֻΪõҳֱ
+	MessageHandler** handlerPages_[HANDLER_PAGE_COUNT];
+
 	MessageID msgID_;
 
 	std::vector< std::string > exposedMessages_;
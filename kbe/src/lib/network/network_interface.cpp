@@ -14,6 +14,7 @@
 #include "network/channel.h"
 #include "network/packet.h"
 #include "network/delayed_channels.h"
+#include "network/io_thread_pool.h"
 #include "network/interfaces.h"
 #include "network/message_handler.h"
 
@@ -38,10 +39,25 @@ NetworkInterface::NetworkInterface(Network::EventDispatcher * pDispatcher,
 	pDelayedChannels_(new DelayedChannels()),
 	pChannelTimeOutHandler_(NULL),
 	pChannelDeregisterHandler_(NULL),
-	numExtChannels_(0)
+	numExtChannels_(0),
+	pIOThreadPool_(NULL),
+	numExtTcpListeners_(1),
+	extTcpListeners_(),
+	pChannelBackpressureHandler_(NULL)
 {
 	if(extlisteningTcpPort_min != -1)
 	{
+		numExtTcpListeners_ = g_extTcpListeners > 0 ? g_extTcpListeners : std::max(g_extIOThreads, (uint32)1);
+
+		// ˿ڷΧʱ̹ͬһ˿ڣ ̶ֻ˿
+		if (numExtTcpListeners_ > 1 && extlisteningTcpPort_min != extlisteningTcpPort_max)
+		{
+			WARNING_MSG(fmt::format("NetworkInterface::NetworkInterface: externalListeners({}) requires a fixed external port(port_min == port_max), "
+				"using a single listener!\n", numExtTcpListeners_));
+
+			numExtTcpListeners_ = 1;
+		}
+
 		pExtListenerReceiver_ = new ListenerTcpReceiver(extTcpEndpoint_, Channel::EXTERNAL, *this);
 
 		this->initialize("EXTERNAL-TCP", htons(extlisteningTcpPort_min), htons(extlisteningTcpPort_max),
@@ -53,6 +69,11 @@ NetworkInterface::NetworkInterface(Network::EventDispatcher * pDispatcher,
 			KBE_ASSERT(extTcpEndpoint_.good() && "Channel::EXTERNAL-TCP: no available port, "
 				"please check for kbengine[_defs].xml!\n");
 		}
+
+		if (numExtTcpListeners_ > 1)
+		{
+			this->initializeExtTcpListeners(extTcpEndpoint_.addr().port, extlisteningInterface, extrbuffer, extwbuffer);
+		}
 	}
 
 	if (extlisteningUdpPort_min != -1)
@@ -82,11 +103,26 @@ NetworkInterface::NetworkInterface(Network::EventDispatcher * pDispatcher,
 		"please check for kbengine[_defs].xml!\n");
 
 	pDelayedChannels_->init(this->dispatcher(), this);
+
+	if (pExtListenerReceiver_ && g_extIOThreads > 0)
+	{
+		pIOThreadPool_ = new IOThreadPool(*this);
+
+		if (!pIOThreadPool_->initialize(g_extIOThreads))
+		{
+			ERROR_MSG("NetworkInterface::NetworkInterface: create io threads failed, external channels will be received on the main thread!\n");
+			SAFE_RELEASE(pIOThreadPool_);
+		}
+	}
 }
 
 //-------------------------------------------------------------------------------------
 NetworkInterface::~NetworkInterface()
 {
+	// ֹͣIỌ߳ ͨʱȻҪע
+	if (pIOThreadPool_)
+		pIOThreadPool_->finalise();
+
 	ChannelMap::iterator iter = channelMap_.begin();
 	while (iter != channelMap_.end())
 	{
@@ -100,6 +136,8 @@ NetworkInterface::~NetworkInterface()
 
 	this->closeSocket();
 
+	SAFE_RELEASE(pIOThreadPool_);
+
 	if (pDispatcher_ != NULL)
 	{
 		pDelayedChannels_->fini(this->dispatcher());
@@ -109,6 +147,15 @@ NetworkInterface::~NetworkInterface()
 	SAFE_RELEASE(pDelayedChannels_);
 	SAFE_RELEASE(pExtListenerReceiver_);
 	SAFE_RELEASE(pIntListenerReceiver_);
+
+	std::vector< std::pair<EndPoint*, ListenerReceiver*> >::iterator listenerIter = extTcpListeners_.begin();
+	for (; listenerIter != extTcpListeners_.end(); ++listenerIter)
+	{
+		delete listenerIter->second;
+		delete listenerIter->first;
+	}
+
+	extTcpListeners_.clear();
 }
 
 //-------------------------------------------------------------------------------------
@@ -131,6 +178,64 @@ void NetworkInterface::closeSocket()
 		this->dispatcher().deregisterReadFileDescriptor(intTcpEndpoint_);
 		intTcpEndpoint_.close();
 	}
+
+	std::vector< std::pair<EndPoint*, ListenerReceiver*> >::iterator iter = extTcpListeners_.begin();
+	for (; iter != extTcpListeners_.end(); ++iter)
+	{
+		if (iter->first->good())
+		{
+			this->dispatcher().deregisterReadFileDescriptor(*iter->first);
+			iter->first->close();
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------
+bool NetworkInterface::isExtTcpListener(const EndPoint* pEP) const
+{
+	if (pEP == &extTcpEndpoint_)
+		return true;
+
+	std::vector< std::pair<EndPoint*, ListenerReceiver*> >::const_iterator iter = extTcpListeners_.begin();
+	for (; iter != extTcpListeners_.end(); ++iter)
+	{
+		if (iter->first == pEP)
+			return true;
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+bool NetworkInterface::initializeExtTcpListeners(uint16 listeningPort, const char * listeningInterface, 
+	uint32 rbuffer, uint32 wbuffer)
+{
+	// еļsocket󶨵ͬһ˿ڣ ں˽ӷɢԵļ
+	for (uint32 i = 1; i < numExtTcpListeners_; ++i)
+	{
+		EndPoint* pEP = new EndPoint();
+		ListenerReceiver* pLR = new ListenerTcpReceiver(*pEP, Channel::EXTERNAL, *this);
+		extTcpListeners_.push_back(std::make_pair(pEP, pLR));
+
+		if (!this->initialize("EXTERNAL-TCP", listeningPort, listeningPort,
+			listeningInterface, pEP, pLR, rbuffer, wbuffer))
+		{
+			ERROR_MSG(fmt::format("NetworkInterface::initializeExtTcpListeners: create listener {} failed, {} listeners in use!\n",
+				i, i));
+
+			extTcpListeners_.pop_back();
+			delete pLR;
+			delete pEP;
+
+			numExtTcpListeners_ = i;
+			return false;
+		}
+	}
+
+	INFO_MSG(fmt::format("NetworkInterface::initializeExtTcpListeners: {} listeners on port {}.\n",
+		numExtTcpListeners_, ntohs(listeningPort)));
+
+	return true;
 }
 
 //-------------------------------------------------------------------------------------
@@ -167,6 +272,18 @@ bool NetworkInterface::initialize(const char* pEndPointName, uint16 listeningPor
 	
 	if (listeningPort_min > 0 && listeningPort_min == listeningPort_max)
 		pEP->setreuseaddr(true);
+
+	// ⲿTCPsocketͬһ˿ڣ bind֮ǰ
+	if (isTCP && numExtTcpListeners_ > 1 && isExtTcpListener(pEP))
+	{
+		if (pEP->setreuseport(true) != 0)
+		{
+			WARNING_MSG(fmt::format("NetworkInterface::initialize({}): SO_REUSEPORT is not supported({}), using a single listener!\n",
+				pEndPointName, kbe_strerror()));
+
+			numExtTcpListeners_ = 1;
+		}
+	}
 	
 	this->dispatcher().registerReadFileDescriptor(*pEP, pLR);
 	
@@ -225,6 +342,7 @@ bool NetworkInterface::initialize(const char* pEndPointName, uint16 listeningPor
 		ERROR_MSG(fmt::format("NetworkInterface::initialize({}): Couldn't bind the socket to {}:{} ({})\n",
 			pEndPointName, inet_ntoa((struct in_addr&)ifIPAddr), ntohs(listeningPort), kbe_strerror()));
 		
+		this->dispatcher().deregisterReadFileDescriptor(*pEP);
 		pEP->close();
 		return false;
 	}
@@ -249,6 +367,7 @@ bool NetworkInterface::initialize(const char* pEndPointName, uint16 listeningPor
 		{
 			ERROR_MSG(fmt::format("NetworkInterface::initialize({}): Couldn't determine ip addr of default interface\n", pEndPointName));
 
+			this->dispatcher().deregisterReadFileDescriptor(*pEP);
 			pEP->close();
 			return false;
 		}
@@ -287,6 +406,7 @@ bool NetworkInterface::initialize(const char* pEndPointName, uint16 listeningPor
 			ERROR_MSG(fmt::format("NetworkInterface::initialize({}): listen to {} ({})\n",
 				pEndPointName, address.c_str(), kbe_strerror()));
 
+			this->dispatcher().deregisterReadFileDescriptor(*pEP);
 			pEP->close();
 			return false;
 		}
@@ -428,6 +548,13 @@ void NetworkInterface::onChannelTimeOut(Channel * pChannel)
 	}
 }
 
+//-------------------------------------------------------------------------------------
+void NetworkInterface::onChannelBackpressure(Channel * pChannel, bool isBackpressure)
+{
+	if (pChannelBackpressureHandler_)
+		pChannelBackpressureHandler_->onChannelBackpressure(pChannel, isBackpressure);
+}
+
 //-------------------------------------------------------------------------------------
 void NetworkInterface::processChannels(KBEngine::Network::MessageHandlers* pMsgHandlers)
 {
@@ -18,11 +18,13 @@ class Bundle;
 class Channel;
 class ChannelTimeOutHandler;
 class ChannelDeregisterHandler;
+class ChannelBackpressureHandler;
 class DelayedChannels;
 class ListenerReceiver;
 class Packet;
 class EventDispatcher;
 class MessageHandlers;
+class IOThreadPool;
 
 class NetworkInterface : public TimerHandler
 {
@@ -60,8 +62,16 @@ public:
 	void pChannelDeregisterHandler(ChannelDeregisterHandler * pHandler)
 		{ pChannelDeregisterHandler_ = pHandler; }
 
+	ChannelBackpressureHandler * pChannelBackpressureHandler() const
+		{ return pChannelBackpressureHandler_; }
+	void pChannelBackpressureHandler(ChannelBackpressureHandler * pHandler)
+		{ pChannelBackpressureHandler_ = pHandler; }
+
 	EventDispatcher & dispatcher()		{ return *pDispatcher_; }
 
+	/* ⲿ̣ͨ߳ δʱΪNULL */
+	IOThreadPool * pIOThreadPool() const	{ return pIOThreadPool_; }
+
 	/* ⲿڲ */
 	EndPoint & extEndpoint()				{ return extTcpEndpoint_; }
 	EndPoint & intEndpoint()				{ return intTcpEndpoint_; }
@@ -77,6 +87,7 @@ public:
 	bool good() const{ return (!pExtListenerReceiver_ || extTcpEndpoint_.good()) && (intTcpEndpoint_.good()); }
 
 	void onChannelTimeOut(Channel * pChannel);
+	void onChannelBackpressure(Channel * pChannel, bool isBackpressure);
 	
 	/* 
 		channels  
@@ -90,6 +101,10 @@ private:
 
 	void closeSocket();
 
+	bool isExtTcpListener(const EndPoint* pEP) const;
+	bool initializeExtTcpListeners(uint16 listeningPort, const char * listeningInterface, 
+		uint32 rbuffer, uint32 wbuffer);
+
 private:
 	EndPoint								extTcpEndpoint_, extUdpEndpoint_, intTcpEndpoint_;
 
@@ -107,6 +122,14 @@ private:
 	ChannelDeregisterHandler *				pChannelDeregisterHandler_;
 
 	int32									numExtChannels_;
+
+	IOThreadPool *							pIOThreadPool_;
+
+	// ⲿTCPsocket 1ʱextTcpEndpoint_֮ļsocketextTcpListeners_
+	uint32									numExtTcpListeners_;
+	std::vector< std::pair<EndPoint*, ListenerReceiver*> >	extTcpListeners_;
+
+	ChannelBackpressureHandler *			pChannelBackpressureHandler_;
 };
 
 }
@@ -16,7 +16,33 @@ NetworkStats g_networkStats;
 //-------------------------------------------------------------------------------------
 NetworkStats::NetworkStats():
 stats_(),
-handlers_()
+handlers_(),
+numSendSyscalls_(0),
+numSendSyscallsSaved_(0),
+numSendSyscallErrors_(0),
+numSendPacketsDropped_(0),
+numRecvSyscalls_(0),
+numRecvSyscallsSaved_(0),
+numKcpUpdates_(0),
+numKcpUpdateBatches_(0),
+kcpUpdateSlippage_(0),
+kcpUpdateMaxSlippage_(0),
+numIOThreadPackets_(0),
+numIOThreadWakeups_(0),
+numAccepted_(0),
+maxAcceptBatch_(0),
+numCompressBytes_(0),
+numCompressedBytes_(0),
+numFragmentBytesCopied_(0),
+numFragmentMessages_(0),
+numBroadcasts_(0),
+numBroadcastChannels_(0),
+numBroadcastBytes_(0),
+numWebSocketPayloadBytes_(0),
+numWebSocketCopiedBytes_(0),
+numSendBackpressures_(0),
+numBackpressuredChannels_(0),
+maxSendQueueBytes_(0)
 {
 }
 
@@ -45,6 +71,165 @@ void NetworkStats::removeHandler(NetworkStatsHandler* pHandler)
 	}
 }
 
+//-------------------------------------------------------------------------------------
+void NetworkStats::trackSendSyscall(uint32 packets)
+{
+	++numSendSyscalls_;
+
+	if (packets > 1)
+		numSendSyscallsSaved_ += packets - 1;
+}
+
+//-------------------------------------------------------------------------------------
+void NetworkStats::trackSendSyscallError(uint32 packets)
+{
+	++numSendSyscallErrors_;
+	numSendPacketsDropped_ += packets;
+}
+
+//-------------------------------------------------------------------------------------
+void NetworkStats::trackRecvSyscall(uint32 packets)
+{
+	++numRecvSyscalls_;
+
+	if (packets > 1)
+		numRecvSyscallsSaved_ += packets - 1;
+}
+
+//-------------------------------------------------------------------------------------
+void NetworkStats::trackKcpUpdates(uint32 channels, uint64 totalSlippage, uint32 maxSlippage)
+{
+	++numKcpUpdateBatches_;
+	numKcpUpdates_ += channels;
+	kcpUpdateSlippage_ += totalSlippage;
+
+	if (maxSlippage > kcpUpdateMaxSlippage_)
+		kcpUpdateMaxSlippage_ = maxSlippage;
+}
+
+//-------------------------------------------------------------------------------------
+void NetworkStats::trackIOThreadPackets(uint32 packets)
+{
+	++numIOThreadWakeups_;
+	numIOThreadPackets_ += packets;
+}
+
+//-------------------------------------------------------------------------------------
+void NetworkStats::trackAccepts(uint32 count)
+{
+	numAccepted_ += count;
+
+	if (count > maxAcceptBatch_)
+		maxAcceptBatch_ = count;
+}
+
+//-------------------------------------------------------------------------------------
+void NetworkStats::trackCompression(const MessageHandler* pMsgHandler, uint32 size, uint32 compressedSize)
+{
+	numCompressBytes_ += size;
+	numCompressedBytes_ += compressedSize;
+
+	if (pMsgHandler)
+	{
+		pMsgHandler->compress_size += size;
+		pMsgHandler->compressed_size += compressedSize;
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void NetworkStats::trackBroadcast(uint32 channels, size_t bytes)
+{
+	++numBroadcasts_;
+	numBroadcastChannels_ += channels;
+	numBroadcastBytes_ += bytes * channels;
+}
+
+//-------------------------------------------------------------------------------------
+void NetworkStats::trackWebSocketPayload(size_t size, bool copied)
+{
+	numWebSocketPayloadBytes_ += size;
+
+	if(copied)
+		numWebSocketCopiedBytes_ += size;
+}
+
+//-------------------------------------------------------------------------------------
+void NetworkStats::trackSendBackpressure(bool isBackpressure)
+{
+	if(isBackpressure)
+	{
+		++numSendBackpressures_;
+		++numBackpressuredChannels_;
+	}
+	else if(numBackpressuredChannels_ > 0)
+	{
+		--numBackpressuredChannels_;
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void NetworkStats::trackSendQueueBytes(uint32 bytes)
+{
+	if(bytes > maxSendQueueBytes_)
+		maxSendQueueBytes_ = bytes;
+}
+
+//-------------------------------------------------------------------------------------
+static uint64 readTcpExtStat(const char* name)
+{
+#if KBE_PLATFORM == PLATFORM_UNIX
+	// TcpExtֵγ
+	FILE* fp = fopen("/proc/net/netstat", "r");
+	if (fp == NULL)
+		return 0;
+
+	char names[4096], values[4096];
+	uint64 result = 0;
+
+	while (fgets(names, sizeof(names), fp) && fgets(values, sizeof(values), fp))
+	{
+		if (strncmp(names, "TcpExt:", 7) != 0 || strncmp(values, "TcpExt:", 7) != 0)
+			continue;
+
+		char* pNameSave = NULL;
+		char* pValueSave = NULL;
+		char* pName = strtok_r(names + 7, " \n", &pNameSave);
+		char* pValue = strtok_r(values + 7, " \n", &pValueSave);
+
+		while (pName && pValue)
+		{
+			if (strcmp(pName, name) == 0)
+			{
+				result = strtoull(pValue, NULL, 10);
+				break;
+			}
+
+			pName = strtok_r(NULL, " \n", &pNameSave);
+			pValue = strtok_r(NULL, " \n", &pValueSave);
+		}
+
+		break;
+	}
+
+	fclose(fp);
+	return result;
+#else
+	return 0;
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+uint64 NetworkStats::listenOverflows() const
+{
+	return readTcpExtStat("ListenOverflows");
+}
+
+//-------------------------------------------------------------------------------------
+uint64 NetworkStats::listenDrops() const
+{
+	return readTcpExtStat("ListenDrops");
+}
+
 //-------------------------------------------------------------------------------------
 void NetworkStats::trackMessage(S_OP op, const MessageHandler& msgHandler, uint32 size)
 {
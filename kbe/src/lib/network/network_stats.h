@@ -6,6 +6,7 @@
 #include "network/interfaces.h"
 #include "common/common.h"
 #include "common/singleton.h"
+#include <atomic>
 
 namespace KBEngine { 
 namespace Network
@@ -54,10 +55,150 @@ public:
 	void addHandler(NetworkStatsHandler* pHandler);
 	void removeHandler(NetworkStatsHandler* pHandler);
 
+	/**
+		¼һηصϵͳã packetsΪε÷İ
+		ϲʱʡpackets - 1ϵͳ
+	*/
+	void trackSendSyscall(uint32 packets);
+
+	uint64 numSendSyscalls() const { return numSendSyscalls_; }
+	uint64 numSendSyscallsSaved() const { return numSendSyscallsSaved_; }
+
+	/**
+		¼һʧܵķϵͳã packetsΪ˱İ
+	*/
+	void trackSendSyscallError(uint32 packets);
+
+	uint64 numSendSyscallErrors() const { return numSendSyscallErrors_; }
+	uint64 numSendPacketsDropped() const { return numSendPacketsDropped_; }
+
+	/**
+		¼һνصϵͳã packetsΪεöİ
+	*/
+	void trackRecvSyscall(uint32 packets);
+
+	uint64 numRecvSyscalls() const { return numRecvSyscalls_; }
+	uint64 numRecvSyscallsSaved() const { return numRecvSyscallsSaved_; }
+
+	/**
+		¼һkcpͨĸ£ slippageΪʵʸʱԤʱĺ
+	*/
+	void trackKcpUpdates(uint32 channels, uint64 totalSlippage, uint32 maxSlippage);
+
+	uint64 numKcpUpdates() const { return numKcpUpdates_; }
+	uint64 numKcpUpdateBatches() const { return numKcpUpdateBatches_; }
+	uint64 kcpUpdateSlippage() const { return kcpUpdateSlippage_; }
+	uint32 kcpUpdateMaxSlippage() const { return kcpUpdateMaxSlippage_; }
+
+	/**
+		¼һ̴߳IO߳ȡݰ
+	*/
+	void trackIOThreadPackets(uint32 packets);
+
+	uint64 numIOThreadPackets() const { return numIOThreadPackets_; }
+	uint64 numIOThreadWakeups() const { return numIOThreadWakeups_; }
+
+	/**
+		¼һμsocketϽܵ
+	*/
+	void trackAccepts(uint32 count);
+
+	uint64 numAccepted() const { return numAccepted_; }
+	uint32 maxAcceptBatch() const { return maxAcceptBatch_; }
+
+	/**
+		ϵͳ붪(Linux /proc/net/netstat ϵͳۼֵ)
+	*/
+	uint64 listenOverflows() const;
+	uint64 listenDrops() const;
+
+	/**
+		¼һѹ еϢ(߿ԽϢ)ͳƵϢ
+	*/
+	void trackCompression(const MessageHandler* pMsgHandler, uint32 size, uint32 compressedSize);
+
+	uint64 numCompressBytes() const { return numCompressBytes_; }
+	uint64 numCompressedBytes() const { return numCompressedBytes_; }
+
+	/**
+		¼ԽϢʱֽ ԼɵϢ
+	*/
+	void trackFragmentCopy(size_t bytes) { numFragmentBytesCopied_ += bytes; }
+	void trackFragmentMessage() { ++numFragmentMessages_; }
+
+	uint64 numFragmentBytesCopied() const { return numFragmentBytesCopied_; }
+	uint64 numFragmentMessages() const { return numFragmentMessages_; }
+
+	/**
+		¼һһԶ෢ͣ һͨͨʡȥһα
+	*/
+	void trackBroadcast(uint32 channels, size_t bytes);
+
+	uint64 numBroadcasts() const { return numBroadcasts_; }
+	uint64 numBroadcastChannels() const { return numBroadcastChannels_; }
+	uint64 numBroadcastBytes() const { return numBroadcastBytes_; }
+
+	/**
+		¼websocket֡غɽ copiedΪǷ񿽱µİ
+	*/
+	void trackWebSocketPayload(size_t size, bool copied);
+
+	uint64 numWebSocketPayloadBytes() const { return numWebSocketPayloadBytes_; }
+	uint64 numWebSocketCopiedBytes() const { return numWebSocketCopiedBytes_; }
+
+	/**
+		ͨݳˮλ(isBackpressureΪtrue)䵽ˮλ
+	*/
+	void trackSendBackpressure(bool isBackpressure);
+	void trackSendQueueBytes(uint32 bytes);
+
+	uint64 numSendBackpressures() const { return numSendBackpressures_; }
+	uint32 numBackpressuredChannels() const { return numBackpressuredChannels_; }
+	uint32 maxSendQueueBytes() const { return maxSendQueueBytes_; }
+
 private:
 	STATS stats_;
 
 	std::vector<NetworkStatsHandler*> handlers_;
+
+	uint64 numSendSyscalls_;
+	uint64 numSendSyscallsSaved_;
+	uint64 numSendSyscallErrors_;
+	uint64 numSendPacketsDropped_;
+
+	uint64 numRecvSyscalls_;
+	uint64 numRecvSyscallsSaved_;
+
+	uint64 numKcpUpdates_;
+	uint64 numKcpUpdateBatches_;
+	uint64 kcpUpdateSlippage_;
+	uint32 kcpUpdateMaxSlippage_;
+
+	uint64 numIOThreadPackets_;
+	uint64 numIOThreadWakeups_;
+
+	uint64 numAccepted_;
+	uint32 maxAcceptBatch_;
+
+	uint64 numCompressBytes_;
+	uint64 numCompressedBytes_;
+
+	// ¼Ҳ߳ۼ
+	std::atomic<uint64> numFragmentBytesCopied_;
+	std::atomic<uint64> numFragmentMessages_;
+
+	uint64 numBroadcasts_;
+	uint64 numBroadcastChannels_;
+	uint64 numBroadcastBytes_;
+
+	std::atomic<uint64> numWebSocketPayloadBytes_;
+	std::atomic<uint64> numWebSocketCopiedBytes_;
+
+	uint64 numSendBackpressures_;
+	uint32 numBackpressuredChannels_;
+
+	// ˮλͨдݵķֵ
+	uint32 maxSendQueueBytes_;
 };
 
 }
@@ -34,6 +34,7 @@ public:
 	isTCPPacket_(isTCPPacket),
 	encrypted_(false),
 	pBundle_(NULL),
+	sharers_(0),
 	sentSize(0)
 	{
 	};
@@ -51,7 +52,7 @@ public:
 	virtual size_t getPoolObjectBytes()
 	{
 		size_t bytes = sizeof(msgID_) + sizeof(isTCPPacket_) + sizeof(encrypted_) + sizeof(pBundle_)
-		 + sizeof(sentSize);
+		 + sizeof(sharers_) + sizeof(sentSize);
 
 		return MemoryStream::getPoolObjectBytes() + bytes;
 	}
@@ -70,6 +71,7 @@ public:
 		sentSize = 0;
 		msgID_ = 0;
 		pBundle_ = NULL;
+		sharers_ = 0;
 		// memset(data(), 0, size());
 	};
 	
@@ -86,12 +88,38 @@ public:
 
 	void encrypted(bool v) { encrypted_ = v; }
 
+	/**
+		㲥ʱͬһbundle sharers_Ϊһ֮ĳ
+		ʹRefCountableü PacketPtrĹ
+		İٱ޸(sentSize) Ҫ޸ʱɳ߻˽еĿ
+	*/
+	bool isShared() const { return sharers_ > 0; }
+
+	void addSharer() { ++sharers_; }
+
+	/**
+		߷ trueʱĳߣ 
+	*/
+	bool releaseShared()
+	{
+		if (sharers_ > 0)
+		{
+			--sharers_;
+			return false;
+		}
+
+		return true;
+	}
+
 protected:
 	MessageID msgID_;
 	bool isTCPPacket_;
 	bool encrypted_;
 	Bundle* pBundle_;
 
+	// 㲥ʱ⹲bundle ֻ߳޸
+	uint32 sharers_;
+
 public:
 	uint32 sentSize;
 
@@ -12,14 +12,14 @@ namespace Network
 
 //-------------------------------------------------------------------------------------
 PacketReader::PacketReader(Channel* pChannel):
-	pFragmentDatas_(NULL),
 	pFragmentDatasWpos_(0),
 	pFragmentDatasRemain_(0),
 	fragmentDatasFlag_(FRAGMENT_DATA_UNKNOW),
 	pFragmentStream_(NULL),
 	currMsgID_(0),
 	currMsgLen_(0),
-	pChannel_(pChannel)
+	pChannel_(pChannel),
+	pSink_(NULL)
 {
 }
 
@@ -38,8 +38,7 @@ void PacketReader::reset()
 	pFragmentDatasRemain_ = 0;
 	currMsgID_ = 0;
 	currMsgLen_ = 0;
-	
-	SAFE_RELEASE_ARRAY(pFragmentDatas_);
+
 	MemoryStream::reclaimPoolObject(pFragmentStream_);
 	pFragmentStream_ = NULL;
 }
@@ -47,7 +46,8 @@ void PacketReader::reset()
 //-------------------------------------------------------------------------------------
 void PacketReader::processMessages(KBEngine::Network::MessageHandlers* pMsgHandlers, Packet* pPacket)
 {
-	while(pPacket->length() > 0 || pFragmentStream_ != NULL)
+	// pFragmentStream_Ϣ֮ǰҲΪNULL ֮fragmentDatasFlag_
+	while(pPacket->length() > 0 || (pFragmentStream_ != NULL && fragmentDatasFlag_ == FRAGMENT_DATA_UNKNOW))
 	{
 		if(fragmentDatasFlag_ == FRAGMENT_DATA_UNKNOW)
 		{
@@ -110,8 +110,7 @@ void PacketReader::processMessages(KBEngine::Network::MessageHandlers* pMsgHandl
 						(*pPacket) >> currlen;
 						currMsgLen_ = currlen;
 
-						NetworkStats::getSingleton().trackMessage(NetworkStats::RECV, *pMsgHandler, 
-							currMsgLen_ + NETWORK_MESSAGE_ID_SIZE + NETWORK_MESSAGE_LENGTH_SIZE);
+						trackMessage(pMsgHandler, currMsgLen_ + NETWORK_MESSAGE_ID_SIZE + NETWORK_MESSAGE_LENGTH_SIZE);
 
 						// ռ˵ʹչȣǻҪȴչϢ
 						if(currMsgLen_ == NETWORK_MESSAGE_MAX_SIZE)
@@ -127,8 +126,7 @@ void PacketReader::processMessages(KBEngine::Network::MessageHandlers* pMsgHandl
 								// ˴չϢ
 								(*pPacket) >> currMsgLen_;
 
-								NetworkStats::getSingleton().trackMessage(NetworkStats::RECV, *pMsgHandler, 
-									currMsgLen_ + NETWORK_MESSAGE_ID_SIZE + NETWORK_MESSAGE_LENGTH1_SIZE);
+								trackMessage(pMsgHandler, currMsgLen_ + NETWORK_MESSAGE_ID_SIZE + NETWORK_MESSAGE_LENGTH1_SIZE);
 							}
 						}
 					}
@@ -137,8 +135,7 @@ void PacketReader::processMessages(KBEngine::Network::MessageHandlers* pMsgHandl
 				{
 					currMsgLen_ = pMsgHandler->msgLen;
 
-					NetworkStats::getSingleton().trackMessage(NetworkStats::RECV, *pMsgHandler, 
-						currMsgLen_ + NETWORK_MESSAGE_LENGTH_SIZE);
+					trackMessage(pMsgHandler, currMsgLen_ + NETWORK_MESSAGE_LENGTH_SIZE);
 				}
 			}
 
@@ -166,9 +163,18 @@ void PacketReader::processMessages(KBEngine::Network::MessageHandlers* pMsgHandl
 
 			if(pFragmentStream_ != NULL)
 			{
-				TRACE_MESSAGE_PACKET(true, pFragmentStream_, pMsgHandler, currMsgLen_, pChannel_->c_str(), false);
-				pMsgHandler->handle(pChannel_, *pFragmentStream_);
-				MemoryStream::reclaimPoolObject(pFragmentStream_);
+				if(pSink_)
+				{
+					// ɽ߻
+					pSink_->onMessage(pMsgHandler, pFragmentStream_, currMsgLen_, true);
+				}
+				else
+				{
+					TRACE_MESSAGE_PACKET(true, pFragmentStream_, pMsgHandler, currMsgLen_, pChannel_->c_str(), false);
+					pMsgHandler->handle(pChannel_, *pFragmentStream_);
+					MemoryStream::reclaimPoolObject(pFragmentStream_);
+				}
+
 				pFragmentStream_ = NULL;
 			}
 			else
@@ -179,6 +185,14 @@ void PacketReader::processMessages(KBEngine::Network::MessageHandlers* pMsgHandl
 					break;
 				}
 
+				if(pSink_)
+				{
+					pSink_->onMessage(pMsgHandler, pPacket, currMsgLen_, false);
+					currMsgID_ = 0;
+					currMsgLen_ = 0;
+					continue;
+				}
+
 				// ʱЧȡλ ֹӿ
 				size_t wpos = pPacket->wpos();
 				// size_t rpos = pPacket->rpos();
@@ -213,22 +227,47 @@ void PacketReader::processMessages(KBEngine::Network::MessageHandlers* pMsgHandl
 	}
 }
 
+//-------------------------------------------------------------------------------------
+void PacketReader::trackMessage(MessageHandler* pMsgHandler, uint32 size)
+{
+	if(pSink_)
+		pSink_->onTrackMessage(pMsgHandler, size);
+	else
+		NetworkStats::getSingleton().trackMessage(NetworkStats::RECV, *pMsgHandler, size);
+}
+
 //-------------------------------------------------------------------------------------
 void PacketReader::writeFragmentMessage(FragmentDataTypes fragmentDatasFlag, Packet* pPacket, uint32 datasize)
 {
-	KBE_ASSERT(pFragmentDatas_ == NULL);
+	KBE_ASSERT(fragmentDatasFlag_ == FRAGMENT_DATA_UNKNOW && pFragmentStream_ == NULL);
 
 	size_t opsize = pPacket->length();
 	pFragmentDatasRemain_ = datasize - opsize;
-	pFragmentDatas_ = new uint8[opsize + pFragmentDatasRemain_ + 1];
 
 	fragmentDatasFlag_ = fragmentDatasFlag;
 	pFragmentDatasWpos_ = opsize;
 
-	if(pPacket->length() > 0)
+	if(fragmentDatasFlag == FRAGMENT_DATA_MESSAGE_BODY)
+	{
+		// Ϣݰһη䣬 İֱ׷ӵ
+		pFragmentStream_ = MemoryStream::createPoolObject(OBJECTPOOL_POINT);
+		pFragmentStream_->reserve(datasize);
+
+		if(opsize > 0)
+			pFragmentStream_->append(pPacket->data() + pPacket->rpos(), opsize);
+	}
+	else
+	{
+		KBE_ASSERT(datasize <= sizeof(fragmentHeaderDatas_));
+
+		if(opsize > 0)
+			memcpy(fragmentHeaderDatas_, pPacket->data() + pPacket->rpos(), opsize);
+	}
+
+	if(opsize > 0)
 	{
-		memcpy(pFragmentDatas_, pPacket->data() + pPacket->rpos(), opsize);
 		pPacket->done();
+		NetworkStats::getSingleton().trackFragmentCopy(opsize);
 	}
 
 	//DEBUG_MSG(fmt::format("PacketReader::writeFragmentMessage({}): channel[{:p}], fragmentDatasFlag={}, remainsize={}, currMsgID={}, currMsgLen={}.\n", 
@@ -242,53 +281,53 @@ void PacketReader::mergeFragmentMessage(Packet* pPacket)
 	if(opsize == 0)
 		return;
 
-	if(pPacket->length() >= pFragmentDatasRemain_)
-	{
-		memcpy(pFragmentDatas_ + pFragmentDatasWpos_, pPacket->data() + pPacket->rpos(), pFragmentDatasRemain_);
-		pPacket->rpos(pPacket->rpos() + pFragmentDatasRemain_);
+	size_t copysize = KBE_MIN(opsize, (size_t)pFragmentDatasRemain_);
 
-		KBE_ASSERT(pFragmentStream_ == NULL);
+	if(fragmentDatasFlag_ == FRAGMENT_DATA_MESSAGE_BODY)
+		pFragmentStream_->append(pPacket->data() + pPacket->rpos(), copysize);
+	else
+		memcpy(fragmentHeaderDatas_ + pFragmentDatasWpos_, pPacket->data() + pPacket->rpos(), copysize);
 
-		switch(fragmentDatasFlag_)
-		{
-		case FRAGMENT_DATA_MESSAGE_ID:			// ϢIDϢȫ
-			memcpy(&currMsgID_, pFragmentDatas_, NETWORK_MESSAGE_ID_SIZE);
-			break;
+	pPacket->rpos(pPacket->rpos() + copysize);
+	pFragmentDatasRemain_ -= copysize;
+	pFragmentDatasWpos_ += copysize;
+
+	NetworkStats::getSingleton().trackFragmentCopy(copysize);
+
+	if(pFragmentDatasRemain_ > 0)
+	{
+		//DEBUG_MSG(fmt::format("PacketReader::mergeFragmentMessage({}): channel[{:p}], fragmentDatasFlag={}, remainsize={}, currMsgID={}, currMsgLen={}.\n",
+		//	pChannel_->c_str(), (void*)pChannel_, fragmentDatasFlag_, pFragmentDatasRemain_, currMsgID_, currMsgLen_));
+		return;
+	}
 
-		case FRAGMENT_DATA_MESSAGE_LENGTH:		// ϢϢȫ
-			memcpy(&currMsgLen_, pFragmentDatas_, NETWORK_MESSAGE_LENGTH_SIZE);
-			break;
+	switch(fragmentDatasFlag_)
+	{
+	case FRAGMENT_DATA_MESSAGE_ID:			// ϢIDϢȫ
+		memcpy(&currMsgID_, fragmentHeaderDatas_, NETWORK_MESSAGE_ID_SIZE);
+		break;
 
-		case FRAGMENT_DATA_MESSAGE_LENGTH1:		// ϢϢȫ
-			memcpy(&currMsgLen_, pFragmentDatas_, NETWORK_MESSAGE_LENGTH1_SIZE);
-			break;
+	case FRAGMENT_DATA_MESSAGE_LENGTH:		// ϢϢȫ
+		memcpy(&currMsgLen_, fragmentHeaderDatas_, NETWORK_MESSAGE_LENGTH_SIZE);
+		break;
 
-		case FRAGMENT_DATA_MESSAGE_BODY:		// ϢϢȫ
-			pFragmentStream_ = MemoryStream::createPoolObject(OBJECTPOOL_POINT);
-			pFragmentStream_->append(pFragmentDatas_, currMsgLen_);
-			break;
+	case FRAGMENT_DATA_MESSAGE_LENGTH1:		// ϢϢȫ
+		memcpy(&currMsgLen_, fragmentHeaderDatas_, NETWORK_MESSAGE_LENGTH1_SIZE);
+		break;
 
-		default:
-			break;
-		};
+	case FRAGMENT_DATA_MESSAGE_BODY:		// ϢϢȫ pFragmentStream_Ѿ processMessagesɷ
+		NetworkStats::getSingleton().trackFragmentMessage();
+		break;
 
-		//DEBUG_MSG(fmt::format("PacketReader::mergeFragmentMessage({}): channel[{:p}], fragmentDatasFlag={}, currMsgID={}, currMsgLen={}, completed!\n", 
-		//	pChannel_->c_str(), (void*)pChannel_, fragmentDatasFlag_, currMsgID_, currMsgLen_));
+	default:
+		break;
+	};
 
-		fragmentDatasFlag_ = FRAGMENT_DATA_UNKNOW;
-		pFragmentDatasRemain_ = 0;
-		SAFE_RELEASE_ARRAY(pFragmentDatas_);
-	}
-	else
-	{
-		memcpy(pFragmentDatas_ + pFragmentDatasWpos_, pPacket->data(), opsize);
-		pFragmentDatasRemain_ -= opsize;
-		pFragmentDatasWpos_ += opsize;
-		pPacket->rpos(pPacket->rpos() + opsize);
+	//DEBUG_MSG(fmt::format("PacketReader::mergeFragmentMessage({}): channel[{:p}], fragmentDatasFlag={}, currMsgID={}, currMsgLen={}, completed!\n", 
+	//	pChannel_->c_str(), (void*)pChannel_, fragmentDatasFlag_, currMsgID_, currMsgLen_));
 
-		//DEBUG_MSG(fmt::format("PacketReader::mergeFragmentMessage({}): channel[{:p}], fragmentDatasFlag={}, remainsize={}, currMsgID={}, currMsgLen={}.\n",
-		//	pChannel_->c_str(), (void*)pChannel_, fragmentDatasFlag_, pFragmentDatasRemain_, currMsgID_, currMsgLen_));
-	}	
+	fragmentDatasFlag_ = FRAGMENT_DATA_UNKNOW;
+	pFragmentDatasWpos_ = 0;
 }
 
 //-------------------------------------------------------------------------------------
@@ -11,8 +11,25 @@ namespace KBEngine{
 namespace Network
 {
 class Channel;
+class MessageHandler;
 class MessageHandlers;
 
+/*
+	ְõϢĽߣ ߳ʹã Ϣͳƽ̴߳
+*/
+class MessageSink
+{
+public:
+	virtual ~MessageSink() {}
+
+	/**
+		pStreamĶȡλΪϢݵĿʼ ʱԽlenֽڵϢ
+		isFragmentΪtrueʱpStreamΪԽϢ ɽ߸
+	*/
+	virtual void onMessage(MessageHandler* pMsgHandler, MemoryStream* pStream, uint32 len, bool isFragment) = 0;
+	virtual void onTrackMessage(MessageHandler* pMsgHandler, uint32 size) = 0;
+};
+
 class PacketReader
 {
 public:
@@ -38,6 +55,11 @@ public:
 
 	virtual PacketReader::PACKET_READER_TYPE type()const { return PACKET_READER_TYPE_SOCKET; }
 
+	/**
+		úϢֱӴǽpSink
+	*/
+	void pMessageSink(MessageSink* pSink) { pSink_ = pSink; }
+	MessageSink* pMessageSink() const { return pSink_; }
 
 protected:
 	enum FragmentDataTypes
@@ -52,8 +74,11 @@ protected:
 	virtual void writeFragmentMessage(FragmentDataTypes fragmentDatasFlag, Packet* pPacket, uint32 datasize);
 	virtual void mergeFragmentMessage(Packet* pPacket);
 
+	void trackMessage(MessageHandler* pMsgHandler, uint32 size);
+
 protected:
-	uint8*						pFragmentDatas_;
+	// ϢID볤Ϣ ϢֱдpFragmentStream_ ֻһ
+	uint8						fragmentHeaderDatas_[NETWORK_MESSAGE_ID_SIZE + NETWORK_MESSAGE_LENGTH1_SIZE];
 	uint32						pFragmentDatasWpos_;
 	uint32						pFragmentDatasRemain_;
 	FragmentDataTypes			fragmentDatasFlag_;
@@ -63,6 +88,8 @@ protected:
 	Network::MessageLength1		currMsgLen_;
 	
 	Channel*					pChannel_;
+
+	MessageSink*				pSink_;
 };
 
 
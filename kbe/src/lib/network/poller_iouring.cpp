@@ -0,0 +1,585 @@
+// Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
+
+
+#include "poller_iouring.h"
+#include "helper/profile.h"
+
+#ifdef HAS_IO_URING
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace KBEngine {
+
+#ifdef HAS_IO_URING
+extern ProfileVal g_idleProfile;
+
+namespace Network
+{
+
+// 取消请求的完成事件不需要处理
+static const uint64 IGNORE_USER_DATA = ~(uint64)0;
+
+enum
+{
+	DIR_READ = 0,
+	DIR_WRITE = 1
+};
+
+//-------------------------------------------------------------------------------------
+static int io_uring_setup(uint32 entries, struct io_uring_params* p)
+{
+	return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+//-------------------------------------------------------------------------------------
+static int io_uring_enter(int fd, uint32 toSubmit, uint32 minComplete, uint32 flags, void* arg, size_t argsz)
+{
+	return (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg, argsz);
+}
+
+//-------------------------------------------------------------------------------------
+IOUringPoller::IOUringPoller(uint32 entries) :
+	ringfd_(-1),
+	sqRingPtr_(MAP_FAILED),
+	sqRingSize_(0),
+	sqHead_(NULL),
+	sqTail_(NULL),
+	sqMask_(0),
+	sqArray_(NULL),
+	sqes_((struct io_uring_sqe*)MAP_FAILED),
+	sqesSize_(0),
+	cqRingPtr_(MAP_FAILED),
+	cqRingSize_(0),
+	cqHead_(NULL),
+	cqTail_(NULL),
+	cqMask_(0),
+	cqes_(NULL),
+	numPendingSqes_(0),
+	generation_(0),
+	fdStates_(),
+	queuedReads_(),
+	recvPackets_(),
+	completions_()
+{
+	if (!setup(entries))
+	{
+		release();
+	}
+}
+
+//-------------------------------------------------------------------------------------
+IOUringPoller::~IOUringPoller()
+{
+	release();
+
+	// io_uring关闭时未完成的recv请求都已被取消， 它们的包可以回收了
+	RECV_PACKETS::iterator iter = recvPackets_.begin();
+	for (; iter != recvPackets_.end(); ++iter)
+		TCPPacket::reclaimPoolObject(iter->second);
+
+	recvPackets_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+bool IOUringPoller::setup(uint32 entries)
+{
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+
+	ringfd_ = io_uring_setup(entries, &params);
+	if (ringfd_ < 0)
+	{
+		ringfd_ = -1;
+
+		WARNING_MSG(fmt::format("IOUringPoller::setup: io_uring_setup failed: {}\n",
+			kbe_strerror()));
+
+		return false;
+	}
+
+	// 等待时需要通过扩展参数指定超时时间
+	if (!(params.features & IORING_FEAT_EXT_ARG))
+	{
+		WARNING_MSG("IOUringPoller::setup: kernel does not support IORING_FEAT_EXT_ARG!\n");
+		return false;
+	}
+
+	sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(uint32);
+	cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	completions_.reserve(params.cq_entries);
+
+	bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (singleMmap)
+	{
+		sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+	}
+
+	sqRingPtr_ = mmap(NULL, sqRingSize_, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_POPULATE, ringfd_, IORING_OFF_SQ_RING);
+
+	if (sqRingPtr_ == MAP_FAILED)
+	{
+		ERROR_MSG(fmt::format("IOUringPoller::setup: mmap sq ring failed: {}\n",
+			kbe_strerror()));
+
+		return false;
+	}
+
+	if (singleMmap)
+	{
+		cqRingPtr_ = sqRingPtr_;
+	}
+	else
+	{
+		cqRingPtr_ = mmap(NULL, cqRingSize_, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, ringfd_, IORING_OFF_CQ_RING);
+
+		if (cqRingPtr_ == MAP_FAILED)
+		{
+			ERROR_MSG(fmt::format("IOUringPoller::setup: mmap cq ring failed: {}\n",
+				kbe_strerror()));
+
+			return false;
+		}
+	}
+
+	sqesSize_ = params.sq_entries * sizeof(struct io_uring_sqe);
+	sqes_ = (struct io_uring_sqe*)mmap(NULL, sqesSize_, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_POPULATE, ringfd_, IORING_OFF_SQES);
+
+	if (sqes_ == MAP_FAILED)
+	{
+		ERROR_MSG(fmt::format("IOUringPoller::setup: mmap sqes failed: {}\n",
+			kbe_strerror()));
+
+		return false;
+	}
+
+	char* sq = (char*)sqRingPtr_;
+	sqHead_ = (uint32*)(sq + params.sq_off.head);
+	sqTail_ = (uint32*)(sq + params.sq_off.tail);
+	sqMask_ = *(uint32*)(sq + params.sq_off.ring_mask);
+	sqArray_ = (uint32*)(sq + params.sq_off.array);
+
+	char* cq = (char*)cqRingPtr_;
+	cqHead_ = (uint32*)(cq + params.cq_off.head);
+	cqTail_ = (uint32*)(cq + params.cq_off.tail);
+	cqMask_ = *(uint32*)(cq + params.cq_off.ring_mask);
+	cqes_ = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void IOUringPoller::release()
+{
+	if (sqes_ != MAP_FAILED)
+	{
+		munmap(sqes_, sqesSize_);
+		sqes_ = (struct io_uring_sqe*)MAP_FAILED;
+	}
+
+	if (cqRingPtr_ != MAP_FAILED && cqRingPtr_ != sqRingPtr_)
+	{
+		munmap(cqRingPtr_, cqRingSize_);
+	}
+
+	cqRingPtr_ = MAP_FAILED;
+
+	if (sqRingPtr_ != MAP_FAILED)
+	{
+		munmap(sqRingPtr_, sqRingSize_);
+		sqRingPtr_ = MAP_FAILED;
+	}
+
+	if (ringfd_ != -1)
+	{
+		close(ringfd_);
+		ringfd_ = -1;
+	}
+}
+
+//-------------------------------------------------------------------------------------
+uint64 IOUringPoller::makeUserData(int fd, int dir, uint32 generation)
+{
+	return ((uint64)generation << 33) | ((uint64)dir << 32) | (uint64)(uint32)fd;
+}
+
+//-------------------------------------------------------------------------------------
+uint32 IOUringPoller::nextGeneration()
+{
+	generation_ = (generation_ + 1) & 0x7fffffff;
+	if (generation_ == 0)
+		generation_ = 1;
+
+	return generation_;
+}
+
+//-------------------------------------------------------------------------------------
+struct io_uring_sqe* IOUringPoller::getSqe()
+{
+	uint32 tail = *sqTail_;
+
+	// 队列已满则先提交已填写的请求
+	if (tail - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE) > sqMask_)
+	{
+		submitAndWait(0.0);
+
+		if (tail - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE) > sqMask_)
+			return NULL;
+	}
+
+	uint32 index = tail & sqMask_;
+	struct io_uring_sqe* sqe = &sqes_[index];
+	memset(sqe, 0, sizeof(*sqe));
+
+	sqArray_[index] = index;
+	__atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+	++numPendingSqes_;
+
+	return sqe;
+}
+
+//-------------------------------------------------------------------------------------
+void IOUringPoller::arm(int fd, FDState& state, int dir)
+{
+	// 读请求在提交前才填写， 见prepareQueuedReads
+	if (dir == DIR_READ)
+	{
+		if (!state.readQueued)
+		{
+			state.readQueued = true;
+			queuedReads_.push_back(std::make_pair(fd, state.generation[dir]));
+		}
+
+		state.armed[dir] = true;
+		return;
+	}
+
+	struct io_uring_sqe* sqe = getSqe();
+	if (sqe == NULL)
+	{
+		ERROR_MSG(fmt::format("IOUringPoller::arm: submission queue is full, fd={}\n", fd));
+		return;
+	}
+
+	sqe->opcode = IORING_OP_POLL_ADD;
+	sqe->fd = fd;
+	sqe->poll32_events = POLLOUT;
+	sqe->user_data = makeUserData(fd, dir, state.generation[dir]);
+
+	state.armed[dir] = true;
+}
+
+//-------------------------------------------------------------------------------------
+void IOUringPoller::prepareQueuedReads()
+{
+	size_t i = 0;
+	for (; i < queuedReads_.size(); ++i)
+	{
+		int fd = queuedReads_[i].first;
+		uint32 generation = queuedReads_[i].second;
+
+		// 登记之后已经注销或者重新注册过
+		FD_STATES::iterator iter = fdStates_.find(fd);
+		if (iter == fdStates_.end() || !iter->second.readQueued || iter->second.generation[DIR_READ] != generation)
+			continue;
+
+		FDState& state = iter->second;
+
+		struct io_uring_sqe* sqe = getSqe();
+		if (sqe == NULL)
+		{
+			ERROR_MSG(fmt::format("IOUringPoller::prepareQueuedReads: submission queue is full, fd={}\n", fd));
+			break;
+		}
+
+		state.readQueued = false;
+
+		uint64 userData = makeUserData(fd, DIR_READ, generation);
+		InputNotificationHandler* pHandler = this->findForRead(fd);
+
+		if (pHandler && pHandler->acceptsRecvCompletion())
+		{
+			TCPPacket* pPacket = TCPPacket::createPoolObject(OBJECTPOOL_POINT);
+
+			sqe->opcode = IORING_OP_RECV;
+			sqe->fd = fd;
+			sqe->addr = (uint64)(uintptr)(pPacket->data() + pPacket->wpos());
+			sqe->len = (uint32)(pPacket->size() - pPacket->wpos());
+
+			recvPackets_[userData] = pPacket;
+		}
+		else
+		{
+			sqe->opcode = IORING_OP_POLL_ADD;
+			sqe->fd = fd;
+			sqe->poll32_events = POLLIN;
+		}
+
+		sqe->user_data = userData;
+	}
+
+	// 提交队列已满时剩下的留到下一轮
+	queuedReads_.erase(queuedReads_.begin(), queuedReads_.begin() + i);
+}
+
+//-------------------------------------------------------------------------------------
+bool IOUringPoller::doRegister(int fd, bool isRead, bool isRegister)
+{
+	if (!isGood())
+		return false;
+
+	int dir = isRead ? DIR_READ : DIR_WRITE;
+
+	if (isRegister)
+	{
+		FDState& state = fdStates_[fd];
+		if (state.wanted[dir])
+			return true;
+
+		state.wanted[dir] = true;
+		state.generation[dir] = nextGeneration();
+		arm(fd, state, dir);
+		return true;
+	}
+
+	FD_STATES::iterator iter = fdStates_.find(fd);
+	if (iter == fdStates_.end() || !iter->second.wanted[dir])
+		return true;
+
+	FDState& state = iter->second;
+
+	state.wanted[dir] = false;
+
+	if (dir == DIR_READ && state.readQueued)
+	{
+		// 还没有提交， 丢弃即可
+		state.readQueued = false;
+	}
+	else if (state.armed[dir])
+	{
+		uint64 userData = makeUserData(fd, dir, state.generation[dir]);
+
+		struct io_uring_sqe* sqe = getSqe();
+		if (sqe)
+		{
+			sqe->opcode = (recvPackets_.find(userData) != recvPackets_.end()) ?
+				IORING_OP_ASYNC_CANCEL : IORING_OP_POLL_REMOVE;
+
+			sqe->fd = -1;
+			sqe->addr = userData;
+			sqe->user_data = IGNORE_USER_DATA;
+		}
+	}
+
+	state.armed[dir] = false;
+
+	// 被取消的请求的完成事件将被忽略
+	state.generation[dir] = 0;
+
+	if (!state.wanted[DIR_READ] && !state.wanted[DIR_WRITE])
+		fdStates_.erase(iter);
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+int IOUringPoller::submitAndWait(double maxWait)
+{
+	uint32 toSubmit = numPendingSqes_;
+	int ret = 0;
+
+	if (maxWait <= 0.0)
+	{
+		if (toSubmit == 0)
+			return 0;
+
+		ret = io_uring_enter(ringfd_, toSubmit, 0, 0, NULL, 0);
+	}
+	else
+	{
+		struct __kernel_timespec ts;
+		ts.tv_sec = (int64)maxWait;
+		ts.tv_nsec = (int64)((maxWait - (double)ts.tv_sec) * 1000000000.0);
+
+		struct io_uring_getevents_arg arg;
+		memset(&arg, 0, sizeof(arg));
+		arg.ts = (uint64)(uintptr)&ts;
+
+		ret = io_uring_enter(ringfd_, toSubmit, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+			&arg, sizeof(arg));
+	}
+
+	// 返回值为实际提交的数量， 失败(例如EBUSY)或者只提交了一部分时剩下的请求仍在队列中， 下次再提交
+	if (ret > 0)
+		numPendingSqes_ -= std::min((uint32)ret, toSubmit);
+
+	return ret;
+}
+
+//-------------------------------------------------------------------------------------
+void IOUringPoller::onRecvCompleted(int fd, TCPPacket* pPacket, int32 res)
+{
+	if (res > 0)
+	{
+		pPacket->wpos((int)(pPacket->wpos() + res));
+	}
+	else
+	{
+		TCPPacket::reclaimPoolObject(pPacket);
+		pPacket = NULL;
+
+		// 没有数据也没有错误， 重新提交即可
+		if (res == -ECANCELED || res == -EAGAIN || res == -EINTR)
+			return;
+	}
+
+	InputNotificationHandler* pHandler = this->findForRead(fd);
+	if (pHandler == NULL)
+	{
+		if (pPacket)
+			TCPPacket::reclaimPoolObject(pPacket);
+
+		return;
+	}
+
+	pHandler->handleRecvCompletion(fd, pPacket, res);
+}
+
+//-------------------------------------------------------------------------------------
+int IOUringPoller::processPendingEvents(double maxWait)
+{
+	if (!isGood())
+		return -1;
+
+	prepareQueuedReads();
+
+	// 已经有完成事件时不需要等待
+	if (__atomic_load_n(cqTail_, __ATOMIC_ACQUIRE) != *cqHead_)
+		maxWait = 0.0;
+
+#if ENABLE_WATCHERS
+	g_idleProfile.start();
+#else
+	uint64 startTime = timestamp();
+#endif
+
+	KBEConcurrency::onStartMainThreadIdling();
+	int ret = submitAndWait(maxWait);
+	KBEConcurrency::onEndMainThreadIdling();
+
+#if ENABLE_WATCHERS
+	g_idleProfile.stop();
+	spareTime_ += g_idleProfile.lastTime_;
+#else
+	spareTime_ += timestamp() - startTime;
+#endif
+
+	if (ret < 0 && errno != ETIME && errno != EINTR && errno != EBUSY)
+	{
+		ERROR_MSG(fmt::format("IOUringPoller::processPendingEvents: io_uring_enter failed: {}\n",
+			kbe_strerror()));
+	}
+
+	// 先取出所有的完成事件， 回调中可能提交新的请求
+	// 交换到局部变量中处理， 复用缓冲区的同时回调中重入也不会破坏正在遍历的数据
+	COMPLETIONS completions;
+	completions.swap(completions_);
+	completions.clear();
+
+	uint32 head = *cqHead_;
+	uint32 tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+
+	for (; head != tail; ++head)
+	{
+		struct io_uring_cqe* cqe = &cqes_[head & cqMask_];
+		if (cqe->user_data != IGNORE_USER_DATA)
+			completions.push_back(std::make_pair((uint64)cqe->user_data, (int32)cqe->res));
+	}
+
+	__atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+
+	int nevents = 0;
+
+	COMPLETIONS::iterator iter = completions.begin();
+	for (; iter != completions.end(); ++iter)
+	{
+		int fd = (int)(uint32)(iter->first & 0xffffffff);
+		int dir = (int)((iter->first >> 32) & 1);
+		uint32 generation = (uint32)(iter->first >> 33);
+
+		// recv请求的包在完成事件到达之后才能回收
+		TCPPacket* pRecvPacket = NULL;
+		if (dir == DIR_READ && !recvPackets_.empty())
+		{
+			RECV_PACKETS::iterator packetIter = recvPackets_.find(iter->first);
+			if (packetIter != recvPackets_.end())
+			{
+				pRecvPacket = packetIter->second;
+				recvPackets_.erase(packetIter);
+			}
+		}
+
+		// 已经取消或者重新提交过的请求
+		FD_STATES::iterator stateIter = fdStates_.find(fd);
+		if (stateIter == fdStates_.end() || 
+			stateIter->second.generation[dir] != generation || !stateIter->second.armed[dir])
+		{
+			if (pRecvPacket)
+				TCPPacket::reclaimPoolObject(pRecvPacket);
+
+			continue;
+		}
+
+		stateIter->second.armed[dir] = false;
+
+		int32 res = iter->second;
+		if (pRecvPacket)
+		{
+			onRecvCompleted(fd, pRecvPacket, res);
+		}
+		else if (res == -ECANCELED)
+		{
+		}
+		else if (res < 0)
+		{
+			WARNING_MSG(fmt::format("IOUringPoller::processPendingEvents: poll fd {} failed: {}\n",
+				fd, strerror(-res)));
+
+			this->triggerError(fd);
+		}
+		else if (res & (POLLERR | POLLHUP))
+		{
+			this->triggerError(fd);
+		}
+		else if (dir == DIR_READ)
+		{
+			this->triggerRead(fd);
+		}
+		else
+		{
+			this->triggerWrite(fd);
+		}
+
+		++nevents;
+
+		// 回调中可能注销或者重新注册了这个文件描述符
+		stateIter = fdStates_.find(fd);
+		if (stateIter != fdStates_.end() && stateIter->second.wanted[dir] && !stateIter->second.armed[dir])
+		{
+			arm(fd, stateIter->second, dir);
+		}
+	}
+
+	completions_.swap(completions);
+	return nevents;
+}
+
+}
+
+#endif // HAS_IO_URING
+
+}
@@ -0,0 +1,143 @@
+// Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
+
+#ifndef KBE_IOURING_POLLER_H
+#define KBE_IOURING_POLLER_H
+
+#include "event_poller.h"
+#include "network/tcp_packet.h"
+
+#if KBE_PLATFORM == PLATFORM_UNIX && defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define HAS_IO_URING
+#endif
+#endif
+
+#ifdef HAS_IO_URING
+#include <linux/io_uring.h>
+#endif
+
+namespace KBEngine {
+namespace Network
+{
+
+#ifdef HAS_IO_URING
+/**
+	基于io_uring的poller(Linux 5.11+)
+	TCP通道的读方向直接提交IORING_OP_RECV， 数据由内核接收到池中的TCPPacket后交给接收器，
+	不再需要每个可读的socket各自调用recv； 其他的文件描述符提交单次的poll请求， 触发后重新提交。
+	所有的提交与等待在每轮处理中合并为一次io_uring_enter调用。
+	内核不支持时isGood()返回false， 由EventPoller::create退回到epoll。
+*/
+class IOUringPoller : public EventPoller
+{
+public:
+	IOUringPoller(uint32 entries = 1024);
+	virtual ~IOUringPoller();
+
+	int getFileDescriptor() const { return ringfd_; }
+
+	bool isGood() const { return ringfd_ != -1; }
+
+protected:
+	virtual bool doRegisterForRead(int fd)
+		{ return this->doRegister(fd, true, true); }
+
+	virtual bool doRegisterForWrite(int fd)
+		{ return this->doRegister(fd, false, true); }
+
+	virtual bool doDeregisterForRead(int fd)
+		{ return this->doRegister(fd, true, false); }
+
+	virtual bool doDeregisterForWrite(int fd)
+		{ return this->doRegister(fd, false, false); }
+
+	virtual int processPendingEvents(double maxWait);
+
+	bool doRegister(int fd, bool isRead, bool isRegister);
+
+private:
+	/**
+		每个文件描述符上读写两个方向的请求的状态
+		读方向的处理器接受时提交IORING_OP_RECV直接接收到池中的TCPPacket， 否则提交poll请求
+		每次注册分配一个新的世代号(31位， 不为0)， 已注销的请求的完成事件据此被忽略， 即使文件描述符已被复用
+	*/
+	struct FDState
+	{
+		FDState():
+		wanted(),
+		armed(),
+		generation(),
+		readQueued(false)
+		{
+			wanted[0] = wanted[1] = false;
+			armed[0] = armed[1] = false;
+			generation[0] = generation[1] = 0;
+		}
+
+		bool wanted[2];
+		bool armed[2];
+		uint32 generation[2];
+
+		// 读请求已登记但尚未填写到提交队列中
+		bool readQueued;
+	};
+
+	typedef KBEUnordered_map<int, FDState> FD_STATES;
+	typedef KBEUnordered_map<uint64, TCPPacket*> RECV_PACKETS;
+	typedef std::vector< std::pair<int, uint32> > QUEUED_READS;
+	typedef std::vector< std::pair<uint64, int32> > COMPLETIONS;
+
+	bool setup(uint32 entries);
+	void release();
+
+	struct io_uring_sqe* getSqe();
+	void arm(int fd, FDState& state, int dir);
+	void prepareQueuedReads();
+	int submitAndWait(double maxWait);
+
+	void onRecvCompleted(int fd, TCPPacket* pPacket, int32 res);
+
+	static uint64 makeUserData(int fd, int dir, uint32 generation);
+	uint32 nextGeneration();
+
+	int ringfd_;
+
+	// 提交队列
+	void* sqRingPtr_;
+	size_t sqRingSize_;
+	uint32* sqHead_;
+	uint32* sqTail_;
+	uint32 sqMask_;
+	uint32* sqArray_;
+	struct io_uring_sqe* sqes_;
+	size_t sqesSize_;
+
+	// 完成队列
+	void* cqRingPtr_;
+	size_t cqRingSize_;
+	uint32* cqHead_;
+	uint32* cqTail_;
+	uint32 cqMask_;
+	struct io_uring_cqe* cqes_;
+
+	// 已经填写尚未提交的请求数量
+	uint32 numPendingSqes_;
+
+	uint32 generation_;
+
+	FD_STATES fdStates_;
+
+	// 读请求在提交前才决定使用recv还是poll， 处理器的状态(例如开启ssl)可能在登记之后改变
+	QUEUED_READS queuedReads_;
+
+	// 已提交的recv请求使用的包， 在完成事件(包括被取消)到达之前内核可能写入， 不能回收
+	RECV_PACKETS recvPackets_;
+
+	// 取出的完成事件(user_data, res)， 重复使用避免每次分配
+	COMPLETIONS completions_;
+};
+#endif // HAS_IO_URING
+
+}
+}
+#endif // KBE_IOURING_POLLER_H
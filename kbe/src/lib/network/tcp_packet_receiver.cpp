@@ -110,6 +110,52 @@ bool TCPPacketReceiver::processRecv(bool expectingPacket)
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+bool TCPPacketReceiver::acceptsRecvCompletion()
+{
+	// sslҪSSL_read ֻڿɶʱԼ
+	return pEndpoint_ != NULL && !pEndpoint_->isSSL();
+}
+
+//-------------------------------------------------------------------------------------
+int TCPPacketReceiver::handleRecvCompletion(int fd, Packet* pPacket, int len)
+{
+	Channel* pChannel = getChannel();
+	KBE_ASSERT(pChannel != NULL);
+
+	if(pChannel->condemn() > 0)
+	{
+		if(pPacket)
+			TCPPacket::reclaimPoolObject(static_cast<TCPPacket*>(pPacket));
+
+		return 0;
+	}
+
+	if (len < 0)
+	{
+		errno = -len;
+
+		PacketReceiver::RecvState rstate = this->checkSocketErrors(len, true);
+
+		if(rstate == PacketReceiver::RECV_STATE_INTERRUPT)
+			onGetError(pChannel, fmt::format("TCPPacketReceiver::handleRecvCompletion(): error={}\n", kbe_lasterror()));
+
+		return 0;
+	}
+	else if(len == 0) // ͻ˳
+	{
+		onGetError(pChannel, "disconnected");
+		return 0;
+	}
+
+	Reason ret = this->processPacket(pChannel, pPacket);
+
+	if(ret != REASON_SUCCESS)
+		this->dispatcher().errorReporter().reportException(ret, pEndpoint_->addr());
+
+	return 0;
+}
+
 //-------------------------------------------------------------------------------------
 void TCPPacketReceiver::onGetError(Channel* pChannel, const std::string& err)
 {
@@ -38,6 +38,9 @@ public:
 
 	Reason processFilteredPacket(Channel* pChannel, Packet * pPacket);
 
+	virtual bool acceptsRecvCompletion();
+	virtual int handleRecvCompletion(int fd, Packet* pPacket, int len);
+
 protected:
 	virtual bool processRecv(bool expectingPacket);
 	PacketReceiver::RecvState checkSocketErrors(int len, bool expectingPacket);
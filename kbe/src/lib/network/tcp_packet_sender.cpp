@@ -14,6 +14,7 @@
 #include "network/network_interface.h"
 #include "network/event_poller.h"
 #include "network/error_reporter.h"
+#include "network/network_stats.h"
 #include "network/tcp_packet.h"
 #include "network/udp_packet.h"
 
@@ -105,6 +106,26 @@ bool TCPPacketSender::processSend(Channel* pChannel, int userarg)
 	Channel::Bundles& bundles = pChannel->bundles();
 	Reason reason = REASON_SUCCESS;
 
+#if KBE_PLATFORM == PLATFORM_UNIX
+	// ûйʱݾҪ͵ݣһԽwritev
+	if (g_vectoredSend && pChannel->pFilter() == NULL && !pChannel->pEndPoint()->isSSL())
+	{
+		reason = processVectoredSend(pChannel);
+		if (reason != REASON_SUCCESS)
+		{
+			onSendFailed(pChannel, reason);
+			return false;
+		}
+
+		sendfailCount_ = 0;
+
+		if(noticed)
+			pChannel->onSendCompleted();
+
+		return true;
+	}
+#endif
+
 	Channel::Bundles::iterator iter = bundles.begin();
 	for(; iter != bundles.end(); ++iter)
 	{
@@ -112,11 +133,17 @@ bool TCPPacketSender::processSend(Channel* pChannel, int userarg)
 		Bundle::Packets::iterator iter1 = pakcets.begin();
 		for (; iter1 != pakcets.end(); ++iter1)
 		{
+			// ԭ޸İ ͽҲ¼ڰϣ İҪ˽еĿ
+			(*iter)->unsharePacket((*iter1));
+
+			// ܸıĳȣ ʱĳȼ
+			uint32 packetLength = (*iter1)->length();
 			reason = processPacket(pChannel, (*iter1), userarg);
 			if(reason != REASON_SUCCESS)
 				break; 
-			else
-				RECLAIM_PACKET((*iter)->isTCPPacket(), (*iter1));
+
+			pChannel->onQueuedPacketSent(packetLength);
+			RECLAIM_PACKET((*iter)->isTCPPacket(), (*iter1));
 		}
 
 		if(reason == REASON_SUCCESS)
@@ -130,64 +157,179 @@ bool TCPPacketSender::processSend(Channel* pChannel, int userarg)
 			pakcets.erase(pakcets.begin(), iter1);
 			bundles.erase(bundles.begin(), iter);
 
-			if (reason == REASON_RESOURCE_UNAVAILABLE)
-			{
-				/* ˴ܻdebugHelper
-					WARNING_MSG(fmt::format("TCPPacketSender::processSend: "
-						"Transmit queue full, waiting for space(kbengine.xml->channelCommon->writeBufferSize->{})...\n",
-						(pChannel->isInternal() ? "internal" : "external")));
-				*/
-
-				// 10֪ͨ
-				if (++sendfailCount_ >= 10 && pChannel->isExternal())
-				{
-					onGetError(pChannel, "TCPPacketSender::processSend: sendfailCount >= 10");
+			onSendFailed(pChannel, reason);
+			return false;
+		}
+	}
 
-					this->dispatcher().errorReporter().reportException(reason, pEndpoint_->addr(), 
-						fmt::format("TCPPacketSender::processSend(external, sendfailCount({}) >= 10)", (int)sendfailCount_).c_str());
-				}
-				else
-				{
-					this->dispatcher().errorReporter().reportException(reason, pEndpoint_->addr(), 
-						fmt::format("TCPPacketSender::processSend(internal, {})", (int)sendfailCount_).c_str());
-				}
-			}
-			else
-			{
-				if (pChannel->isExternal())
-				{
+	bundles.clear();
+
+	if(noticed)
+		pChannel->onSendCompleted();
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void TCPPacketSender::onSendFailed(Channel* pChannel, Reason reason)
+{
+	if (reason == REASON_RESOURCE_UNAVAILABLE)
+	{
+		// Ѿ Ƿ䵽˵ˮλ
+		if (pChannel->sendBackpressure())
+			pChannel->checkSendWaterMarks();
+
+		/* ˴ܻdebugHelper
+			WARNING_MSG(fmt::format("TCPPacketSender::processSend: "
+				"Transmit queue full, waiting for space(kbengine.xml->channelCommon->writeBufferSize->{})...\n",
+				(pChannel->isInternal() ? "internal" : "external")));
+		*/
+
+		// 10֪ͨ
+		if (++sendfailCount_ >= 10 && pChannel->isExternal())
+		{
+			onGetError(pChannel, "TCPPacketSender::processSend: sendfailCount >= 10");
+
+			this->dispatcher().errorReporter().reportException(reason, pEndpoint_->addr(), 
+				fmt::format("TCPPacketSender::processSend(external, sendfailCount({}) >= 10)", (int)sendfailCount_).c_str());
+		}
+		else
+		{
+			this->dispatcher().errorReporter().reportException(reason, pEndpoint_->addr(), 
+				fmt::format("TCPPacketSender::processSend(internal, {})", (int)sendfailCount_).c_str());
+		}
+	}
+	else
+	{
+		if (pChannel->isExternal())
+		{
 #if KBE_PLATFORM == PLATFORM_UNIX
-					this->dispatcher().errorReporter().reportException(reason, pEndpoint_->addr(), "TCPPacketSender::processSend(external)",
-						fmt::format(", errno: {}", errno).c_str());
+			this->dispatcher().errorReporter().reportException(reason, pEndpoint_->addr(), "TCPPacketSender::processSend(external)",
+				fmt::format(", errno: {}", errno).c_str());
 #else
-					this->dispatcher().errorReporter().reportException(reason, pEndpoint_->addr(), "TCPPacketSender::processSend(external)",
-						fmt::format(", errno: {}", WSAGetLastError()).c_str());
+			this->dispatcher().errorReporter().reportException(reason, pEndpoint_->addr(), "TCPPacketSender::processSend(external)",
+				fmt::format(", errno: {}", WSAGetLastError()).c_str());
 #endif
-				}
-				else
-				{
+		}
+		else
+		{
 #if KBE_PLATFORM == PLATFORM_UNIX
-					this->dispatcher().errorReporter().reportException(reason, pEndpoint_->addr(), "TCPPacketSender::processSend(internal)",
-						fmt::format(", errno: {}, {}", errno, pChannel->c_str()).c_str());
+			this->dispatcher().errorReporter().reportException(reason, pEndpoint_->addr(), "TCPPacketSender::processSend(internal)",
+				fmt::format(", errno: {}, {}", errno, pChannel->c_str()).c_str());
 #else
-					this->dispatcher().errorReporter().reportException(reason, pEndpoint_->addr(), "TCPPacketSender::processSend(internal)",
-						fmt::format(", errno: {}, {}", WSAGetLastError(), pChannel->c_str()).c_str());
+			this->dispatcher().errorReporter().reportException(reason, pEndpoint_->addr(), "TCPPacketSender::processSend(internal)",
+				fmt::format(", errno: {}, {}", WSAGetLastError(), pChannel->c_str()).c_str());
 #endif
+		}
+
+		onGetError(pChannel, fmt::format("TCPPacketSender::processSend: errno={}", kbe_lasterror()));
+	}
+}
+
+//-------------------------------------------------------------------------------------
+Reason TCPPacketSender::processVectoredSend(Channel* pChannel)
+{
+#if KBE_PLATFORM == PLATFORM_UNIX
+	// writevύĻܳϵͳIOV_MAX
+	static const int MAX_IOVECS = 64;
+
+	Channel::Bundles& bundles = pChannel->bundles();
+	EndPoint* pEndpoint = pChannel->pEndPoint();
+
+	struct iovec iov[MAX_IOVECS];
+
+	while (!bundles.empty())
+	{
+		if (pChannel->condemn() == Channel::FLAG_CONDEMN_AND_DESTROY)
+			return REASON_CHANNEL_CONDEMN;
+
+		int iovcnt = 0;
+		size_t totalSize = 0;
+
+		Channel::Bundles::iterator iter = bundles.begin();
+		for (; iter != bundles.end() && iovcnt < MAX_IOVECS; ++iter)
+		{
+			Bundle::Packets& packets = (*iter)->packets();
+			Bundle::Packets::iterator iter1 = packets.begin();
+			for (; iter1 != packets.end() && iovcnt < MAX_IOVECS; ++iter1)
+			{
+				Packet* pPacket = (*iter1);
+				iov[iovcnt].iov_base = pPacket->data() + pPacket->sentSize;
+				iov[iovcnt].iov_len = pPacket->length() - pPacket->sentSize;
+				totalSize += iov[iovcnt].iov_len;
+				++iovcnt;
+			}
+		}
+
+		size_t remain = 0;
+
+		if (totalSize > 0)
+		{
+			int len = pEndpoint->sendv(iov, iovcnt);
+			NetworkStats::getSingleton().trackSendSyscall(iovcnt);
+
+			if (len < 0)
+				return checkSocketErrors(pEndpoint);
+
+			remain = (size_t)len;
+
+			// нչķͲʧܣ ֻ޷ʱŶϿ
+			if (len > 0)
+				sendfailCount_ = 0;
+		}
+
+		bool sentAll = remain == totalSize;
+
+		// ʵʷ͵ֽƽ ϵİbundle
+		Channel::Bundles::iterator bundleIter = bundles.begin();
+		for (; bundleIter != bundles.end(); ++bundleIter)
+		{
+			Bundle::Packets& packets = (*bundleIter)->packets();
+			Bundle::Packets::iterator iter1 = packets.begin();
+			for (; iter1 != packets.end(); ++iter1)
+			{
+				Packet* pPacket = (*iter1);
+				size_t sent = std::min(remain, (size_t)(pPacket->length() - pPacket->sentSize));
+				remain -= sent;
+
+				bool sentCompleted = pPacket->sentSize + sent == pPacket->length();
+				if (sent > 0 || sentCompleted)
+					pChannel->onPacketSent((int)sent, sentCompleted);
+
+				if (!sentCompleted)
+				{
+					// İܼ¼ͨķͽȣ ֻһʱ˽еĿ
+					if (sent > 0)
+						(*bundleIter)->unsharePacket((*iter1))->sentSize += sent;
+
+					break;
 				}
 
-				onGetError(pChannel, fmt::format("TCPPacketSender::processSend: errno={}", kbe_lasterror()));
+				pChannel->onQueuedPacketSent(pPacket->length());
+				RELEASE_PACKET((*bundleIter)->isTCPPacket(), pPacket);
 			}
 
-			return false;
+			if (iter1 != packets.end())
+			{
+				packets.erase(packets.begin(), iter1);
+				break;
+			}
+
+			packets.clear();
+			Network::Bundle::reclaimPoolObject((*bundleIter));
 		}
-	}
 
-	bundles.clear();
+		bundles.erase(bundles.begin(), bundleIter);
 
-	if(noticed)
-		pChannel->onSendCompleted();
+		// ֻһݣΪREASON_RESOURCE_UNAVAILABLE
+		if (!sentAll)
+			return REASON_RESOURCE_UNAVAILABLE;
+	}
 
-	return true;
+	return REASON_SUCCESS;
+#else
+	return REASON_GENERAL_NETWORK;
+#endif
 }
 
 //-------------------------------------------------------------------------------------
@@ -200,6 +342,7 @@ Reason TCPPacketSender::processFilterPacket(Channel* pChannel, Packet * pPacket,
 
 	EndPoint* pEndpoint = pChannel->pEndPoint();
 	int len = pEndpoint->send(pPacket->data() + pPacket->sentSize, pPacket->length() - pPacket->sentSize);
+	NetworkStats::getSingleton().trackSendSyscall(1);
 
 	if(len > 0)
 	{
@@ -48,6 +48,13 @@ public:
 protected:
 	virtual Reason processFilterPacket(Channel* pChannel, Packet * pPacket, int userarg);
 
+	/**
+		将通道中所有待发送的包通过writev合并发送
+	*/
+	Reason processVectoredSend(Channel* pChannel);
+
+	void onSendFailed(Channel* pChannel, Reason reason);
+
 	uint8 sendfailCount_;
 };
 }
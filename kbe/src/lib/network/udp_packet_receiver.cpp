@@ -14,6 +14,7 @@
 #include "network/network_interface.h"
 #include "network/event_poller.h"
 #include "network/error_reporter.h"
+#include "network/network_stats.h"
 
 namespace KBEngine { 
 namespace Network
@@ -63,6 +64,16 @@ UDPPacketReceiver::UDPPacketReceiver(EndPoint & endpoint,
 //-------------------------------------------------------------------------------------
 UDPPacketReceiver::~UDPPacketReceiver()
 {
+#if KBE_PLATFORM == PLATFORM_UNIX
+	std::vector<UDPPacket*>::iterator iter = recvPackets_.begin();
+	for (; iter != recvPackets_.end(); ++iter)
+	{
+		if ((*iter) != NULL)
+			UDPPacket::reclaimPoolObject((*iter));
+	}
+
+	recvPackets_.clear();
+#endif
 }
 
 //-------------------------------------------------------------------------------------
@@ -74,6 +85,11 @@ Channel* UDPPacketReceiver::findChannel(const Address& addr)
 //-------------------------------------------------------------------------------------
 bool UDPPacketReceiver::processRecv(bool expectingPacket)
 {	
+#if KBE_PLATFORM == PLATFORM_UNIX
+	if (g_batchedRecv)
+		return processBatchedRecv(expectingPacket);
+#endif
+
 	Address	srcAddr;
 	UDPPacket* pChannelReceiveWindow = UDPPacket::createPoolObject(OBJECTPOOL_POINT);
 	int len = pChannelReceiveWindow->recvFromEndPoint(*pEndpoint_, &srcAddr);
@@ -85,6 +101,80 @@ bool UDPPacketReceiver::processRecv(bool expectingPacket)
 		return rstate == PacketReceiver::RECV_STATE_CONTINUE;
 	}
 	
+	NetworkStats::getSingleton().trackRecvSyscall(1);
+	return processRecvPacket(pChannelReceiveWindow, srcAddr);
+}
+
+#if KBE_PLATFORM == PLATFORM_UNIX
+//-------------------------------------------------------------------------------------
+bool UDPPacketReceiver::processBatchedRecv(bool expectingPacket)
+{
+	// մֻڵһʹʱ䣬 δյݵĴһνռʹ
+	if (recvPackets_.empty())
+	{
+		recvPackets_.resize(UDP_RECV_BATCH_SIZE, NULL);
+		recvMsgs_.resize(UDP_RECV_BATCH_SIZE);
+		recvIovs_.resize(UDP_RECV_BATCH_SIZE);
+		recvAddrs_.resize(UDP_RECV_BATCH_SIZE);
+	}
+
+	for (int i = 0; i < UDP_RECV_BATCH_SIZE; ++i)
+	{
+		if (recvPackets_[i] == NULL)
+			recvPackets_[i] = UDPPacket::createPoolObject(OBJECTPOOL_POINT);
+
+		UDPPacket* pPacket = recvPackets_[i];
+		KBE_ASSERT(pPacket->wpos() == 0);
+
+		recvIovs_[i].iov_base = pPacket->data();
+		recvIovs_[i].iov_len = pPacket->size();
+
+		struct msghdr& hdr = recvMsgs_[i].msg_hdr;
+		memset(&hdr, 0, sizeof(hdr));
+		hdr.msg_name = &recvAddrs_[i];
+		hdr.msg_namelen = sizeof(sockaddr_in);
+		hdr.msg_iov = &recvIovs_[i];
+		hdr.msg_iovlen = 1;
+		recvMsgs_[i].msg_len = 0;
+	}
+
+	int count = pEndpoint_->recvmmsg(&recvMsgs_[0], UDP_RECV_BATCH_SIZE);
+
+	if (count <= 0)
+	{
+		PacketReceiver::RecvState rstate = this->checkSocketErrors(count, expectingPacket);
+		return rstate == PacketReceiver::RECV_STATE_CONTINUE;
+	}
+
+	NetworkStats::getSingleton().trackRecvSyscall(count);
+
+	for (int i = 0; i < count; ++i)
+	{
+		UDPPacket* pPacket = recvPackets_[i];
+		recvPackets_[i] = NULL;
+
+		// հrecvfrom0ʱһ
+		if (recvMsgs_[i].msg_len == 0)
+		{
+			UDPPacket::reclaimPoolObject(pPacket);
+			this->checkSocketErrors(0, expectingPacket);
+			continue;
+		}
+
+		pPacket->wpos(recvMsgs_[i].msg_len);
+
+		Address srcAddr(recvAddrs_[i].sin_addr.s_addr, recvAddrs_[i].sin_port);
+		processRecvPacket(pPacket, srcAddr);
+	}
+
+	// û˵socketѾûˣ һעEAGAINĵ
+	return count == UDP_RECV_BATCH_SIZE;
+}
+#endif
+
+//-------------------------------------------------------------------------------------
+bool UDPPacketReceiver::processRecvPacket(UDPPacket* pChannelReceiveWindow, const Address& srcAddr)
+{
 	Channel* pSrcChannel = findChannel(srcAddr);
 
 	if(pSrcChannel == NULL) 
@@ -54,8 +54,26 @@ public:
 protected:
 	PacketReceiver::RecvState checkSocketErrors(int len, bool expectingPacket);
 
-protected:
+	/**
+		将收到的数据报按来源地址派发到对应的通道， 通道不存在则创建
+	*/
+	bool processRecvPacket(UDPPacket* pChannelReceiveWindow, const Address& srcAddr);
+
+#if KBE_PLATFORM == PLATFORM_UNIX
+	/**
+		使用recvmmsg一次读取多个数据报
+	*/
+	bool processBatchedRecv(bool expectingPacket);
+#endif
 
+protected:
+#if KBE_PLATFORM == PLATFORM_UNIX
+	// 批量接收预先分配的接收窗口以及recvmmsg所需的结构
+	std::vector<UDPPacket*> recvPackets_;
+	std::vector<struct mmsghdr> recvMsgs_;
+	std::vector<struct iovec> recvIovs_;
+	std::vector<sockaddr_in> recvAddrs_;
+#endif
 };
 
 }
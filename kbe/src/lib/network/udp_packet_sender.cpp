@@ -112,12 +112,15 @@ bool UDPPacketSender::processSend(Channel* pChannel, int userarg)
 		Bundle::Packets::iterator iter1 = pakcets.begin();
 		for (; iter1 != pakcets.end(); ++iter1)
 		{
-			Packet* pPacket = (*iter1);
+			// 过滤器与发送进度都会修改包， 共享的包换成私有的拷贝
+			Packet* pPacket = (*iter)->unsharePacket((*iter1));
+			uint32 packetLength = pPacket->length();
 			reason = processPacket(pChannel, pPacket, userarg);
 			if (reason != REASON_SUCCESS)
 				break;
-			else
-				onSent(pPacket);
+
+			pChannel->onQueuedPacketSent(packetLength);
+			onSent(pPacket);
 		}
 
 		if (reason == REASON_SUCCESS)
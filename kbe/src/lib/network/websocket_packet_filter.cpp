@@ -9,6 +9,8 @@
 #include "network/tcp_packet.h"
 #include "network/network_interface.h"
 #include "network/packet_receiver.h"
+#include "network/network_stats.h"
+#include "network/io_thread_pool.h"
 
 namespace KBEngine { 
 namespace Network
@@ -266,6 +268,24 @@ Reason WebSocketPacketFilter::recv(Channel * pChannel, PacketReceiver & receiver
 				return REASON_WEBSOCKET_ERROR;
 			}
 
+			// ⲿ֡غеƫƣ ڶ
+			size_t maskOffset = (size_t)(msg_payload_length_ - (uint64)pFragmentDatasRemain_);
+
+			// ʣݶڵǰ֡غɣ ֱڰϽ벢 ٿ
+			if (msg_frameType_ != websocket::WebSocketProtocol::PING_FRAME && pTCPPacket_ == NULL &&
+				pFragmentDatasRemain_ >= (int32)pPacket->length())
+			{
+				pFragmentDatasRemain_ -= pPacket->length();
+				websocket::WebSocketProtocol::decodingDatas(pPacket, msg_masked_, msg_mask_, maskOffset);
+				NetworkStats::getSingleton().trackWebSocketPayload(pPacket->length(), false);
+
+				if (pFragmentDatasRemain_ == 0)
+					reset();
+
+				// pPacketɽ
+				return PacketFilter::recv(pChannel, receiver, pPacket);
+			}
+
 			if (pTCPPacket_ == NULL)
 				pTCPPacket_ = TCPPacket::createPoolObject(OBJECTPOOL_POINT);
 
@@ -306,7 +326,7 @@ Reason WebSocketPacketFilter::recv(Channel * pChannel, PacketReceiver & receiver
 			}
 			else
 			{
-				if (!websocket::WebSocketProtocol::decodingDatas(pTCPPacket_, msg_masked_, msg_mask_))
+				if (!websocket::WebSocketProtocol::decodingDatas(pTCPPacket_, msg_masked_, msg_mask_, maskOffset))
 				{
 					ERROR_MSG(fmt::format("WebSocketPacketFilter::recv: decoding-frame error! addr={}!\n",
 						pChannel_->c_str()));
@@ -318,6 +338,7 @@ Reason WebSocketPacketFilter::recv(Channel * pChannel, PacketReceiver & receiver
 					return REASON_WEBSOCKET_ERROR;
 				}
 
+				NetworkStats::getSingleton().trackWebSocketPayload(pTCPPacket_->length(), true);
 				reason = PacketFilter::recv(pChannel, receiver, pTCPPacket_);
 				KBE_ASSERT(reason == REASON_SUCCESS);
 
@@ -357,6 +378,10 @@ Reason WebSocketPacketFilter::onPing(Channel * pChannel, Packet* pPacket)
 
 	int sendSize = pPongPacket->length();
 
+	// ߳н̷߳ͣ ̵߳ķͽ
+	if (IOThreadPool::deferSend(pChannel, pPongPacket->data(), sendSize))
+		sendSize = 0;
+
 	while (sendSize > 0)
 	{
 		int ret = pChannel->pEndPoint()->send(pPongPacket->data() + (pPongPacket->length() - sendSize), sendSize);
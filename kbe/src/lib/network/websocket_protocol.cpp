@@ -8,6 +8,15 @@
 #include "common/base64.h"
 #include "common/sha1.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define KBE_WEBSOCKET_SSE2
+#endif
+
 #if KBE_PLATFORM == PLATFORM_WIN32
 #ifdef _DEBUG
 #pragma comment(lib, "libeay32_d.lib")
@@ -349,18 +358,59 @@ int WebSocketProtocol::getFrame(Packet * pPacket, uint8& msg_opcode, uint8& msg_
 }
 
 //-------------------------------------------------------------------------------------
-bool WebSocketProtocol::decodingDatas(Packet* pPacket, uint8 msg_masked, uint32 msg_mask)
+bool WebSocketProtocol::decodingDatas(Packet* pPacket, uint8 msg_masked, uint32 msg_mask, size_t offset)
 {
 	// 
 	if(msg_masked) 
+		unmask(pPacket->data() + pPacket->rpos(), pPacket->length(), msg_mask, offset);
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void WebSocketProtocol::unmask(uint8* data, size_t len, uint32 msg_mask, size_t offset)
+{
+	// ƫת룬 ʹdata[0]Ӧrmaskĵһֽ
+	const uint8* pMask = (const uint8*)&msg_mask;
+	uint8 bytes[4];
+	for (size_t i = 0; i < 4; ++i)
+		bytes[i] = pMask[(offset + i) & 3];
+
+	uint32 rmask = 0;
+	memcpy(&rmask, bytes, sizeof(rmask));
+
+	// ÿһĳȶ4ı Ķ
+	size_t i = 0;
+
+#if defined(__AVX2__)
+	const __m256i mask256 = _mm256_set1_epi32((int)rmask);
+	for (; i + 32 <= len; i += 32)
 	{
-		uint8* c = pPacket->data() + pPacket->rpos();
-		for(int i=0; i<(int)pPacket->length(); i++) {
-			c[i] = c[i] ^ ((uint8*)(&msg_mask))[i % 4];
-		}
+		__m256i v = _mm256_loadu_si256((const __m256i*)(data + i));
+		_mm256_storeu_si256((__m256i*)(data + i), _mm256_xor_si256(v, mask256));
 	}
+#endif
 
-	return true;
+#if defined(KBE_WEBSOCKET_SSE2)
+	const __m128i mask128 = _mm_set1_epi32((int)rmask);
+	for (; i + 16 <= len; i += 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+		_mm_storeu_si128((__m128i*)(data + i), _mm_xor_si128(v, mask128));
+	}
+#endif
+
+	const uint64 mask64 = ((uint64)rmask << 32) | rmask;
+	for (; i + 8 <= len; i += 8)
+	{
+		uint64 v;
+		memcpy(&v, data + i, sizeof(v));
+		v ^= mask64;
+		memcpy(data + i, &v, sizeof(v));
+	}
+
+	for (; i < len; ++i)
+		data[i] ^= bytes[i & 3];
 }
 
 std::string WebSocketProtocol::getFrameTypeName(FrameType frame_type)
@@ -69,7 +69,15 @@ public:
 	static int getFrame(Packet* pPacket, uint8& msg_opcode, uint8& msg_fin, uint8& msg_masked, uint32& msg_mask, 
 		int32& msg_length_field, uint64& msg_payload_length, FrameType& frameType);
 
-	static bool decodingDatas(Packet* pPacket, uint8 msg_masked, uint32 msg_mask);
+	/**
+		offsetΪⲿ֡غеƫƣ غɱֵʱڶ
+	*/
+	static bool decodingDatas(Packet* pPacket, uint8 msg_masked, uint32 msg_mask, size_t offset = 0);
+
+	/**
+		ʹ ֧ʱʹSSE2/AVX2ÿδ16/32ֽ
+	*/
+	static void unmask(uint8* data, size_t len, uint32 msg_mask, size_t offset);
 
 	static std::string getFrameTypeName(FrameType frame_type);
 
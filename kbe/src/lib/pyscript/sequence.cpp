@@ -277,6 +277,7 @@ int Sequence::seq_ass_item(PyObject* self, Py_ssize_t index, PyObject* value)
 		values.erase(values.begin() + index);
 	}
 
+	seq->onDataChanged();
 	return 0;
 }
 
@@ -287,6 +288,11 @@ PyObject* Sequence::createNewItemFromObj(PyObject* pyItem)
 	return pyItem;
 }
 
+//-------------------------------------------------------------------------------------
+void Sequence::onDataChanged()
+{
+}
+
 //-------------------------------------------------------------------------------------
 int Sequence::seq_ass_slice(PyObject* self, Py_ssize_t index1, Py_ssize_t index2, PyObject* oterSeq)
 {
@@ -306,6 +312,7 @@ int Sequence::seq_ass_slice(PyObject* self, Py_ssize_t index1, Py_ssize_t index2
 			values.erase(values.begin() + index1, values.begin() + index2);
 		}
 
+		seq->onDataChanged();
 		return 0;
 	}
 
@@ -375,6 +382,7 @@ int Sequence::seq_ass_slice(PyObject* self, Py_ssize_t index1, Py_ssize_t index2
 			Py_DECREF(pyTemp);
 	}
 
+	seq->onDataChanged();
 	return 0;
 }
 
@@ -437,6 +445,7 @@ PyObject* Sequence::seq_inplace_concat(PyObject* self, PyObject* oterSeq)
 		values[szA + i] = pyTemp;
 	}
 
+	seq->onDataChanged();
 	Py_INCREF(seq);
 	return seq;
 }
@@ -477,6 +486,7 @@ PyObject* Sequence::seq_inplace_repeat(PyObject* self, Py_ssize_t n)
 		}
 	}
 
+	seq->onDataChanged();
 	Py_INCREF(seq);
 	return seq;
 }
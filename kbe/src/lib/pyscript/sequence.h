@@ -41,6 +41,11 @@ public:
 	virtual bool isSameItemType(PyObject* pyValue);
 	virtual PyObject* createNewItemFromObj(PyObject* pyItem);
 
+	/** 
+		ݸı֪ͨ 
+	*/
+	virtual void onDataChanged();
+
 protected:
 	std::vector<PyObject*>				values_;
 } ;
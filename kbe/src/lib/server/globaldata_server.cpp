@@ -48,6 +48,31 @@ bool GlobalDataServer::del(Network::Channel* pChannel, COMPONENT_TYPE componentT
 	return true;	
 }
 
+//-------------------------------------------------------------------------------------
+static void broadcastToChannels(const Network::MessageHandler& msgHandler, const std::vector<Network::Channel*>& channels,
+										const std::string& key, const std::string& value, bool isDelete)
+{
+	if(channels.empty())
+		return;
+
+	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+	(*pBundle).newMessage(msgHandler);
+
+	(*pBundle) << isDelete;
+	ArraySize slen = key.size();
+	(*pBundle) << slen;
+	(*pBundle).assign(key.data(), slen);
+
+	if(!isDelete)
+	{
+		slen = value.size();
+		(*pBundle) << slen;
+		(*pBundle).assign(value.data(), slen);
+	}
+
+	Network::Bundle::broadcast(pBundle, channels);
+}
+
 //-------------------------------------------------------------------------------------
 void GlobalDataServer::broadcastDataChanged(Network::Channel* pChannel, COMPONENT_TYPE componentType, 
 										const std::string& key, const std::string& value, bool isDelete)
@@ -55,6 +80,9 @@ void GlobalDataServer::broadcastDataChanged(Network::Channel* pChannel, COMPONEN
 	INFO_MSG(fmt::format("GlobalDataServer::broadcastDataChanged: writer({0}, addr={4}), keySize={1}, valSize={2}, isDelete={3}\n",
 		COMPONENT_NAME_EX(componentType), key.size(), value.size(), (int)isDelete, pChannel->c_str()));
 
+	std::vector<Network::Channel*> cellappChannels;
+	std::vector<Network::Channel*> baseappChannels;
+
 	std::vector<COMPONENT_TYPE>::iterator iter = concernComponentTypes_.begin();
 	for(; iter != concernComponentTypes_.end(); ++iter)
 	{
@@ -76,51 +104,32 @@ void GlobalDataServer::broadcastDataChanged(Network::Channel* pChannel, COMPONEN
 			if(dataType_ == CELLAPP_DATA && iter1->componentType != CELLAPP_TYPE)
 				continue;
 
-			Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
-
-			switch(dataType_)
-			{
-			case GLOBAL_DATA:
-				if(iter1->componentType == CELLAPP_TYPE)
-				{
-					(*pBundle).newMessage(CellappInterface::onBroadcastGlobalDataChanged);
-				}
-				else if(iter1->componentType == BASEAPP_TYPE)
-				{
-					(*pBundle).newMessage(BaseappInterface::onBroadcastGlobalDataChanged);
-				}
-				else
-				{
-					KBE_ASSERT(false && "componentType error!\n");
-				}
-				break;
-			case BASEAPP_DATA:
-				(*pBundle).newMessage(BaseappInterface::onBroadcastBaseAppDataChanged);
-				break;
-			case CELLAPP_DATA:
-				(*pBundle).newMessage(CellappInterface::onBroadcastCellAppDataChanged);
-				break;
-			default:
-				KBE_ASSERT(false && "dataType error!\n");
-				break;
-			};
-
-			
-			(*pBundle) << isDelete;
-			ArraySize slen = key.size();
-			(*pBundle) << slen;
-			(*pBundle).assign(key.data(), slen);
-
-			if(!isDelete)
-			{
-				slen = value.size();
-				(*pBundle) << slen;
-				(*pBundle).assign(value.data(), slen);
-			}
-
-			lpChannel->send(pBundle);
+			if(iter1->componentType == CELLAPP_TYPE)
+				cellappChannels.push_back(lpChannel);
+			else if(iter1->componentType == BASEAPP_TYPE)
+				baseappChannels.push_back(lpChannel);
+			else
+				KBE_ASSERT(false && "componentType error!\n");
 		}
 	}
+
+	// ͬһյϢȫͬ ֻһ
+	switch(dataType_)
+	{
+	case GLOBAL_DATA:
+		broadcastToChannels(CellappInterface::onBroadcastGlobalDataChanged, cellappChannels, key, value, isDelete);
+		broadcastToChannels(BaseappInterface::onBroadcastGlobalDataChanged, baseappChannels, key, value, isDelete);
+		break;
+	case BASEAPP_DATA:
+		broadcastToChannels(BaseappInterface::onBroadcastBaseAppDataChanged, baseappChannels, key, value, isDelete);
+		break;
+	case CELLAPP_DATA:
+		broadcastToChannels(CellappInterface::onBroadcastCellAppDataChanged, cellappChannels, key, value, isDelete);
+		break;
+	default:
+		KBE_ASSERT(false && "dataType error!\n");
+		break;
+	};
 }
 
 //-------------------------------------------------------------------------------------
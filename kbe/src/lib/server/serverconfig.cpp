@@ -310,6 +310,30 @@ bool ServerConfig::loadConfig(std::string fileName)
 					if (childnode2)
 						Network::g_extSentWindowBytesOverflow = KBE_MAX(0, xml->getValInt(childnode2));
 				}
+
+				childnode1 = xml->enterNode(sendNode, "highWaterMark");
+				if (childnode1)
+				{
+					TiXmlNode* childnode2 = xml->enterNode(childnode1, "internal");
+					if (childnode2)
+						Network::g_intSendWindowBytesHighWater = KBE_MAX(0, xml->getValInt(childnode2));
+
+					childnode2 = xml->enterNode(childnode1, "external");
+					if (childnode2)
+						Network::g_extSendWindowBytesHighWater = KBE_MAX(0, xml->getValInt(childnode2));
+				}
+
+				childnode1 = xml->enterNode(sendNode, "lowWaterMark");
+				if (childnode1)
+				{
+					TiXmlNode* childnode2 = xml->enterNode(childnode1, "internal");
+					if (childnode2)
+						Network::g_intSendWindowBytesLowWater = KBE_MAX(0, xml->getValInt(childnode2));
+
+					childnode2 = xml->enterNode(childnode1, "external");
+					if (childnode2)
+						Network::g_extSendWindowBytesLowWater = KBE_MAX(0, xml->getValInt(childnode2));
+				}
 			}
 
 			TiXmlNode* recvNode = xml->enterNode(childnode, "receive");
@@ -351,6 +375,45 @@ bool ServerConfig::loadConfig(std::string fileName)
 			Network::g_channelExternalEncryptType = xml->getValInt(childnode);
 		}
 
+		childnode = xml->enterNode(rootNode, "compressThreshold");
+		if (childnode)
+		{
+			int threshold = xml->getValInt(childnode);
+			Network::g_channelExternalCompressThreshold = threshold > 0 ? (uint32)threshold : 0;
+		}
+
+		childnode = xml->enterNode(rootNode, "vectoredSend");
+		if (childnode)
+		{
+			Network::g_vectoredSend = (xml->getValStr(childnode) == "true");
+		}
+
+		childnode = xml->enterNode(rootNode, "batchedRecv");
+		if (childnode)
+		{
+			Network::g_batchedRecv = (xml->getValStr(childnode) == "true");
+		}
+
+		childnode = xml->enterNode(rootNode, "eventPoller");
+		if (childnode)
+		{
+			Network::g_eventPoller = xml->getValStr(childnode);
+		}
+
+		childnode = xml->enterNode(rootNode, "externalIOThreads");
+		if (childnode)
+		{
+			int ioThreads = xml->getValInt(childnode);
+			Network::g_extIOThreads = ioThreads > 0 ? (uint32)ioThreads : 0;
+		}
+
+		childnode = xml->enterNode(rootNode, "externalListeners");
+		if (childnode)
+		{
+			int listeners = xml->getValInt(childnode);
+			Network::g_extTcpListeners = listeners > 0 ? (uint32)listeners : 0;
+		}
+
 		childnode = xml->enterNode(rootNode, "sslCertificate");
 		if (childnode)
 		{
@@ -629,6 +692,32 @@ bool ServerConfig::loadConfig(std::string fileName)
 				if (node)
 					_cellAppInfo.entity_posdir_updates_smart_threshold = xml->getValInt(node);
 			}
+
+			childnode = xml->enterNode(node, "type");
+			if (childnode)
+			{
+				_cellAppInfo.coordinateSystem_type = (xml->getValStr(childnode) == "grid") ? 1 : 0;
+			}
+
+			childnode = xml->enterNode(node, "gridCellSize");
+			if (childnode)
+			{
+				_cellAppInfo.coordinateSystem_gridCellSize = float(xml->getValFloat(childnode));
+			}
+
+			childnode = xml->enterNode(node, "spaces");
+			if (childnode)
+			{
+				XML_FOR_BEGIN(childnode)
+				{
+					if (childnode->FirstChild())
+					{
+						_cellAppInfo.coordinateSystem_spaceTypes[xml->getKey(childnode)] = 
+							(xml->getValStr(childnode->FirstChild()) == "grid") ? 1 : 0;
+					}
+				}
+				XML_FOR_END(childnode);
+			}
 		}
 
 		node = xml->enterNode(rootNode, "telnet_service");
@@ -671,6 +760,38 @@ bool ServerConfig::loadConfig(std::string fileName)
 			{
 				_cellAppInfo.witness_timeout = uint16(xml->getValInt(childnode));
 			}
+
+			childnode = xml->enterNode(node, "coalescePropertyUpdates");
+			if(childnode)
+			{
+				_cellAppInfo.witness_coalescePropertyUpdates = (xml->getValStr(childnode) == "true");
+			}
+		}
+
+		node = xml->enterNode(rootNode, "navigation");
+		if(node != NULL)
+		{
+			TiXmlNode* childnode = xml->enterNode(node, "asyncResultsPerTick");
+			if(childnode)
+			{
+				_cellAppInfo.navigation_asyncResultsPerTick = uint32(xml->getValInt(childnode));
+			}
+
+			childnode = xml->enterNode(node, "crowd");
+			if(childnode)
+			{
+				TiXmlNode* crowdnode = xml->enterNode(childnode, "maxAgents");
+				if(crowdnode)
+					_cellAppInfo.navigation_crowdMaxAgents = uint32(xml->getValInt(crowdnode));
+
+				crowdnode = xml->enterNode(childnode, "agentRadius");
+				if(crowdnode)
+					_cellAppInfo.navigation_crowdAgentRadius = float(xml->getValFloat(crowdnode));
+
+				crowdnode = xml->enterNode(childnode, "agentHeight");
+				if(crowdnode)
+					_cellAppInfo.navigation_crowdAgentHeight = float(xml->getValFloat(crowdnode));
+			}
 		}
 	}
 	
@@ -1129,6 +1250,27 @@ bool ServerConfig::loadConfig(std::string fileName)
 			_dbmgrInfo.debugDBMgr = (xml->getValStr(node) == "true");
 		}
 
+		node = xml->enterNode(rootNode, "writeCoalescing");
+		if(node != NULL){
+			_dbmgrInfo.writeCoalescing = (xml->getValStr(node) == "true");
+		}
+
+		node = xml->enterNode(rootNode, "writeBatch");
+		if(node != NULL)
+		{
+			TiXmlNode* childnode = xml->enterNode(node, "size");
+			if(childnode)
+			{
+				_dbmgrInfo.writeBatchSize = xml->getValInt(childnode);
+			}
+
+			childnode = xml->enterNode(node, "latency");
+			if(childnode)
+			{
+				_dbmgrInfo.writeBatchLatency = xml->getValInt(childnode);
+			}
+		}
+
 		node = xml->enterNode(rootNode, "allowEmptyDigest");
 		if(node != NULL){
 			_dbmgrInfo.allowEmptyDigest = (xml->getValStr(node) == "true");
@@ -1424,6 +1566,22 @@ bool ServerConfig::loadConfig(std::string fileName)
 			}
 		}
 
+		node = xml->enterNode(rootNode, "reconnectStorm");
+		if(node != NULL)
+		{
+			TiXmlNode* childnode = xml->enterNode(node, "delay");
+			if(childnode)
+			{
+				_botsInfo.bots_reconnectStorm_delay = (float)xml->getValFloat(childnode);
+			}
+
+			childnode = xml->enterNode(node, "interval");
+			if(childnode)
+			{
+				_botsInfo.bots_reconnectStorm_interval = (float)xml->getValFloat(childnode);
+			}
+		}
+
 		node = xml->enterNode(rootNode, "account_infos");
 		if(node != NULL)
 		{
@@ -121,13 +121,25 @@ typedef struct EngineComponentInfo
 		account_registration_enable = false;
 		account_reset_password_enable = false;
 		use_coordinate_system = true;
+		coordinateSystem_type = 0;
+		coordinateSystem_gridCellSize = 50.f;
 		account_type = 3;
 		debugDBMgr = false;
+		writeBatchSize = 32;
+		writeBatchLatency = 100;
+		writeCoalescing = true;
+		witness_coalescePropertyUpdates = true;
+		navigation_asyncResultsPerTick = 256;
+		navigation_crowdMaxAgents = 1024;
+		navigation_crowdAgentRadius = 0.5f;
+		navigation_crowdAgentHeight = 2.0f;
 
 		externalAddress[0] = '\0';
 
 		isOnInitCallPropertysSetMethods = true;
 		forceInternalLogin = false;
+		bots_reconnectStorm_delay = 0.f;
+		bots_reconnectStorm_interval = 0.f;
 	}
 
 	~EngineComponentInfo()
@@ -144,6 +156,11 @@ typedef struct EngineComponentInfo
 	float defaultViewRadius;								// cellappڵеplayerview뾶С
 	float defaultViewHysteresisArea;						// cellappڵеplayerviewͺΧ
 	uint16 witness_timeout;									// ۲Ĭϳʱʱ()
+	bool witness_coalescePropertyUpdates;					// 㲥ͻ˵Ըıÿtickɹ۲ߺϲ
+	uint32 navigation_asyncResultsPerTick;					// 첽Ѱ·ÿtick߳ദĽ 0Ϊ
+	uint32 navigation_crowdMaxAgents;						// Ⱥƶÿspaceÿagent
+	float navigation_crowdAgentRadius;						// Ⱥƶagentİ뾶
+	float navigation_crowdAgentHeight;						// Ⱥƶagentĸ߶
 	const Network::Address* externalTcpAddr;				// ⲿַ
 	const Network::Address* externalUdpAddr;				// ⲿַ
 	const Network::Address* internalTcpAddr;				// ڲַ
@@ -158,6 +175,9 @@ typedef struct EngineComponentInfo
 	uint16 entity_posdir_additional_updates;				// ʵλֹͣıͻ˸tickελϢΪ0Ǹ¡
 	uint16 entity_posdir_updates_type;						// ʵλø·ʽ0Ż߾ͬ, 1:Żͬ, 2:ѡģʽ
 	uint16 entity_posdir_updates_smart_threshold;			// ʵλøģʽµֵͬ
+	uint16 coordinateSystem_type;							// ϵͳʵ֣0ʮ, 1
+	float coordinateSystem_gridCellSize;					// ϵͳ߳
+	std::map<std::string, uint16> coordinateSystem_spaceTypes;	// spaceĽű𵥶ָϵͳʵ
 
 	bool aliasEntityID;										// ŻEntityIDviewΧС255EntityID, 䵽clientʱʹ1ֽαID 
 	bool entitydefAliasID;									// ŻentityԺͷ㲥ʱռõĴentityͻԻ߿ͻ˲255ʱ uiduid䵽clientʱʹ1ֽڱID
@@ -209,6 +229,9 @@ typedef struct EngineComponentInfo
 	uint32 bots_account_name_suffix_inc;					// ˺Ƶĺ׺, 0ʹ baseNumд
 	std::string bots_account_passwd;						// ˺ŵ
 
+	float bots_reconnectStorm_delay;						// л˴ɺȴôͬʱϿµ¼ 0Ϊ
+	float bots_reconnectStorm_interval;						// 籩ظ() 0Ϊֻһ
+
 	uint32 tcp_SOMAXCONN;									// listenֵ
 
 	int8 encrypt_login;										// ܵ¼Ϣ
@@ -231,6 +254,10 @@ typedef struct EngineComponentInfo
 
 	bool debugDBMgr;										// debugģʽ¿дϢ
 
+	uint32 writeBatchSize;									// ͬentityĸºϲдݿ С2򲻺ϲ
+	uint32 writeBatchLatency;								// ϲдʱȴʱ()
+	bool writeCoalescing;									// ͬһentityδִедǷ񱻸µдȡ
+
 	bool isOnInitCallPropertysSetMethods;					// (bots)רãEntityʼʱǷ񴥷Եset_*¼
 } ENGINE_COMPONENT_INFO;
 
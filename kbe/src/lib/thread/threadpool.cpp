@@ -90,15 +90,19 @@ finiTaskList_count_(0),
 bufferedTaskList_mutex_(),
 threadStateList_mutex_(),
 finiTaskList_mutex_(),
-busyThreadList_(),
 freeThreadList_(),
 allThreadList_(),
 maxThreadCount_(0),
 extraNewAddThreadCount_(0),
 currentThreadCount_(0),
 currentFreeThreadCount_(0),
+freeTempThreadCount_(0),
 normalThreadCount_(0),
-isDestroyed_(false)
+isDestroyed_(false),
+workers_(),
+nextWorker_(0),
+retiredStolenTasks_(0),
+retiredExecutedTasks_(0)
 {		
 	THREAD_MUTEX_INIT(threadStateList_mutex_);	
 	THREAD_MUTEX_INIT(bufferedTaskList_mutex_);
@@ -116,11 +120,15 @@ bool ThreadPool::initializeWatcher()
 {
 	WATCH_OBJECT((fmt::format("{}/maxThreadCount", name())).c_str(), this->maxThreadCount_);
 	WATCH_OBJECT((fmt::format("{}/extraNewAddThreadCount", name())).c_str(), this->extraNewAddThreadCount_);
-	WATCH_OBJECT((fmt::format("{}/currentFreeThreadCount", name())).c_str(), this->currentFreeThreadCount_);
+	WATCH_OBJECT((fmt::format("{}/currentFreeThreadCount", name())).c_str(), this, &ThreadPool::currentFreeThreadCount);
 	WATCH_OBJECT((fmt::format("{}/normalThreadCount", name())).c_str(), this->normalThreadCount_);
 	WATCH_OBJECT((fmt::format("{}/bufferedTaskSize", name())).c_str(), this, &ThreadPool::bufferTaskSize);
 	WATCH_OBJECT((fmt::format("{}/finiTaskSize", name()).c_str()), this, &ThreadPool::finiTaskSize);
 	WATCH_OBJECT((fmt::format("{}/busyThreadStates", name())).c_str(), this, &ThreadPool::printThreadWorks);
+	WATCH_OBJECT((fmt::format("{}/queuedTaskSize", name())).c_str(), this, &ThreadPool::queuedTaskSize);
+	WATCH_OBJECT((fmt::format("{}/workerQueues", name())).c_str(), this, &ThreadPool::printWorkerQueues);
+	WATCH_OBJECT((fmt::format("{}/stolenTasks", name())).c_str(), this, &ThreadPool::stolenTaskCount);
+	WATCH_OBJECT((fmt::format("{}/executedTasks", name())).c_str(), this, &ThreadPool::executedTaskCount);
 	return true;
 }
 
@@ -131,9 +139,12 @@ std::string ThreadPool::printThreadWorks()
 
 	THREAD_MUTEX_LOCK(threadStateList_mutex_);
 	int i = 0;
-	std::list<TPThread*>::iterator itr = busyThreadList_.begin();
-	for(; itr != busyThreadList_.end(); ++itr)
+	std::list<TPThread*>::iterator itr = allThreadList_.begin();
+	for(; itr != allThreadList_.end(); ++itr)
 	{
+		if((*itr)->isFree())
+			continue;
+
 		ret += (fmt::format("{0:p}:({1}), ", (void*)(*itr), (*itr)->printWorkState()));
 		i++;
 
@@ -145,6 +156,65 @@ std::string ThreadPool::printThreadWorks()
 	return ret;
 }
 
+//-------------------------------------------------------------------------------------
+uint32 ThreadPool::queuedTaskSize() const
+{
+	uint32 size = bufferTaskSize();
+
+	std::vector<TPThread*>::const_iterator iter = workers_.begin();
+	for (; iter != workers_.end(); ++iter)
+		size += (*iter)->queuedTaskSize();
+
+	return size;
+}
+
+//-------------------------------------------------------------------------------------
+uint32 ThreadPool::stolenTaskCount()
+{
+	THREAD_MUTEX_LOCK(threadStateList_mutex_);
+
+	uint32 count = retiredStolenTasks_;
+
+	std::list<TPThread*>::iterator itr = allThreadList_.begin();
+	for (; itr != allThreadList_.end(); ++itr)
+		count += (*itr)->stolenTasks();
+
+	THREAD_MUTEX_UNLOCK(threadStateList_mutex_);
+	return count;
+}
+
+//-------------------------------------------------------------------------------------
+uint32 ThreadPool::executedTaskCount()
+{
+	THREAD_MUTEX_LOCK(threadStateList_mutex_);
+
+	uint32 count = retiredExecutedTasks_;
+
+	std::list<TPThread*>::iterator itr = allThreadList_.begin();
+	for (; itr != allThreadList_.end(); ++itr)
+		count += (*itr)->executedTasks();
+
+	THREAD_MUTEX_UNLOCK(threadStateList_mutex_);
+	return count;
+}
+
+//-------------------------------------------------------------------------------------
+std::string ThreadPool::printWorkerQueues()
+{
+	std::string ret;
+
+	std::vector<TPThread*>::iterator iter = workers_.begin();
+	for (; iter != workers_.end(); ++iter)
+	{
+		if (!ret.empty())
+			ret += ",";
+
+		ret += fmt::format("{}", (*iter)->queuedTaskSize());
+	}
+
+	return ret;
+}
+
 //-------------------------------------------------------------------------------------
 void ThreadPool::finalise()
 {
@@ -207,6 +277,28 @@ void ThreadPool::destroy()
 
 	KBEngine::sleep(100);
 
+	int discardTasks = 0;
+	std::vector<TPThread*>::iterator witr = workers_.begin();
+	for(; witr != workers_.end(); ++witr)
+	{
+		TPThread* tptd = (*witr);
+		TPTask* tptask = NULL;
+
+		while((tptask = tptd->popTask()) != NULL)
+		{
+			delete tptask;
+			++discardTasks;
+		}
+	}
+
+	if(discardTasks > 0)
+	{
+		WARNING_MSG(fmt::format("ThreadPool::~ThreadPool(): Discarding {0} queued tasks.\n", 
+			discardTasks));
+	}
+
+	workers_.clear();
+
 	std::list<TPThread*>::iterator itr = allThreadList_.begin();
 	for(; itr != allThreadList_.end(); ++itr)
 	{
@@ -287,6 +379,57 @@ TPTask* ThreadPool::popbufferTask(void)
 	return tptask;
 }
 
+//-------------------------------------------------------------------------------------
+TPTask* ThreadPool::popTask(TPThread* tptd)
+{
+	TPTask* tptask = tptd->popTask();
+	if(tptask)
+		return tptask;
+
+	// ԼĶпˣ פ̵߳Ķβȡ
+	size_t size = workers_.size();
+	if(size > 0)
+	{
+		size_t start = (size_t)(tptd->executedTasks() % size);
+
+		for(size_t i = 0; i < size; ++i)
+		{
+			TPThread* pVictim = workers_[(start + i) % size];
+			if(pVictim == tptd)
+				continue;
+
+			tptask = pVictim->stealTask();
+			if(tptask)
+			{
+				++tptd->stolen_tasks_;
+				return tptask;
+			}
+		}
+	}
+
+	return popbufferTask();
+}
+
+//-------------------------------------------------------------------------------------
+TPThread* ThreadPool::selectWorker()
+{
+	size_t size = workers_.size();
+	if(size == 0)
+		return NULL;
+
+	size_t start = (size_t)(nextWorker_.fetch_add(1));
+
+	TPThread* pWorker = NULL;
+	for(size_t i = 0; i < size; ++i)
+	{
+		TPThread* tptd = workers_[(start + i) % size];
+		if(pWorker == NULL || tptd->queuedTaskSize() < pWorker->queuedTaskSize())
+			pWorker = tptd;
+	}
+
+	return pWorker;
+}
+
 //-------------------------------------------------------------------------------------
 void ThreadPool::addFiniTask(TPTask* tptask)
 { 
@@ -309,7 +452,7 @@ bool ThreadPool::createThreadPool(uint32 inewThreadCount,
 	
 	for(uint32 i=0; i<normalThreadCount_; ++i)
 	{
-		TPThread* tptd = createThread(0);
+		TPThread* tptd = createThread(0, false);
 		
 		if(!tptd)
 		{
@@ -320,13 +463,20 @@ bool ThreadPool::createThreadPool(uint32 inewThreadCount,
 		currentFreeThreadCount_++;	
 		currentThreadCount_++;
 		
-		freeThreadList_.push_back(tptd);
+		tptd->isWorker_ = true;
+		tptd->isFree_ = true;
 		allThreadList_.push_back(tptd);
+		workers_.push_back(tptd);
 	}
+
+	// ߳ȡʱworkers_ȡ гפ̶֮߳
+	std::vector<TPThread*>::iterator iter = workers_.begin();
+	for(; iter != workers_.end(); ++iter)
+		(*iter)->createThread();
 	
 	INFO_MSG(fmt::format("ThreadPool::createThreadPool: successfully({0}), "
 		"newThreadCount={1}, normalMaxThreadCount={2}, maxThreadCount={3}\n",
-			currentThreadCount_, extraNewAddThreadCount_, normalThreadCount_, maxThreadCount_));
+			(uint32)currentThreadCount_, extraNewAddThreadCount_, normalThreadCount_, maxThreadCount_));
 
 	isInitialize_ = true;
 	KBEngine::sleep(100);
@@ -412,57 +562,48 @@ TPThread* ThreadPool::createThread(int threadWaitSecond, bool threadStartsImmedi
 //-------------------------------------------------------------------------------------
 bool ThreadPool::addFreeThread(TPThread* tptd)
 {
-	THREAD_MUTEX_LOCK(threadStateList_mutex_);
-	std::list<TPThread*>::iterator itr;
-	itr = find(busyThreadList_.begin(), busyThreadList_.end(), tptd);
-
-	if(itr != busyThreadList_.end())
-	{
-		busyThreadList_.erase(itr);
-	}
-	else
+	// ԼټһζУ addTaskȷټọ̃߳
+	// һܿԷ ˲˴
+	if(tptd->isWorker())
 	{
-		THREAD_MUTEX_UNLOCK(threadStateList_mutex_);
+		tptd->isFree_ = true;
+		++currentFreeThreadCount_;
 
-		ERROR_MSG(fmt::format("ThreadPool::addFreeThread: busyThreadList_ not found thread.{0}\n",
-		 (uint32)tptd->id()));
-		
-		delete tptd;
-		return false;
+		TPTask* tptask = popTask(tptd);
+		if(tptask)
+		{
+			// ȡʧ˵addTaskѾȡ˱̲߳˼ źŻᱻ
+			if(tptd->claim())
+				--currentFreeThreadCount_;
+
+			tptd->task(tptask);
+		}
+
+		return true;
 	}
-		
-	freeThreadList_.push_back(tptd);
-	currentFreeThreadCount_++;
-	THREAD_MUTEX_UNLOCK(threadStateList_mutex_);
-	return true;
-}
 
-//-------------------------------------------------------------------------------------
-bool ThreadPool::addBusyThread(TPThread* tptd)
-{
+	// ʱֻ߳ڳthreadStateList_mutex_ʱȡ
 	THREAD_MUTEX_LOCK(threadStateList_mutex_);
-	std::list<TPThread*>::iterator itr;
-	itr = find(freeThreadList_.begin(), freeThreadList_.end(), tptd);
-	
-	if(itr != freeThreadList_.end())
+
+	tptd->isFree_ = true;
+	++currentFreeThreadCount_;
+	++freeTempThreadCount_;
+
+	TPTask* tptask = popTask(tptd);
+	if(tptask)
 	{
-		freeThreadList_.erase(itr);
+		tptd->isFree_ = false;
+		--currentFreeThreadCount_;
+		--freeTempThreadCount_;
+
+		tptd->task(tptask);
 	}
 	else
 	{
-		THREAD_MUTEX_UNLOCK(threadStateList_mutex_);
-		ERROR_MSG(fmt::format("ThreadPool::addBusyThread: freeThreadList_ not "
-				"found thread.{0}\n",
-					(uint32)tptd->id()));
-		
-		delete tptd;
-		return false;
+		freeThreadList_.push_back(tptd);
 	}
-		
-	busyThreadList_.push_back(tptd);
-	--currentFreeThreadCount_;
-	THREAD_MUTEX_UNLOCK(threadStateList_mutex_);		
 
+	THREAD_MUTEX_UNLOCK(threadStateList_mutex_);
 	return true;
 }
 
@@ -472,48 +613,55 @@ bool ThreadPool::removeHangThread(TPThread* tptd)
 	THREAD_MUTEX_LOCK(threadStateList_mutex_);
 	std::list<TPThread*>::iterator itr, itr1;
 	itr = find(freeThreadList_.begin(), freeThreadList_.end(), tptd);
+
+	// ʱͬʱȡˣ ̼߳
+	if(itr == freeThreadList_.end())
+	{
+		THREAD_MUTEX_UNLOCK(threadStateList_mutex_);
+		return false;
+	}
+
 	itr1 = find(allThreadList_.begin(), allThreadList_.end(), tptd);
-	
-	if(itr != freeThreadList_.end() && itr1 != allThreadList_.end())
+
+	if(itr1 != allThreadList_.end())
 	{
 		freeThreadList_.erase(itr);
 		allThreadList_.erase(itr1);
+		tptd->claim();
 		--currentThreadCount_;
 		--currentFreeThreadCount_;
+		--freeTempThreadCount_;
+
+		retiredStolenTasks_ += tptd->stolenTasks();
+		retiredExecutedTasks_ += tptd->executedTasks();
 
 		INFO_MSG(fmt::format("ThreadPool::removeHangThread: thread.{0} is destroy. "
 			"currentFreeThreadCount:{1}, currentThreadCount:{2}\n",
-		(uint32)tptd->id(), currentFreeThreadCount_, currentThreadCount_));
-		
+		(uint32)tptd->id(), (uint32)currentFreeThreadCount_, (uint32)currentThreadCount_));
+
 		SAFE_RELEASE(tptd);
 	}
 	else
 	{
-		THREAD_MUTEX_UNLOCK(threadStateList_mutex_);		
-		
-		ERROR_MSG(fmt::format("ThreadPool::removeHangThread: not found thread.{0}\n", 
+		THREAD_MUTEX_UNLOCK(threadStateList_mutex_);
+
+		ERROR_MSG(fmt::format("ThreadPool::removeHangThread: not found thread.{0}\n",
 			(uint32)tptd->id()));
-		
+
 		return false;
 	}
-	
+
 	THREAD_MUTEX_UNLOCK(threadStateList_mutex_);
-	return true;		
+	return true;
 }
 
 //-------------------------------------------------------------------------------------
-bool ThreadPool::_addTask(TPTask* tptask)
+bool ThreadPool::wakeupThread(TPThread* tptd)
 {
-	std::list<TPThread*>::iterator itr = freeThreadList_.begin();
-	TPThread* tptd = (TPThread*)(*itr);
-	freeThreadList_.erase(itr);
-	busyThreadList_.push_back(tptd);
-	--currentFreeThreadCount_;
-
-	//INFO_MSG("ThreadPool::currFree:%d, currThreadCount:%d, busy:[%d]\n",
-	//		 currentFreeThreadCount_, currentThreadCount_, busyThreadList_count_);
+	if(!tptd->claim())
+		return false;
 
-	tptd->task(tptask);
+	--currentFreeThreadCount_;
 
 #if KBE_PLATFORM == PLATFORM_WIN32
 	if (tptd->sendCondSignal() == 0) {
@@ -528,19 +676,42 @@ bool ThreadPool::_addTask(TPTask* tptask)
 }
 
 //-------------------------------------------------------------------------------------
-bool ThreadPool::addTask(TPTask* tptask)
+bool ThreadPool::wakeupFreeWorker()
 {
+	if(currentFreeThreadCount_ == 0)
+		return false;
+
+	size_t size = workers_.size();
+	size_t start = (size_t)nextWorker_;
+
+	for(size_t i = 0; i < size; ++i)
+	{
+		TPThread* tptd = workers_[(start + i) % size];
+		if(tptd->isFree() && wakeupThread(tptd))
+			return true;
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+bool ThreadPool::wakeupTempThread()
+{
+	if(freeTempThreadCount_ == 0 && (extraNewAddThreadCount_ == 0 || isThreadCountMax()))
+		return false;
+
 	THREAD_MUTEX_LOCK(threadStateList_mutex_);
-	if(currentFreeThreadCount_ > 0)
+
+	if(freeThreadList_.size() > 0)
 	{
-		bool ret = _addTask(tptask);
+		TPThread* tptd = freeThreadList_.front();
+		freeThreadList_.pop_front();
+		--freeTempThreadCount_;
 		THREAD_MUTEX_UNLOCK(threadStateList_mutex_);
 
-		return ret;
+		return wakeupThread(tptd);
 	}
-	
-	bufferTask(tptask);
-	
+
 	if(isThreadCountMax())
 	{
 		THREAD_MUTEX_UNLOCK(threadStateList_mutex_);
@@ -553,58 +724,62 @@ bool ThreadPool::addTask(TPTask* tptask)
 
 	for(uint32 i=0; i<extraNewAddThreadCount_; ++i)
 	{
-		bool threadStartsImmediately = i > 0;
-
-		// 趨5δʹ˳߳
-		TPThread* tptd = createThread(ThreadPool::timeout, threadStartsImmediately);
+		// 趨5δʹ˳̣߳ ߳ԼӶȡ
+		TPThread* tptd = createThread(ThreadPool::timeout, true);
 		if(!tptd)
 		{
-#if KBE_PLATFORM == PLATFORM_WIN32		
+#if KBE_PLATFORM == PLATFORM_WIN32
 			ERROR_MSG("ThreadPool::addTask: the ThreadPool create thread error! ... \n");
 #else
-			ERROR_MSG(fmt::format("ThreadPool::addTask: the ThreadPool create thread error:{0}\n", 
+			ERROR_MSG(fmt::format("ThreadPool::addTask: the ThreadPool create thread error:{0}\n",
 				kbe_strerror()));
-#endif				
-		}
-		
-		// е߳б
-		allThreadList_.push_back(tptd);	
-		
-		if (threadStartsImmediately)
-		{
-			// õ߳б
-			freeThreadList_.push_back(tptd);
-			++currentFreeThreadCount_;
-		}
-		else
-		{
-			TPTask * pTask = tptd->tryGetTask();
-			if (pTask)
-			{
-				busyThreadList_.push_back(tptd);
-				tptd->task(pTask);
-			}
-			else
-			{
-				freeThreadList_.push_back(tptd);
-				++currentFreeThreadCount_;
-			}
-
-			tptd->createThread();
+#endif
+			continue;
 		}
 
+		// е߳б
+		allThreadList_.push_back(tptd);
 		++currentThreadCount_;
-		
-		
 	}
-	
-	INFO_MSG(fmt::format("ThreadPool::addTask: new Thread, currThreadCount: {0}\n", 
-		currentThreadCount_));
+
+	INFO_MSG(fmt::format("ThreadPool::addTask: new Thread, currThreadCount: {0}\n",
+		(uint32)currentThreadCount_));
 
 	THREAD_MUTEX_UNLOCK(threadStateList_mutex_);
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+bool ThreadPool::addTask(TPTask* tptask)
+{
+	if(workers_.size() == 0)
+	{
+		bufferTask(tptask);
+		return wakeupTempThread();
+	}
+
+	// кʱִܱвɾ Ҫȡ׺ͼ
+	uint64 affinityKey = tptask->affinityKey();
+
+	// ׺ͼǽͬһפ̣߳ ֤ͬ˳ִ
+	if(affinityKey != 0)
+	{
+		TPThread* tptd = workers_[(size_t)(affinityKey % workers_.size())];
+		tptd->pushTask(tptask);
+		wakeupThread(tptd);
+		return true;
+	}
+
+	TPThread* pWorker = selectWorker();
+	pWorker->pushTask(tptask);
+
+	if(wakeupThread(pWorker) || wakeupFreeWorker())
+		return true;
+
+	// פ̶߳æ ڶУ ʱ̻߳ȿĳפ߳ȡ
+	return wakeupTempThread();
+}
+
 //-------------------------------------------------------------------------------------
 bool ThreadPool::hasThread(TPThread* pTPThread)
 {
@@ -651,6 +826,16 @@ void* TPThread::threadFunc(void* arg)
 		{
 			tptd->reset_done_tasks();
 			isRun = tptd->onWaitCondSignal();
+
+			// ȡԼӶȡ Ѿ߳ȡ½״̬
+			if(isRun && !tptd->isFree() && !pThreadPool->isDestroyed())
+			{
+				TPTask * task = tptd->tryGetTask();
+				if(task)
+					tptd->task(task);
+				else
+					pThreadPool->addFreeThread(tptd);
+			}
 		}
 
 		if(!isRun || pThreadPool->isDestroyed())
@@ -720,25 +905,35 @@ __THREAD_END__:
 //-------------------------------------------------------------------------------------
 bool TPThread::onWaitCondSignal(void)
 {
+	// ȡ޸isFree_ٷźţ ÿεȴǰisFree_ᶪʧź
 #if KBE_PLATFORM == PLATFORM_WIN32
 	if(threadWaitSecond_ <= 0)
 	{
 		state_ = THREAD_STATE_SLEEP;
-		WaitForSingleObject(cond_, INFINITE); 
-		ResetEvent(cond_);
+
+		while(isFree_ && !threadPool_->isDestroyed())
+		{
+			WaitForSingleObject(cond_, INFINITE); 
+			ResetEvent(cond_);
+		}
 	}
 	else
 	{
 		state_ = THREAD_STATE_SLEEP;
-		DWORD ret = WaitForSingleObject(cond_, threadWaitSecond_ * 1000);
-		ResetEvent(cond_);
+
+		DWORD ret = WAIT_OBJECT_0;
+		while(ret == WAIT_OBJECT_0 && isFree_ && !threadPool_->isDestroyed())
+		{
+			ret = WaitForSingleObject(cond_, threadWaitSecond_ * 1000);
+			ResetEvent(cond_);
+		}
 
 		// Ϊʱˣ ˵̺ܾ߳ûбõ Ӧע̡߳
-		// ֪ͨThreadPoolעԼ
+		// ֪ͨThreadPoolעԼ ͬʱȡ
 		if (ret == WAIT_TIMEOUT)
 		{
-			threadPool_->removeHangThread(this);
-			return false;
+			if(threadPool_->removeHangThread(this))
+				return false;
 		}
 		else if(ret != WAIT_OBJECT_0)
 		{
@@ -751,7 +946,10 @@ bool TPThread::onWaitCondSignal(void)
 	{
 		lock();
 		state_ = THREAD_STATE_SLEEP;
-		pthread_cond_wait(&cond_, &mutex_);
+
+		while(isFree_ && !threadPool_->isDestroyed())
+			pthread_cond_wait(&cond_, &mutex_);
+
 		unlock();
 	}
 	else
@@ -764,15 +962,19 @@ bool TPThread::onWaitCondSignal(void)
 		
 		lock();
 		state_ = THREAD_STATE_SLEEP;
-		int ret = pthread_cond_timedwait(&cond_, &mutex_, &timeout);
+
+		int ret = 0;
+		while(ret == 0 && isFree_ && !threadPool_->isDestroyed())
+			ret = pthread_cond_timedwait(&cond_, &mutex_, &timeout);
+
 		unlock();
 		
 		// Ϊʱˣ ˵̺ܾ߳ûбõ Ӧע̡߳
 		if (ret == ETIMEDOUT)
 		{
-			// ֪ͨThreadPoolעԼ
-			threadPool_->removeHangThread(this);
-			return false;
+			// ֪ͨThreadPoolעԼ ͬʱȡ
+			if(threadPool_->removeHangThread(this))
+				return false;
 		}
 		else if(ret != 0)
 		{
@@ -795,7 +997,74 @@ void TPThread::onTaskCompleted(void)
 //-------------------------------------------------------------------------------------
 TPTask* TPThread::tryGetTask(void)
 {
-	return threadPool_->popbufferTask();
+	return threadPool_->popTask(this);
+}
+
+//-------------------------------------------------------------------------------------
+void TPThread::pushTask(TPTask* pTask)
+{
+	THREAD_MUTEX_LOCK(tasksMutex_);
+
+	if(pTask->affinityKey() != 0)
+		pinnedTasks_.push_back(pTask);
+	else
+		tasks_[pTask->priority()].push_back(pTask);
+
+	++queued_tasks_;
+	THREAD_MUTEX_UNLOCK(tasksMutex_);
+}
+
+//-------------------------------------------------------------------------------------
+TPTask* TPThread::popTask()
+{
+	if(queued_tasks_ == 0)
+		return NULL;
+
+	TPTask* pTask = NULL;
+	THREAD_MUTEX_LOCK(tasksMutex_);
+
+	// ȼ > ׺ͼ > ͨ
+	std::deque<TPTask*>* pQueue = NULL;
+	if(!tasks_[TPTask::TPTASK_PRIORITY_HIGH].empty())
+		pQueue = &tasks_[TPTask::TPTASK_PRIORITY_HIGH];
+	else if(!pinnedTasks_.empty())
+		pQueue = &pinnedTasks_;
+	else if(!tasks_[TPTask::TPTASK_PRIORITY_NORMAL].empty())
+		pQueue = &tasks_[TPTask::TPTASK_PRIORITY_NORMAL];
+
+	if(pQueue)
+	{
+		pTask = pQueue->front();
+		pQueue->pop_front();
+		--queued_tasks_;
+	}
+
+	THREAD_MUTEX_UNLOCK(tasksMutex_);
+	return pTask;
+}
+
+//-------------------------------------------------------------------------------------
+TPTask* TPThread::stealTask()
+{
+	if(queued_tasks_ == 0)
+		return NULL;
+
+	TPTask* pTask = NULL;
+	THREAD_MUTEX_LOCK(tasksMutex_);
+
+	for(int i = TPTask::TPTASK_PRIORITY_MAX - 1; i >= 0; --i)
+	{
+		if(!tasks_[i].empty())
+		{
+			pTask = tasks_[i].back();
+			tasks_[i].pop_back();
+			--queued_tasks_;
+			break;
+		}
+	}
+
+	THREAD_MUTEX_UNLOCK(tasksMutex_);
+	return pTask;
 }
 
 //-------------------------------------------------------------------------------------
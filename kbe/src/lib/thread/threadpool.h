@@ -8,6 +8,8 @@
 #include "common/tasks.h"
 #include "helper/debug_helper.h"
 #include "thread/threadtask.h"
+#include <deque>
+#include <atomic>
 // windows include	
 #if KBE_PLATFORM == PLATFORM_WIN32
 #include <windows.h>          // for HANDLE
@@ -59,17 +61,25 @@ public:
 	TPThread(ThreadPool* threadPool, int threadWaitSecond = 0):
 	threadWaitSecond_(threadWaitSecond), 
 	currTask_(NULL), 
-	threadPool_(threadPool)
+	threadPool_(threadPool),
+	pinnedTasks_(),
+	queued_tasks_(0),
+	stolen_tasks_(0),
+	executed_tasks_(0),
+	isFree_(false),
+	isWorker_(false)
 	{
 		state_ = THREAD_STATE_SLEEP;
 		initCond();
 		initMutex();
+		THREAD_MUTEX_INIT(tasksMutex_);
 	}
 		
 	virtual ~TPThread()
 	{
 		deleteCond();
 		deleteMutex();
+		THREAD_MUTEX_DELETE(tasksMutex_);
 
 		DEBUG_MSG(fmt::format("TPThread::~TPThread(): {}\n", (void*)this));
 	}
@@ -130,16 +140,8 @@ public:
 #if KBE_PLATFORM == PLATFORM_WIN32
 		return THREAD_SINGNAL_SET(cond_);
 #else
-REATTEMPT:
-
+		// ߳ڽȴǰڼǷѾȡ ȴ뿪PENDING״̬
 		lock();
-
-		if (state_ == THREAD_STATE_PENDING)
-		{       
-			unlock();
-			goto REATTEMPT;
-		}
-
 		int ret = THREAD_SINGNAL_SET(cond_);
 		unlock();
 		return ret;
@@ -198,7 +200,35 @@ REATTEMPT:
 		߳һδı䵽״ִ̬е
 	*/
 	void reset_done_tasks(){ done_tasks_ = 0; }
-	void inc_done_tasks(){ ++done_tasks_; }
+	void inc_done_tasks(){ ++done_tasks_; ++executed_tasks_; }
+
+	/**
+		פ߳ӵԼУ ̴߳Ӷȡ ̴߳Ӷβȡ
+		׺ͼڵĶУ ֻɱ̰߳˳ִ
+	*/
+	void pushTask(TPTask* pTask);
+	TPTask* popTask();
+	TPTask* stealTask();
+
+	/**
+		е ȡ watcherο
+	*/
+	uint32 queuedTaskSize() const { return queued_tasks_; }
+
+	uint32 stolenTasks() const { return stolen_tasks_; }
+	uint32 executedTasks() const { return executed_tasks_; }
+
+	/**
+		ȡһе̣߳ ɹȡ߷źŻ ѵ߳ԼӶȡ
+	*/
+	bool claim()
+	{
+		bool expected = true;
+		return isFree_.compare_exchange_strong(expected, false);
+	}
+
+	bool isFree() const { return isFree_; }
+	bool isWorker() const { return isWorker_; }
 
 protected:
 	THREAD_SINGNAL cond_;			// ߳ź
@@ -209,6 +239,16 @@ protected:
 	ThreadPool* threadPool_;		// ָ̳߳
 	THREAD_STATE state_;			// ߳״̬: -1δ, 0˯, 1æ
 	uint32 done_tasks_;				// ߳һδı䵽״ִ̬е
+
+	THREAD_MUTEX tasksMutex_;										// л
+	std::deque<TPTask*> tasks_[TPTask::TPTASK_PRIORITY_MAX];		// Աȡ ȼ
+	std::deque<TPTask*> pinnedTasks_;								// ׺ͼ
+	// ¼ɹ߳޸ģ ߳(watcher)ȡ
+	std::atomic<uint32> queued_tasks_;								// е
+	std::atomic<uint32> stolen_tasks_;								// ߳ȡ
+	std::atomic<uint32> executed_tasks_;								// ִй
+	std::atomic<bool> isFree_;										// Ƿ(ȴȡ)
+	bool isWorker_;													// ǷΪפ߳
 };
 
 
@@ -251,9 +291,10 @@ public:
 	
 	/**
 		̳߳һ
+		Ƿ볣פ̵߳ĶУ ȡһеĳפ߳ȥִУ ̲Ҫȫ
+		ֻгפ̶߳æҪѻߴʱ߳ʱųthreadStateList_mutex_
 	*/		
 	bool addTask(TPTask* tptask);
-	bool _addTask(TPTask* tptask);
 	INLINE bool addBackgroundTask(TPTask* tptask){ return addTask(tptask); }
 	INLINE bool pushTask(TPTask* tptask){ return addTask(tptask); }
 
@@ -304,6 +345,22 @@ public:
 	*/
 	INLINE uint32 finiTaskSize() const;
 
+	/** 
+		óפ̶߳Լ
+	*/
+	uint32 queuedTaskSize() const;
+
+	/** 
+		ȡִй ֮ȼȡ
+	*/
+	uint32 stolenTaskCount();
+	uint32 executedTaskCount();
+
+	/** 
+		פ̵߳Ķг(ṩwatch)
+	*/
+	std::string printWorkerQueues();
+
 	virtual std::string name() const { return "ThreadPool"; }
 
 public:
@@ -325,14 +382,30 @@ public:
 	TPTask* popbufferTask(void);
 
 	/**
-		ƶһ̵߳б
+		Ϊ̻߳ȡһ γ߳ԼĶСȡפ̵߳δб
 	*/
-	bool addFreeThread(TPThread* tptd);
-	
+	TPTask* popTask(TPThread* tptd);
+
 	/**
-		ƶһ̵߳æб
-	*/	
-	bool addBusyThread(TPThread* tptd);
+		ѡһ̵ĳפ߳
+	*/
+	TPThread* selectWorker();
+
+	/**
+		ȡһе߳
+	*/
+	bool wakeupThread(TPThread* tptd);
+	bool wakeupFreeWorker();
+
+	/**
+		פ̶߳æʱһеʱ̣߳ û򴴽µʱ߳
+	*/
+	bool wakeupTempThread();
+
+	/**
+		߳ûʱã ״̬ȡһµ
+	*/
+	bool addFreeThread(TPThread* tptd);
 	
 	/**
 		һѾɵб
@@ -357,18 +430,24 @@ protected:
 	THREAD_MUTEX threadStateList_mutex_;							// bufferTaskList and freeThreadList_
 	THREAD_MUTEX finiTaskList_mutex_;								// finiTaskList
 	
-	std::list<TPThread*> busyThreadList_;							// æ߳б
-	std::list<TPThread*> freeThreadList_;							// õ߳б
+	std::list<TPThread*> freeThreadList_;							// õʱ߳б
 	std::list<TPThread*> allThreadList_;							// е߳б
 
 	uint32 maxThreadCount_;											// ߳
 	uint32 extraNewAddThreadCount_;									// normalThreadCount_㹻ʹ´ô߳
-	uint32 currentThreadCount_;										// ǰ߳
-	uint32 currentFreeThreadCount_;									// ǰõ߳
+	std::atomic<uint32> currentThreadCount_;						// ǰ߳
+	std::atomic<uint32> currentFreeThreadCount_;					// ǰõ߳
+	std::atomic<uint32> freeTempThreadCount_;						// õʱ߳
 	uint32 normalThreadCount_;										// ׼״̬µ߳ ĬһͿô߳
 																	// ̲߳㹻´һЩ̣߳ ܹmaxThreadNum.
 
 	bool isDestroyed_;
+
+	std::vector<TPThread*> workers_;								// פ̣߳ ӵԼУ ̳߳شٸı
+	std::atomic<uint32> nextWorker_;								// һοʼѡĳפ߳λ
+
+	uint32 retiredStolenTasks_;										// ˳ʱ߳ȡ
+	uint32 retiredExecutedTasks_;									// ˳ʱִ߳е
 };
 
 }
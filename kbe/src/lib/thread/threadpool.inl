@@ -9,7 +9,7 @@ INLINE bool ThreadPool::isInitialize(void) const
 
 INLINE bool ThreadPool::isBusy(void) const
 {
-	return bufferedTaskList_.size() > THREAD_BUSY_SIZE;
+	return queuedTaskSize() > THREAD_BUSY_SIZE;
 }	
 
 INLINE bool ThreadPool::isThreadCountMax(void) const
@@ -30,12 +30,34 @@ public:
 		TPTASK_STATE_CONTINUE_CHILDTHREAD = 2,
 	};
 
+	enum TPTaskPriority
+	{
+		TPTASK_PRIORITY_NORMAL = 0,
+		TPTASK_PRIORITY_HIGH = 1,
+		TPTASK_PRIORITY_MAX = 2
+	};
+
 	/**
 		ֵ thread::TPTask::TPTaskState οTPTaskState
 	*/
 	virtual thread::TPTask::TPTaskState presentMainThread(){ 
 		return thread::TPTask::TPTASK_STATE_COMPLETED; 
 	}
+
+	/**
+		ȼ ִ߳жиȼ
+	*/
+	virtual TPTaskPriority priority() const {
+		return TPTASK_PRIORITY_NORMAL;
+	}
+
+	/**
+		׺ͼ Ϊ0ʱͬǽͬһפ̰߳˳ִУ ᱻ߳ȡ
+		˳ִζźpriority() ҪִеӦ׺ͼ
+	*/
+	virtual uint64 affinityKey() const {
+		return 0;
+	}
 };
 
 }
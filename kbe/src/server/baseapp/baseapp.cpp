@@ -16,12 +16,12 @@
 #include "sync_entitystreamtemplate_handler.h"
 #include "common/timestamp.h"
 #include "common/kbeversion.h"
-#include "common/sha1.h"
 #include "network/common.h"
 #include "network/tcp_packet.h"
 #include "network/udp_packet.h"
 #include "network/fixed_messages.h"
 #include "network/encryption_filter.h"
+#include "network/compression_filter.h"
 #include "server/components.h"
 #include "server/telnet_server.h"
 #include "server/py_file_descriptor.h"
@@ -243,6 +243,8 @@ Baseapp::Baseapp(Network::EventDispatcher& dispatcher,
 		std::tr1::placeholders::_1, std::tr1::placeholders::_2);
 
 	EntityCallAbstract::setEntityCallCallHookFunc(&entitycallCallHookFunc);
+
+	ninterface.pChannelBackpressureHandler(this);
 }
 
 //-------------------------------------------------------------------------------------
@@ -626,6 +628,9 @@ bool Baseapp::initializeEnd()
 	pBackuper_.reset(new Backuper());
 	pArchiver_.reset(new Archiver());
 
+	// ־ûеFIXED_DICTARRAY޸ʱʵ
+	DataOwner::onChangedFunc(&Entity::onPersistentDataChanged);
+
 	new SyncEntityStreamTemplateHandler(this->networkInterface());
 
 	// Ҫpyprofileڴ˴װ
@@ -824,6 +829,18 @@ void Baseapp::onChannelDeregister(Network::Channel * pChannel)
 	}
 }
 
+//-------------------------------------------------------------------------------------
+void Baseapp::onChannelBackpressure(Network::Channel * pChannel, bool isBackpressure)
+{
+	ENTITY_ID pid = pChannel->proxyID();
+	if(pid <= 0)
+		return;
+
+	Proxy* proxy = static_cast<Proxy*>(this->findEntity(pid));
+	if(proxy)
+		proxy->onClientBackpressure(isBackpressure, pChannel->queuedBytes());
+}
+
 //-------------------------------------------------------------------------------------
 void Baseapp::onGetEntityAppFromDbmgr(Network::Channel* pChannel, int32 uid, std::string& username, 
 						COMPONENT_TYPE componentType, COMPONENT_ID componentID, COMPONENT_ORDER globalorderID, COMPONENT_ORDER grouporderID,
@@ -1349,14 +1366,12 @@ void Baseapp::onCreateEntityFromDBIDCallback(Network::Channel* pChannel, KBEngin
 	if(e)
 	{
 		static_cast<Entity*>(e)->dbid(dbInterfaceIndex, dbid);
-		static_cast<Entity*>(e)->initializeEntity(pyDict);
+		static_cast<Entity*>(e)->createNamespace(pyDict);
 		Py_DECREF(pyDict);
 
-		KBE_SHA1 sha;
-		uint32 digest[5];
-		sha.Input(s.data(), s.length());
-		sha.Result(digest);
-		static_cast<Entity*>(e)->setDirty((uint32*)&digest[0]);
+		// ݸմݿ űʼ֮޸ĲҪд
+		static_cast<Entity*>(e)->checkPersistentsDirty();
+		static_cast<Entity*>(e)->initializeScript();
 	}
 	else
 	{
@@ -1795,14 +1810,12 @@ void Baseapp::createEntityAnywhereFromDBIDOtherBaseapp(Network::Channel* pChanne
 	if(e)
 	{
 		static_cast<Entity*>(e)->dbid(dbInterfaceIndex, dbid);
-		static_cast<Entity*>(e)->initializeEntity(pyDict);
+		static_cast<Entity*>(e)->createNamespace(pyDict);
 		Py_DECREF(pyDict);
 
-		KBE_SHA1 sha;
-		uint32 digest[5];
-		sha.Input(s.data(), s.length());
-		sha.Result(digest);
-		static_cast<Entity*>(e)->setDirty((uint32*)&digest[0]);
+		// ݸմݿ űʼ֮޸ĲҪд
+		static_cast<Entity*>(e)->checkPersistentsDirty();
+		static_cast<Entity*>(e)->initializeScript();
 	}
 	else
 	{
@@ -2278,14 +2291,12 @@ void Baseapp::createEntityRemotelyFromDBIDOtherBaseapp(Network::Channel* pChanne
 	if(e)
 	{
 		static_cast<Entity*>(e)->dbid(dbInterfaceIndex, dbid);
-		static_cast<Entity*>(e)->initializeEntity(pyDict);
+		static_cast<Entity*>(e)->createNamespace(pyDict);
 		Py_DECREF(pyDict);
 
-		KBE_SHA1 sha;
-		uint32 digest[5];
-		sha.Input(s.data(), s.length());
-		sha.Result(digest);
-		static_cast<Entity*>(e)->setDirty((uint32*)&digest[0]);
+		// ݸմݿ űʼ֮޸ĲҪд
+		static_cast<Entity*>(e)->checkPersistentsDirty();
+		static_cast<Entity*>(e)->initializeScript();
 	}
 	else
 	{
@@ -4116,14 +4127,12 @@ void Baseapp::onQueryAccountCBFromDbmgr(Network::Channel* pChannel, KBEngine::Me
 	Py_DECREF(py__ACCOUNT_PASSWD__);
 
 	Py_INCREF(pEntity);
-	pEntity->initializeEntity(pyDict);
+	pEntity->createNamespace(pyDict);
 	Py_DECREF(pyDict);
 
-	KBE_SHA1 sha;
-	uint32 digest[5];
-	sha.Input(s.data(), s.length());
-	sha.Result(digest);
-	pEntity->setDirty((uint32*)&digest[0]);
+	// ݸմݿ űʼ֮޸ĲҪд
+	pEntity->checkPersistentsDirty();
+	pEntity->initializeScript();
 
 	if(pClientChannel != NULL)
 	{
@@ -4769,7 +4778,20 @@ void Baseapp::onHello(Network::Channel* pChannel,
 		if(encryptedKey.size() > 3)
 		{
 			// 滻ΪһܵĹ
-			pChannel->pFilter(Network::createEncryptionFilter(Network::g_channelExternalEncryptType, encryptedKey));
+			Network::EncryptionFilter* pEncryptionFilter = Network::createEncryptionFilter(Network::g_channelExternalEncryptType, encryptedKey);
+
+			// ԿЧʱᶪеİ ֱӶϿ
+			if(pEncryptionFilter && !pEncryptionFilter->isGood())
+			{
+				ERROR_MSG(fmt::format("Baseapp::onHello: invalid encryption key(size={}), addr={}\n",
+					encryptedKey.size(), pChannel->c_str()));
+
+				delete pEncryptionFilter;
+				pChannel->condemn("invalid encryption key");
+				return;
+			}
+
+			pChannel->pFilter(pEncryptionFilter);
 		}
 		else
 		{
@@ -4777,6 +4799,13 @@ void Baseapp::onHello(Network::Channel* pChannel,
 				, pChannel->c_str()));
 		}
 	}
+
+	// ѹڼ֮ǰУ ܹѹ֮(webЭ鲻ѹ)
+	if(Network::g_channelExternalCompressThreshold > 0 && pChannel->type() != KBEngine::Network::Channel::CHANNEL_WEB)
+	{
+		pChannel->pFilter(new Network::CompressionFilter(Network::g_channelExternalCompressThreshold,
+			pChannel->pFilter(), &ClientInterface::messageHandlers));
+	}
 }
 
 //-------------------------------------------------------------------------------------
@@ -35,6 +35,7 @@ class RestoreEntityHandler;
 class InitProgressHandler;
 
 class Baseapp :	public EntityApp<Entity>,
+				public Network::ChannelBackpressureHandler,
 				public Singleton<Baseapp>
 {
 public:
@@ -87,6 +88,11 @@ public:
 
 	virtual void onChannelDeregister(Network::Channel * pChannel);
 
+	/**
+		ͻͨݳˮλ/䵽ˮλ
+	*/
+	virtual void onChannelBackpressure(Network::Channel * pChannel, bool isBackpressure);
+
 	/**
 		һcellapp
 	*/
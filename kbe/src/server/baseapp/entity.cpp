@@ -100,7 +100,13 @@ void Entity::onDefDataChanged(EntityComponent* pEntityComponent, const PropertyD
 		return;
 
 	if(propertyDescription->isPersistent())
-		setDirty();
+	{
+		// Ըıˣ ʵ
+		if (pEntityComponent && pEntityComponent->pPropertyDescription())
+			setDirty(pEntityComponent->pPropertyDescription()->getUType());
+		else
+			setDirty(propertyDescription->getUType());
+	}
 	
 	uint32 flags = propertyDescription->getFlags();
 	ENTITY_PROPERTY_UID componentPropertyUID = 0;
@@ -395,7 +401,8 @@ void Entity::addCellDataToStream(COMPONENT_TYPE sendTo, uint32 flags, MemoryStre
 }
 
 //-------------------------------------------------------------------------------------
-void Entity::addPersistentsDataToStream(uint32 flags, MemoryStream* s)
+void Entity::addPersistentsDataToStream(uint32 flags, MemoryStream* s, 
+	const std::set<ENTITY_PROPERTY_UID>* pPropertys)
 {
 	std::vector<ENTITY_PROPERTY_UID> log;
 
@@ -406,7 +413,8 @@ void Entity::addPersistentsDataToStream(uint32 flags, MemoryStream* s)
 	ScriptDefModule::PROPERTYDESCRIPTION_MAP& propertyDescrs = pScriptModule_->getPersistentPropertyDescriptions();
 	ScriptDefModule::PROPERTYDESCRIPTION_MAP::const_iterator iter = propertyDescrs.begin();
 
-	if(pScriptModule_->hasCell())
+	if(pScriptModule_->hasCell() && (pPropertys == NULL || 
+		pPropertys->find(ENTITY_BASE_PROPERTY_UTYPE_POSITION_XYZ) != pPropertys->end()))
 	{
 		addPositionAndDirectionToStream(*s);
 	}
@@ -414,6 +422,10 @@ void Entity::addPersistentsDataToStream(uint32 flags, MemoryStream* s)
 	for(; iter != propertyDescrs.end(); ++iter)
 	{
 		PropertyDescription* propertyDescription = iter->second;
+
+		if(pPropertys && pPropertys->find(propertyDescription->getUType()) == pPropertys->end())
+			continue;
+
 		std::vector<ENTITY_PROPERTY_UID>::const_iterator finditer = 
 			std::find(log.begin(), log.end(), propertyDescription->getUType());
 
@@ -508,6 +520,184 @@ void Entity::addPersistentsDataToStream(uint32 flags, MemoryStream* s)
 	SCRIPT_ERROR_CHECK();
 }
 
+//-------------------------------------------------------------------------------------
+static bool updatePersistentDigest(MemoryStream* s, uint32* digest)
+{
+	KBE_SHA1 sha;
+	uint32 newDigest[5];
+
+	sha.Input(s->data(), s->length());
+	sha.Result(newDigest);
+
+	if (memcmp((void*)digest, (void*)&newDigest[0], sizeof(newDigest)) == 0)
+		return false;
+
+	memcpy((void*)digest, (void*)&newDigest[0], sizeof(newDigest));
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool Entity::checkPersistentsDirty(std::set<ENTITY_PROPERTY_UID>* pChangedPropertys)
+{
+	bool changed = allPersistentDirty_ || !dirtyPersistentPropertys_.empty();
+
+	// cellΪһȽϣ иıʱеԶҪд
+	std::vector<ENTITY_PROPERTY_UID> cellPropertys;
+
+	// ûcellʱűֱ޸cellData cellʱcellDataֻcellݹʱı
+	MemoryStream* pCellStream = NULL;
+	if (cellDataDict_ != NULL && (cellDataDirty_ || cellEntityCall_ == NULL))
+	{
+		pCellStream = MemoryStream::createPoolObject(OBJECTPOOL_POINT);
+
+		if (pScriptModule_->hasCell())
+			addPositionAndDirectionToStream(*pCellStream);
+	}
+
+	MemoryStream* s = MemoryStream::createPoolObject(OBJECTPOOL_POINT);
+	PyObject* pydict = PyObject_GetAttrString(this, "__dict__");
+
+	ScriptDefModule::PROPERTYDESCRIPTION_MAP& propertyDescrs = pScriptModule_->getPersistentPropertyDescriptions();
+	ScriptDefModule::PROPERTYDESCRIPTION_MAP::const_iterator iter = propertyDescrs.begin();
+
+	for (; iter != propertyDescrs.end(); ++iter)
+	{
+		PropertyDescription* propertyDescription = iter->second;
+		if (!propertyDescription->isPersistent())
+			continue;
+
+		const char* attrname = propertyDescription->getName();
+		ENTITY_PROPERTY_UID utype = propertyDescription->getUType();
+		bool isComponent = propertyDescription->getDataType()->type() == DATA_TYPE_ENTITY_COMPONENT;
+
+		// addPersistentsDataToStreamȡݵ˳һ
+		PyObject* pyVal = NULL;
+		bool isCellData = false;
+
+		if (!isComponent && cellDataDict_ != NULL)
+			pyVal = PyDict_GetItemString(cellDataDict_, attrname);
+
+		if (pyVal)
+			isCellData = true;
+		else if (pydict)
+			pyVal = PyDict_GetItemString(pydict, attrname);
+
+		if (!pyVal && isComponent && cellDataDict_ != NULL)
+		{
+			pyVal = PyDict_GetItemString(cellDataDict_, attrname);
+			isCellData = pyVal != NULL;
+		}
+
+		// ûʱдʹõĬֵ ı
+		if (!pyVal)
+			continue;
+
+		if (isCellData)
+		{
+			if (pCellStream && propertyDescription->isSamePersistentType(pyVal))
+			{
+				(*pCellStream) << utype;
+				propertyDescription->addPersistentToStream(pCellStream, pyVal);
+				cellPropertys.push_back(utype);
+			}
+
+			continue;
+		}
+
+		bool isDirty = allPersistentDirty_ || 
+			dirtyPersistentPropertys_.find(utype) != dirtyPersistentPropertys_.end();
+
+		PERSISTENT_DIGESTS::iterator diter = persistentDigests_.find(utype);
+
+		// ܸ޸ĵûб࣬ ûиı
+		if (!isDirty && diter == persistentDigests_.end())
+			continue;
+
+		// еԹʱ޸Ĳ֪ͨ ʹժҪ
+		bool isTracked = propertyDescription->getDataType()->isChangeTrackable() &&
+			DataOwner::claim(pyVal, id(), utype);
+
+		if (isTracked && diter == persistentDigests_.end())
+		{
+			if (pChangedPropertys && isDirty)
+				pChangedPropertys->insert(utype);
+
+			continue;
+		}
+
+		if (!propertyDescription->isSamePersistentType(pyVal))
+			continue;
+
+		s->clear(false);
+		propertyDescription->addPersistentToStream(s, pyVal);
+
+		if (diter == persistentDigests_.end())
+		{
+			diter = persistentDigests_.insert(std::make_pair(utype, PersistentDigest())).first;
+			memset((void*)&diter->second, 0, sizeof(PersistentDigest));
+		}
+
+		if (updatePersistentDigest(s, &diter->second.digest[0]))
+		{
+			changed = true;
+
+			if (pChangedPropertys)
+				pChangedPropertys->insert(utype);
+		}
+
+		// ֮ǰʹժҪڿԸ
+		if (isTracked)
+			persistentDigests_.erase(diter);
+	}
+
+	if (pCellStream)
+	{
+		if (updatePersistentDigest(pCellStream, &cellDataDigest_.digest[0]))
+		{
+			changed = true;
+
+			if (pChangedPropertys)
+			{
+				pChangedPropertys->insert(cellPropertys.begin(), cellPropertys.end());
+
+				if (pScriptModule_->hasCell())
+					pChangedPropertys->insert(ENTITY_BASE_PROPERTY_UTYPE_POSITION_XYZ);
+			}
+		}
+
+		MemoryStream::reclaimPoolObject(pCellStream);
+	}
+
+	// еԶΪʱҪд룬 ֻȡҪд
+	if (pChangedPropertys)
+	{
+		if (allPersistentDirty_)
+			pChangedPropertys->clear();
+		else
+			changed = !pChangedPropertys->empty();
+	}
+
+	Py_XDECREF(pydict);
+	MemoryStream::reclaimPoolObject(s);
+
+	allPersistentDirty_ = false;
+	cellDataDirty_ = false;
+	dirtyPersistentPropertys_.clear();
+
+	SCRIPT_ERROR_CHECK();
+	return changed;
+}
+
+//-------------------------------------------------------------------------------------
+void Entity::onPersistentDataChanged(ENTITY_ID entityID, ENTITY_PROPERTY_UID utype)
+{
+	Entity* pEntity = Baseapp::getSingleton().findEntity(entityID);
+	if (pEntity == NULL || pEntity->isDestroyed())
+		return;
+
+	pEntity->setDirty(utype);
+}
+
 //-------------------------------------------------------------------------------------
 PyObject* Entity::createCellDataDict(uint32 flags)
 {
@@ -1121,7 +1311,7 @@ void Entity::onBackupCellData(Network::Channel* pChannel, MemoryStream& s)
 		PyObject* cellData = createCellDataFromStream(&s);
 		installCellDataAttr(cellData);
 		Py_DECREF(cellData);
-		setDirty();
+		cellDataDirty_ = true;
 	}
 }
 
@@ -1255,6 +1445,10 @@ void Entity::onWriteToDBCallback(ENTITY_ID eid,
 		hasDB(false);
 	}
 
+	// дʧܣ θı´Ҫд
+	if (!success)
+		setDirty();
+
 	if(callbackID > 0)
 	{
 		PyObject* pyargs = PyTuple_New(2);
@@ -1315,18 +1509,29 @@ void Entity::onCellWriteToDBCompleted(CALLBACK_ID callbackID, int8 shouldAutoLoa
 
 		return;
 	}
+
+	// Ƿб仯б仯д⣬û仯ʲôҲ(ҲҪл)
+	std::set<ENTITY_PROPERTY_UID> changedPropertys;
+	if (!checkPersistentsDirty(&changedPropertys))
+		return;
+
+	// µʵҪݣ ֻдı˵
+	if (this->dbid() == 0)
+		changedPropertys.clear();
 	
 	MemoryStream* s = MemoryStream::createPoolObject(OBJECTPOOL_POINT);
 
 	try
 	{
-		addPersistentsDataToStream(ED_FLAG_ALL, s);
+		addPersistentsDataToStream(ED_FLAG_ALL, s, changedPropertys.size() > 0 ? &changedPropertys : NULL);
 	}
 	catch (MemoryStreamWriteOverflow & err)
 	{
 		ERROR_MSG(fmt::format("{}::onCellWriteToDBCompleted({}): {}\n",
 			this->scriptName(), this->id(), err.what()));
 
+		// ûд⣬ ´Ҫд
+		setDirty();
 		MemoryStream::reclaimPoolObject(s);
 		return;
 	}
@@ -1337,23 +1542,6 @@ void Entity::onCellWriteToDBCompleted(CALLBACK_ID callbackID, int8 shouldAutoLoa
 		return;
 	}
 
-	KBE_SHA1 sha;
-	uint32 digest[5];
-
-	sha.Input(s->data(), s->length());
-	sha.Result(digest);
-
-	// Ƿб仯б仯ݱݲҼ¼hashû仯ʲôҲ
-	if (memcmp((void*)&persistentDigest_[0], (void*)&digest[0], sizeof(persistentDigest_)) == 0)
-	{
-		MemoryStream::reclaimPoolObject(s);
-		return;
-	}
-	else
-	{
-		setDirty((uint32*)&digest[0]);
-	}
-
 	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
 	(*pBundle).newMessage(DbmgrInterface::writeEntity);
 
@@ -1365,6 +1553,13 @@ void Entity::onCellWriteToDBCompleted(CALLBACK_ID callbackID, int8 shouldAutoLoa
 	(*pBundle) << callbackID;
 	(*pBundle) << shouldAutoLoad;
 
+	// дԣ Ϊ0ʾд
+	(*pBundle) << (uint16)changedPropertys.size();
+
+	std::set<ENTITY_PROPERTY_UID>::const_iterator piter = changedPropertys.begin();
+	for (; piter != changedPropertys.end(); ++piter)
+		(*pBundle) << (*piter);
+
 	// ¼¼ַ
 	if(this->dbid() == 0)
 	{
@@ -98,7 +98,11 @@ public:
 
 	void destroyCellData(void);
 
-	void addPersistentsDataToStream(uint32 flags, MemoryStream* s);
+	/** 
+		pPropertysΪNULLʱֻдеԣ ENTITY_BASE_PROPERTY_UTYPE_POSITION_XYZʱдλ볯
+	*/
+	void addPersistentsDataToStream(uint32 flags, MemoryStream* s, 
+		const std::set<ENTITY_PROPERTY_UID>* pPropertys = NULL);
 
 	PyObject* createCellDataDict(uint32 flags);
 
@@ -251,9 +255,23 @@ public:
 	
 	/** 
 		ʵ־ûǷ࣬˻Զ浵 
+		ָʱеĳ־ûݶҪд
 	*/
-	INLINE void setDirty(uint32* digest = NULL);
+	INLINE void setDirty();
+	INLINE void setDirty(ENTITY_PROPERTY_UID utype);
 	INLINE bool isDirty() const;
+
+	/** 
+		־ûϴдǷиı䣬 ǰΪд
+		ܸ޸ĵֻǣ cell޷޸ĵԱȽϸԵժҪ
+		pChangedPropertysȡı˵ԣ ΪʱʾҪде
+	*/
+	bool checkPersistentsDirty(std::set<ENTITY_PROPERTY_UID>* pChangedPropertys = NULL);
+
+	/** 
+		־ûеFIXED_DICTARRAY޸
+	*/
+	static void onPersistentDataChanged(ENTITY_ID entityID, ENTITY_PROPERTY_UID utype);
 	
 protected:
 	/** 
@@ -306,8 +324,22 @@ protected:
 	// cell1İִִcell2İ
 	BaseMessagesForwardClientHandler*		pBufferedSendToClientMessages_;
 	
-	// Ҫ־ûǷࣨڴsha1ûб಻Ҫ־û
-	uint32									persistentDigest_[5];
+	// ϴд޸Ĺĳ־ûԣ ûб಻Ҫ־û
+	std::set<ENTITY_PROPERTY_UID>			dirtyPersistentPropertys_;
+	bool									allPersistentDirty_;
+
+	// cellֵǷcellݹ(cellʱֻбݻıcellData)
+	bool									cellDataDirty_;
+
+	// ޷޸ĵĳ־ûcellϴдʱժҪڴsha1
+	struct PersistentDigest
+	{
+		uint32 digest[5];
+	};
+
+	typedef std::map<ENTITY_PROPERTY_UID, PersistentDigest> PERSISTENT_DIGESTS;
+	PERSISTENT_DIGESTS						persistentDigests_;
+	PersistentDigest						cellDataDigest_;
 
 	// ʵѾдݿ⣬ôԾǶӦݿӿڵ
 	uint16									dbInterfaceIndex_;
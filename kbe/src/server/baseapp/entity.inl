@@ -104,30 +104,23 @@ INLINE void Entity::shouldAutoBackup(int8 v)
 }
 
 //-------------------------------------------------------------------------------------
-INLINE void Entity::setDirty(uint32* digest)
+INLINE void Entity::setDirty()
 {
-	if (digest)
-	{
-		memcpy((void*)&persistentDigest_[0], (void*)digest, sizeof(persistentDigest_));
-	}
-	else
-	{
-		persistentDigest_[0] = 0;
-		persistentDigest_[1] = 0;
-		persistentDigest_[2] = 0;
-		persistentDigest_[3] = 0;
-		persistentDigest_[4] = 0;
-	}
+	allPersistentDirty_ = true;
+	cellDataDirty_ = true;
+	memset((void*)&cellDataDigest_, 0, sizeof(cellDataDigest_));
+}
+
+//-------------------------------------------------------------------------------------
+INLINE void Entity::setDirty(ENTITY_PROPERTY_UID utype)
+{
+	dirtyPersistentPropertys_.insert(utype);
 }
 
 //-------------------------------------------------------------------------------------
 INLINE bool Entity::isDirty() const
 {
-	return persistentDigest_[0] == 0 &&
-		persistentDigest_[1] == 0 &&
-		persistentDigest_[2] == 0 &&
-		persistentDigest_[3] == 0 &&
-		persistentDigest_[4] == 0;
+	return allPersistentDirty_ || cellDataDirty_ || !dirtyPersistentPropertys_.empty();
 }
 
 //-------------------------------------------------------------------------------------
@@ -432,6 +432,20 @@ void Proxy::onGetWitness()
 	}
 }
 
+//-------------------------------------------------------------------------------------
+void Proxy::onClientBackpressure(bool isBackpressure, uint32 queuedBytes)
+{
+	if(cellEntityCall())
+	{
+		Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+		(*pBundle).newMessage(CellappInterface::onClientBackpressure);
+		(*pBundle) << this->id();
+		(*pBundle) << (uint8)(isBackpressure ? 1 : 0);
+		(*pBundle) << queuedBytes;
+		sendToCellapp(pBundle);
+	}
+}
+
 //-------------------------------------------------------------------------------------
 double Proxy::getRoundTripTime() const
 {
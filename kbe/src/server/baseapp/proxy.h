@@ -163,6 +163,11 @@ public:
 	*/
 	void onGetWitness();
 
+	/**
+		ͻͨݳˮλ/䵽ˮλ ֪ͨcellwitnessͬƵ
+	*/
+	void onClientBackpressure(bool isBackpressure, uint32 queuedBytes);
+
 	/**
 		ͻ˴ӷ߳
 	*/
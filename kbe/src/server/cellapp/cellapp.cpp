@@ -13,6 +13,8 @@
 #include "entity_remotemethod.h"
 #include "initprogress_handler.h"
 #include "forward_message_over_handler.h"
+#include "navigate_threadtasks.h"
+#include "crowd_manager.h"
 #include "network/tcp_packet.h"
 #include "network/udp_packet.h"
 #include "network/network_stats.h"
@@ -51,7 +53,13 @@ Cellapp::Cellapp(Network::EventDispatcher& dispatcher,
 	pWitnessedTimeoutHandler_(NULL),
 	pGhostManager_(NULL),
 	flags_(APP_FLAGS_NONE),
-	spaceViewers_()
+	spaceViewers_(),
+	propertyUpdateEntities_(),
+	numPropertyUpdateMessages_(0),
+	numSavedPropertyUpdateMessages_(0),
+	numPendingNavigateQueries_(0),
+	numNavigateResultsThisTick_(0),
+	numDeferredNavigateResults_(0)
 {
 	KBEngine::Network::MessageHandlers::pMainMessageHandlers = &CellappInterface::messageHandlers;
 
@@ -141,6 +149,11 @@ bool Cellapp::initializeWatcher()
 	WATCH_OBJECT("load", this, &Cellapp::_getLoad);
 	WATCH_OBJECT("spaceSize", &KBEngine::getUsername);
 	WATCH_OBJECT("stats/runningTime", &runningTime);
+	WATCH_OBJECT("stats/numPropertyUpdateMessages", this, &Cellapp::numPropertyUpdateMessages);
+	WATCH_OBJECT("stats/numSavedPropertyUpdateMessages", this, &Cellapp::numSavedPropertyUpdateMessages);
+	WATCH_OBJECT("stats/numPendingNavigateQueries", this, &Cellapp::numPendingNavigateQueries);
+	WATCH_OBJECT("stats/numDeferredNavigateResults", this, &Cellapp::numDeferredNavigateResults);
+	WATCH_OBJECT("stats/numCrowdAgents", &CrowdManager::numTotalAgents);
 	return EntityApp<Entity>::initializeWatcher() && WatchObjectPool::initWatchPools();
 }
 
@@ -183,6 +196,7 @@ bool Cellapp::installPyModules()
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(),		isShuttingDown,					__py_isShuttingDown,									METH_VARARGS,			0);
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(),		address,						__py_address,											METH_VARARGS,			0);
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(),		raycast,						__py_raycast,											METH_VARARGS,			0);
+	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(),		raycastAsync,					__py_raycastAsync,										METH_VARARGS,			0);
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(), 		setAppFlags,					__py_setFlags,											METH_VARARGS,			0);
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(), 		getAppFlags,					__py_getFlags,											METH_VARARGS,			0);
 	
@@ -253,9 +267,23 @@ void Cellapp::handleGameTick()
 	// һҪǰ
 	updateLoad();
 
+	numNavigateResultsThisTick_ = 0;
+
 	EntityApp<Entity>::handleGameTick();
 
+	// һtickԸıwitnessкϲͣ tickĸıһtick
+	std::vector<EntityPtr> propertyUpdateEntities;
+	propertyUpdateEntities.swap(propertyUpdateEntities_);
+
+	std::vector<EntityPtr>::iterator iter = propertyUpdateEntities.begin();
+	for (; iter != propertyUpdateEntities.end(); ++iter)
+		(*iter)->beginPropertyUpdates();
+
 	updatables_.update();
+
+	for (iter = propertyUpdateEntities.begin(); iter != propertyUpdateEntities.end(); ++iter)
+		(*iter)->endPropertyUpdates();
+
 	SpaceMemorys::update();
 }
 
@@ -1773,6 +1801,21 @@ bool Cellapp::removeUpdatable(Updatable* pObject)
 	return updatables_.remove(pObject);
 }
 
+//-------------------------------------------------------------------------------------
+void Cellapp::addPropertyUpdateEntity(Entity* pEntity)
+{
+	propertyUpdateEntities_.push_back(pEntity);
+}
+
+//-------------------------------------------------------------------------------------
+void Cellapp::onPropertyUpdatesSent(uint32 numChanges)
+{
+	++numPropertyUpdateMessages_;
+
+	if (numChanges > 1)
+		numSavedPropertyUpdateMessages_ += numChanges - 1;
+}
+
 //-------------------------------------------------------------------------------------
 void Cellapp::lookApp(Network::Channel* pChannel)
 {
@@ -2206,6 +2249,116 @@ PyObject* Cellapp::__py_raycast(PyObject* self, PyObject* args)
 	return pyHitpos;
 }
 
+//-------------------------------------------------------------------------------------
+PyObject* Cellapp::__py_raycastAsync(PyObject* self, PyObject* args)
+{
+	uint16 currargsSize = (uint16)PyTuple_Size(args);
+
+	int layer = 0;
+	SPACE_ID spaceID = 0;
+
+	PyObject* pyStartPos = NULL;
+	PyObject* pyEndPos = NULL;
+	PyObject* pyCallback = NULL;
+
+	if(currargsSize == 4)
+	{
+		if(PyArg_ParseTuple(args, "IOOO", &spaceID, &pyStartPos, &pyEndPos, &pyCallback) == -1)
+		{
+			PyErr_Format(PyExc_TypeError, "Cellapp::raycastAsync: args error!");
+			PyErr_PrintEx(0);
+			return 0;
+		}
+	}
+	else if(currargsSize == 5)
+	{
+		if(PyArg_ParseTuple(args, "IiOOO", &spaceID, &layer, &pyStartPos, &pyEndPos, &pyCallback) == -1)
+		{
+			PyErr_Format(PyExc_TypeError, "Cellapp::raycastAsync: args error!");
+			PyErr_PrintEx(0);
+			return 0;
+		}
+	}
+	else
+	{
+		PyErr_Format(PyExc_TypeError, "Cellapp::raycastAsync: args error!");
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	if(!PySequence_Check(pyStartPos) || PySequence_Size(pyStartPos) != 3)
+	{
+		PyErr_Format(PyExc_TypeError, "Cellapp::raycastAsync: args1(startPos) invalid!");
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	if(!PySequence_Check(pyEndPos) || PySequence_Size(pyEndPos) != 3)
+	{
+		PyErr_Format(PyExc_TypeError, "Cellapp::raycastAsync: args2(endPos) invalid!");
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	if(!PyCallable_Check(pyCallback))
+	{
+		PyErr_Format(PyExc_TypeError, "Cellapp::raycastAsync: args3(callback) not is callable!");
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	SpaceMemory* pSpace = SpaceMemorys::findSpace(spaceID);
+	if(pSpace == NULL || pSpace->pNavHandle() == NULL)
+	{
+		ERROR_MSG(fmt::format("Cellapp::raycastAsync: not found space({}) or space not addSpaceGeometryMapping!\n", 
+			spaceID));
+
+		Py_RETURN_FALSE;
+	}
+
+	Position3D startPos;
+	Position3D endPos;
+
+	script::ScriptVector3::convertPyObjectToVector3(startPos, pyStartPos);
+	script::ScriptVector3::convertPyObjectToVector3(endPos, pyEndPos);
+
+	CALLBACK_ID callbackID = Cellapp::getSingleton().callbackMgr().save(pyCallback);
+
+	Cellapp::getSingleton().addNavigateQuery(new RaycastTask(pSpace->pNavHandle(), 
+		(int8)layer, callbackID, startPos, endPos));
+
+	Py_RETURN_TRUE;
+}
+
+//-------------------------------------------------------------------------------------
+void Cellapp::addNavigateQuery(thread::TPTask* pTask)
+{
+	// ̳߳ʱ񱻻棬 ͬᱻִ
+	threadPool().addTask(pTask);
+	++numPendingNavigateQueries_;
+}
+
+//-------------------------------------------------------------------------------------
+bool Cellapp::onNavigateQueryResult()
+{
+	uint32 resultsPerTick = g_kbeSrvConfig.getCellApp().navigation_asyncResultsPerTick;
+	if(resultsPerTick > 0 && numNavigateResultsThisTick_ >= resultsPerTick)
+	{
+		++numDeferredNavigateResults_;
+		return false;
+	}
+
+	++numNavigateResultsThisTick_;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void Cellapp::onNavigateQueryCompleted()
+{
+	if(numPendingNavigateQueries_ > 0)
+		--numPendingNavigateQueries_;
+}
+
 //-------------------------------------------------------------------------------------
 PyObject* Cellapp::__py_getFlags(PyObject* self, PyObject* args)
 {
@@ -196,6 +196,15 @@ public:
 	bool addUpdatable(Updatable* pObject);
 	bool removeUpdatable(Updatable* pObject);
 
+	/**
+		ʵлԸı䣬 һtickwitnessϲ͸ͻ
+	*/
+	void addPropertyUpdateEntity(Entity* pEntity);
+	void onPropertyUpdatesSent(uint32 numChanges);
+
+	uint32 numPropertyUpdateMessages() const { return numPropertyUpdateMessages_; }
+	uint32 numSavedPropertyUpdateMessages() const { return numSavedPropertyUpdateMessages_; }
+
 	/**
 		hook entitycallcall
 	*/
@@ -246,6 +255,18 @@ public:
 	*/
 	int raycast(SPACE_ID spaceID, int layer, const Position3D& start, const Position3D& end, std::vector<Position3D>& hitPos);
 	static PyObject* __py_raycast(PyObject* self, PyObject* args);
+	static PyObject* __py_raycastAsync(PyObject* self, PyObject* args);
+
+	/**
+		첽ѯ
+		onNavigateQueryResult̴߳һѯǰã tickĽѴʱfalse
+	*/
+	void addNavigateQuery(thread::TPTask* pTask);
+	bool onNavigateQueryResult();
+	void onNavigateQueryCompleted();
+
+	uint32 numPendingNavigateQueries() const { return numPendingNavigateQueries_; }
+	uint32 numDeferredNavigateResults() const { return numDeferredNavigateResults_; }
 
 	uint32 flags() const { return flags_; }
 	void flags(uint32 v) { flags_ = v; }
@@ -274,6 +295,18 @@ protected:
 
 	// ߲ͨ鿴space
 	SpaceViewers						spaceViewers_;
+
+	// лԸıʵ
+	std::vector<EntityPtr>				propertyUpdateEntities_;
+
+	// ϲ󷢳ԸϢԼϲʡϢ
+	uint32								numPropertyUpdateMessages_;
+	uint32								numSavedPropertyUpdateMessages_;
+
+	// δɵ첽ѯ tickѴĽ 򳬳ÿtick޶ƳٵĽ
+	uint32								numPendingNavigateQueries_;
+	uint32								numNavigateResultsThisTick_;
+	uint32								numDeferredNavigateResults_;
 };
 
 }
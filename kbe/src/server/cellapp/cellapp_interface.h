@@ -192,6 +192,11 @@ NETWORK_INTERFACE_DECLARE_BEGIN(CellappInterface)
 
 	//entityʧһ۲(ͻ)
 	ENTITY_MESSAGE_DECLARE_ARGS0(onLoseWitness,										NETWORK_FIXED_MESSAGE)
+
+	//entityĿͻͨݳˮλ/䵽ˮλ Լʱͨд͵ֽ
+	ENTITY_MESSAGE_DECLARE_ARGS2(onClientBackpressure,								NETWORK_FIXED_MESSAGE,
+									uint8,											isBackpressure,
+									uint32,											queuedBytes)
 NETWORK_INTERFACE_DECLARE_END()
 
 #ifdef DEFINE_IN_INTERFACE
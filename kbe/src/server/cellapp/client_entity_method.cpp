@@ -109,6 +109,9 @@ PyObject* ClientEntityMethod::callmethod(PyObject* args, PyObject* kwds)
 		return 0;
 	}
 
+	// ԸıҪõͻ
+	e->flushPropertyUpdates();
+
 	MethodDescription* methodDescription = getDescription();
 	if(methodDescription->checkArgs(args))
 	{
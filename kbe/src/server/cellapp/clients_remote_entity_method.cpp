@@ -110,6 +110,15 @@ PyObject* ClientsRemoteEntityMethod::callmethod(PyObject* args, PyObject* kwds)
 			S_Return;
 		}
 
+		// ϢϴʱֻһΣ ÿ۲ߵbundleֻдԵϢͷ Ϣİ
+		Network::Bundle* pPayloadBundle = NULL;
+		if (mstream->wpos() >= (size_t)Network::Bundle::SHARED_PAYLOAD_MIN_SIZE)
+		{
+			pPayloadBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+			(*pPayloadBundle).append(mstream->data(), (int)mstream->wpos());
+			pPayloadBundle->seal();
+		}
+
 		if((!otherClients_ && (pEntity->pWitness() && (pEntity->clientEntityCall()))))
 		{
 			Network::Bundle* pSendBundle = NULL;
@@ -122,7 +131,9 @@ PyObject* ClientsRemoteEntityMethod::callmethod(PyObject* args, PyObject* kwds)
 
 			pEntity->clientEntityCall()->newCall_((*pSendBundle));
 
-			if(mstream->wpos() > 0)
+			if(pPayloadBundle)
+				pSendBundle->appendShared(*pPayloadBundle);
+			else if(mstream->wpos() > 0)
 				(*pSendBundle).append(mstream->data(), (int)mstream->wpos());
 
 			if(Network::g_trace_packet > 0)
@@ -160,7 +171,9 @@ PyObject* ClientsRemoteEntityMethod::callmethod(PyObject* args, PyObject* kwds)
 			pEntity->pWitness()->sendToClient(ClientInterface::onRemoteMethodCall, pSendBundle);
 		}
 
-		// 㲥
+		// 㲥ˣ ԸıҪõͻ
+		pEntity->flushPropertyUpdates();
+
 		std::list<ENTITY_ID>::const_iterator iter = entities.begin();
 		for(; iter != entities.end(); ++iter)
 		{
@@ -202,7 +215,9 @@ PyObject* ClientsRemoteEntityMethod::callmethod(PyObject* args, PyObject* kwds)
 				(*pSendBundle)  << pEntity->id();
 			}
 
-			if(mstream->wpos() > 0)
+			if(pPayloadBundle)
+				pSendBundle->appendShared(*pPayloadBundle);
+			else if(mstream->wpos() > 0)
 				(*pSendBundle).append(mstream->data(), (int)mstream->wpos());
 
 			if(Network::g_trace_packet > 0)
@@ -241,6 +256,9 @@ PyObject* ClientsRemoteEntityMethod::callmethod(PyObject* args, PyObject* kwds)
 			pViewEntity->pWitness()->sendToClient(ClientInterface::onRemoteMethodCallOptimized, pSendBundle);
 		}
 
+		if(pPayloadBundle)
+			Network::Bundle::reclaimPoolObject(pPayloadBundle);
+
 		MemoryStream::reclaimPoolObject(mstream);
 	}
 
@@ -1,6 +1,7 @@
 // Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
 #include "coordinate_node.h"
 #include "coordinate_system.h"
+#include "grid_coordinate_system.h"
 #include "profile.h"
 
 #ifndef CODE_INLINE
@@ -62,6 +63,15 @@ CoordinateSystem::~CoordinateSystem()
 	releaseNodes();
 }
 
+//-------------------------------------------------------------------------------------
+CoordinateSystem* CoordinateSystem::create(uint16 type, float gridCellSize)
+{
+	if (type == COORDINATE_SYSTEM_TYPE_GRID)
+		return new GridCoordinateSystem(gridCellSize);
+
+	return new CoordinateSystem();
+}
+
 //-------------------------------------------------------------------------------------
 bool CoordinateSystem::insert(CoordinateNode* pNode)
 {
@@ -10,24 +10,40 @@
 
 namespace KBEngine{
 
+/**
+	ϵͳ(AOI)ʵ
+*/
+enum COORDINATE_SYSTEM_TYPE
+{
+	COORDINATE_SYSTEM_TYPE_LIST = 0,	// ʮ
+	COORDINATE_SYSTEM_TYPE_GRID = 1,	// 
+};
+
 class CoordinateNode;
 
 class CoordinateSystem
 {
 public:
 	CoordinateSystem();
-	~CoordinateSystem();
+	virtual ~CoordinateSystem();
+
+	/**
+		𴴽һϵͳ
+	*/
+	static CoordinateSystem* create(uint16 type, float gridCellSize);
+
+	virtual uint16 type() const { return COORDINATE_SYSTEM_TYPE_LIST; }
 
 	/**
 		listвڵ
 	*/
-	bool insert(CoordinateNode* pNode);
+	virtual bool insert(CoordinateNode* pNode);
 
 	/**
 		ڵlistƳ
 	*/
 	bool remove(CoordinateNode* pNode);
-	bool removeReal(CoordinateNode* pNode);
+	virtual bool removeReal(CoordinateNode* pNode);
 	void removeDelNodes();
 	void releaseNodes();
 
@@ -35,7 +51,7 @@ public:
 		ĳڵб䶯ʱҪlistе
 		λõϢ
 	*/
-	void update(CoordinateNode* pNode);
+	virtual void update(CoordinateNode* pNode);
 
 	/**
 		ƶڵ
@@ -57,7 +73,7 @@ public:
 	INLINE void incUpdating();
 	INLINE void decUpdating();
 
-private:
+protected:
 	uint32 size_;
 
 	// βָ
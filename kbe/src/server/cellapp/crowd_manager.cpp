@@ -0,0 +1,256 @@
+// Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
+
+#include "cellapp.h"
+#include "entity.h"
+#include "crowd_manager.h"
+#include "crowd_navigate_handler.h"
+#include "helper/profile.h"
+#include "navigation/navigation_mesh_handle.h"
+#include "navigation/DetourCrowd.h"
+
+namespace KBEngine{
+
+uint32 CrowdManager::numTotalAgents_ = 0;
+
+//-------------------------------------------------------------------------------------
+CrowdManager::CrowdManager(SPACE_ID spaceID, int layer):
+spaceID_(spaceID),
+layer_(layer),
+pNavHandle_(),
+pCrowd_(NULL),
+handlers_(),
+numAgents_(0)
+{
+}
+
+//-------------------------------------------------------------------------------------
+CrowdManager::~CrowdManager()
+{
+	std::vector<CrowdNavigateHandler*>::iterator iter = handlers_.begin();
+	for(; iter != handlers_.end(); ++iter)
+	{
+		if((*iter))
+			(*iter)->detachCrowdManager();
+	}
+
+	numTotalAgents_ -= numAgents_;
+	numAgents_ = 0;
+
+	if(pCrowd_)
+	{
+		dtFreeCrowd(pCrowd_);
+		pCrowd_ = NULL;
+	}
+
+	pNavHandle_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+bool CrowdManager::initialize(NavigationHandlePtr pNavHandle)
+{
+	if(pNavHandle == NULL || pNavHandle->type() != NavigationHandle::NAV_MESH)
+	{
+		ERROR_MSG(fmt::format("CrowdManager::initialize: space({}) has no navmesh!\n", spaceID_));
+		return false;
+	}
+
+	NavMeshHandle* pNavMeshHandle = static_cast<NavMeshHandle*>(pNavHandle.get());
+	std::map<int, NavMeshHandle::NavmeshLayer>::iterator iter = pNavMeshHandle->navmeshLayer.find(layer_);
+	if(iter == pNavMeshHandle->navmeshLayer.end())
+	{
+		ERROR_MSG(fmt::format("CrowdManager::initialize: space({}) not found layer({})!\n", spaceID_, layer_));
+		return false;
+	}
+
+	const ENGINE_COMPONENT_INFO& cellappInfo = g_kbeSrvConfig.getCellApp();
+
+	pCrowd_ = dtAllocCrowd();
+	if(!pCrowd_ || !pCrowd_->init((int)cellappInfo.navigation_crowdMaxAgents, cellappInfo.navigation_crowdAgentRadius,
+		iter->second.pNavmesh))
+	{
+		ERROR_MSG(fmt::format("CrowdManager::initialize: space({}) layer({}) init crowd error!\n", spaceID_, layer_));
+		return false;
+	}
+
+	pNavHandle_ = pNavHandle;
+	handlers_.resize(pCrowd_->getAgentCount(), NULL);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+int CrowdManager::addAgent(const Position3D& pos, const Position3D& destPos, float speed)
+{
+	const dtNavMeshQuery* pNavmeshQuery = pCrowd_->getNavMeshQuery();
+	const dtQueryFilter* pFilter = pCrowd_->getFilter(0);
+
+	float dest[3] = {destPos.x, destPos.y, destPos.z};
+	float nearestPos[3];
+	dtPolyRef destRef = 0;
+
+	pNavmeshQuery->findNearestPoly(dest, pCrowd_->getQueryExtents(), pFilter, &destRef, nearestPos);
+	if(destRef == 0)
+		return -1;
+
+	const ENGINE_COMPONENT_INFO& cellappInfo = g_kbeSrvConfig.getCellApp();
+
+	dtCrowdAgentParams params;
+	memset(&params, 0, sizeof(params));
+	params.radius = cellappInfo.navigation_crowdAgentRadius;
+	params.height = cellappInfo.navigation_crowdAgentHeight;
+	params.maxSpeed = speed;
+	params.maxAcceleration = speed * 8.f;
+	params.collisionQueryRange = params.radius * 12.f;
+	params.pathOptimizationRange = params.radius * 30.f;
+	params.separationWeight = 2.f;
+	params.updateFlags = DT_CROWD_ANTICIPATE_TURNS | DT_CROWD_OBSTACLE_AVOIDANCE | DT_CROWD_SEPARATION |
+		DT_CROWD_OPTIMIZE_VIS | DT_CROWD_OPTIMIZE_TOPO;
+	params.obstacleAvoidanceType = 0;
+	params.queryFilterType = 0;
+
+	float start[3] = {pos.x, pos.y, pos.z};
+	int idx = pCrowd_->addAgent(start, &params);
+	if(idx < 0)
+		return -1;
+
+	pCrowd_->requestMoveTarget(idx, destRef, nearestPos);
+
+	++numAgents_;
+	++numTotalAgents_;
+	return idx;
+}
+
+//-------------------------------------------------------------------------------------
+void CrowdManager::removeAgent(int idx)
+{
+	KBE_ASSERT(idx >= 0 && idx < (int)handlers_.size());
+
+	handlers_[idx] = NULL;
+	pCrowd_->removeAgent(idx);
+
+	--numAgents_;
+	--numTotalAgents_;
+}
+
+//-------------------------------------------------------------------------------------
+void CrowdManager::resetAgentPosition(int idx, const Position3D& pos)
+{
+	dtCrowdAgent* pAgent = pCrowd_->getEditableAgent(idx);
+
+	float start[3] = {pos.x, pos.y, pos.z};
+	float nearest[3];
+	dtPolyRef ref = 0;
+	dtVcopy(nearest, start);
+
+	dtStatus status = pCrowd_->getNavMeshQuery()->findNearestPoly(start, pCrowd_->getQueryExtents(),
+		pCrowd_->getFilter(pAgent->params.queryFilterType), &ref, nearest);
+
+	if(dtStatusFailed(status))
+	{
+		dtVcopy(nearest, start);
+		ref = 0;
+	}
+
+	// 与dtCrowd::addAgent中的初始化相同
+	pAgent->corridor.reset(ref, nearest);
+	pAgent->boundary.reset();
+	pAgent->partial = false;
+	pAgent->topologyOptTime = 0;
+	pAgent->targetReplanTime = 0;
+	pAgent->nneis = 0;
+
+	dtVset(pAgent->dvel, 0, 0, 0);
+	dtVset(pAgent->nvel, 0, 0, 0);
+	dtVset(pAgent->vel, 0, 0, 0);
+	dtVcopy(pAgent->npos, nearest);
+
+	pAgent->desiredSpeed = 0;
+	pAgent->state = ref ? DT_CROWDAGENT_STATE_WALKING : DT_CROWDAGENT_STATE_INVALID;
+
+	if(pAgent->targetRef)
+	{
+		float targetPos[3];
+		dtVcopy(targetPos, pAgent->targetPos);
+		pCrowd_->requestMoveTarget(idx, pAgent->targetRef, targetPos);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void CrowdManager::attachHandler(int idx, CrowdNavigateHandler* pHandler)
+{
+	KBE_ASSERT(idx >= 0 && idx < (int)handlers_.size() && handlers_[idx] == NULL);
+	handlers_[idx] = pHandler;
+}
+
+//-------------------------------------------------------------------------------------
+void CrowdManager::update()
+{
+	if(numAgents_ == 0)
+		return;
+
+	AUTO_SCOPED_PROFILE("crowdUpdate");
+
+	float hertz = (float)g_kbeSrvConfig.gameUpdateHertz();
+
+	// 脚本可能修改了实体的位置或者通过Entity.accelerate修改了速度
+	for(int i = 0; i < (int)handlers_.size(); ++i)
+	{
+		CrowdNavigateHandler* pHandler = handlers_[i];
+		if(pHandler == NULL || pHandler->isDestroyed())
+			continue;
+
+		Entity* pEntity = pHandler->pEntity();
+		if(pEntity && !pEntity->isDestroyed())
+		{
+			Vector3 movement = pEntity->position() - pHandler->lastPos();
+			if(KBEVec3LengthSq(&movement) > 0.0001f)
+				resetAgentPosition(i, pEntity->position());
+		}
+
+		const dtCrowdAgent* pAgent = pCrowd_->getAgent(i);
+		float speed = pHandler->velocity() * hertz;
+		if(fabs(pAgent->params.maxSpeed - speed) > 0.0001f)
+		{
+			dtCrowdAgentParams params = pAgent->params;
+			params.maxSpeed = speed;
+			params.maxAcceleration = speed * 8.f;
+			pCrowd_->updateAgentParameters(i, &params);
+		}
+	}
+
+	pCrowd_->update(1.f / hertz, NULL);
+
+	// 将新位置批量写回实体， 回调中可能销毁其他handler， 因此每次都重新检查
+	for(int i = 0; i < (int)handlers_.size(); ++i)
+	{
+		CrowdNavigateHandler* pHandler = handlers_[i];
+		if(pHandler == NULL || pHandler->isDestroyed())
+			continue;
+
+		Entity* pEntity = pHandler->pEntity();
+		if(pEntity == NULL || pEntity->isDestroyed() || !pEntity->isReal() || pEntity->spaceID() != spaceID_)
+		{
+			if(pEntity && !pEntity->isDestroyed())
+				pEntity->stopMove();
+			else
+				pHandler->destroy();
+
+			continue;
+		}
+
+		const dtCrowdAgent* pAgent = pCrowd_->getAgent(i);
+
+		bool failed = pAgent->state == DT_CROWDAGENT_STATE_INVALID ||
+			pAgent->targetState == DT_CROWDAGENT_TARGET_FAILED;
+
+		// 周围的agent会互相推挤， 因此至少以agent半径作为到达的范围
+		float arriveRange = std::max(pHandler->distance(), pAgent->params.radius);
+		bool arrived = pAgent->targetState == DT_CROWDAGENT_TARGET_VALID &&
+			dtVdist2DSqr(pAgent->npos, pAgent->targetPos) <= arriveRange * arriveRange;
+
+		pHandler->onCrowdUpdate(Position3D(pAgent->npos[0], pAgent->npos[1], pAgent->npos[2]),
+			Vector3(pAgent->vel[0], pAgent->vel[1], pAgent->vel[2]), arrived, failed);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+}
@@ -0,0 +1,72 @@
+// Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
+
+#ifndef KBE_CROWDMANAGER_H
+#define KBE_CROWDMANAGER_H
+
+#include "common/common.h"
+#include "helper/debug_helper.h"
+#include "math/math.h"
+#include "navigation/navigation_handle.h"
+
+class dtCrowd;
+
+namespace KBEngine{
+
+class CrowdNavigateHandler;
+
+/**
+	space中一个导航层的群体移动管理器(DetourCrowd)
+	通过Entity.crowdNavigate移动的实体作为dtCrowd的agent， 每个tick由space统一调用一次dtCrowd::update，
+	然后将所有agent的新位置批量写回实体(同时更新实体的坐标节点)， agent之间有局部避让。
+*/
+class CrowdManager
+{
+public:
+	CrowdManager(SPACE_ID spaceID, int layer);
+	~CrowdManager();
+
+	bool initialize(NavigationHandlePtr pNavHandle);
+
+	/**
+		添加一个agent并设置移动目标， speed为每秒移动的距离
+		agent已满或者目标点不在导航网格上时返回-1
+	*/
+	int addAgent(const Position3D& pos, const Position3D& destPos, float speed);
+	void removeAgent(int idx);
+
+	/**
+		将agent重新放置到pos并重新请求移动目标(脚本修改了实体的位置)
+	*/
+	void resetAgentPosition(int idx, const Position3D& pos);
+
+	void attachHandler(int idx, CrowdNavigateHandler* pHandler);
+
+	void update();
+
+	int layer() const { return layer_; }
+	uint32 numAgents() const { return numAgents_; }
+
+	/**
+		当前cellapp上所有space的agent数量
+	*/
+	static uint32 numTotalAgents() { return numTotalAgents_; }
+
+protected:
+	SPACE_ID spaceID_;
+	int layer_;
+
+	// 持有导航句柄， 保证space重新加载几何数据时navmesh不会在dtCrowd之前被释放
+	NavigationHandlePtr pNavHandle_;
+
+	dtCrowd* pCrowd_;
+
+	// agent索引对应的移动处理器
+	std::vector<CrowdNavigateHandler*> handlers_;
+	uint32 numAgents_;
+
+	static uint32 numTotalAgents_;
+};
+
+}
+
+#endif // KBE_CROWDMANAGER_H
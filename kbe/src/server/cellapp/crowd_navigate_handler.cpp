@@ -0,0 +1,81 @@
+// Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
+
+#include "cellapp.h"
+#include "entity.h"
+#include "crowd_manager.h"
+#include "crowd_navigate_handler.h"
+
+namespace KBEngine{
+
+
+//-------------------------------------------------------------------------------------
+CrowdNavigateHandler::CrowdNavigateHandler(KBEShared_ptr<Controller>& pController, const Position3D& destPos,
+											 float velocity, float distance, bool faceMovement,
+											PyObject* userarg, CrowdManager* pCrowdManager, int agentIdx):
+MoveToPointHandler(pController, pCrowdManager->layer(), destPos, velocity, distance, faceMovement, false, userarg),
+pCrowdManager_(pCrowdManager),
+agentIdx_(agentIdx),
+lastPos_(pController->pEntity()->position())
+{
+	updatableName = "CrowdNavigateHandler";
+
+	pCrowdManager_->attachHandler(agentIdx_, this);
+}
+
+//-------------------------------------------------------------------------------------
+CrowdNavigateHandler::~CrowdNavigateHandler()
+{
+	if(pCrowdManager_)
+		pCrowdManager_->removeAgent(agentIdx_);
+}
+
+//-------------------------------------------------------------------------------------
+bool CrowdNavigateHandler::update()
+{
+	// 位置由CrowdManager统一更新
+	if (isDestroyed_)
+	{
+		delete this;
+		return false;
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void CrowdNavigateHandler::onCrowdUpdate(const Position3D& pos, const Vector3& vel, bool arrived, bool failed)
+{
+	Entity* pEntity = pController_->pEntity();
+	Py_INCREF(pEntity);
+
+	if(failed)
+	{
+		// onMoveFailure中会销毁移动控制器
+		pEntity->onMoveFailure(pController_->id(), pyuserarg_);
+		Py_DECREF(pEntity);
+		return;
+	}
+
+	Position3D currpos_backup = pEntity->position();
+	Direction3D direction = pEntity->direction();
+
+	// 是否需要改变面向
+	if (faceMovement_ && (vel.x != 0.f || vel.z != 0.f))
+		direction.yaw(vel.yaw());
+
+	// 设置entity的新位置和面向
+	pEntity->setPositionAndDirection(pos, direction);
+	lastPos_ = pos;
+	pEntity->isOnGround(isOnGround());
+
+	// 通知脚本
+	pEntity->onMove(pController_->id(), layer_, currpos_backup, pyuserarg_);
+
+	if(!isDestroyed_ && arrived)
+		requestMoveOver(currpos_backup);
+
+	Py_DECREF(pEntity);
+}
+
+//-------------------------------------------------------------------------------------
+}
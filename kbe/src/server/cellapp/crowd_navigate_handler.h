@@ -0,0 +1,53 @@
+// Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
+
+#ifndef KBE_CROWDNAVIGATEHANDLER_H
+#define KBE_CROWDNAVIGATEHANDLER_H
+
+#include "move_controller.h"
+#include "math/math.h"
+
+namespace KBEngine{
+
+class CrowdManager;
+
+/**
+	Entity.crowdNavigate
+	位置由CrowdManager在每个tick统一更新， 自身的update只负责销毁。
+*/
+class CrowdNavigateHandler : public MoveToPointHandler
+{
+public:
+	CrowdNavigateHandler(KBEShared_ptr<Controller>& pController, const Position3D& destPos, float velocity, float distance, bool faceMovement,
+		PyObject* userarg, CrowdManager* pCrowdManager, int agentIdx);
+
+	virtual ~CrowdNavigateHandler();
+
+	virtual bool update();
+
+	virtual bool isOnGround(){ return true; }
+
+	virtual MoveType type() const { return MOVE_TYPE_CROWD; }
+
+	/**
+		dtCrowd::update之后由CrowdManager调用
+	*/
+	void onCrowdUpdate(const Position3D& pos, const Vector3& vel, bool arrived, bool failed);
+
+	void detachCrowdManager() { pCrowdManager_ = NULL; }
+
+	/**
+		上一次写回实体的位置， 与实体当前位置不同说明脚本修改了实体的位置
+	*/
+	const Position3D& lastPos() const { return lastPos_; }
+
+	Entity* pEntity() const { return pController_->pEntity(); }
+	float distance() const { return distance_; }
+
+protected:
+	CrowdManager* pCrowdManager_;
+	int agentIdx_;
+	Position3D lastPos_;
+};
+
+}
+#endif // KBE_CROWDNAVIGATEHANDLER_H
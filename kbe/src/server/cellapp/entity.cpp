@@ -17,6 +17,9 @@
 #include "moveto_point_handler.h"	
 #include "moveto_entity_handler.h"	
 #include "navigate_handler.h"	
+#include "navigate_threadtasks.h"
+#include "crowd_manager.h"
+#include "crowd_navigate_handler.h"
 #include "rotator_handler.h"
 #include "turn_controller.h"
 #include "pyscript/py_gc.h"
@@ -56,6 +59,10 @@ SCRIPT_METHOD_DECLARE("canNavigate",				pycanNavigate,					METH_VARARGS,				0)
 SCRIPT_METHOD_DECLARE("navigatePathPoints",			pyNavigatePathPoints,			METH_VARARGS,				0)
 SCRIPT_METHOD_DECLARE("navigate",					pyNavigate,						METH_VARARGS,				0)
 SCRIPT_METHOD_DECLARE("getRandomPoints",			pyGetRandomPoints,				METH_VARARGS,				0)
+SCRIPT_METHOD_DECLARE("navigatePathPointsAsync",	pyNavigatePathPointsAsync,		METH_VARARGS,				0)
+SCRIPT_METHOD_DECLARE("navigateAsync",				pyNavigateAsync,				METH_VARARGS,				0)
+SCRIPT_METHOD_DECLARE("getRandomPointsAsync",		pyGetRandomPointsAsync,			METH_VARARGS,				0)
+SCRIPT_METHOD_DECLARE("crowdNavigate",				pyCrowdNavigate,				METH_VARARGS,				0)
 SCRIPT_METHOD_DECLARE("moveToPoint",				pyMoveToPoint,					METH_VARARGS,				0)
 SCRIPT_METHOD_DECLARE("moveToEntity",				pyMoveToEntity,					METH_VARARGS,				0)
 SCRIPT_METHOD_DECLARE("accelerate",					pyAccelerate,					METH_VARARGS,				0)
@@ -122,7 +129,10 @@ pControllers_(new Controllers(id)),
 pyPositionChangedCallback_(),
 pyDirectionChangedCallback_(),
 layer_(0),
-pCustomVolatileinfo_(NULL)
+pCustomVolatileinfo_(NULL),
+pVolatileDataCache_(NULL),
+pendingPropertyUpdates_(),
+propertyUpdates_()
 {
 	setDirty();
 
@@ -147,6 +157,10 @@ Entity::~Entity()
 	ENTITY_DECONSTRUCTION(Entity);
 
 	S_RELEASE(pCustomVolatileinfo_);
+	SAFE_RELEASE(pVolatileDataCache_);
+
+	endPropertyUpdates();
+	clearPropertyUpdates(pendingPropertyUpdates_);
 
 	S_RELEASE(clientEntityCall_);
 	S_RELEASE(baseEntityCall_);
@@ -717,79 +731,13 @@ void Entity::onDefDataChanged(EntityComponent* pEntityComponent, const PropertyD
 		}
 	}
 	
-	const Position3D& basePos = this->position(); 
 	if((flags & ENTITY_BROADCAST_OTHER_CLIENT_FLAGS) > 0)
 	{
-		DETAIL_TYPE propertyDetailLevel = propertyDescription->getDetailLevel();
-
-		std::list<ENTITY_ID>::iterator witer = witnesses_.begin();
-		for(; witer != witnesses_.end(); ++witer)
-		{
-			Entity* pEntity = Cellapp::getSingleton().findEntity((*witer));
-			if(pEntity == NULL || pEntity->pWitness() == NULL)
-				continue;
-
-			EntityCall* clientEntityCall = pEntity->clientEntityCall();
-			if(clientEntityCall == NULL)
-				continue;
-
-			Network::Channel* pChannel = clientEntityCall->getChannel();
-			if(pChannel == NULL)
-				continue;
-
-			// ǴڵģԴcreateWitnessFromStream()
-			// ԼentityδĿͻϴ
-			if(!pEntity->pWitness()->entityInView(id()))
-				continue;
-
-			const Position3D& targetPos = pEntity->position();
-			Position3D lengthPos = targetPos - basePos;
-
-			if(pScriptModule_->getDetailLevel().level[propertyDetailLevel].inLevel(lengthPos.length()))
-			{
-				Network::Bundle* pSendBundle = pChannel->createSendBundle();
-				NETWORK_ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pEntity->id(), (*pSendBundle));
-				
-				int ialiasID = -1;
-				const Network::MessageHandler& msgHandler = pEntity->pWitness()->getViewEntityMessageHandler(ClientInterface::onUpdatePropertys, 
-					ClientInterface::onUpdatePropertysOptimized, id(), ialiasID);
-				
-				ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pSendBundle, msgHandler, viewEntityMessage);
-				
-				if(ialiasID != -1)
-				{
-					KBE_ASSERT(msgHandler.msgID == ClientInterface::onUpdatePropertysOptimized.msgID);
-					(*pSendBundle)  << (uint8)ialiasID;
-				}
-				else
-				{
-					KBE_ASSERT(msgHandler.msgID == ClientInterface::onUpdatePropertys.msgID);
-					(*pSendBundle)  << id();
-				}
-				
-				if (pScriptModule_->usePropertyDescrAlias())
-				{
-					(*pSendBundle) << componentPropertyAliasID;
-					(*pSendBundle) << propertyDescription->aliasIDAsUint8();
-				}
-				else
-				{
-					(*pSendBundle) << componentPropertyUID;
-					(*pSendBundle) << propertyDescription->getUType();
-				}
-
-				pSendBundle->append(*mstream);
-				
-				// ¼¼С
-				g_publicClientEventHistoryStats.trackEvent(scriptName(), 
-					propertyDescription->getName(), 
-					pSendBundle->currMsgLength());
+		addPropertyUpdate(componentPropertyUID, componentPropertyAliasID, propertyDescription, mstream);
 
-				ENTITY_MESSAGE_FORWARD_CLIENT_END(pSendBundle, msgHandler, viewEntityMessage);
-
-				pEntity->pWitness()->sendToClient(ClientInterface::onUpdatePropertysOptimized, pSendBundle);
-			}
-		}
+		// ûпϲʱͣ ڱtick۲߸ʱϲ
+		if(!g_kbeSrvConfig.getCellApp().witness_coalescePropertyUpdates)
+			flushPropertyUpdates();
 	}
 
 	/*
@@ -892,6 +840,161 @@ void Entity::onDefDataChanged(EntityComponent* pEntityComponent, const PropertyD
 	MemoryStream::reclaimPoolObject(mstream);
 }
 
+//-------------------------------------------------------------------------------------
+void Entity::addPropertyUpdate(ENTITY_PROPERTY_UID componentPropertyUID, int8 componentPropertyAliasID, 
+	const PropertyDescription* propertyDescription, const MemoryStream* pData)
+{
+	// һθıʱǼǵcellapp ڹ۲߸ǰ
+	if(pendingPropertyUpdates_.size() == 0 && g_kbeSrvConfig.getCellApp().witness_coalescePropertyUpdates)
+		Cellapp::getSingleton().addPropertyUpdateEntity(this);
+
+	PROPERTY_UPDATES::iterator iter = pendingPropertyUpdates_.begin();
+	for(; iter != pendingPropertyUpdates_.end(); ++iter)
+	{
+		if(iter->pPropertyDescription == propertyDescription && iter->componentPropertyUID == componentPropertyUID)
+			break;
+	}
+
+	if(iter == pendingPropertyUpdates_.end())
+	{
+		PropertyUpdate update;
+		update.componentPropertyUID = componentPropertyUID;
+		update.componentPropertyAliasID = componentPropertyAliasID;
+		update.pPropertyDescription = propertyDescription;
+		update.pData = MemoryStream::createPoolObject(OBJECTPOOL_POINT);
+		update.numChanges = 0;
+		iter = pendingPropertyUpdates_.insert(pendingPropertyUpdates_.end(), update);
+	}
+	else
+	{
+		// ͬһtickٴθı䣬 ֵֻ
+		iter->pData->clear(false);
+	}
+
+	iter->pData->append(*pData);
+	++iter->numChanges;
+}
+
+//-------------------------------------------------------------------------------------
+void Entity::clearPropertyUpdates(PROPERTY_UPDATES& updates)
+{
+	PROPERTY_UPDATES::iterator iter = updates.begin();
+	for(; iter != updates.end(); ++iter)
+		MemoryStream::reclaimPoolObject(iter->pData);
+
+	updates.clear();
+}
+
+//-------------------------------------------------------------------------------------
+void Entity::beginPropertyUpdates()
+{
+	if(pendingPropertyUpdates_.size() == 0)
+		return;
+
+	clearPropertyUpdates(propertyUpdates_);
+	propertyUpdates_.swap(pendingPropertyUpdates_);
+}
+
+//-------------------------------------------------------------------------------------
+void Entity::endPropertyUpdates()
+{
+	clearPropertyUpdates(propertyUpdates_);
+}
+
+//-------------------------------------------------------------------------------------
+void Entity::flushPropertyUpdates()
+{
+	// һtickĸı䱾tickлδй۲߷ͣ ֮ĸıϲһ𷢳
+	// ۲߸ʱþɵֵǵ﷢ֵ
+	if(propertyUpdates_.size() > 0)
+	{
+		PROPERTY_UPDATES updates;
+		updates.swap(propertyUpdates_);
+
+		PROPERTY_UPDATES::iterator iter = updates.begin();
+		for(; iter != updates.end(); ++iter)
+		{
+			PROPERTY_UPDATES::iterator piter = pendingPropertyUpdates_.begin();
+			for(; piter != pendingPropertyUpdates_.end(); ++piter)
+			{
+				if(piter->pPropertyDescription == iter->pPropertyDescription && 
+					piter->componentPropertyUID == iter->componentPropertyUID)
+					break;
+			}
+
+			// Ѿµֵ
+			if(piter != pendingPropertyUpdates_.end())
+			{
+				piter->numChanges += iter->numChanges;
+				MemoryStream::reclaimPoolObject(iter->pData);
+				iter->pData = NULL;
+			}
+		}
+
+		// ָıȺ˳
+		iter = updates.begin();
+		while(iter != updates.end())
+		{
+			if(iter->pData == NULL)
+				iter = updates.erase(iter);
+			else
+				++iter;
+		}
+
+		updates.insert(updates.end(), pendingPropertyUpdates_.begin(), pendingPropertyUpdates_.end());
+		pendingPropertyUpdates_.swap(updates);
+	}
+
+	if(pendingPropertyUpdates_.size() == 0)
+		return;
+
+	std::list<ENTITY_ID>::iterator witer = witnesses_.begin();
+	for(; witer != witnesses_.end(); ++witer)
+	{
+		Entity* pEntity = Cellapp::getSingleton().findEntity((*witer));
+		if(pEntity == NULL || pEntity->pWitness() == NULL)
+			continue;
+
+		EntityCall* clientEntityCall = pEntity->clientEntityCall();
+		if(clientEntityCall == NULL)
+			continue;
+
+		Network::Channel* pChannel = clientEntityCall->getChannel();
+		if(pChannel == NULL)
+			continue;
+
+		// ǴڵģԴcreateWitnessFromStream()
+		// ԼentityδĿͻϴ
+		if(!pEntity->pWitness()->entityInView(id()))
+			continue;
+
+		Network::Bundle* pSendBundle = pChannel->createSendBundle();
+
+		// õǰpSendBundleǷݣݱʾbundleõĻݰ
+		bool isBufferedSendBundleMessageLength = pSendBundle->packets().size() > 0 ? true : 
+			(pSendBundle->pCurrPacket() && pSendBundle->pCurrPacket()->length() > 0);
+
+		NETWORK_ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pEntity->id(), (*pSendBundle));
+
+		if(pEntity->pWitness()->addPropertyUpdatesToStream(pSendBundle, this, pendingPropertyUpdates_))
+		{
+			pEntity->pWitness()->sendToClient(ClientInterface::onUpdatePropertysOptimized, pSendBundle);
+		}
+		else if(isBufferedSendBundleMessageLength)
+		{
+			// û鼶Χڵԣ NETWORK_ENTITY_MESSAGE_FORWARD_CLIENT_BEGINӻİĨ
+			pSendBundle->revokeMessage(8);
+			pChannel->pushBundle(pSendBundle);
+		}
+		else
+		{
+			Network::Bundle::reclaimPoolObject(pSendBundle);
+		}
+	}
+
+	clearPropertyUpdates(pendingPropertyUpdates_);
+}
+
 //-------------------------------------------------------------------------------------
 void Entity::onRemoteMethodCall(Network::Channel* pChannel, MemoryStream& s)
 {
@@ -2215,6 +2318,30 @@ void Entity::onLoseWitness(Network::Channel* pChannel)
 	CALL_ENTITY_AND_COMPONENTS_METHOD(this, SCRIPT_OBJECT_CALL_ARGS0(pyTempObj, const_cast<char*>("onLoseWitness"), GETERR));
 }
 
+//-------------------------------------------------------------------------------------
+void Entity::onClientBackpressure(Network::Channel* pChannel, uint8 isBackpressure, uint32 queuedBytes)
+{
+	if (!isReal())
+	{
+		// Ҫת
+		GhostManager* gm = Cellapp::getSingleton().pGhostManager();
+		if (gm)
+		{
+			Network::Bundle* pBundle = gm->createSendBundle(realCell());
+			pBundle->newMessage(CellappInterface::onClientBackpressure);
+			(*pBundle) << id();
+			(*pBundle) << isBackpressure;
+			(*pBundle) << queuedBytes;
+			gm->pushMessage(realCell(), pBundle);
+		}
+
+		return;
+	}
+
+	if (pWitness_)
+		pWitness_->onClientBackpressure(isBackpressure > 0, queuedBytes);
+}
+
 //-------------------------------------------------------------------------------------
 int Entity::pySetLayer(PyObject *value)
 {
@@ -2670,6 +2797,13 @@ uint32 Entity::navigate(const Position3D& destination, float velocity, float dis
 		return 0;
 	}
 
+	return startNavigate(destination, velocity, distance, maxMoveDistance, faceMovement, paths_ptr, userData);
+}
+
+//-------------------------------------------------------------------------------------
+uint32 Entity::startNavigate(const Position3D& destination, float velocity, float distance, float maxMoveDistance,
+	bool faceMovement, VECTOR_POS3D_PTR paths_ptr, PyObject* userData)
+{
 	stopMove();
 
 	velocity = velocity / g_kbeSrvConfig.gameUpdateHertz();
@@ -2729,6 +2863,246 @@ PyObject* Entity::pyNavigate(PyObject_ptr pyDestination, float velocity, float d
 		maxDistance, faceMovement > 0, layer, userData));
 }
 
+//-------------------------------------------------------------------------------------
+uint32 Entity::crowdNavigate(const Position3D& destination, float velocity, float distance,
+	bool faceMovement, int8 layer, PyObject* userData)
+{
+	SpaceMemory* pSpace = SpaceMemorys::findSpace(spaceID());
+	if(pSpace == NULL || !pSpace->isGood())
+	{
+		ERROR_MSG(fmt::format("Entity::crowdNavigate(): not found space({}), entityID({})!\n",
+			spaceID(), id()));
+
+		return 0;
+	}
+
+	CrowdManager* pCrowdManager = pSpace->findOrCreateCrowdManager(layer);
+	if(pCrowdManager == NULL)
+		return 0;
+
+	int agentIdx = pCrowdManager->addAgent(position(), destination, velocity);
+	if(agentIdx < 0)
+		return 0;
+
+	// ֮ǰȺ嵼agenthandlerʱƳ
+	stopMove();
+
+	velocity = velocity / g_kbeSrvConfig.gameUpdateHertz();
+
+	KBEShared_ptr<Controller> p(new MoveController(this, NULL));
+
+	new CrowdNavigateHandler(p, destination, velocity, 
+		distance, faceMovement, userData, pCrowdManager, agentIdx);
+
+	bool ret = pControllers_->add(p);
+	KBE_ASSERT(ret);
+	
+	pMoveController_ = p;
+	return p->id();
+}
+
+//-------------------------------------------------------------------------------------
+PyObject* Entity::pyCrowdNavigate(PyObject_ptr pyDestination, float velocity, float distance,
+								 int8 faceMovement, int8 layer, PyObject_ptr userData)
+{
+	if(!isReal())
+	{
+		PyErr_Format(PyExc_AssertionError, "%s::crowdNavigate: not is real entity(%d).", 
+			scriptName(), id());
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	if(this->isDestroyed())
+	{
+		PyErr_Format(PyExc_AssertionError, "%s::crowdNavigate: %d is destroyed!\n",		
+			scriptName(), id());		
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	Position3D destination;
+
+	if(!PySequence_Check(pyDestination) || PySequence_Size(pyDestination) != 3)
+	{
+		PyErr_Format(PyExc_TypeError, "%s::crowdNavigate: args1(position) invalid!", scriptName());
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	// Ϣȡ
+	script::ScriptVector3::convertPyObjectToVector3(destination, pyDestination);
+
+	return PyLong_FromLong(crowdNavigate(destination, velocity, distance, 
+		faceMovement > 0, layer, userData));
+}
+
+//-------------------------------------------------------------------------------------
+static NavigationHandlePtr findAsyncNavHandle(Entity* pEntity, const char* funcName)
+{
+	SpaceMemory* pSpace = SpaceMemorys::findSpace(pEntity->spaceID());
+	if(pSpace == NULL || !pSpace->isGood())
+	{
+		ERROR_MSG(fmt::format("Entity::{}(): not found space({}), entityID({})!\n",
+			funcName, pEntity->spaceID(), pEntity->id()));
+
+		return NavigationHandlePtr();
+	}
+
+	NavigationHandlePtr pNavHandle = pSpace->pNavHandle();
+
+	if(!pNavHandle)
+	{
+		WARNING_MSG(fmt::format("Entity::{}(): space({}), entityID({}), not found navhandle!\n",
+			funcName, pEntity->spaceID(), pEntity->id()));
+	}
+
+	return pNavHandle;
+}
+
+//-------------------------------------------------------------------------------------
+bool Entity::navigateAsync(const Position3D& destination, float velocity, float distance, float maxMoveDistance, float maxSearchDistance,
+	bool faceMovement, int8 layer, PyObject* userData, PyObject* pyCallback)
+{
+	NavigationHandlePtr pNavHandle = findAsyncNavHandle(this, "navigateAsync");
+	if(!pNavHandle)
+		return false;
+
+	CALLBACK_ID callbackID = 0;
+	if(pyCallback != NULL && pyCallback != Py_None)
+		callbackID = Cellapp::getSingleton().callbackMgr().save(pyCallback);
+
+	CALLBACK_ID userDataID = Cellapp::getSingleton().callbackMgr().save(userData);
+
+	Cellapp::getSingleton().addNavigateQuery(new NavigateTask(pNavHandle, layer, id(), callbackID, 
+		position_, destination, velocity, distance, maxMoveDistance, faceMovement, userDataID));
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool Entity::navigatePathPointsAsync(const Position3D& destination, float maxSearchDistance, int8 layer, PyObject* pyCallback)
+{
+	NavigationHandlePtr pNavHandle = findAsyncNavHandle(this, "navigatePathPointsAsync");
+	if(!pNavHandle)
+		return false;
+
+	CALLBACK_ID callbackID = Cellapp::getSingleton().callbackMgr().save(pyCallback);
+
+	Cellapp::getSingleton().addNavigateQuery(new FindPathTask(pNavHandle, layer, id(), callbackID, 
+		position_, destination));
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool Entity::getRandomPointsAsync(const Position3D& centerPos, float maxRadius, uint32 maxPoints, int8 layer, PyObject* pyCallback)
+{
+	NavigationHandlePtr pNavHandle = findAsyncNavHandle(this, "getRandomPointsAsync");
+	if(!pNavHandle)
+		return false;
+
+	CALLBACK_ID callbackID = Cellapp::getSingleton().callbackMgr().save(pyCallback);
+
+	Cellapp::getSingleton().addNavigateQuery(new RandomPointsTask(pNavHandle, layer, id(), callbackID, 
+		centerPos, maxRadius, maxPoints));
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+PyObject* Entity::pyNavigateAsync(PyObject_ptr pyDestination, float velocity, float distance, float maxMoveDistance, float maxDistance,
+	int8 faceMovement, int8 layer, PyObject_ptr userData, PyObject_ptr pyCallback)
+{
+	if(!isReal())
+	{
+		PyErr_Format(PyExc_AssertionError, "%s::navigateAsync: not is real entity(%d).", 
+			scriptName(), id());
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	if(this->isDestroyed())
+	{
+		PyErr_Format(PyExc_AssertionError, "%s::navigateAsync: %d is destroyed!\n",		
+			scriptName(), id());		
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	if(!PySequence_Check(pyDestination) || PySequence_Size(pyDestination) != 3)
+	{
+		PyErr_Format(PyExc_TypeError, "%s::navigateAsync: args1(position) invalid!", scriptName());
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	if(pyCallback != Py_None && !PyCallable_Check(pyCallback))
+	{
+		PyErr_Format(PyExc_TypeError, "%s::navigateAsync: args9(callback) not is callable!", scriptName());
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	Position3D destination;
+
+	// Ϣȡ
+	script::ScriptVector3::convertPyObjectToVector3(destination, pyDestination);
+
+	return PyBool_FromLong(navigateAsync(destination, velocity, distance, maxMoveDistance, 
+		maxDistance, faceMovement > 0, layer, userData, pyCallback));
+}
+
+//-------------------------------------------------------------------------------------
+PyObject* Entity::pyNavigatePathPointsAsync(PyObject_ptr pyDestination, float maxSearchDistance, int8 layer, PyObject_ptr pyCallback)
+{
+	if(!PySequence_Check(pyDestination) || PySequence_Size(pyDestination) != 3)
+	{
+		PyErr_Format(PyExc_TypeError, "%s::navigatePathPointsAsync: args1(position) invalid!", scriptName());
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	if(!PyCallable_Check(pyCallback))
+	{
+		PyErr_Format(PyExc_TypeError, "%s::navigatePathPointsAsync: args4(callback) not is callable!", scriptName());
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	Position3D destination;
+
+	// Ϣȡ
+	script::ScriptVector3::convertPyObjectToVector3(destination, pyDestination);
+
+	return PyBool_FromLong(navigatePathPointsAsync(destination, maxSearchDistance, layer, pyCallback));
+}
+
+//-------------------------------------------------------------------------------------
+PyObject* Entity::pyGetRandomPointsAsync(PyObject_ptr pyCenterPos, float maxRadius, uint32 maxPoints, int8 layer, PyObject_ptr pyCallback)
+{
+	if(!PySequence_Check(pyCenterPos) || PySequence_Size(pyCenterPos) != 3)
+	{
+		PyErr_Format(PyExc_TypeError, "%s::getRandomPointsAsync: args1(position) invalid!", scriptName());
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	if(!PyCallable_Check(pyCallback))
+	{
+		PyErr_Format(PyExc_TypeError, "%s::getRandomPointsAsync: args5(callback) not is callable!", scriptName());
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	Position3D centerPos;
+
+	// Ϣȡ
+	script::ScriptVector3::convertPyObjectToVector3(centerPos, pyCenterPos);
+
+	return PyBool_FromLong(getRandomPointsAsync(centerPos, maxRadius, maxPoints, layer, pyCallback));
+}
+
 //-------------------------------------------------------------------------------------
 bool Entity::getRandomPoints(std::vector<Position3D>& outPoints, const Position3D& centerPos,
 	float maxRadius, uint32 maxPoints, int8 layer)
@@ -3968,6 +4342,9 @@ void Entity::changeToGhost(COMPONENT_ID realCell, KBEngine::MemoryStream& s)
 	KBE_ASSERT(isReal() == true && "Entity::changeToGhost(): not is real.\n");
 	KBE_ASSERT(realCell_ != g_componentID);
 
+	// Ϊghost֮ٷԸı䣬 Ҫȷͳȥ
+	flushPropertyUpdates();
+
 	realCell_ = realCell;
 	ghostCell_ = 0;
 	
@@ -4264,6 +4641,18 @@ void Entity::createWitnessFromStream(KBEngine::MemoryStream& s)
 //-------------------------------------------------------------------------------------
 void Entity::addMovementHandlerToStream(KBEngine::MemoryStream& s)
 {
+	// Ⱥ嵼ǰspaceCrowdManager Ǩƣ ֹͣ
+	if(pMoveController_)
+	{
+		MoveToPointHandler* pMoveToPointHandler = static_cast<MoveController*>(pMoveController_.get())->pMoveToPointHandler();
+		if(pMoveToPointHandler && pMoveToPointHandler->type() == MoveToPointHandler::MOVE_TYPE_CROWD)
+		{
+			cancelController(pMoveController_->id());
+			pMoveController_->destroy();
+			pMoveController_.reset();
+		}
+	}
+
 	if(pMoveController_)
 	{
 		s << true;
@@ -41,6 +41,20 @@ class Bundle;
 }
 
 typedef SmartPointer<Entity> EntityPtr;
+
+/**
+	㲥ͻ˵Ըı䣬 ͬһtickеĸı仺ʵϣ ɹ۲Witness::updateкϲ
+	ͬһֵֻ numChangesΪϲĸı
+*/
+struct PropertyUpdate
+{
+	ENTITY_PROPERTY_UID componentPropertyUID;
+	int8 componentPropertyAliasID;
+	const PropertyDescription* pPropertyDescription;
+	MemoryStream* pData;
+	uint32 numChanges;
+};
+
 typedef std::vector<EntityPtr> SPACE_ENTITIES;
 
 class Entity : public script::ScriptObject
@@ -291,6 +305,33 @@ public:
 	DECLARE_PY_MOTHOD_ARG3(pyNavigatePathPoints, PyObject_ptr, float, int8);
 	DECLARE_PY_MOTHOD_ARG8(pyNavigate, PyObject_ptr, float, float, float, float, int8, int8, PyObject_ptr);
 
+	/**
+		Ѿҵ·ʼƶ
+	*/
+	uint32 startNavigate(const Position3D& destination, float velocity, float distance,
+					float maxMoveDistance, bool faceMovement, VECTOR_POS3D_PTR paths_ptr, PyObject* userData);
+
+	/** 
+		entity첽 ̳߳вѯ ͨصű
+	*/
+	bool navigateAsync(const Position3D& destination, float velocity, float distance,
+					float maxMoveDistance, float maxSearchDistance,
+					bool faceMovement, int8 layer, PyObject* userData, PyObject* pyCallback);
+	bool navigatePathPointsAsync(const Position3D& destination, float maxSearchDistance, int8 layer, PyObject* pyCallback);
+	bool getRandomPointsAsync(const Position3D& centerPos, float maxRadius, uint32 maxPoints, int8 layer, PyObject* pyCallback);
+
+	DECLARE_PY_MOTHOD_ARG9(pyNavigateAsync, PyObject_ptr, float, float, float, float, int8, int8, PyObject_ptr, PyObject_ptr);
+	DECLARE_PY_MOTHOD_ARG4(pyNavigatePathPointsAsync, PyObject_ptr, float, int8, PyObject_ptr);
+	DECLARE_PY_MOTHOD_ARG5(pyGetRandomPointsAsync, PyObject_ptr, float, uint32, int8, PyObject_ptr);
+
+	/** 
+		entityȺ嵼 spaceCrowdManagerͳһƶ Ⱥ嵼entity
+	*/
+	uint32 crowdNavigate(const Position3D& destination, float velocity, float distance,
+					bool faceMovement, int8 layer, PyObject* userData);
+
+	DECLARE_PY_MOTHOD_ARG6(pyCrowdNavigate, PyObject_ptr, float, float, int8, int8, PyObject_ptr);
+
 	/** 
 		entity 
 	*/
@@ -410,6 +451,11 @@ public:
 	*/
 	void onLoseWitness(Network::Channel* pChannel);
 
+	/** ӿ
+		entityĿͻͨݳˮλ/䵽ˮλ
+	*/
+	void onClientBackpressure(Network::Channel* pChannel, uint8 isBackpressure, uint32 queuedBytes);
+
 	/** 
 		client
 	*/
@@ -580,6 +626,77 @@ public:
 	INLINE VolatileInfo* pCustomVolatileinfo(void);
 	DECLARE_PY_GETSET_MOTHOD(pyGetVolatileinfo, pySetVolatileinfo);
 
+	/**
+		tickѾõvolatileݣ Witness䲢й۲֮乲
+		ͬһentityλóÿ۲ظ
+		ÿָϵ棬 ۲Ҫϲͬʱụา
+		ֻб۲߱entityŻᴴ volatileDataCache()
+	*/
+	struct VolatileDataCache
+	{
+		enum
+		{
+			// λ(ޡxzxyz)볯(yawpitchroll)24ϣ Żģʽֻг8
+			VARIANT_MAX = 3 * 8 + 8,
+
+			// Ϊxyzypr6float
+			DATA_SIZE_MAX = sizeof(float) * 6
+		};
+
+		struct Variant
+		{
+			uint8 size;
+			uint8 data[DATA_SIZE_MAX];
+		};
+
+		VolatileDataCache():
+		time(0),
+		position(),
+		direction(),
+		validMask(0)
+		{
+		}
+
+		GAME_TIME time;
+
+		// ʱλó ͬһtickڱű޸ĺҪ±
+		Position3D position;
+		Direction3D direction;
+
+		// ÿһλʾvariantsжӦǷѾ
+		uint32 validMask;
+		Variant variants[VARIANT_MAX];
+	};
+
+	INLINE VolatileDataCache& volatileDataCache();
+
+	/**
+		㲥ͻ˵Ըı
+	*/
+	typedef std::vector<PropertyUpdate> PROPERTY_UPDATES;
+
+	/**
+		tickҪ۲߷͵Ըı
+	*/
+	INLINE const PROPERTY_UPDATES& propertyUpdates() const;
+
+	/**
+		һ㲥ͻ˵Ըı
+	*/
+	void addPropertyUpdate(ENTITY_PROPERTY_UID componentPropertyUID, int8 componentPropertyAliasID, 
+		const PropertyDescription* propertyDescription, const MemoryStream* pData);
+
+	/**
+		۲߸֮ǰȡԸı䣬 ۲߸֮ͷ
+	*/
+	void beginPropertyUpdates();
+	void endPropertyUpdates();
+
+	/**
+		Ըı䷢͸ͻˣ ֮󷢳ϢЩı䵽ͻ
+	*/
+	void flushPropertyUpdates();
+
 	/**
 		ʵĻصпܱ
 	*/
@@ -593,6 +710,11 @@ private:
 	void _sendBaseTeleportResult(ENTITY_ID sourceEntityID, COMPONENT_ID sourceBaseAppID, 
 		SPACE_ID spaceID, SPACE_ID lastSpaceID, bool fromCellTeleport);
 
+	/** 
+		ͷŻԸı
+	*/
+	static void clearPropertyUpdates(PROPERTY_UPDATES& updates);
+
 private:
 	struct BufferedScriptCall
 	{
@@ -684,6 +806,12 @@ protected:
 
 	// ûùVolatileinfo˴VolatileinfoΪNULLʹScriptDefModuleVolatileinfo
 	VolatileInfo*											pCustomVolatileinfo_;
+
+	VolatileDataCache*										pVolatileDataCache_;
+
+	// tickлԸı۲ڷ͵Ըı
+	PROPERTY_UPDATES										pendingPropertyUpdates_;
+	PROPERTY_UPDATES										propertyUpdates_;
 };
 
 }
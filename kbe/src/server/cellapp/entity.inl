@@ -292,5 +292,21 @@ INLINE VolatileInfo* Entity::pCustomVolatileinfo(void)
 	return pCustomVolatileinfo_;
 }
 
+//-------------------------------------------------------------------------------------
+INLINE Entity::VolatileDataCache& Entity::volatileDataCache()
+{
+	// 󲿷entityûй۲ߣ һαʱŴ
+	if (pVolatileDataCache_ == NULL)
+		pVolatileDataCache_ = new VolatileDataCache();
+
+	return *pVolatileDataCache_;
+}
+
+//-------------------------------------------------------------------------------------
+INLINE const Entity::PROPERTY_UPDATES& Entity::propertyUpdates() const
+{
+	return propertyUpdates_;
+}
+
 //-------------------------------------------------------------------------------------
 }
@@ -4,6 +4,7 @@
 #include "entity_coordinate_node.h"
 #include "entity.h"
 #include "coordinate_system.h"
+#include "grid_coordinate_system.h"
 #include "range_trigger_node.h"
 
 namespace KBEngine{	
@@ -467,6 +468,14 @@ bool EntityCoordinateNode::delWatcherNode(CoordinateNode* pNode)
 void EntityCoordinateNode::entitiesInRange(std::vector<Entity*>& foundEntities, CoordinateNode* rootNode,
 									  const Position3D& originPos, float radius, int entityUType)
 {
+	// ϵͳûάʮֱӲѯ
+	CoordinateSystem* pCoordinateSystem = rootNode->pCoordinateSystem();
+	if (pCoordinateSystem && pCoordinateSystem->type() == COORDINATE_SYSTEM_TYPE_GRID)
+	{
+		static_cast<GridCoordinateSystem*>(pCoordinateSystem)->entitiesInRange(foundEntities, originPos, radius, entityUType);
+		return;
+	}
+
 	std::set<Entity*> entities_X;
 	std::set<Entity*> entities_Z;
 
@@ -0,0 +1,551 @@
+// Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
+
+#include "grid_coordinate_system.h"
+#include "coordinate_node.h"
+#include "entity.h"
+#include "entity_coordinate_node.h"
+#include "range_trigger.h"
+#include "range_trigger_node.h"
+#include "profile.h"
+
+namespace KBEngine{
+
+//-------------------------------------------------------------------------------------
+GridCoordinateSystem::GridCoordinateSystem(float cellSize):
+CoordinateSystem(),
+cellSize_(cellSize < 1.f ? 1.f : cellSize),
+cells_(),
+nodeCells_(),
+triggers_(),
+deadTriggers_(),
+negativeBoundaryNodes_(),
+cellKeys_()
+{
+}
+
+//-------------------------------------------------------------------------------------
+GridCoordinateSystem::~GridCoordinateSystem()
+{
+	// 先将等待删除的节点移入releases_， 由基类统一释放
+	removeDelNodes();
+
+	std::vector<CoordinateNode*> nodes;
+
+	NODE_CELLS::iterator nodeIter = nodeCells_.begin();
+	for (; nodeIter != nodeCells_.end(); ++nodeIter)
+		nodes.push_back(nodeIter->first);
+
+	TRIGGERS::iterator triggerIter = triggers_.begin();
+	for (; triggerIter != triggers_.end(); ++triggerIter)
+	{
+		nodes.push_back(triggerIter->first);
+		delete triggerIter->second;
+	}
+
+	nodes.insert(nodes.end(), negativeBoundaryNodes_.begin(), negativeBoundaryNodes_.end());
+
+	cells_.clear();
+	nodeCells_.clear();
+	triggers_.clear();
+	negativeBoundaryNodes_.clear();
+	releaseTriggerStates();
+
+	std::vector<CoordinateNode*>::iterator iter = nodes.begin();
+	for (; iter != nodes.end(); ++iter)
+	{
+		(*iter)->pCoordinateSystem(NULL);
+		delete (*iter);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+bool GridCoordinateSystem::insert(CoordinateNode* pNode)
+{
+	pNode->pCoordinateSystem(this);
+	++size_;
+
+	if (pNode->hasFlags(COORDINATE_NODE_FLAG_ENTITY))
+	{
+		// 节点之前不在任何触发器范围内
+		pNode->old_xx(-FLT_MAX);
+		pNode->old_yy(-FLT_MAX);
+		pNode->old_zz(-FLT_MAX);
+
+		update(pNode);
+		return true;
+	}
+
+	// 触发器节点在安装流程中调用update时才真正生效
+	if (pNode->hasFlags(COORDINATE_NODE_FLAG_POSITIVE_BOUNDARY))
+	{
+		RangeTriggerNode* pTriggerNode = static_cast<RangeTriggerNode*>(pNode);
+		if (triggers_.find(pTriggerNode) == triggers_.end())
+			triggers_[pTriggerNode] = new TriggerState(pTriggerNode);
+	}
+	else
+	{
+		negativeBoundaryNodes_.insert(pNode);
+	}
+
+	pNode->x(pNode->xx());
+	pNode->y(pNode->yy());
+	pNode->z(pNode->zz());
+	pNode->resetOld();
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool GridCoordinateSystem::removeReal(CoordinateNode* pNode)
+{
+	if (pNode->pCoordinateSystem() == NULL)
+	{
+		return true;
+	}
+
+	if (pNode->hasFlags(COORDINATE_NODE_FLAG_ENTITY))
+	{
+		NODE_CELLS::iterator iter = nodeCells_.find(pNode);
+		if (iter != nodeCells_.end())
+		{
+			delNodeFromCell(pNode, iter->second);
+			nodeCells_.erase(iter);
+		}
+	}
+	else if (pNode->hasFlags(COORDINATE_NODE_FLAG_POSITIVE_BOUNDARY))
+	{
+		uninstallTrigger(static_cast<RangeTriggerNode*>(pNode));
+	}
+	else
+	{
+		negativeBoundaryNodes_.erase(pNode);
+	}
+
+	pNode->pCoordinateSystem(NULL);
+	releases_.push_back(pNode);
+
+	--size_;
+
+	if (updating_ == 0)
+		releaseTriggerStates();
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void GridCoordinateSystem::update(CoordinateNode* pNode)
+{
+	AUTO_SCOPED_PROFILE("coordinateSystemUpdates");
+
+	++updating_;
+
+	if (pNode->hasFlags(COORDINATE_NODE_FLAG_ENTITY))
+	{
+		onEntityNodeUpdate(pNode);
+	}
+	else
+	{
+		if (pNode->hasFlags(COORDINATE_NODE_FLAG_POSITIVE_BOUNDARY))
+			onTriggerNodeUpdate(static_cast<RangeTriggerNode*>(pNode));
+
+		pNode->x(pNode->xx());
+		pNode->y(pNode->yy());
+		pNode->z(pNode->zz());
+		pNode->resetOld();
+	}
+
+	--updating_;
+
+	if (updating_ == 0)
+		releaseTriggerStates();
+}
+
+//-------------------------------------------------------------------------------------
+void GridCoordinateSystem::onEntityNodeUpdate(CoordinateNode* pNode)
+{
+	bool removing = pNode->hasFlags(COORDINATE_NODE_FLAG_REMOVING | COORDINATE_NODE_FLAG_REMOVED);
+
+	float oldX = pNode->old_xx();
+	float oldY = pNode->old_yy();
+	float oldZ = pNode->old_zz();
+
+	float newX = pNode->xx();
+	float newY = pNode->yy();
+	float newZ = pNode->zz();
+
+	NODE_CELLS::iterator nodeIter = nodeCells_.find(pNode);
+	bool hasOldCell = nodeIter != nodeCells_.end();
+	CELL_KEY oldKey = hasOldCell ? nodeIter->second : 0;
+
+	int32 newCellX = removing ? 0 : toCellIndex(newX);
+	int32 newCellZ = removing ? 0 : toCellIndex(newZ);
+	CELL_KEY newKey = toCellKey(newCellX, newCellZ);
+	bool cellChanged = removing || !hasOldCell || oldKey != newKey;
+
+	// 先根据触发器的范围计算出所有的进入与离开事件， 回调中可能会修改网格，因此不能边遍历边回调
+	TRIGGER_EVENTS events;
+
+	if (hasOldCell)
+	{
+		CELLS::iterator cellIter = cells_.find(oldKey);
+		if (cellIter != cells_.end())
+		{
+			std::vector<TriggerState*>::iterator iter = cellIter->second.triggers.begin();
+			for (; iter != cellIter->second.triggers.end(); ++iter)
+			{
+				TriggerState* pState = (*iter);
+				if (pState->pTriggerNode->pRangeTrigger()->origin() == pNode)
+					continue;
+
+				bool wasIn = pState->isInRange(oldX, oldY, oldZ);
+				bool isIn = !removing && pState->isInRange(newX, newY, newZ);
+
+				if (wasIn != isIn)
+					events.push_back(TriggerEvent(pState, pNode, isIn));
+			}
+		}
+	}
+
+	if (!removing && cellChanged)
+	{
+		CELLS::iterator cellIter = cells_.find(newKey);
+		if (cellIter != cells_.end())
+		{
+			int32 oldCellX = (int32)(uint32)(oldKey >> 32);
+			int32 oldCellZ = (int32)(uint32)(oldKey & 0xffffffff);
+
+			std::vector<TriggerState*>::iterator iter = cellIter->second.triggers.begin();
+			for (; iter != cellIter->second.triggers.end(); ++iter)
+			{
+				TriggerState* pState = (*iter);
+
+				// 同时覆盖新旧网格的触发器已经检查过了
+				if (hasOldCell && pState->cells.contains(oldCellX, oldCellZ))
+					continue;
+
+				if (pState->pTriggerNode->pRangeTrigger()->origin() == pNode)
+					continue;
+
+				bool wasIn = pState->isInRange(oldX, oldY, oldZ);
+				bool isIn = pState->isInRange(newX, newY, newZ);
+
+				if (wasIn != isIn)
+					events.push_back(TriggerEvent(pState, pNode, isIn));
+			}
+		}
+	}
+
+	// 更新节点所在的网格
+	if (cellChanged)
+	{
+		if (hasOldCell)
+		{
+			delNodeFromCell(pNode, oldKey);
+			nodeCells_.erase(nodeIter);
+		}
+
+		if (!removing)
+		{
+			cells_[newKey].nodes.push_back(pNode);
+			nodeCells_[pNode] = newKey;
+		}
+	}
+
+	// 回调之前节点的位置必须已经生效，否则回调中嵌套的update会产生重复的事件
+	pNode->x(newX);
+	pNode->y(newY);
+	pNode->z(newZ);
+	pNode->resetOld();
+
+	fireEvents(events);
+}
+
+//-------------------------------------------------------------------------------------
+void GridCoordinateSystem::onTriggerNodeUpdate(RangeTriggerNode* pTriggerNode)
+{
+	TRIGGERS::iterator triggerIter = triggers_.find(pTriggerNode);
+	if (triggerIter == triggers_.end())
+		return;
+
+	// 触发器被删除时不产生离开事件， 与CoordinateSystem的行为保持一致
+	if (pTriggerNode->hasFlags(COORDINATE_NODE_FLAG_REMOVING | COORDINATE_NODE_FLAG_REMOVED))
+	{
+		uninstallTrigger(pTriggerNode);
+		return;
+	}
+
+	RangeTrigger* pRangeTrigger = pTriggerNode->pRangeTrigger();
+	if (pRangeTrigger == NULL || pRangeTrigger->origin() == NULL)
+		return;
+
+	CoordinateNode* pOrigin = pRangeTrigger->origin();
+	if (pOrigin->hasFlags(COORDINATE_NODE_FLAG_REMOVING | COORDINATE_NODE_FLAG_REMOVED))
+		return;
+
+	TriggerState* pState = triggerIter->second;
+	TriggerState oldState = *pState;
+
+	float originX = pOrigin->xx();
+	float originY = pOrigin->yy();
+	float originZ = pOrigin->zz();
+	float rangeXZ = pRangeTrigger->range_xz();
+	float rangeY = pRangeTrigger->range_y();
+
+	pState->hasRange = true;
+	pState->minX = originX - rangeXZ;
+	pState->maxX = originX + rangeXZ;
+	pState->minY = originY - rangeY;
+	pState->maxY = originY + rangeY;
+	pState->minZ = originZ - rangeXZ;
+	pState->maxZ = originZ + rangeXZ;
+
+	// 范围没有改变
+	if (oldState.hasRange && pState->minX == oldState.minX && pState->maxX == oldState.maxX &&
+		pState->minY == oldState.minY && pState->maxY == oldState.maxY &&
+		pState->minZ == oldState.minZ && pState->maxZ == oldState.maxZ)
+		return;
+
+	CellRange cells(toCellIndex(pState->minX), toCellIndex(pState->maxX),
+		toCellIndex(pState->minZ), toCellIndex(pState->maxZ));
+
+	// 去掉最外一圈部分覆盖的网格后， 同时处于新旧范围之内的网格中的节点必定在新旧范围内， 不会产生事件
+	// (节点自身移动时由onEntityNodeUpdate检查)， 因此只需要检查进入和离开覆盖范围的网格以及新旧范围的边缘
+	CellRange inner;
+
+	if (oldState.hasRange && (!CoordinateSystem::hasY || 
+		(pState->minY == oldState.minY && pState->maxY == oldState.maxY)))
+	{
+		inner = CellRange(std::max(cells.minX, oldState.cells.minX) + 1, std::min(cells.maxX, oldState.cells.maxX) - 1,
+			std::max(cells.minZ, oldState.cells.minZ) + 1, std::min(cells.maxZ, oldState.cells.maxZ) - 1);
+	}
+
+	TRIGGER_EVENTS events;
+
+	// 新范围中除内部以外的网格
+	collectCellKeys(cells, inner);
+
+	std::vector<CELL_KEY>::iterator keyIter = cellKeys_.begin();
+	for (; keyIter != cellKeys_.end(); ++keyIter)
+	{
+		CELLS::iterator cellIter = cells_.find((*keyIter));
+		if (cellIter != cells_.end())
+			collectCellEvents(cellIter->second, oldState, pState, pOrigin, events);
+	}
+
+	if (!(cells == oldState.cells))
+	{
+		// 离开覆盖范围的网格
+		collectCellKeys(oldState.cells, cells);
+
+		for (keyIter = cellKeys_.begin(); keyIter != cellKeys_.end(); ++keyIter)
+		{
+			CELLS::iterator cellIter = cells_.find((*keyIter));
+			if (cellIter != cells_.end())
+				collectCellEvents(cellIter->second, oldState, pState, pOrigin, events);
+		}
+
+		// 只在进入与离开的网格上登记和注销触发器
+		delTriggerFromCells(pState, oldState.cells, cells);
+		addTriggerToCells(pState, cells, oldState.cells);
+		pState->cells = cells;
+	}
+
+	fireEvents(events);
+}
+
+//-------------------------------------------------------------------------------------
+void GridCoordinateSystem::collectCellEvents(const Cell& cell, const TriggerState& oldState, TriggerState* pState,
+	CoordinateNode* pOrigin, TRIGGER_EVENTS& events)
+{
+	std::vector<CoordinateNode*>::const_iterator iter = cell.nodes.begin();
+	for (; iter != cell.nodes.end(); ++iter)
+	{
+		CoordinateNode* pNode = (*iter);
+		if (pNode == pOrigin)
+			continue;
+
+		bool wasIn = oldState.isInRange(pNode->old_xx(), pNode->old_yy(), pNode->old_zz());
+		bool isIn = pState->isInRange(pNode->old_xx(), pNode->old_yy(), pNode->old_zz());
+
+		if (wasIn != isIn)
+			events.push_back(TriggerEvent(pState, pNode, isIn));
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void GridCoordinateSystem::fireEvents(const TRIGGER_EVENTS& events)
+{
+	TRIGGER_EVENTS::const_iterator iter = events.begin();
+	for (; iter != events.end(); ++iter)
+	{
+		const TriggerEvent& event = (*iter);
+
+		// 之前的回调中可能卸载了触发器
+		if (event.pState->pTriggerNode == NULL)
+			continue;
+
+		RangeTrigger* pRangeTrigger = event.pState->pTriggerNode->pRangeTrigger();
+		if (pRangeTrigger == NULL)
+			continue;
+
+		// 之前的回调中节点可能又被移动或删除了，此时由嵌套的update负责产生事件
+		CoordinateNode* pNode = event.pNode;
+		bool isIn = !pNode->hasFlags(COORDINATE_NODE_FLAG_REMOVING | COORDINATE_NODE_FLAG_REMOVED) &&
+			event.pState->isInRange(pNode->old_xx(), pNode->old_yy(), pNode->old_zz());
+
+		if (isIn != event.isEnter)
+			continue;
+
+		if (event.isEnter)
+			pRangeTrigger->onEnter(pNode);
+		else
+			pRangeTrigger->onLeave(pNode);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void GridCoordinateSystem::collectCellKeys(const CellRange& range, const CellRange& exclude)
+{
+	cellKeys_.clear();
+
+	for (int32 x = range.minX; x <= range.maxX; ++x)
+	{
+		bool excludeX = x >= exclude.minX && x <= exclude.maxX;
+
+		for (int32 z = range.minZ; z <= range.maxZ; ++z)
+		{
+			// 直接跳过exclude覆盖的这一段
+			if (excludeX && z >= exclude.minZ && z <= exclude.maxZ)
+			{
+				z = exclude.maxZ;
+				continue;
+			}
+
+			cellKeys_.push_back(toCellKey(x, z));
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void GridCoordinateSystem::addTriggerToCells(TriggerState* pState, const CellRange& range, const CellRange& exclude)
+{
+	collectCellKeys(range, exclude);
+
+	std::vector<CELL_KEY>::iterator keyIter = cellKeys_.begin();
+	for (; keyIter != cellKeys_.end(); ++keyIter)
+		cells_[(*keyIter)].triggers.push_back(pState);
+}
+
+//-------------------------------------------------------------------------------------
+void GridCoordinateSystem::delTriggerFromCells(TriggerState* pState, const CellRange& range, const CellRange& exclude)
+{
+	collectCellKeys(range, exclude);
+
+	std::vector<CELL_KEY>::iterator keyIter = cellKeys_.begin();
+	for (; keyIter != cellKeys_.end(); ++keyIter)
+	{
+		CELLS::iterator cellIter = cells_.find((*keyIter));
+		if (cellIter == cells_.end())
+			continue;
+
+		std::vector<TriggerState*>& triggers = cellIter->second.triggers;
+		std::vector<TriggerState*>::iterator iter = std::find(triggers.begin(), triggers.end(), pState);
+		if (iter != triggers.end())
+		{
+			(*iter) = triggers.back();
+			triggers.pop_back();
+		}
+
+		if (triggers.empty() && cellIter->second.nodes.empty())
+			cells_.erase(cellIter);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void GridCoordinateSystem::delNodeFromCell(CoordinateNode* pNode, CELL_KEY key)
+{
+	CELLS::iterator cellIter = cells_.find(key);
+	if (cellIter == cells_.end())
+		return;
+
+	std::vector<CoordinateNode*>& nodes = cellIter->second.nodes;
+	std::vector<CoordinateNode*>::iterator iter = std::find(nodes.begin(), nodes.end(), pNode);
+	if (iter != nodes.end())
+	{
+		(*iter) = nodes.back();
+		nodes.pop_back();
+	}
+
+	if (nodes.empty() && cellIter->second.triggers.empty())
+		cells_.erase(cellIter);
+}
+
+//-------------------------------------------------------------------------------------
+void GridCoordinateSystem::uninstallTrigger(RangeTriggerNode* pTriggerNode)
+{
+	TRIGGERS::iterator triggerIter = triggers_.find(pTriggerNode);
+	if (triggerIter == triggers_.end())
+		return;
+
+	TriggerState* pState = triggerIter->second;
+	triggers_.erase(triggerIter);
+
+	delTriggerFromCells(pState, pState->cells);
+	pState->cells = CellRange();
+	pState->pTriggerNode = NULL;
+	pState->hasRange = false;
+	deadTriggers_.push_back(pState);
+}
+
+//-------------------------------------------------------------------------------------
+void GridCoordinateSystem::releaseTriggerStates()
+{
+	std::vector<TriggerState*>::iterator iter = deadTriggers_.begin();
+	for (; iter != deadTriggers_.end(); ++iter)
+		delete (*iter);
+
+	deadTriggers_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+void GridCoordinateSystem::entitiesInRange(std::vector<Entity*>& foundEntities, const Position3D& originPos,
+	float radius, int entityUType)
+{
+	int32 cellMinX = toCellIndex(originPos.x - radius);
+	int32 cellMaxX = toCellIndex(originPos.x + radius);
+	int32 cellMinZ = toCellIndex(originPos.z - radius);
+	int32 cellMaxZ = toCellIndex(originPos.z + radius);
+
+	for (int32 x = cellMinX; x <= cellMaxX; ++x)
+	{
+		for (int32 z = cellMinZ; z <= cellMaxZ; ++z)
+		{
+			CELLS::iterator cellIter = cells_.find(toCellKey(x, z));
+			if (cellIter == cells_.end())
+				continue;
+
+			std::vector<CoordinateNode*>::iterator iter = cellIter->second.nodes.begin();
+			for (; iter != cellIter->second.nodes.end(); ++iter)
+			{
+				CoordinateNode* pNode = (*iter);
+				if (pNode->hasFlags(COORDINATE_NODE_FLAG_HIDE_OR_REMOVED))
+					continue;
+
+				Entity* pEntity = static_cast<EntityCoordinateNode*>(pNode)->pEntity();
+				if (entityUType != -1 && pEntity->pScriptModule()->getUType() != (ENTITY_SCRIPT_UID)entityUType)
+					continue;
+
+				const Position3D& position = pEntity->position();
+				if (fabs(position.x - originPos.x) > radius || fabs(position.z - originPos.z) > radius)
+					continue;
+
+				if (CoordinateSystem::hasY && fabs(position.y - originPos.y) > radius)
+					continue;
+
+				foundEntities.push_back(pEntity);
+			}
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------
+}
@@ -0,0 +1,179 @@
+// Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
+
+#ifndef KBE_GRID_COORDINATE_SYSTEM_H
+#define KBE_GRID_COORDINATE_SYSTEM_H
+
+#include "coordinate_system.h"
+#include "math/math.h"
+
+namespace KBEngine{
+
+class Entity;
+class RangeTriggerNode;
+
+/**
+	基于均匀网格(空间哈希)的坐标系统
+	实体节点按照xz坐标落入网格， 触发器登记在其范围覆盖的所有网格上，
+	节点移动时只需要检查新旧网格上登记的触发器， 不再需要沿着十字链表逐个节点移动。
+	触发器的onEnter/onLeave语义与CoordinateSystem保持一致。
+*/
+class GridCoordinateSystem : public CoordinateSystem
+{
+public:
+	GridCoordinateSystem(float cellSize);
+	virtual ~GridCoordinateSystem();
+
+	virtual uint16 type() const { return COORDINATE_SYSTEM_TYPE_GRID; }
+
+	virtual bool insert(CoordinateNode* pNode);
+	virtual bool removeReal(CoordinateNode* pNode);
+	virtual void update(CoordinateNode* pNode);
+
+	/**
+		查找范围内的entity， 与EntityCoordinateNode::entitiesInRange的语义一致
+	*/
+	void entitiesInRange(std::vector<Entity*>& foundEntities, const Position3D& originPos,
+		float radius, int entityUType);
+
+	float cellSize() const { return cellSize_; }
+
+protected:
+	typedef uint64 CELL_KEY;
+
+	/**
+		一块矩形的网格范围(包含边界)， minX > maxX时为空
+	*/
+	struct CellRange
+	{
+		CellRange() :
+		minX(0), maxX(-1), minZ(0), maxZ(-1)
+		{
+		}
+
+		CellRange(int32 x0, int32 x1, int32 z0, int32 z1) :
+		minX(x0), maxX(x1), minZ(z0), maxZ(z1)
+		{
+		}
+
+		INLINE bool contains(int32 x, int32 z) const
+		{
+			return x >= minX && x <= maxX && z >= minZ && z <= maxZ;
+		}
+
+		INLINE bool operator==(const CellRange& other) const
+		{
+			return minX == other.minX && maxX == other.maxX && minZ == other.minZ && maxZ == other.maxZ;
+		}
+
+		int32 minX, maxX, minZ, maxZ;
+	};
+
+	/**
+		触发器在网格中的状态
+		范围总是使用触发器最后一次更新时的值， 配合节点的old_*坐标即可推算出节点之前是否在范围内
+	*/
+	struct TriggerState
+	{
+		TriggerState(RangeTriggerNode* pNode) :
+		pTriggerNode(pNode),
+		hasRange(false),
+		minX(0.f), maxX(0.f), minY(0.f), maxY(0.f), minZ(0.f), maxZ(0.f),
+		cells()
+		{
+		}
+
+		INLINE bool isInRange(float x, float y, float z) const
+		{
+			return hasRange && x >= minX && x <= maxX && z >= minZ && z <= maxZ &&
+				(!CoordinateSystem::hasY || (y >= minY && y <= maxY));
+		}
+
+		// 触发器卸载后为NULL
+		RangeTriggerNode* pTriggerNode;
+
+		bool hasRange;
+		float minX, maxX, minY, maxY, minZ, maxZ;
+
+		// 触发器当前覆盖的网格范围
+		CellRange cells;
+	};
+
+	struct Cell
+	{
+		std::vector<CoordinateNode*> nodes;
+		std::vector<TriggerState*> triggers;
+	};
+
+	struct TriggerEvent
+	{
+		TriggerEvent(TriggerState* state, CoordinateNode* node, bool enter) :
+		pState(state),
+		pNode(node),
+		isEnter(enter)
+		{
+		}
+
+		TriggerState* pState;
+		CoordinateNode* pNode;
+		bool isEnter;
+	};
+
+	typedef KBEUnordered_map<CELL_KEY, Cell> CELLS;
+	typedef KBEUnordered_map<CoordinateNode*, CELL_KEY> NODE_CELLS;
+	typedef KBEUnordered_map<RangeTriggerNode*, TriggerState*> TRIGGERS;
+	typedef std::vector<TriggerEvent> TRIGGER_EVENTS;
+
+	INLINE int32 toCellIndex(float v) const
+	{
+		return (int32)floorf(v / cellSize_);
+	}
+
+	INLINE CELL_KEY toCellKey(int32 x, int32 z) const
+	{
+		return (((CELL_KEY)(uint32)x) << 32) | (CELL_KEY)(uint32)z;
+	}
+
+	void onEntityNodeUpdate(CoordinateNode* pNode);
+	void onTriggerNodeUpdate(RangeTriggerNode* pTriggerNode);
+
+	void fireEvents(const TRIGGER_EVENTS& events);
+
+	/**
+		取出range中不属于exclude的网格， 结果存放在cellKeys_中
+	*/
+	void collectCellKeys(const CellRange& range, const CellRange& exclude = CellRange());
+
+	void addTriggerToCells(TriggerState* pState, const CellRange& range, const CellRange& exclude = CellRange());
+	void delTriggerFromCells(TriggerState* pState, const CellRange& range, const CellRange& exclude = CellRange());
+	void collectCellEvents(const Cell& cell, const TriggerState& oldState, TriggerState* pState,
+		CoordinateNode* pOrigin, TRIGGER_EVENTS& events);
+
+	void delNodeFromCell(CoordinateNode* pNode, CELL_KEY key);
+
+	void uninstallTrigger(RangeTriggerNode* pTriggerNode);
+	void releaseTriggerStates();
+
+protected:
+	float cellSize_;
+
+	CELLS cells_;
+
+	// 所有在网格中的实体节点所在的网格
+	NODE_CELLS nodeCells_;
+
+	// 所有已安装的触发器(以正边界节点作为标识)
+	TRIGGERS triggers_;
+
+	// 已卸载的触发器状态， 回调中可能还会被引用，因此延迟到update结束后释放
+	std::vector<TriggerState*> deadTriggers_;
+
+	// 触发器的负边界节点， 在网格中没有实际作用，仅仅维护其生命周期
+	std::set<CoordinateNode*> negativeBoundaryNodes_;
+
+	// collectCellKeys的结果， 使用期间不会产生回调
+	std::vector<CELL_KEY> cellKeys_;
+};
+
+}
+
+#endif
@@ -19,6 +19,9 @@ public:
 	void pMoveToPointHandler(MoveToPointHandler* pMoveToPointHandler)
 		{ pMoveToPointHandler_ = pMoveToPointHandler; }
 
+	MoveToPointHandler* pMoveToPointHandler() const
+		{ return pMoveToPointHandler_; }
+
 	virtual void destroy();
 	virtual void addToStream(KBEngine::MemoryStream& s);
 	virtual void createFromStream(KBEngine::MemoryStream& s);
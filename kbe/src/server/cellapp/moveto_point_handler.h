@@ -18,6 +18,7 @@ public:
 		MOVE_TYPE_POINT = 0,		// 
 		MOVE_TYPE_ENTITY = 1,		// Χ
 		MOVE_TYPE_NAV = 2,			// ƶ
+		MOVE_TYPE_CROWD = 3,		// Ⱥƶ
 	};
 
 	void addToStream(KBEngine::MemoryStream& s);
@@ -39,6 +40,7 @@ public:
 	virtual MoveType type() const { return MOVE_TYPE_POINT; }
 
 	void destroy() { isDestroyed_ = true; }
+	bool isDestroyed() const { return isDestroyed_; }
 
 	float velocity() const {
 		return velocity_;
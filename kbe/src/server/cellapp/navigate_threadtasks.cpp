@@ -0,0 +1,272 @@
+// Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
+
+#include "cellapp.h"
+#include "entity.h"
+#include "navigate_threadtasks.h"
+#include "pyscript/vector3.h"
+
+namespace KBEngine{
+
+//-------------------------------------------------------------------------------------
+NavigateQueryTask::NavigateQueryTask(NavigationHandlePtr pNavHandle, int8 layer, ENTITY_ID entityID, CALLBACK_ID callbackID):
+thread::TPTask(),
+pNavHandle_(pNavHandle),
+layer_(layer),
+entityID_(entityID),
+callbackID_(callbackID),
+result_(NavigationHandle::NAV_ERROR),
+points_(),
+queried_(false)
+{
+}
+
+//-------------------------------------------------------------------------------------
+NavigateQueryTask::~NavigateQueryTask()
+{
+	// 没有机会回调(实体已经销毁等)时释放回调
+	if(callbackID_ > 0)
+		Cellapp::getSingleton().callbackMgr().take(callbackID_);
+}
+
+//-------------------------------------------------------------------------------------
+bool NavigateQueryTask::process()
+{
+	if(pNavHandle_->isThreadSafe())
+	{
+		query();
+		queried_ = true;
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+thread::TPTask::TPTaskState NavigateQueryTask::presentMainThread()
+{
+	// 本tick处理的结果已经达到上限， 留到下一个tick
+	if(!Cellapp::getSingleton().onNavigateQueryResult())
+		return thread::TPTask::TPTASK_STATE_CONTINUE_MAINTHREAD;
+
+	Cellapp::getSingleton().onNavigateQueryCompleted();
+
+	if(entityID_ > 0)
+	{
+		Entity* pEntity = Cellapp::getSingleton().findEntity(entityID_);
+		if(pEntity == NULL || pEntity->isDestroyed())
+			return thread::TPTask::TPTASK_STATE_COMPLETED;
+	}
+
+	if(!queried_)
+	{
+		query();
+		queried_ = true;
+	}
+
+	onQueryCompleted();
+	return thread::TPTask::TPTASK_STATE_COMPLETED;
+}
+
+//-------------------------------------------------------------------------------------
+void NavigateQueryTask::callback(PyObject* pyArgs)
+{
+	if(callbackID_ > 0)
+	{
+		PyObjectPtr pyCallback = Cellapp::getSingleton().callbackMgr().take(callbackID_);
+		callbackID_ = 0;
+
+		if(pyCallback != NULL)
+		{
+			PyObject* pyRet = PyObject_CallObject(pyCallback.get(), pyArgs);
+			if(pyRet == NULL)
+			{
+				SCRIPT_ERROR_CHECK();
+			}
+			else
+			{
+				Py_DECREF(pyRet);
+			}
+		}
+	}
+
+	Py_DECREF(pyArgs);
+}
+
+//-------------------------------------------------------------------------------------
+PyObject* NavigateQueryTask::createPyPoints(const std::vector<Position3D>& points)
+{
+	PyObject* pyList = PyList_New(points.size());
+
+	int i = 0;
+	std::vector<Position3D>::const_iterator iter = points.begin();
+	for (; iter != points.end(); ++iter)
+	{
+		script::ScriptVector3 *pos = new script::ScriptVector3(*iter);
+		PyList_SET_ITEM(pyList, i++, pos);
+	}
+
+	return pyList;
+}
+
+//-------------------------------------------------------------------------------------
+FindPathTask::FindPathTask(NavigationHandlePtr pNavHandle, int8 layer, ENTITY_ID entityID, CALLBACK_ID callbackID,
+	const Position3D& start, const Position3D& destination):
+NavigateQueryTask(pNavHandle, layer, entityID, callbackID),
+start_(start),
+destination_(destination)
+{
+}
+
+//-------------------------------------------------------------------------------------
+void FindPathTask::query()
+{
+	result_ = pNavHandle_->findStraightPath(layer_, start_, destination_, points_);
+	if(result_ < 0)
+	{
+		points_.clear();
+		return;
+	}
+
+	std::vector<Position3D>::iterator iter = points_.begin();
+	while(iter != points_.end())
+	{
+		Vector3 movement = (*iter) - start_;
+		if(KBEVec3Length(&movement) <= 0.00001f)
+		{
+			iter++;
+			continue;
+		}
+
+		break;
+	}
+
+	// 第一个坐标点是查询时的位置，因此可以过滤掉
+	if (iter != points_.begin())
+	{
+		points_.erase(points_.begin(), iter);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void FindPathTask::onQueryCompleted()
+{
+	PyObject* pyArgs = PyTuple_New(1);
+	PyTuple_SET_ITEM(pyArgs, 0, createPyPoints(points_));
+	callback(pyArgs);
+}
+
+//-------------------------------------------------------------------------------------
+NavigateTask::NavigateTask(NavigationHandlePtr pNavHandle, int8 layer, ENTITY_ID entityID, CALLBACK_ID callbackID,
+	const Position3D& start, const Position3D& destination, float velocity, float distance,
+	float maxMoveDistance, bool faceMovement, CALLBACK_ID userDataID):
+FindPathTask(pNavHandle, layer, entityID, callbackID, start, destination),
+velocity_(velocity),
+distance_(distance),
+maxMoveDistance_(maxMoveDistance),
+faceMovement_(faceMovement),
+userDataID_(userDataID)
+{
+}
+
+//-------------------------------------------------------------------------------------
+NavigateTask::~NavigateTask()
+{
+	if(userDataID_ > 0)
+		Cellapp::getSingleton().callbackMgr().take(userDataID_);
+}
+
+//-------------------------------------------------------------------------------------
+void NavigateTask::onQueryCompleted()
+{
+	PyObjectPtr pyUserData = Cellapp::getSingleton().callbackMgr().take(userDataID_);
+	userDataID_ = 0;
+
+	uint32 controllerID = 0;
+
+	// 查询期间实体可能已经迁移到其他cell
+	Entity* pEntity = Cellapp::getSingleton().findEntity(entityID_);
+	if(pEntity->isReal() && points_.size() > 0)
+	{
+		VECTOR_POS3D_PTR paths_ptr(new std::vector<Position3D>());
+		paths_ptr->swap(points_);
+
+		controllerID = pEntity->startNavigate(destination_, velocity_, distance_, maxMoveDistance_,
+			faceMovement_, paths_ptr, pyUserData.get() ? pyUserData.get() : Py_None);
+	}
+
+	PyObject* pyArgs = PyTuple_New(1);
+	PyTuple_SET_ITEM(pyArgs, 0, PyLong_FromUnsignedLong(controllerID));
+	callback(pyArgs);
+}
+
+//-------------------------------------------------------------------------------------
+RandomPointsTask::RandomPointsTask(NavigationHandlePtr pNavHandle, int8 layer, ENTITY_ID entityID, CALLBACK_ID callbackID,
+	const Position3D& centerPos, float maxRadius, uint32 maxPoints):
+NavigateQueryTask(pNavHandle, layer, entityID, callbackID),
+centerPos_(centerPos),
+maxRadius_(maxRadius),
+maxPoints_(maxPoints)
+{
+}
+
+//-------------------------------------------------------------------------------------
+void RandomPointsTask::query()
+{
+	result_ = pNavHandle_->findRandomPointAroundCircle(layer_, centerPos_, points_, maxPoints_, maxRadius_);
+}
+
+//-------------------------------------------------------------------------------------
+void RandomPointsTask::onQueryCompleted()
+{
+	PyObject* pyArgs = PyTuple_New(1);
+	PyTuple_SET_ITEM(pyArgs, 0, createPyPoints(points_));
+	callback(pyArgs);
+}
+
+//-------------------------------------------------------------------------------------
+RaycastTask::RaycastTask(NavigationHandlePtr pNavHandle, int8 layer, CALLBACK_ID callbackID,
+	const Position3D& start, const Position3D& end):
+NavigateQueryTask(pNavHandle, layer, 0, callbackID),
+start_(start),
+end_(end)
+{
+}
+
+//-------------------------------------------------------------------------------------
+void RaycastTask::query()
+{
+	result_ = pNavHandle_->raycast(layer_, start_, end_, points_);
+}
+
+//-------------------------------------------------------------------------------------
+void RaycastTask::onQueryCompleted()
+{
+	PyObject* pyArgs = PyTuple_New(1);
+
+	// 与KBEngine.raycast的返回值相同， 没有碰撞时为None
+	if(result_ <= 0)
+	{
+		Py_INCREF(Py_None);
+		PyTuple_SET_ITEM(pyArgs, 0, Py_None);
+	}
+	else
+	{
+		int idx = 0;
+		PyObject* pyHitpos = PyTuple_New(points_.size());
+		for(std::vector<Position3D>::iterator iter = points_.begin(); iter != points_.end(); ++iter)
+		{
+			PyObject* pyHitposItem = PyTuple_New(3);
+			PyTuple_SetItem(pyHitposItem, 0, ::PyFloat_FromDouble((*iter).x));
+			PyTuple_SetItem(pyHitposItem, 1, ::PyFloat_FromDouble((*iter).y));
+			PyTuple_SetItem(pyHitposItem, 2, ::PyFloat_FromDouble((*iter).z));
+
+			PyTuple_SetItem(pyHitpos, idx++, pyHitposItem);
+		}
+
+		PyTuple_SET_ITEM(pyArgs, 0, pyHitpos);
+	}
+
+	callback(pyArgs);
+}
+
+//-------------------------------------------------------------------------------------
+}
@@ -0,0 +1,141 @@
+// Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
+
+#ifndef KBE_NAVIGATE_THREADTASKS_H
+#define KBE_NAVIGATE_THREADTASKS_H
+
+#include "common/common.h"
+#include "thread/threadtask.h"
+#include "helper/debug_helper.h"
+#include "math/math.h"
+#include "navigation/navigation_handle.h"
+
+namespace KBEngine{
+
+/**
+	异步导航查询
+	查询在线程池中执行(导航句柄不允许多线程查询时退回到主线程)， 结果在主线程中交给脚本回调，
+	主线程每个tick处理的结果数量受cellapp/navigation/asyncResultsPerTick限制。
+	脚本回调保存在cellapp的callbackMgr中， 任务只持有回调ID。
+*/
+class NavigateQueryTask : public thread::TPTask
+{
+public:
+	NavigateQueryTask(NavigationHandlePtr pNavHandle, int8 layer, ENTITY_ID entityID, CALLBACK_ID callbackID);
+	virtual ~NavigateQueryTask();
+
+	virtual bool process();
+	virtual thread::TPTask::TPTaskState presentMainThread();
+
+protected:
+	/**
+		执行查询， 结果放入points_
+	*/
+	virtual void query() = 0;
+
+	/**
+		在主线程中处理查询结果， 发起查询的实体已经销毁时不会被调用
+	*/
+	virtual void onQueryCompleted() = 0;
+
+	/**
+		调用脚本回调， pyArgs会被释放
+	*/
+	void callback(PyObject* pyArgs);
+
+	static PyObject* createPyPoints(const std::vector<Position3D>& points);
+
+	NavigationHandlePtr pNavHandle_;
+	int8 layer_;
+	ENTITY_ID entityID_;
+	CALLBACK_ID callbackID_;
+
+	int result_;
+	std::vector<Position3D> points_;
+	bool queried_;
+};
+
+/**
+	Entity.navigatePathPointsAsync
+*/
+class FindPathTask : public NavigateQueryTask
+{
+public:
+	FindPathTask(NavigationHandlePtr pNavHandle, int8 layer, ENTITY_ID entityID, CALLBACK_ID callbackID,
+		const Position3D& start, const Position3D& destination);
+
+	virtual ~FindPathTask(){}
+
+protected:
+	virtual void query();
+	virtual void onQueryCompleted();
+
+	Position3D start_;
+	Position3D destination_;
+};
+
+/**
+	Entity.navigateAsync， 找到路径后开始移动
+*/
+class NavigateTask : public FindPathTask
+{
+public:
+	NavigateTask(NavigationHandlePtr pNavHandle, int8 layer, ENTITY_ID entityID, CALLBACK_ID callbackID,
+		const Position3D& start, const Position3D& destination, float velocity, float distance,
+		float maxMoveDistance, bool faceMovement, CALLBACK_ID userDataID);
+
+	virtual ~NavigateTask();
+
+protected:
+	virtual void onQueryCompleted();
+
+	float velocity_;
+	float distance_;
+	float maxMoveDistance_;
+	bool faceMovement_;
+
+	// 移动控制器的userData， 同样保存在callbackMgr中
+	CALLBACK_ID userDataID_;
+};
+
+/**
+	Entity.getRandomPointsAsync
+*/
+class RandomPointsTask : public NavigateQueryTask
+{
+public:
+	RandomPointsTask(NavigationHandlePtr pNavHandle, int8 layer, ENTITY_ID entityID, CALLBACK_ID callbackID,
+		const Position3D& centerPos, float maxRadius, uint32 maxPoints);
+
+	virtual ~RandomPointsTask(){}
+
+protected:
+	virtual void query();
+	virtual void onQueryCompleted();
+
+	Position3D centerPos_;
+	float maxRadius_;
+	uint32 maxPoints_;
+};
+
+/**
+	KBEngine.raycastAsync
+*/
+class RaycastTask : public NavigateQueryTask
+{
+public:
+	RaycastTask(NavigationHandlePtr pNavHandle, int8 layer, CALLBACK_ID callbackID,
+		const Position3D& start, const Position3D& end);
+
+	virtual ~RaycastTask(){}
+
+protected:
+	virtual void query();
+	virtual void onQueryCompleted();
+
+	Position3D start_;
+	Position3D end_;
+};
+
+}
+
+#endif // KBE_NAVIGATE_THREADTASKS_H
@@ -4,6 +4,7 @@
 #include "spacememory.h"	
 #include "entity.h"
 #include "witness.h"	
+#include "crowd_manager.h"
 #include "navigation/navigation.h"
 #include "loadnavmesh_threadtasks.h"
 #include "entitydef/entities.h"
@@ -25,11 +26,21 @@ scriptModuleName_(scriptModuleName),
 entities_(),
 hasGeometry_(false),
 pCell_(NULL),
-coordinateSystem_(),
+pCoordinateSystem_(NULL),
 pNavHandle_(),
 state_(STATE_NORMAL),
-destroyTime_(0)
+destroyTime_(0),
+crowdManagers_()
 {
+	const ENGINE_COMPONENT_INFO& cellappInfo = g_kbeSrvConfig.getCellApp();
+
+	uint16 coordinateSystemType = cellappInfo.coordinateSystem_type;
+	std::map<std::string, uint16>::const_iterator typeIter = cellappInfo.coordinateSystem_spaceTypes.find(scriptModuleName_);
+	if (typeIter != cellappInfo.coordinateSystem_spaceTypes.end())
+		coordinateSystemType = typeIter->second;
+
+	pCoordinateSystem_ = CoordinateSystem::create(coordinateSystemType, cellappInfo.coordinateSystem_gridCellSize);
+
 	Network::Channel* pChannel = Components::getSingleton().getCellappmgrChannel();
 	if (pChannel != NULL)
 	{
@@ -52,8 +63,14 @@ SpaceMemory::~SpaceMemory()
 	_clearGhosts();
 	entities_.clear();
 	
-	this->coordinateSystem_.releaseNodes();
+	this->pCoordinateSystem_->releaseNodes();
 	
+	std::map<int, CrowdManager*>::iterator crowdIter = crowdManagers_.begin();
+	for(; crowdIter != crowdManagers_.end(); ++crowdIter)
+		delete crowdIter->second;
+
+	crowdManagers_.clear();
+
 	pNavHandle_.clear();
 
 	SAFE_RELEASE(pCell_);	
@@ -72,6 +89,8 @@ SpaceMemory::~SpaceMemory()
 
 		pChannel->send(pBundle);
 	}
+
+	SAFE_RELEASE(pCoordinateSystem_);
 }
 
 //-------------------------------------------------------------------------------------
@@ -346,18 +365,41 @@ bool SpaceMemory::update()
 			return false;
 	}
 
-	this->coordinateSystem_.releaseNodes();
+	// ÿtickͳһһȺƶ
+	std::map<int, CrowdManager*>::iterator crowdIter = crowdManagers_.begin();
+	for(; crowdIter != crowdManagers_.end(); ++crowdIter)
+		crowdIter->second->update();
+
+	this->pCoordinateSystem_->releaseNodes();
 
 	if(destroyTime_ > 0 && timestamp() - destroyTime_ >= uint64( 30.f * stampsPerSecond() ))
 	{
 		_clearGhosts();
 		KBE_ASSERT(entities_.size() == 0);
-		this->coordinateSystem_.releaseNodes();
+		this->pCoordinateSystem_->releaseNodes();
 	}
 		
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+CrowdManager* SpaceMemory::findOrCreateCrowdManager(int layer)
+{
+	std::map<int, CrowdManager*>::iterator iter = crowdManagers_.find(layer);
+	if(iter != crowdManagers_.end())
+		return iter->second;
+
+	CrowdManager* pCrowdManager = new CrowdManager(id_, layer);
+	if(!pCrowdManager->initialize(pNavHandle_))
+	{
+		delete pCrowdManager;
+		return NULL;
+	}
+
+	crowdManagers_[layer] = pCrowdManager;
+	return pCrowdManager;
+}
+
 //-------------------------------------------------------------------------------------
 void SpaceMemory::addEntityAndEnterWorld(Entity* pEntity, bool isRestore)
 {
@@ -378,7 +420,7 @@ void SpaceMemory::addEntity(Entity* pEntity)
 //-------------------------------------------------------------------------------------
 void SpaceMemory::addEntityToNode(Entity* pEntity)
 {
-	pEntity->installCoordinateNodes(&coordinateSystem_);
+	pEntity->installCoordinateNodes(pCoordinateSystem_);
 }
 
 //-------------------------------------------------------------------------------------
@@ -404,7 +446,7 @@ void SpaceMemory::removeEntity(Entity* pEntity)
 	onLeaveWorld(pEntity);
 
 	// onLeaveWorld֮ ΪrangeTriggerҪοpEntityCoordinateNode
-	pEntity->uninstallCoordinateNodes(&coordinateSystem_);
+	pEntity->uninstallCoordinateNodes(pCoordinateSystem_);
 	pEntity->onLeaveSpace(this);
 
 	// ûentityҪspace, Ϊspaceٴһentity
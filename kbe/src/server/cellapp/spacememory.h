@@ -14,6 +14,7 @@
 namespace KBEngine{
 
 class Entity;
+class CrowdManager;
 typedef SmartPointer<Entity> EntityPtr;
 typedef std::vector<EntityPtr> SPACE_ENTITIES;
 
@@ -75,6 +76,11 @@ public:
 	
 	NavigationHandlePtr pNavHandle() const{ return pNavHandle_; }
 
+	/**
+		õȺƶ һʹʱ ûnavmeshʱNULL
+	*/
+	CrowdManager* findOrCreateCrowdManager(int layer);
+
 	/**
 		spaceDataزӿ
 	*/
@@ -87,7 +93,7 @@ public:
 	static PyObject* __py_GetSpaceData(PyObject* self, PyObject* args);
 	static PyObject* __py_DelSpaceData(PyObject* self, PyObject* args);
 
-	CoordinateSystem* pCoordinateSystem(){ return &coordinateSystem_; }
+	CoordinateSystem* pCoordinateSystem(){ return pCoordinateSystem_; }
 
 	bool isDestroyed() const{ return state_ == STATE_DESTROYED; }
 	bool isGood() const{ return state_ == STATE_NORMAL; }
@@ -120,7 +126,8 @@ protected:
 	// ÿspaceֻһcell
 	Cell*						pCell_;
 
-	CoordinateSystem			coordinateSystem_;
+	// ϵͳͨkbengine.xmlspaceĽűѡʵ
+	CoordinateSystem*			pCoordinateSystem_;
 
 	NavigationHandlePtr			pNavHandle_;
 
@@ -131,6 +138,9 @@ protected:
 	int8						state_;
 	
 	uint64						destroyTime_;	
+
+	// ÿһȺƶ
+	std::map<int, CrowdManager*>	crowdManagers_;
 };
 
 
@@ -41,7 +41,11 @@ pViewTrigger_(NULL),
 pViewHysteresisAreaTrigger_(NULL),
 viewEntities_(),
 viewEntities_map_(),
-clientViewSize_(0)
+clientViewSize_(0),
+clientBackpressure_(false),
+backpressureTicks_(0),
+clientQueuedBytes_(0),
+forceVolatileUpdates_(false)
 {
 	updatableName = "Witness";
 }
@@ -209,6 +213,10 @@ void Witness::clear(Entity* pEntity)
 	viewRadius_ = 0.0f;
 	viewHysteresisArea_ = 5.0f;
 	clientViewSize_ = 0;
+	clientBackpressure_ = false;
+	backpressureTicks_ = 0;
+	clientQueuedBytes_ = 0;
+	forceVolatileUpdates_ = false;
 
 	// Ҫ٣滹
 	// ˴ٿܻΪenterviewпܵʵ
@@ -763,6 +771,23 @@ bool Witness::update()
 		}
 	}
 
+	// ͻͨ˸ˮλ ֻڲupdateͬvolatileݣ /뿪viewϢӰ
+	bool skipVolatileUpdates = clientBackpressure_ && 
+		(++backpressureTicks_ % BACKPRESSURE_UPDATE_INTERVAL) != 0;
+
+	// updateзλ볯ıҪһͬ ָһͬе
+	uint32 volatileUpdateWindow = 0;
+	if (forceVolatileUpdates_)
+	{
+		volatileUpdateWindow = 0xffffffff;
+		forceVolatileUpdates_ = false;
+	}
+	else if (clientBackpressure_)
+	{
+		volatileUpdateWindow = BACKPRESSURE_UPDATE_INTERVAL + 
+			g_kbeSrvConfig.getCellApp().entity_posdir_additional_updates;
+	}
+
 	if (viewEntities_map_.size() > 0 || pEntity_->isControlledNotSelfClient())
 	{
 		Network::Bundle* pSendBundle = pChannel->createSendBundle();
@@ -856,7 +881,12 @@ bool Witness::update()
 				
 				KBE_ASSERT(pEntityRef->flags() == ENTITYREF_FLAG_NORMAL);
 				
-				addUpdateToStream(pSendBundle, getEntityVolatileDataUpdateFlags(otherEntity), pEntityRef);
+				if (!skipVolatileUpdates)
+					addUpdateToStream(pSendBundle, getEntityVolatileDataUpdateFlags(otherEntity, volatileUpdateWindow), pEntityRef);
+
+				// tickлԸı䣬 volatileһ
+				if (otherEntity->propertyUpdates().size() > 0)
+					addPropertyUpdatesToStream(pSendBundle, otherEntity, otherEntity->propertyUpdates());
 			}
 
 			++iter;
@@ -913,6 +943,39 @@ bool Witness::update()
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+void Witness::onClientBackpressure(bool isBackpressure, uint32 queuedBytes)
+{
+	clientQueuedBytes_ = queuedBytes;
+
+	if (clientBackpressure_ == isBackpressure)
+		return;
+
+	clientBackpressure_ = isBackpressure;
+	backpressureTicks_ = 0;
+
+	// Ƶڼλ볯ûͬ
+	if (!isBackpressure)
+		forceVolatileUpdates_ = true;
+
+	// ͻˮλлʱˢ ÿһΣ ֻ
+	static GAME_TIME lastLogTime = 0;
+	static uint32 suppressedLogs = 0;
+
+	if (lastLogTime > 0 && g_kbetime - lastLogTime < (GAME_TIME)g_kbeSrvConfig.gameUpdateHertz())
+	{
+		++suppressedLogs;
+		return;
+	}
+
+	DEBUG_MSG(fmt::format("Witness::onClientBackpressure({}): {}, queuedBytes={}, volatile updates every {} ticks, suppressed {} similar messages.\n",
+		(pEntity_ ? pEntity_->id() : 0), (isBackpressure ? "throttled" : "recovered"), queuedBytes,
+		(isBackpressure ? (int)BACKPRESSURE_UPDATE_INTERVAL : 1), suppressedLogs));
+
+	lastLogTime = g_kbetime;
+	suppressedLogs = 0;
+}
+
 //-------------------------------------------------------------------------------------
 void Witness::addBaseDataToStream(Network::Bundle* pSendBundle)
 {
@@ -953,629 +1016,207 @@ void Witness::addBaseDataToStream(Network::Bundle* pSendBundle)
 }
 
 //-------------------------------------------------------------------------------------
-void Witness::addUpdateToStream(Network::Bundle* pForwardBundle, uint32 flags, EntityRef* pEntityRef)
+// ±еλò
+#define VOLATILE_POS_NULL				0
+#define VOLATILE_POS_XZ					1
+#define VOLATILE_POS_XYZ				2
+
+// ±еĳ򲿷֣ yawpitchrollϳ0-7 Эе˳һ
+#define VOLATILE_DIR_YAW				0x01
+#define VOLATILE_DIR_PITCH				0x02
+#define VOLATILE_DIR_ROLL				0x04
+
+static const struct
 {
-	Entity* otherEntity = pEntityRef->pEntity();
+	uint32 flag;
+	uint8 dirBits;
+} s_volatileDirFlags[] = {
+	{ UPDATE_FLAG_YAW,				VOLATILE_DIR_YAW },
+	{ UPDATE_FLAG_PITCH,			VOLATILE_DIR_PITCH },
+	{ UPDATE_FLAG_ROLL,				VOLATILE_DIR_ROLL },
+	{ UPDATE_FLAG_YAW_PITCH_ROLL,	VOLATILE_DIR_YAW | VOLATILE_DIR_PITCH | VOLATILE_DIR_ROLL },
+	{ UPDATE_FLAG_YAW_PITCH,		VOLATILE_DIR_YAW | VOLATILE_DIR_PITCH },
+	{ UPDATE_FLAG_YAW_ROLL,			VOLATILE_DIR_YAW | VOLATILE_DIR_ROLL },
+	{ UPDATE_FLAG_PITCH_ROLL,		VOLATILE_DIR_PITCH | VOLATILE_DIR_ROLL },
+};
 
-	static uint8 type = g_kbeSrvConfig.getCellApp().entity_posdir_updates_type;
-	static uint16 threshold = g_kbeSrvConfig.getCellApp().entity_posdir_updates_smart_threshold;
-	
-	bool isOptimized = true;
-	if ((type == 2 && clientViewSize_ <= threshold) || type == 0)
+//-------------------------------------------------------------------------------------
+static void splitVolatileFlags(uint32 flags, uint8& posType, uint8& dirBits)
+{
+	if ((flags & UPDATE_FLAG_XZ) > 0)
+		posType = VOLATILE_POS_XZ;
+	else if ((flags & UPDATE_FLAG_XYZ) > 0)
+		posType = VOLATILE_POS_XYZ;
+	else
+		posType = VOLATILE_POS_NULL;
+
+	dirBits = 0;
+	for (size_t i = 0; i < sizeof(s_volatileDirFlags) / sizeof(s_volatileDirFlags[0]); ++i)
 	{
-		isOptimized = false;
-	} 
-	
-	if (isOptimized)
+		if ((flags & s_volatileDirFlags[i].flag) > 0)
+			dirBits |= s_volatileDirFlags[i].dirBits;
+	}
+}
+
+//-------------------------------------------------------------------------------------
+static const Network::MessageHandler& getVolatileDataMessageHandler(uint8 posType, uint8 dirBits, bool isOptimized)
+{
+	// Ϣʱʼã ˱ڵһʹʱŽ
+	static const Network::MessageHandler* handlers[3][8] = {
+		{ NULL, &ClientInterface::onUpdateData_y, &ClientInterface::onUpdateData_p, &ClientInterface::onUpdateData_yp,
+			&ClientInterface::onUpdateData_r, &ClientInterface::onUpdateData_yr, &ClientInterface::onUpdateData_pr, &ClientInterface::onUpdateData_ypr },
+		{ &ClientInterface::onUpdateData_xz, &ClientInterface::onUpdateData_xz_y, &ClientInterface::onUpdateData_xz_p, &ClientInterface::onUpdateData_xz_yp,
+			&ClientInterface::onUpdateData_xz_r, &ClientInterface::onUpdateData_xz_yr, &ClientInterface::onUpdateData_xz_pr, &ClientInterface::onUpdateData_xz_ypr },
+		{ &ClientInterface::onUpdateData_xyz, &ClientInterface::onUpdateData_xyz_y, &ClientInterface::onUpdateData_xyz_p, &ClientInterface::onUpdateData_xyz_yp,
+			&ClientInterface::onUpdateData_xyz_r, &ClientInterface::onUpdateData_xyz_yr, &ClientInterface::onUpdateData_xyz_pr, &ClientInterface::onUpdateData_xyz_ypr },
+	};
+
+	static const Network::MessageHandler* optimizedHandlers[3][8] = {
+		{ NULL, &ClientInterface::onUpdateData_y_optimized, &ClientInterface::onUpdateData_p_optimized, &ClientInterface::onUpdateData_yp_optimized,
+			&ClientInterface::onUpdateData_r_optimized, &ClientInterface::onUpdateData_yr_optimized, &ClientInterface::onUpdateData_pr_optimized, &ClientInterface::onUpdateData_ypr_optimized },
+		{ &ClientInterface::onUpdateData_xz_optimized, &ClientInterface::onUpdateData_xz_y_optimized, &ClientInterface::onUpdateData_xz_p_optimized, &ClientInterface::onUpdateData_xz_yp_optimized,
+			&ClientInterface::onUpdateData_xz_r_optimized, &ClientInterface::onUpdateData_xz_yr_optimized, &ClientInterface::onUpdateData_xz_pr_optimized, &ClientInterface::onUpdateData_xz_ypr_optimized },
+		{ &ClientInterface::onUpdateData_xyz_optimized, &ClientInterface::onUpdateData_xyz_y_optimized, &ClientInterface::onUpdateData_xyz_p_optimized, &ClientInterface::onUpdateData_xyz_yp_optimized,
+			&ClientInterface::onUpdateData_xyz_r_optimized, &ClientInterface::onUpdateData_xyz_yr_optimized, &ClientInterface::onUpdateData_xyz_pr_optimized, &ClientInterface::onUpdateData_xyz_ypr_optimized },
+	};
+
+	const Network::MessageHandler* pMsgHandler = isOptimized ? optimizedHandlers[posType][dirBits] : handlers[posType][dirBits];
+	KBE_ASSERT(pMsgHandler != NULL);
+	return *pMsgHandler;
+}
+
+//-------------------------------------------------------------------------------------
+template <typename T>
+static inline uint8 appendVolatileData(uint8* pData, T value)
+{
+	EndianConvert(value);
+	memcpy(pData, &value, sizeof(value));
+	return (uint8)sizeof(value);
+}
+
+//-------------------------------------------------------------------------------------
+static const Entity::VolatileDataCache::Variant& getVolatileDataCache(Entity* otherEntity,
+	uint8 posType, uint8 dirBits, bool isOptimized)
+{
+	Entity::VolatileDataCache& cache = otherEntity->volatileDataCache();
+
+	const Position3D& pos = otherEntity->position();
+	const Direction3D& dir = otherEntity->direction();
+
+	// µtickλó޸Ĺ ֮ǰ϶
+	if (cache.time != g_kbetime || !(cache.position == pos) || !(cache.direction.dir == dir.dir))
 	{
-		switch (flags)
-		{
-		case UPDATE_FLAG_NULL:
-		{
-			// (*pForwardBundle).newMessage(ClientInterface::onUpdateData);
-		}
-		break;
-		case UPDATE_FLAG_XZ:
-		{
-			Position3D relativePos = otherEntity->position() - this->pEntity()->position();
+		cache.time = g_kbetime;
+		cache.position = pos;
+		cache.direction = dir;
+		cache.validMask = 0;
+	}
 
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xz_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			pForwardBundle->appendPackXZ(relativePos.x, relativePos.z);
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xz_optimized, update);
-		}
-		break;
-		case UPDATE_FLAG_XYZ:
-		{
-			Position3D relativePos = otherEntity->position() - this->pEntity()->position();
+	// Żģʽµ۲زᱻ棬 ֻ泯򲿷
+	KBE_ASSERT(!isOptimized || posType == VOLATILE_POS_NULL);
+	uint8 index = isOptimized ? (uint8)(3 * 8 + dirBits) : (uint8)(posType * 8 + dirBits);
 
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xyz_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			pForwardBundle->appendPackXZ(relativePos.x, relativePos.z);
-			pForwardBundle->appendPackY(relativePos.y);
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xyz_optimized, update);
-		}
-		break;
-		case UPDATE_FLAG_YAW:
-		{
-			const Direction3D& dir = otherEntity->direction();
+	Entity::VolatileDataCache::Variant& variant = cache.variants[index];
+	if ((cache.validMask & (1u << index)) > 0)
+		return variant;
 
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_y_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << angle2int8(dir.yaw());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_y_optimized, update);
-		}
-		break;
-		case UPDATE_FLAG_ROLL:
-		{
-			const Direction3D& dir = otherEntity->direction();
+	uint8* pData = variant.data;
 
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_r_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << angle2int8(dir.roll());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_r_optimized, update);
-		}
-		break;
-		case UPDATE_FLAG_PITCH:
-		{
-			const Direction3D& dir = otherEntity->direction();
+	if (posType == VOLATILE_POS_XZ)
+	{
+		pData += appendVolatileData(pData, pos.x);
+		pData += appendVolatileData(pData, pos.z);
+	}
+	else if (posType == VOLATILE_POS_XYZ)
+	{
+		pData += appendVolatileData(pData, pos.x);
+		pData += appendVolatileData(pData, pos.y);
+		pData += appendVolatileData(pData, pos.z);
+	}
 
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_p_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << angle2int8(dir.pitch());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_p_optimized, update);
-		}
-		break;
-		case UPDATE_FLAG_YAW_PITCH_ROLL:
-		{
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_ypr_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << angle2int8(dir.yaw());
-			(*pForwardBundle) << angle2int8(dir.pitch());
-			(*pForwardBundle) << angle2int8(dir.roll());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_ypr_optimized, update);
-		}
-		break;
-		case UPDATE_FLAG_YAW_PITCH:
-		{
-			const Direction3D& dir = otherEntity->direction();
+	float angles[3] = { dir.yaw(), dir.pitch(), dir.roll() };
+	for (int i = 0; i < 3; ++i)
+	{
+		if ((dirBits & (1 << i)) == 0)
+			continue;
 
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_yp_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << angle2int8(dir.yaw());
-			(*pForwardBundle) << angle2int8(dir.pitch());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_yp_optimized, update);
-		}
-		break;
-		case UPDATE_FLAG_YAW_ROLL:
-		{
-			const Direction3D& dir = otherEntity->direction();
+		if (isOptimized)
+			pData += appendVolatileData(pData, angle2int8(angles[i]));
+		else
+			pData += appendVolatileData(pData, angles[i]);
+	}
 
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_yr_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << angle2int8(dir.yaw());
-			(*pForwardBundle) << angle2int8(dir.roll());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_yr_optimized, update);
-		}
-		break;
-		case UPDATE_FLAG_PITCH_ROLL:
-		{
-			const Direction3D& dir = otherEntity->direction();
+	variant.size = (uint8)(pData - variant.data);
+	cache.validMask |= (1u << index);
+	return variant;
+}
 
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_pr_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << angle2int8(dir.pitch());
-			(*pForwardBundle) << angle2int8(dir.roll());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_pr_optimized, update);
-		}
-		break;
-		case (UPDATE_FLAG_XZ | UPDATE_FLAG_YAW):
-		{
-			Position3D relativePos = otherEntity->position() - this->pEntity()->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xz_y_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			pForwardBundle->appendPackXZ(relativePos.x, relativePos.z);
-			(*pForwardBundle) << angle2int8(dir.yaw());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xz_y_optimized, update);
-		}
-		break;
-		case (UPDATE_FLAG_XZ | UPDATE_FLAG_PITCH):
-		{
-			Position3D relativePos = otherEntity->position() - this->pEntity()->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xz_p_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			pForwardBundle->appendPackXZ(relativePos.x, relativePos.z);
-			(*pForwardBundle) << angle2int8(dir.pitch());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xz_p_optimized, update);
-		}
-		break;
-		case (UPDATE_FLAG_XZ | UPDATE_FLAG_ROLL):
-		{
-			Position3D relativePos = otherEntity->position() - this->pEntity()->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xz_r_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			pForwardBundle->appendPackXZ(relativePos.x, relativePos.z);
-			(*pForwardBundle) << angle2int8(dir.roll());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xz_r_optimized, update);
-		}
-		break;
-		case (UPDATE_FLAG_XZ | UPDATE_FLAG_YAW_ROLL):
-		{
-			Position3D relativePos = otherEntity->position() - this->pEntity()->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xz_yr_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			pForwardBundle->appendPackXZ(relativePos.x, relativePos.z);
-			(*pForwardBundle) << angle2int8(dir.yaw());
-			(*pForwardBundle) << angle2int8(dir.roll());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xz_yr_optimized, update);
-		}
-		break;
-		case (UPDATE_FLAG_XZ | UPDATE_FLAG_YAW_PITCH):
-		{
-			Position3D relativePos = otherEntity->position() - this->pEntity()->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xz_yp_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			pForwardBundle->appendPackXZ(relativePos.x, relativePos.z);
-			(*pForwardBundle) << angle2int8(dir.yaw());
-			(*pForwardBundle) << angle2int8(dir.pitch());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xz_yp_optimized, update);
-		}
-		break;
-		case (UPDATE_FLAG_XZ | UPDATE_FLAG_PITCH_ROLL):
-		{
-			Position3D relativePos = otherEntity->position() - this->pEntity()->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xz_pr_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			pForwardBundle->appendPackXZ(relativePos.x, relativePos.z);
-			(*pForwardBundle) << angle2int8(dir.pitch());
-			(*pForwardBundle) << angle2int8(dir.roll());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xz_pr_optimized, update);
-		}
-		break;
-		case (UPDATE_FLAG_XZ | UPDATE_FLAG_YAW_PITCH_ROLL):
-		{
-			Position3D relativePos = otherEntity->position() - this->pEntity()->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xz_ypr_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			pForwardBundle->appendPackXZ(relativePos.x, relativePos.z);
-			(*pForwardBundle) << angle2int8(dir.yaw());
-			(*pForwardBundle) << angle2int8(dir.pitch());
-			(*pForwardBundle) << angle2int8(dir.roll());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xz_ypr_optimized, update);
-		}
-		break;
-		case (UPDATE_FLAG_XYZ | UPDATE_FLAG_YAW):
-		{
-			Position3D relativePos = otherEntity->position() - this->pEntity()->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xyz_y_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			pForwardBundle->appendPackXZ(relativePos.x, relativePos.z);
-			pForwardBundle->appendPackY(relativePos.y);
-			(*pForwardBundle) << angle2int8(dir.yaw());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xyz_y_optimized, update);
-		}
-		break;
-		case (UPDATE_FLAG_XYZ | UPDATE_FLAG_PITCH):
-		{
-			Position3D relativePos = otherEntity->position() - this->pEntity()->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xyz_p_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			pForwardBundle->appendPackXZ(relativePos.x, relativePos.z);
-			pForwardBundle->appendPackY(relativePos.y);
-			(*pForwardBundle) << angle2int8(dir.pitch());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xyz_p_optimized, update);
-		}
-		break;
-		case (UPDATE_FLAG_XYZ | UPDATE_FLAG_ROLL):
-		{
-			Position3D relativePos = otherEntity->position() - this->pEntity()->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xyz_r_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			pForwardBundle->appendPackXZ(relativePos.x, relativePos.z);
-			pForwardBundle->appendPackY(relativePos.y);
-			(*pForwardBundle) << angle2int8(dir.roll());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xyz_r_optimized, update);
-		}
-		break;
-		case (UPDATE_FLAG_XYZ | UPDATE_FLAG_YAW_ROLL):
-		{
-			Position3D relativePos = otherEntity->position() - this->pEntity()->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xyz_yr_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			pForwardBundle->appendPackXZ(relativePos.x, relativePos.z);
-			pForwardBundle->appendPackY(relativePos.y);
-			(*pForwardBundle) << angle2int8(dir.yaw());
-			(*pForwardBundle) << angle2int8(dir.roll());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xyz_yr_optimized, update);
-		}
-		break;
-		case (UPDATE_FLAG_XYZ | UPDATE_FLAG_YAW_PITCH):
-		{
-			Position3D relativePos = otherEntity->position() - this->pEntity()->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xyz_yp_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			pForwardBundle->appendPackXZ(relativePos.x, relativePos.z);
-			pForwardBundle->appendPackY(relativePos.y);
-			(*pForwardBundle) << angle2int8(dir.yaw());
-			(*pForwardBundle) << angle2int8(dir.pitch());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xyz_yp_optimized, update);
-		}
-		break;
-		case (UPDATE_FLAG_XYZ | UPDATE_FLAG_PITCH_ROLL):
-		{
-			Position3D relativePos = otherEntity->position() - this->pEntity()->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xyz_pr_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			pForwardBundle->appendPackXZ(relativePos.x, relativePos.z);
-			pForwardBundle->appendPackY(relativePos.y);
-			(*pForwardBundle) << angle2int8(dir.pitch());
-			(*pForwardBundle) << angle2int8(dir.roll());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xyz_pr_optimized, update);
-		}
-		break;
-		case (UPDATE_FLAG_XYZ | UPDATE_FLAG_YAW_PITCH_ROLL):
-		{
-			Position3D relativePos = otherEntity->position() - this->pEntity()->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xyz_ypr_optimized, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			pForwardBundle->appendPackXZ(relativePos.x, relativePos.z);
-			pForwardBundle->appendPackY(relativePos.y);
-			(*pForwardBundle) << angle2int8(dir.yaw());
-			(*pForwardBundle) << angle2int8(dir.pitch());
-			(*pForwardBundle) << angle2int8(dir.roll());
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xyz_ypr_optimized, update);
-		}
-		break;
-		default:
-			KBE_ASSERT(false);
-			break;
-		};
+//-------------------------------------------------------------------------------------
+void Witness::addUpdateToStream(Network::Bundle* pForwardBundle, uint32 flags, EntityRef* pEntityRef)
+{
+	if (flags == UPDATE_FLAG_NULL)
+		return;
+
+	static uint8 type = g_kbeSrvConfig.getCellApp().entity_posdir_updates_type;
+	static uint16 threshold = g_kbeSrvConfig.getCellApp().entity_posdir_updates_smart_threshold;
+
+	bool isOptimized = true;
+	if ((type == 2 && clientViewSize_ <= threshold) || type == 0)
+	{
+		isOptimized = false;
 	}
-	else
+
+	uint8 posType, dirBits;
+	splitVolatileFlags(flags, posType, dirBits);
+
+	// Żģʽµڹ۲ߵģ ÿ۲߶ֻͬܵ
+	if (isOptimized && posType != VOLATILE_POS_NULL)
 	{
-		switch (flags)
-		{
-		case UPDATE_FLAG_NULL:
-		{
-			// (*pForwardBundle).newMessage(ClientInterface::onUpdateData);
-		}
-		break;
-		case UPDATE_FLAG_XZ:
-		{
-			const Position3D& pos = otherEntity->position();
+		addRelativeUpdateToStream(pForwardBundle, flags, pEntityRef);
+		return;
+	}
 
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xz, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << pos.x;
-			(*pForwardBundle) << pos.z;
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xz, update);
-		}
-		break;
-		case UPDATE_FLAG_XYZ:
-		{
-			const Position3D& pos = otherEntity->position();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xyz, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << pos.x;
-			(*pForwardBundle) << pos.y;
-			(*pForwardBundle) << pos.z;
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xyz, update);
-		}
-		break;
-		case UPDATE_FLAG_YAW:
-		{
-			const Direction3D& dir = otherEntity->direction();
+	// ۲޹أ һtickֻһΣֱ֮ӿ۲ߵİ
+	const Network::MessageHandler& msgHandler = getVolatileDataMessageHandler(posType, dirBits, isOptimized);
+	const Entity::VolatileDataCache::Variant& variant = getVolatileDataCache(pEntityRef->pEntity(), posType, dirBits, isOptimized);
 
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_y, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << dir.yaw();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_y, update);
-		}
-		break;
-		case UPDATE_FLAG_ROLL:
-		{
-			const Direction3D& dir = otherEntity->direction();
+	ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, msgHandler, update);
+	_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
+	pForwardBundle->append(variant.data, variant.size);
+	ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, msgHandler, update);
+}
 
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_r, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << dir.roll();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_r, update);
-		}
-		break;
-		case UPDATE_FLAG_PITCH:
-		{
-			const Direction3D& dir = otherEntity->direction();
+//-------------------------------------------------------------------------------------
+void Witness::addRelativeUpdateToStream(Network::Bundle* pForwardBundle, uint32 flags, EntityRef* pEntityRef)
+{
+	Entity* otherEntity = pEntityRef->pEntity();
 
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_p, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << dir.pitch();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_p, update);
-		}
-		break;
-		case UPDATE_FLAG_YAW_PITCH_ROLL:
-		{
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_ypr, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << dir.yaw();
-			(*pForwardBundle) << dir.pitch();
-			(*pForwardBundle) << dir.roll();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_ypr, update);
-		}
-		break;
-		case UPDATE_FLAG_YAW_PITCH:
-		{
-			const Direction3D& dir = otherEntity->direction();
+	uint8 posType, dirBits;
+	splitVolatileFlags(flags, posType, dirBits);
+	KBE_ASSERT(posType != VOLATILE_POS_NULL);
 
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_yp, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << dir.yaw();
-			(*pForwardBundle) << dir.pitch();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_yp, update);
-		}
-		break;
-		case UPDATE_FLAG_YAW_ROLL:
-		{
-			const Direction3D& dir = otherEntity->direction();
+	const Network::MessageHandler& msgHandler = getVolatileDataMessageHandler(posType, dirBits, true);
+	Position3D relativePos = otherEntity->position() - this->pEntity()->position();
 
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_yr, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << dir.yaw();
-			(*pForwardBundle) << dir.roll();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_yr, update);
-		}
-		break;
-		case UPDATE_FLAG_PITCH_ROLL:
-		{
-			const Direction3D& dir = otherEntity->direction();
+	ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, msgHandler, update);
+	_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
+	pForwardBundle->appendPackXZ(relativePos.x, relativePos.z);
 
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_pr, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << dir.pitch();
-			(*pForwardBundle) << dir.roll();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_pr, update);
-		}
-		break;
-		case (UPDATE_FLAG_XZ | UPDATE_FLAG_YAW):
-		{
-			const Position3D& pos = otherEntity->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xz_y, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << pos.x;
-			(*pForwardBundle) << pos.z;
-			(*pForwardBundle) << dir.yaw();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xz_y, update);
-		}
-		break;
-		case (UPDATE_FLAG_XZ | UPDATE_FLAG_PITCH):
-		{
-			const Position3D& pos = otherEntity->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xz_p, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << pos.x;
-			(*pForwardBundle) << pos.z;
-			(*pForwardBundle) << dir.pitch();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xz_p, update);
-		}
-		break;
-		case (UPDATE_FLAG_XZ | UPDATE_FLAG_ROLL):
-		{
-			const Position3D& pos = otherEntity->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xz_r, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << pos.x;
-			(*pForwardBundle) << pos.z;
-			(*pForwardBundle) << dir.roll();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xz_r, update);
-		}
-		break;
-		case (UPDATE_FLAG_XZ | UPDATE_FLAG_YAW_ROLL):
-		{
-			const Position3D& pos = otherEntity->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xz_yr, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << pos.x;
-			(*pForwardBundle) << pos.z;
-			(*pForwardBundle) << dir.yaw();
-			(*pForwardBundle) << dir.roll();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xz_yr, update);
-		}
-		break;
-		case (UPDATE_FLAG_XZ | UPDATE_FLAG_YAW_PITCH):
-		{
-			const Position3D& pos = otherEntity->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xz_yp, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << pos.x;
-			(*pForwardBundle) << pos.z;
-			(*pForwardBundle) << dir.yaw();
-			(*pForwardBundle) << dir.pitch();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xz_yp, update);
-		}
-		break;
-		case (UPDATE_FLAG_XZ | UPDATE_FLAG_PITCH_ROLL):
-		{
-			const Position3D& pos = otherEntity->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xz_pr, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << pos.x;
-			(*pForwardBundle) << pos.z;
-			(*pForwardBundle) << dir.pitch();
-			(*pForwardBundle) << dir.roll();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xz_pr, update);
-		}
-		break;
-		case (UPDATE_FLAG_XZ | UPDATE_FLAG_YAW_PITCH_ROLL):
-		{
-			const Position3D& pos = otherEntity->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xz_ypr, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << pos.x;
-			(*pForwardBundle) << pos.z;
-			(*pForwardBundle) << dir.yaw();
-			(*pForwardBundle) << dir.pitch();
-			(*pForwardBundle) << dir.roll();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xz_ypr, update);
-		}
-		break;
-		case (UPDATE_FLAG_XYZ | UPDATE_FLAG_YAW):
-		{
-			const Position3D& pos = otherEntity->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xyz_y, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << pos.x;
-			(*pForwardBundle) << pos.y;
-			(*pForwardBundle) << pos.z;
-			(*pForwardBundle) << dir.yaw();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xyz_y, update);
-		}
-		break;
-		case (UPDATE_FLAG_XYZ | UPDATE_FLAG_PITCH):
-		{
-			const Position3D& pos = otherEntity->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xyz_p, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << pos.x;
-			(*pForwardBundle) << pos.y;
-			(*pForwardBundle) << pos.z;
-			(*pForwardBundle) << dir.pitch();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xyz, update);
-		}
-		break;
-		case (UPDATE_FLAG_XYZ | UPDATE_FLAG_ROLL):
-		{
-			const Position3D& pos = otherEntity->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xyz_r, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << pos.x;
-			(*pForwardBundle) << pos.y;
-			(*pForwardBundle) << pos.z;
-			(*pForwardBundle) << dir.roll();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xyz_r, update);
-		}
-		break;
-		case (UPDATE_FLAG_XYZ | UPDATE_FLAG_YAW_ROLL):
-		{
-			const Position3D& pos = otherEntity->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xyz_yr, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << pos.x;
-			(*pForwardBundle) << pos.y;
-			(*pForwardBundle) << pos.z;
-			(*pForwardBundle) << dir.yaw();
-			(*pForwardBundle) << dir.roll();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xyz_yr, update);
-		}
-		break;
-		case (UPDATE_FLAG_XYZ | UPDATE_FLAG_YAW_PITCH):
-		{
-			const Position3D& pos = otherEntity->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xyz_yp, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << pos.x;
-			(*pForwardBundle) << pos.y;
-			(*pForwardBundle) << pos.z;
-			(*pForwardBundle) << dir.yaw();
-			(*pForwardBundle) << dir.pitch();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xyz_yp, update);
-		}
-		break;
-		case (UPDATE_FLAG_XYZ | UPDATE_FLAG_PITCH_ROLL):
-		{
-			const Position3D& pos = otherEntity->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xyz_pr, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << pos.x;
-			(*pForwardBundle) << pos.y;
-			(*pForwardBundle) << pos.z;
-			(*pForwardBundle) << dir.pitch();
-			(*pForwardBundle) << dir.roll();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xyz_pr, update);
-		}
-		break;
-		case (UPDATE_FLAG_XYZ | UPDATE_FLAG_YAW_PITCH_ROLL):
-		{
-			const Position3D& pos = otherEntity->position();
-			const Direction3D& dir = otherEntity->direction();
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, ClientInterface::onUpdateData_xyz_ypr, update);
-			_addViewEntityIDToBundle(pForwardBundle, pEntityRef);
-			(*pForwardBundle) << pos.x;
-			(*pForwardBundle) << pos.y;
-			(*pForwardBundle) << pos.z;
-			(*pForwardBundle) << dir.yaw();
-			(*pForwardBundle) << dir.pitch();
-			(*pForwardBundle) << dir.roll();
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, ClientInterface::onUpdateData_xyz_ypr, update);
-		}
-		break;
-		default:
-			KBE_ASSERT(false);
-			break;
-		};
+	if (posType == VOLATILE_POS_XYZ)
+		pForwardBundle->appendPackY(relativePos.y);
+
+	// 򲿷۲޹أ ʹùı
+	if (dirBits > 0)
+	{
+		const Entity::VolatileDataCache::Variant& variant = getVolatileDataCache(otherEntity, VOLATILE_POS_NULL, dirBits, true);
+		pForwardBundle->append(variant.data, variant.size);
 	}
+
+	ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, msgHandler, update);
 }
 
 //-------------------------------------------------------------------------------------
-uint32 Witness::getEntityVolatileDataUpdateFlags(Entity* otherEntity)
+uint32 Witness::getEntityVolatileDataUpdateFlags(Entity* otherEntity, uint32 updateWindow)
 {
 	uint32 flags = UPDATE_FLAG_NULL;
 
@@ -1591,8 +1232,11 @@ uint32 Witness::getEntityVolatileDataUpdateFlags(Entity* otherEntity)
 		pVolatileInfo = otherEntity->pScriptModule()->getPVolatileInfo();
 
 	static uint16 entity_posdir_additional_updates = g_kbeSrvConfig.getCellApp().entity_posdir_additional_updates;
+
+	if (updateWindow == 0)
+		updateWindow = entity_posdir_additional_updates;
 	
-	if ((pVolatileInfo->position() > 0.f) && (entity_posdir_additional_updates == 0 || g_kbetime - otherEntity->posChangedTime() < entity_posdir_additional_updates))
+	if ((pVolatileInfo->position() > 0.f) && (entity_posdir_additional_updates == 0 || g_kbetime - otherEntity->posChangedTime() < updateWindow))
 	{
 		if (!otherEntity->isOnGround() || !pVolatileInfo->optimized())
 		{
@@ -1604,7 +1248,7 @@ uint32 Witness::getEntityVolatileDataUpdateFlags(Entity* otherEntity)
 		}
 	}
 
-	if((entity_posdir_additional_updates == 0) || (g_kbetime - otherEntity->dirChangedTime() < entity_posdir_additional_updates))
+	if((entity_posdir_additional_updates == 0) || (g_kbetime - otherEntity->dirChangedTime() < updateWindow))
 	{
 		if (pVolatileInfo->yaw() > 0.f)
 		{
@@ -1648,6 +1292,78 @@ uint32 Witness::getEntityVolatileDataUpdateFlags(Entity* otherEntity)
 	return flags;
 }
 
+//-------------------------------------------------------------------------------------
+bool Witness::addPropertyUpdatesToStream(Network::Bundle* pForwardBundle, Entity* otherEntity, 
+	const std::vector<PropertyUpdate>& updates)
+{
+	ScriptDefModule* pScriptModule = otherEntity->pScriptModule();
+	DetailLevel& detailLevel = pScriptModule->getDetailLevel();
+
+	Position3D lengthPos = pEntity_->position() - otherEntity->position();
+	float dist = lengthPos.length();
+
+	std::vector<PropertyUpdate>::const_iterator iter = updates.begin();
+	for(; iter != updates.end(); ++iter)
+	{
+		if(detailLevel.level[iter->pPropertyDescription->getDetailLevel()].inLevel(dist))
+			break;
+	}
+
+	if(iter == updates.end())
+		return false;
+
+	int ialiasID = -1;
+	const Network::MessageHandler& msgHandler = getViewEntityMessageHandler(ClientInterface::onUpdatePropertys, 
+		ClientInterface::onUpdatePropertysOptimized, otherEntity->id(), ialiasID);
+
+	ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pForwardBundle, msgHandler, viewEntityMessage);
+
+	if(ialiasID != -1)
+	{
+		KBE_ASSERT(msgHandler.msgID == ClientInterface::onUpdatePropertysOptimized.msgID);
+		(*pForwardBundle) << (uint8)ialiasID;
+	}
+	else
+	{
+		KBE_ASSERT(msgHandler.msgID == ClientInterface::onUpdatePropertys.msgID);
+		(*pForwardBundle) << otherEntity->id();
+	}
+
+	// ͬһʵĶԺϲһϢУ ÿԵĸı֮ǰҪһϢ
+	uint32 numChanges = 0;
+
+	for(; iter != updates.end(); ++iter)
+	{
+		const PropertyUpdate& update = (*iter);
+		if(!detailLevel.level[update.pPropertyDescription->getDetailLevel()].inLevel(dist))
+			continue;
+
+		if (pScriptModule->usePropertyDescrAlias())
+		{
+			(*pForwardBundle) << update.componentPropertyAliasID;
+			(*pForwardBundle) << update.pPropertyDescription->aliasIDAsUint8();
+		}
+		else
+		{
+			(*pForwardBundle) << update.componentPropertyUID;
+			(*pForwardBundle) << update.pPropertyDescription->getUType();
+		}
+
+		(*pForwardBundle).append(*update.pData);
+		numChanges += update.numChanges;
+
+		// ¼¼С
+		g_publicClientEventHistoryStats.trackEvent(otherEntity->scriptName(), 
+			update.pPropertyDescription->getName(), 
+			update.pData->length());
+	}
+
+	ENTITY_MESSAGE_FORWARD_CLIENT_END(pForwardBundle, msgHandler, viewEntityMessage);
+
+	Cellapp::getSingleton().onPropertyUpdatesSent(numChanges);
+	return true;
+}
+
 //-------------------------------------------------------------------------------------
 bool Witness::sendToClient(const Network::MessageHandler& msgHandler, Network::Bundle* pBundle)
 {
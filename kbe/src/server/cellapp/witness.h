@@ -27,6 +27,7 @@ namespace Network
 }
 
 class Entity;
+struct PropertyUpdate;
 class MemoryStream;
 class ViewTrigger;
 class SpaceMemory;
@@ -64,6 +65,9 @@ public:
 	typedef std::list<EntityRef*> VIEW_ENTITIES;
 	typedef std::map<ENTITY_ID, EntityRef*> VIEW_ENTITIES_MAP;
 
+	// ͻͨˮλʱ ÿٴupdateͬһvolatile
+	enum { BACKPRESSURE_UPDATE_INTERVAL = 4 };
+
 	Witness();
 	~Witness();
 	
@@ -120,6 +124,13 @@ public:
 	INLINE const Direction3D& baseDir();
 
 	bool update();
+
+	/**
+		ͻͨݳˮλʱvolatileݵͬƵʣ 䵽ˮλʱָ
+	*/
+	void onClientBackpressure(bool isBackpressure, uint32 queuedBytes);
+	INLINE bool clientBackpressure() const;
+	INLINE uint32 clientQueuedBytes() const;
 	
 	void onEnterSpace(SpaceMemory* pSpace);
 	void onLeaveSpace(SpaceMemory* pSpace);
@@ -130,8 +141,9 @@ public:
 
 	/**
 		ʵ屾ͬVolatileݵı
+		updateWindow: λ볯ٸtickڸıҪͬ 0Ϊʹcellappentity_posdir_additional_updates
 	*/
-	uint32 getEntityVolatileDataUpdateFlags(Entity* otherEntity);
+	uint32 getEntityVolatileDataUpdateFlags(Entity* otherEntity, uint32 updateWindow = 0);
 	
 
 	const Network::MessageHandler& getViewEntityMessageHandler(const Network::MessageHandler& normalMsgHandler, 
@@ -144,6 +156,17 @@ public:
 	*/
 	void addUpdateToStream(Network::Bundle* pForwardBundle, uint32 flags, EntityRef* pEntityRef);
 
+	/**
+		Żģʽʹ¿ͻˣ ۲
+	*/
+	void addRelativeUpdateToStream(Network::Bundle* pForwardBundle, uint32 flags, EntityRef* pEntityRef);
+
+	/**
+		ʵ建ԸıϲΪһϢд룬 ֻд鼶Χڵԣ ûдʱfalse
+	*/
+	bool addPropertyUpdatesToStream(Network::Bundle* pForwardBundle, Entity* otherEntity, 
+		const std::vector<PropertyUpdate>& updates);
+
 	/**
 		ӻλõ°
 	*/
@@ -204,6 +227,16 @@ private:
 	Direction3D								lastBaseDir_;
 
 	uint16									clientViewSize_;
+
+	// ͻͨǷ񳬹˸ˮλ Լ˺󾭹update
+	bool									clientBackpressure_;
+	uint32									backpressureTicks_;
+
+	// һˮλ仯ʱͻͨд͵ֽ
+	uint32									clientQueuedBytes_;
+
+	// ӸˮλָĵһupdateҪͬʵvolatile
+	bool									forceVolatileUpdates_;
 };
 
 }
@@ -27,6 +27,18 @@ INLINE float Witness::viewHysteresisArea() const
 	return viewHysteresisArea_; 
 }
 
+//-------------------------------------------------------------------------------------
+INLINE bool Witness::clientBackpressure() const
+{ 
+	return clientBackpressure_; 
+}
+
+//-------------------------------------------------------------------------------------
+INLINE uint32 Witness::clientQueuedBytes() const
+{ 
+	return clientQueuedBytes_; 
+}
+
 //-------------------------------------------------------------------------------------
 INLINE EntityRef* Witness::getViewEntityRef(ENTITY_ID entityID)
 {
@@ -13,7 +13,15 @@ Buffered_DBTasks::Buffered_DBTasks():
 dbid_tasks_(),
 entityid_tasks_(),
 mutex_(),
-dbInterfaceName_()
+dbInterfaceName_(),
+writeBatches_(),
+numWriteBatches_(0),
+numBatchedWrites_(0),
+numBatchStatements_(0),
+numMergedWrites_(0),
+numWrittenEntities_(0),
+numPartialWrites_(0),
+numWrittenRows_(0)
 {
 }
 
@@ -72,6 +80,12 @@ void Buffered_DBTasks::addTask(EntityDBTask* pTask)
 	{
 		if(hasTask_(pTask->EntityDBTask_entityDBID()))
 		{
+			if(g_kbeSrvConfig.getDBMgr().writeCoalescing && mergeWriteTask_(pTask))
+			{
+				mutex_.unlockMutex();
+				return;
+			}
+
 			dbid_tasks_.insert(std::make_pair(pTask->EntityDBTask_entityDBID(), pTask));
 			mutex_.unlockMutex();
 			return;
@@ -82,7 +96,138 @@ void Buffered_DBTasks::addTask(EntityDBTask* pTask)
 	}
 
 	mutex_.unlockMutex();
-	DBUtil::pThreadPool(dbInterfaceName_)->addTask(pTask);
+	dispatchTask(pTask);
+}
+
+//-------------------------------------------------------------------------------------
+bool Buffered_DBTasks::mergeWriteTask_(EntityDBTask* pTask)
+{
+	if(!pTask->canBatchWrite())
+		return false;
+
+	std::pair<DBID_TASKS_MAP::iterator, DBID_TASKS_MAP::iterator> range = 
+		dbid_tasks_.equal_range(pTask->EntityDBTask_entityDBID());
+
+	if (range.first == range.second)
+		return false;
+
+	// ֻȡһ ı֮˳
+	// һѾʼִУ ܱȡ
+	DBID_TASKS_MAP::iterator lastIter = range.second;
+	--lastIter;
+
+	if (lastIter == range.first)
+		return false;
+
+	EntityDBTask* pLastTask = lastIter->second;
+	if (pLastTask == NULL || !pLastTask->canBatchWrite())
+		return false;
+
+	DBTaskWriteEntity* pWriteTask = static_cast<DBTaskWriteEntity*>(pTask);
+	DBTaskWriteEntity* pOldTask = static_cast<DBTaskWriteEntity*>(pLastTask);
+
+	if (pWriteTask->sid() != pOldTask->sid() || !pWriteTask->canMergeWrite(pOldTask))
+		return false;
+
+	pWriteTask->mergeWrite(pOldTask);
+	lastIter->second = pTask;
+	++numMergedWrites_;
+
+	if(g_kbeSrvConfig.getDBMgr().debugDBMgr)
+	{
+		DEBUG_MSG(fmt::format("Buffered_DBTasks::mergeWriteTask_(): dbid={}, entityID={}, merged={}.\n", 
+			pTask->EntityDBTask_entityDBID(), pTask->EntityDBTask_entityID(), numMergedWrites_)); 
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void Buffered_DBTasks::dispatchTask(EntityDBTask* pTask)
+{
+	uint32 writeBatchSize = g_kbeSrvConfig.getDBMgr().writeBatchSize;
+
+	if(writeBatchSize < 2 || !pTask->canBatchWrite())
+	{
+		DBUtil::pThreadPool(dbInterfaceName_)->addTask(pTask);
+		return;
+	}
+
+	DBTaskWriteEntity* pWriteTask = static_cast<DBTaskWriteEntity*>(pTask);
+
+	mutex_.lockMutex();
+
+	WriteBatch& batch = writeBatches_[pWriteTask->sid()];
+	if(batch.tasks.size() == 0)
+		batch.startTime = timestamp();
+
+	batch.tasks.push_back(pWriteTask);
+
+	if(batch.tasks.size() >= writeBatchSize)
+		flushWriteBatch_(pWriteTask->sid(), batch);
+
+	mutex_.unlockMutex();
+}
+
+//-------------------------------------------------------------------------------------
+void Buffered_DBTasks::flushWriteBatches(bool force)
+{
+	mutex_.lockMutex();
+
+	uint64 now = timestamp();
+	uint64 latency = (uint64)g_kbeSrvConfig.getDBMgr().writeBatchLatency * stampsPerSecond() / 1000;
+
+	WRITE_BATCHES_MAP::iterator iter = writeBatches_.begin();
+	for(; iter != writeBatches_.end(); ++iter)
+	{
+		WriteBatch& batch = iter->second;
+		if(batch.tasks.size() == 0)
+			continue;
+
+		if(force || now - batch.startTime >= latency)
+			flushWriteBatch_(iter->first, batch);
+	}
+
+	mutex_.unlockMutex();
+}
+
+//-------------------------------------------------------------------------------------
+void Buffered_DBTasks::flushWriteBatch_(ENTITY_SCRIPT_UID sid, WriteBatch& batch)
+{
+	thread::ThreadPool* pThreadPool = DBUtil::pThreadPool(dbInterfaceName_);
+
+	// ֻһʱûкϲıҪ
+	if(batch.tasks.size() == 1)
+	{
+		pThreadPool->addTask(batch.tasks.front());
+		batch.tasks.clear();
+		return;
+	}
+
+	++numWriteBatches_;
+	pThreadPool->addTask(new DBTaskWriteEntities(this, sid, batch.tasks));
+	batch.tasks.clear();
+}
+
+//-------------------------------------------------------------------------------------
+void Buffered_DBTasks::onWriteBatchCompleted(uint32 numTasks, uint32 numStatements)
+{
+	numBatchedWrites_ += numTasks;
+	numBatchStatements_ += numStatements;
+
+	if(g_kbeSrvConfig.getDBMgr().debugDBMgr)
+	{
+		DEBUG_MSG(fmt::format("Buffered_DBTasks::onWriteBatchCompleted(): dbInterface={}, entities={}, statements={}.\n", 
+			dbInterfaceName_, numTasks, numStatements)); 
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void Buffered_DBTasks::onEntitiesWritten(uint32 numEntities, uint32 numPartialWrites, uint32 numRows)
+{
+	numWrittenEntities_ += numEntities;
+	numPartialWrites_ += numPartialWrites;
+	numWrittenRows_ += numRows;
 }
 
 //-------------------------------------------------------------------------------------
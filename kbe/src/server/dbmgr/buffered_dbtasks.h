@@ -28,6 +28,23 @@ public:
 	
 	void addTask(EntityDBTask* pTask);
 
+	/**
+		Ѿִֵе񽻸̳߳أ ɺϲдȻ
+	*/
+	void dispatchTask(EntityDBTask* pTask);
+
+	/**
+		ȴϲд񽻸̳߳أ forceΪfalseʱֻȴʱ
+	*/
+	void flushWriteBatches(bool force = false);
+
+	void onWriteBatchCompleted(uint32 numTasks, uint32 numStatements);
+
+	/**
+		дɣ numPartialWritesΪֻдıԵ numRowsΪдݿ
+	*/
+	void onEntitiesWritten(uint32 numEntities, uint32 numPartialWrites, uint32 numRows);
+
 	EntityDBTask* tryGetNextTask(EntityDBTask* pTask);
 
 	size_t size() { return dbid_tasks_.size() + entityid_tasks_.size(); }
@@ -110,6 +127,17 @@ public:
 		return ret;
 	}
 
+	/**
+		ṩwatcherʹ
+	*/
+	uint32 numWriteBatches() const { return numWriteBatches_; }
+	uint32 numBatchedWrites() const { return numBatchedWrites_; }
+	uint32 numBatchStatements() const { return numBatchStatements_; }
+	uint32 numMergedWrites() const { return numMergedWrites_; }
+	uint32 numWrittenEntities() const { return numWrittenEntities_; }
+	uint32 numPartialWrites() const { return numPartialWrites_; }
+	uint32 numWrittenRows() const { return numWrittenRows_; }
+
 	/**
 		ṩwatcherʹ
 	*/
@@ -122,12 +150,48 @@ protected:
 	bool hasTask_(DBID dbid);
 	bool hasTask_(ENTITY_ID entityID);
 
+	struct WriteBatch
+	{
+		WriteBatch():
+		startTime(0),
+		tasks()
+		{
+		}
+
+		uint64 startTime;
+		std::vector<DBTaskWriteEntity*> tasks;
+	};
+
+	typedef std::map<ENTITY_SCRIPT_UID, WriteBatch> WRITE_BATCHES_MAP;
+
+	void flushWriteBatch_(ENTITY_SCRIPT_UID sid, WriteBatch& batch);
+
+	/**
+		µдȡͬһDBIDδִед
+	*/
+	bool mergeWriteTask_(EntityDBTask* pTask);
+
 	DBID_TASKS_MAP dbid_tasks_;
 	ENTITYID_TASKS_MAP entityid_tasks_;
 
 	KBEngine::thread::ThreadMutex mutex_;
 
 	std::string dbInterfaceName_;
+
+	// entity͵ȴϲд
+	WRITE_BATCHES_MAP writeBatches_;
+
+	uint32 numWriteBatches_;
+	uint32 numBatchedWrites_;
+	uint32 numBatchStatements_;
+
+	// µдȡд
+	uint32 numMergedWrites_;
+
+	// ִедֻдıԵдݿ
+	uint32 numWrittenEntities_;
+	uint32 numPartialWrites_;
+	uint32 numWrittenRows_;
 };
 
 }
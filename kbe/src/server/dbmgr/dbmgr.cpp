@@ -102,6 +102,8 @@ ShutdownHandler::CAN_SHUTDOWN_STATE Dbmgr::canShutdown()
 	{
 		if (bditer->second.size() > 0)
 		{
+			bditer->second.flushWriteBatches(true);
+
 			thread::ThreadPool* pThreadPool = DBUtil::pThreadPool(bditer->first);
 			KBE_ASSERT(pThreadPool);
 
@@ -178,6 +180,13 @@ bool Dbmgr::initializeWatcher()
 		WATCH_OBJECT(fmt::format("DBThreadPool/{}/entityid_tasksSize", bditer->first).c_str(), &bditer->second, &Buffered_DBTasks::entityid_tasksSize);
 		WATCH_OBJECT(fmt::format("DBThreadPool/{}/printBuffered_dbid", bditer->first).c_str(), &bditer->second, &Buffered_DBTasks::printBuffered_dbid);
 		WATCH_OBJECT(fmt::format("DBThreadPool/{}/printBuffered_entityID", bditer->first).c_str(), &bditer->second, &Buffered_DBTasks::printBuffered_entityID);
+		WATCH_OBJECT(fmt::format("DBThreadPool/{}/numWriteBatches", bditer->first).c_str(), &bditer->second, &Buffered_DBTasks::numWriteBatches);
+		WATCH_OBJECT(fmt::format("DBThreadPool/{}/numBatchedWrites", bditer->first).c_str(), &bditer->second, &Buffered_DBTasks::numBatchedWrites);
+		WATCH_OBJECT(fmt::format("DBThreadPool/{}/numBatchStatements", bditer->first).c_str(), &bditer->second, &Buffered_DBTasks::numBatchStatements);
+		WATCH_OBJECT(fmt::format("DBThreadPool/{}/numMergedWrites", bditer->first).c_str(), &bditer->second, &Buffered_DBTasks::numMergedWrites);
+		WATCH_OBJECT(fmt::format("DBThreadPool/{}/numWrittenEntities", bditer->first).c_str(), &bditer->second, &Buffered_DBTasks::numWrittenEntities);
+		WATCH_OBJECT(fmt::format("DBThreadPool/{}/numPartialWrites", bditer->first).c_str(), &bditer->second, &Buffered_DBTasks::numPartialWrites);
+		WATCH_OBJECT(fmt::format("DBThreadPool/{}/numWrittenRows", bditer->first).c_str(), &bditer->second, &Buffered_DBTasks::numWrittenRows);
 	}
 
 	return ServerApp::initializeWatcher() && DBUtil::initializeWatcher();
@@ -217,6 +226,11 @@ void Dbmgr::handleMainTick()
 	 // DEBUG_MSG(fmt::format("Dbmgr::handleGameTick[{}]:{}\n", t, ++kbeTime));
 	
 	threadPool_.onMainThreadTick();
+
+	KBEUnordered_map<std::string, Buffered_DBTasks>::iterator bditer = bufferedDBTasksMaps_.begin();
+	for (; bditer != bufferedDBTasksMaps_.end(); ++bditer)
+		bditer->second.flushWriteBatches();
+
 	DBUtil::handleMainTick();
 	networkInterface().processChannels(&DbmgrInterface::messageHandlers);
 }
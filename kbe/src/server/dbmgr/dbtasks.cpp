@@ -315,20 +315,63 @@ entityDBID_(entityDBID),
 sid_(0),
 callbackID_(0),
 shouldAutoLoad_(-1),
-success_(false)
+success_(false),
+propertys_(),
+executed_(false),
+numWrittenRows_(0),
+mergedTasks_()
 {
+	// ߳жsid Buffered_DBTasksҪݴ˺ϲͬentityд
+	(*pDatas_) >> sid_ >> callbackID_ >> shouldAutoLoad_;
+
+	uint16 numPropertys = 0;
+	(*pDatas_) >> numPropertys;
+
+	for(uint16 i = 0; i < numPropertys; ++i)
+	{
+		ENTITY_PROPERTY_UID utype;
+		(*pDatas_) >> utype;
+		propertys_.insert(utype);
+	}
 }
 
 //-------------------------------------------------------------------------------------
 DBTaskWriteEntity::~DBTaskWriteEntity()
 {
+	std::vector<DBTaskWriteEntity*>::iterator iter = mergedTasks_.begin();
+	for(; iter != mergedTasks_.end(); ++iter)
+		delete (*iter);
 }
 
 //-------------------------------------------------------------------------------------
-bool DBTaskWriteEntity::db_thread_process()
+void DBTaskWriteEntity::mergeWrite(DBTaskWriteEntity* pOldTask)
 {
-	(*pDatas_) >> sid_ >> callbackID_ >> shouldAutoLoad_;
+	// д԰˱ȡд(canMergeWrite) ֻҪȡбûָѡ
+	if(shouldAutoLoad_ == -1)
+		shouldAutoLoad_ = pOldTask->shouldAutoLoad_;
 
+	// ֻص˳ ȡ֮ǰȡǰ
+	KBE_ASSERT(mergedTasks_.size() == 0);
+	mergedTasks_.swap(pOldTask->mergedTasks_);
+	mergedTasks_.push_back(pOldTask);
+}
+
+//-------------------------------------------------------------------------------------
+bool DBTaskWriteEntity::canMergeWrite(const DBTaskWriteEntity* pOldTask) const
+{
+	if(!isPartialWrite())
+		return true;
+
+	if(!pOldTask->isPartialWrite())
+		return false;
+
+	return std::includes(propertys_.begin(), propertys_.end(), 
+		pOldTask->propertys_.begin(), pOldTask->propertys_.end());
+}
+
+//-------------------------------------------------------------------------------------
+bool DBTaskWriteEntity::db_thread_process()
+{
 	ScriptDefModule* pModule = EntityDef::findScriptModule(sid_);
 	bool writeEntityLog = (entityDBID_ == 0);
 
@@ -351,9 +394,13 @@ bool DBTaskWriteEntity::db_thread_process()
 
 	EntityTables& entityTables = EntityTables::findByInterfaceName(pdbi_->name());
 
+	uint32 numWrittenRows = pdbi_->numWrittenRows();
 	entityDBID_ = entityTables.writeEntity(pdbi_, entityDBID_, shouldAutoLoad_, pDatas_, pModule);
 	success_ = entityDBID_ > 0;
 
+	executed_ = true;
+	numWrittenRows_ = pdbi_->numWrittenRows() - numWrittenRows;
+
 	if(writeEntityLog && success_)
 	{
 		success_ = false;
@@ -377,6 +424,24 @@ bool DBTaskWriteEntity::db_thread_process()
 //-------------------------------------------------------------------------------------
 thread::TPTask::TPTaskState DBTaskWriteEntity::presentMainThread()
 {
+	// ȡ뱾дĽ
+	std::vector<DBTaskWriteEntity*>::iterator iter = mergedTasks_.begin();
+	for(; iter != mergedTasks_.end(); ++iter)
+	{
+		DBTaskWriteEntity* pTask = (*iter);
+		pTask->pdbi(pdbi_);
+		pTask->entityDBID_ = entityDBID_;
+		pTask->success_ = success_;
+		pTask->presentMainThread();
+		delete pTask;
+	}
+
+	mergedTasks_.clear();
+
+	// ϲִеDBTaskWriteEntitiesͳ
+	if(executed_ && pBuffered_DBTasks())
+		pBuffered_DBTasks()->onEntitiesWritten(1, isPartialWrite() ? 1 : 0, numWrittenRows_);
+
 	ScriptDefModule* pModule = EntityDef::findScriptModule(sid_);
 	DEBUG_MSG(fmt::format("Dbmgr::writeEntity: {0}({1}).\n", pModule->getName(), entityDBID_));
 
@@ -396,6 +461,107 @@ thread::TPTask::TPTaskState DBTaskWriteEntity::presentMainThread()
 	return EntityDBTask::presentMainThread();
 }
 
+//-------------------------------------------------------------------------------------
+DBTaskWriteEntities::DBTaskWriteEntities(Buffered_DBTasks* pBuffered_DBTasks, ENTITY_SCRIPT_UID sid, 
+	std::vector<DBTaskWriteEntity*>& tasks):
+DBTask(),
+pBuffered_DBTasks_(pBuffered_DBTasks),
+sid_(sid),
+tasks_(),
+rposs_(),
+numStatements_(0),
+numWrittenRows_(0)
+{
+	tasks_.swap(tasks);
+
+	std::vector<DBTaskWriteEntity*>::iterator iter = tasks_.begin();
+	for(; iter != tasks_.end(); ++iter)
+		rposs_.push_back((*iter)->pDatas_->rpos());
+}
+
+//-------------------------------------------------------------------------------------
+DBTaskWriteEntities::~DBTaskWriteEntities()
+{
+	std::vector<DBTaskWriteEntity*>::iterator iter = tasks_.begin();
+	for(; iter != tasks_.end(); ++iter)
+		delete (*iter);
+}
+
+//-------------------------------------------------------------------------------------
+bool DBTaskWriteEntities::db_thread_process()
+{
+	ScriptDefModule* pModule = EntityDef::findScriptModule(sid_);
+
+	std::vector<ENTITY_WRITE_DATA> datas;
+	datas.reserve(tasks_.size());
+
+	for(size_t i = 0; i < tasks_.size(); ++i)
+	{
+		DBTaskWriteEntity* pTask = tasks_[i];
+		pTask->pdbi(pdbi_);
+		pTask->pDatas_->rpos(rposs_[i]);
+
+		datas.push_back(ENTITY_WRITE_DATA(pTask->EntityDBTask_entityDBID(), 
+			pTask->shouldAutoLoad_, pTask->pDatas_));
+	}
+
+	EntityTables& entityTables = EntityTables::findByInterfaceName(pdbi_->name());
+
+	uint32 numWrittenRows = pdbi_->numWrittenRows();
+	numStatements_ = entityTables.writeEntities(pdbi_, datas, pModule);
+	numWrittenRows_ = pdbi_->numWrittenRows() - numWrittenRows;
+
+	for(size_t i = 0; i < tasks_.size(); ++i)
+	{
+		DBTaskWriteEntity* pTask = tasks_[i];
+		pTask->entityDBID_ = datas[i].dbid;
+		pTask->success_ = pTask->entityDBID_ > 0;
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+DBTaskBase* DBTaskWriteEntities::tryGetNextTask()
+{
+	DBTask* pNextTask = NULL;
+
+	std::vector<DBTaskWriteEntity*>::iterator iter = tasks_.begin();
+	for(; iter != tasks_.end(); ++iter)
+	{
+		EntityDBTask* pTask = static_cast<EntityDBTask*>((*iter)->tryGetNextTask());
+		if(pTask == NULL)
+			continue;
+
+		// ǰִֻܼ߳һ ɷ
+		if(pNextTask == NULL)
+			pNextTask = pTask;
+		else
+			pBuffered_DBTasks_->dispatchTask(pTask);
+	}
+
+	return pNextTask;
+}
+
+//-------------------------------------------------------------------------------------
+thread::TPTask::TPTaskState DBTaskWriteEntities::presentMainThread()
+{
+	std::vector<DBTaskWriteEntity*>::iterator iter = tasks_.begin();
+	for(; iter != tasks_.end(); ++iter)
+		(*iter)->presentMainThread();
+
+	uint32 numPartialWrites = 0;
+	for(iter = tasks_.begin(); iter != tasks_.end(); ++iter)
+	{
+		if((*iter)->isPartialWrite())
+			++numPartialWrites;
+	}
+
+	pBuffered_DBTasks_->onWriteBatchCompleted((uint32)tasks_.size(), numStatements_);
+	pBuffered_DBTasks_->onEntitiesWritten((uint32)tasks_.size(), numPartialWrites, numWrittenRows_);
+	return DBTask::presentMainThread();
+}
+
 //-------------------------------------------------------------------------------------
 DBTaskRemoveEntity::DBTaskRemoveEntity(const Network::Address& addr, 
 									 COMPONENT_ID componentID, ENTITY_ID eid, 
@@ -83,10 +83,18 @@ public:
 	DBID EntityDBTask_entityDBID() const { return _entityDBID; }
 	
 	void pBuffered_DBTasks(Buffered_DBTasks* v){ _pBuffered_DBTasks = v; }
+	Buffered_DBTasks* pBuffered_DBTasks() const{ return _pBuffered_DBTasks; }
 	virtual thread::TPTask::TPTaskState presentMainThread();
 
 	DBTask* tryGetNextTask();
 
+	/**
+		Ƿͬentityдϲִ
+	*/
+	virtual bool canBatchWrite() const {
+		return false;
+	}
+
 	virtual std::string name() const {
 		return "EntityDBTask";
 	}
@@ -163,7 +171,33 @@ public:
 		return "DBTaskWriteEntity";
 	}
 
+	/**
+		Ѵڵentityĸ¿Ժϲд
+	*/
+	virtual bool canBatchWrite() const {
+		return entityDBID_ > 0;
+	}
+
+	ENTITY_SCRIPT_UID sid() const { return sid_; }
+
+	/**
+		ȡһδִеͬһentityд ȡĻصڱɺһ
+	*/
+	void mergeWrite(DBTaskWriteEntity* pOldTask);
+
+	/**
+		ֻд벿ʱ ֻа˱ȡдԲȡ
+	*/
+	bool canMergeWrite(const DBTaskWriteEntity* pOldTask) const;
+
+	/**
+		Ƿֻд˸ı
+	*/
+	bool isPartialWrite() const { return propertys_.size() > 0; }
+
 protected:
+	friend class DBTaskWriteEntities;
+
 	COMPONENT_ID componentID_;
 	ENTITY_ID eid_;
 	DBID entityDBID_;
@@ -171,6 +205,46 @@ protected:
 	CALLBACK_ID callbackID_;
 	int8 shouldAutoLoad_;
 	bool success_;
+
+	// дԣ Ϊʱд
+	std::set<ENTITY_PROPERTY_UID> propertys_;
+
+	// ɱ񵥶ִдʱͳдݿ
+	bool executed_;
+	uint32 numWrittenRows_;
+
+	// ȡд
+	std::vector<DBTaskWriteEntity*> mergedTasks_;
+};
+
+/**
+	ͬentityĶºϲдݿ
+*/
+class DBTaskWriteEntities : public DBTask
+{
+public:
+	DBTaskWriteEntities(Buffered_DBTasks* pBuffered_DBTasks, ENTITY_SCRIPT_UID sid, 
+		std::vector<DBTaskWriteEntity*>& tasks);
+
+	virtual ~DBTaskWriteEntities();
+	virtual bool db_thread_process();
+	virtual DBTaskBase* tryGetNextTask();
+	virtual thread::TPTask::TPTaskState presentMainThread();
+
+	virtual std::string name() const {
+		return "DBTaskWriteEntities";
+	}
+
+protected:
+	Buffered_DBTasks* pBuffered_DBTasks_;
+	ENTITY_SCRIPT_UID sid_;
+	std::vector<DBTaskWriteEntity*> tasks_;
+
+	// ÿʼλã ݿ쳣ʱҪ¶ȡ
+	std::vector<size_t> rposs_;
+
+	uint32 numStatements_;
+	uint32 numWrittenRows_;
 };
 
 /**
@@ -485,6 +559,11 @@ public:
 		return "DBTaskQueryAccount";
 	}
 
+	// ¼еִУ ⱻд
+	virtual thread::TPTask::TPTaskPriority priority() const {
+		return thread::TPTask::TPTASK_PRIORITY_HIGH;
+	}
+
 protected:
 	std::string accountName_;
 	std::string password_;
@@ -564,6 +643,11 @@ public:
 		return "DBTaskAccountLogin";
 	}
 
+	// ¼еִУ ⱻд
+	virtual thread::TPTask::TPTaskPriority priority() const {
+		return thread::TPTask::TPTASK_PRIORITY_HIGH;
+	}
+
 protected:
 	std::string loginName_;
 	std::string accountName_;
@@ -18,6 +18,7 @@
 #include "server/sendmail_threadtasks.h"
 #include "client_lib/client_interface.h"
 #include "network/encryption_filter.h"
+#include "network/compression_filter.h"
 
 #include "baseapp/baseapp_interface.h"
 #include "baseappmgr/baseappmgr_interface.h"
@@ -1366,7 +1367,20 @@ void Loginapp::onHello(Network::Channel* pChannel,
 		if(encryptedKey.size() > 3)
 		{
 			// 滻ΪһܵĹ
-			pChannel->pFilter(Network::createEncryptionFilter(Network::g_channelExternalEncryptType, encryptedKey));
+			Network::EncryptionFilter* pEncryptionFilter = Network::createEncryptionFilter(Network::g_channelExternalEncryptType, encryptedKey);
+
+			// ԿЧʱᶪеİ ֱӶϿ
+			if(pEncryptionFilter && !pEncryptionFilter->isGood())
+			{
+				ERROR_MSG(fmt::format("Loginapp::onHello: invalid encryption key(size={}), addr={}\n",
+					encryptedKey.size(), pChannel->c_str()));
+
+				delete pEncryptionFilter;
+				pChannel->condemn("invalid encryption key");
+				return;
+			}
+
+			pChannel->pFilter(pEncryptionFilter);
 		}
 		else
 		{
@@ -1374,6 +1388,13 @@ void Loginapp::onHello(Network::Channel* pChannel,
 				pChannel->c_str()));
 		}
 	}
+
+	// ѹڼ֮ǰУ ܹѹ֮(webЭ鲻ѹ)
+	if(Network::g_channelExternalCompressThreshold > 0 && pChannel->type() != KBEngine::Network::Channel::CHANNEL_WEB)
+	{
+		pChannel->pFilter(new Network::CompressionFilter(Network::g_channelExternalCompressThreshold,
+			pChannel->pFilter(), &ClientInterface::messageHandlers));
+	}
 }
 
 //-------------------------------------------------------------------------------------
@@ -43,7 +43,8 @@ reqCreateAndLoginTickCount_(g_kbeSrvConfig.getBots().defaultAddBots_tickCount),
 reqCreateAndLoginTickTime_(g_kbeSrvConfig.getBots().defaultAddBots_tickTime),
 pCreateAndLoginHandler_(NULL),
 pEventPoller_(Network::EventPoller::create()),
-pTelnetServer_(NULL)
+pTelnetServer_(NULL),
+pReconnectStormHandler_(NULL)
 {
 	// ʼEntityDefģȡentityʵ庯ַ
 	EntityDef::setGetEntityFunc(std::tr1::bind(&Bots::tryGetEntity, this,
@@ -145,6 +146,7 @@ void Bots::finalise()
 
 	reqCreateAndLoginTotalCount_ = 0;
 	SAFE_RELEASE(pCreateAndLoginHandler_);
+	SAFE_RELEASE(pReconnectStormHandler_);
 	
 	if (pTelnetServer_)
 	{
@@ -253,6 +255,10 @@ bool Bots::uninstallPyModules()
 bool Bots::run(void)
 {
 	pCreateAndLoginHandler_ = new CreateAndLoginHandler();
+
+	if (g_kbeSrvConfig.getBots().bots_reconnectStorm_delay > 0.f)
+		pReconnectStormHandler_ = new ReconnectStormHandler();
+
 	return ClientApp::run();
 }
 
@@ -524,6 +530,31 @@ bool Bots::delClient(Network::Channel * pChannel)
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+uint32 Bots::reconnectClients()
+{
+	// úͻʹµͨ Ҫ½
+	CLIENTS clients;
+	uint32 count = 0;
+
+	CLIENTS::iterator iter = clients_.begin();
+	for(; iter != clients_.end(); ++iter)
+	{
+		ClientObject* pClient = iter->second;
+
+		if(!pClient->isDestroyed())
+		{
+			pClient->reset();
+			++count;
+		}
+
+		clients.insert(std::make_pair(pClient->pServerChannel(), pClient));
+	}
+
+	clients_.swap(clients);
+	return count;
+}
+
 //-------------------------------------------------------------------------------------
 ClientObject* Bots::findClient(Network::Channel * pChannel)
 {
@@ -7,6 +7,7 @@
 // common include	
 #include "profile.h"
 #include "create_and_login_handler.h"
+#include "reconnect_storm_handler.h"
 #include "common/timer.h"
 #include "pyscript/script.h"
 #include "network/endpoint.h"
@@ -116,6 +117,11 @@ public:
 	bool delClient(ClientObject* pClient);
 	bool delClient(Network::Channel * pChannel);
 
+	/**
+		Ͽл˵Ӳͷʼµ¼ 
+	*/
+	uint32 reconnectClients();
+
 	ClientObject* findClient(Network::Channel * pChannel);
 	ClientObject* findClientByAppID(int32 appID);
 
@@ -376,6 +382,9 @@ protected:
 	Network::EventPoller*									pEventPoller_;
 
 	TelnetServer*											pTelnetServer_;
+
+	// 籩 δʱΪNULL
+	ReconnectStormHandler*									pReconnectStormHandler_;
 };
 
 }
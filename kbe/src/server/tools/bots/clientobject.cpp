@@ -38,7 +38,7 @@ ClientObject::ClientObject(std::string name, Network::NetworkInterface& ninterfa
 ClientObjectBase(ninterface, getScriptType()),
 error_(C_ERROR_NONE),
 state_(C_STATE_INIT),
-pBlowfishFilter_(0),
+pEncryptionFilter_(0),
 pTCPPacketSenderEx_(NULL),
 pTCPPacketReceiverEx_(NULL),
 pKCPPacketSenderEx_(NULL),
@@ -53,7 +53,7 @@ pKCPPacketReceiverEx_(NULL)
 //-------------------------------------------------------------------------------------
 ClientObject::~ClientObject()
 {
-	SAFE_RELEASE(pBlowfishFilter_);
+	SAFE_RELEASE(pEncryptionFilter_);
 }
 
 //-------------------------------------------------------------------------------------		
@@ -189,10 +189,11 @@ bool ClientObject::initCreate()
 	(*pBundle).newMessage(LoginappInterface::hello);
 	(*pBundle) << KBEVersion::versionString() << KBEVersion::scriptVersionString();
 
-	if(Network::g_channelExternalEncryptType == 1)
+	// ֵ֧ļ(2)벻ͬ ͿյԿ
+	pEncryptionFilter_ = Network::createClientEncryptionFilter(Network::g_channelExternalEncryptType);
+	if(pEncryptionFilter_)
 	{
-		pBlowfishFilter_ = new Network::BlowfishFilter();
-		(*pBundle).appendBlob(pBlowfishFilter_->key());
+		(*pBundle).appendBlob(pEncryptionFilter_->key());
 	}
 	else
 	{
@@ -315,11 +316,14 @@ bool ClientObject::initLoginBaseapp()
 					(*pBundle).newMessage(BaseappInterface::hello);
 					(*pBundle) << KBEVersion::versionString() << KBEVersion::scriptVersionString();
 
-					if (Network::g_channelExternalEncryptType == 1)
+					// һ(loginapp)Ĺ ѹܶҪ¿ʼ
+					pServerChannel_->pFilter(NULL);
+
+					// ֵ֧ļ(2)벻ͬ ͿյԿ
+					pEncryptionFilter_ = Network::createClientEncryptionFilter(Network::g_channelExternalEncryptType);
+					if(pEncryptionFilter_)
 					{
-						pBlowfishFilter_ = new Network::BlowfishFilter();
-						(*pBundle).appendBlob(pBlowfishFilter_->key());
-						pServerChannel_->pFilter(NULL);
+						(*pBundle).appendBlob(pEncryptionFilter_->key());
 					}
 					else
 					{
@@ -389,11 +393,14 @@ bool ClientObject::initLoginBaseapp()
 		(*pBundle).newMessage(BaseappInterface::hello);
 		(*pBundle) << KBEVersion::versionString() << KBEVersion::scriptVersionString();
 
-		if (Network::g_channelExternalEncryptType == 1)
+		// һ(loginapp)Ĺ ѹܶҪ¿ʼ
+		pServerChannel_->pFilter(NULL);
+
+		// ֵ֧ļ(2)벻ͬ ͿյԿ
+		pEncryptionFilter_ = Network::createClientEncryptionFilter(Network::g_channelExternalEncryptType);
+		if(pEncryptionFilter_)
 		{
-			pBlowfishFilter_ = new Network::BlowfishFilter();
-			(*pBundle).appendBlob(pBlowfishFilter_->key());
-			pServerChannel_->pFilter(NULL);
+			(*pBundle).appendBlob(pEncryptionFilter_->key());
 		}
 		else
 		{
@@ -502,10 +509,17 @@ void ClientObject::onHelloCB_(Network::Channel* pChannel, const std::string& ver
 		const std::string& scriptVerInfo, const std::string& protocolMD5, const std::string& entityDefMD5, 
 		COMPONENT_TYPE componentType)
 {
-	if(Network::g_channelExternalEncryptType == 1)
+	if(pEncryptionFilter_)
+	{
+		pServerChannel_->pFilter(pEncryptionFilter_);
+		pEncryptionFilter_ = NULL;
+	}
+
+	// ѹڼ֮ǰ ܹѹ֮
+	if(Network::g_channelExternalCompressThreshold > 0)
 	{
-		pServerChannel_->pFilter(pBlowfishFilter_);
-		pBlowfishFilter_ = NULL;
+		pServerChannel_->pFilter(new Network::CompressionFilter(Network::g_channelExternalCompressThreshold,
+			pServerChannel_->pFilter()));
 	}
 
 	if(componentType == LOGINAPP_TYPE)
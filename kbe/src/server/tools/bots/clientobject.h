@@ -10,6 +10,7 @@
 #include "client_lib/entity.h"
 #include "client_lib/clientobjectbase.h"
 #include "network/encryption_filter.h"
+#include "network/compression_filter.h"
 #include "pyscript/pyobject_pointer.h"
 
 namespace KBEngine { 
@@ -100,7 +101,7 @@ public:
 protected:
 	C_ERROR error_;
 	C_STATE state_;
-	Network::BlowfishFilter* pBlowfishFilter_;
+	Network::EncryptionFilter* pEncryptionFilter_;
 
 	Network::TCPPacketSenderEx* pTCPPacketSenderEx_;
 	Network::TCPPacketReceiverEx* pTCPPacketReceiverEx_;
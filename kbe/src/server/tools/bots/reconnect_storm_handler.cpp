@@ -0,0 +1,69 @@
+// Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
+
+#include "bots.h"
+#include "reconnect_storm_handler.h"
+#include "network/network_interface.h"
+#include "network/event_dispatcher.h"
+#include "server/serverconfig.h"
+
+namespace KBEngine { 
+
+//-------------------------------------------------------------------------------------
+ReconnectStormHandler::ReconnectStormHandler():
+stormTime_(0),
+numStorms_(0)
+{
+	timerHandle_ = Bots::getSingleton().networkInterface().dispatcher().addTimer(
+							1 * 1000000, this);
+}
+
+//-------------------------------------------------------------------------------------
+ReconnectStormHandler::~ReconnectStormHandler()
+{
+	timerHandle_.cancel();
+}
+
+//-------------------------------------------------------------------------------------
+void ReconnectStormHandler::handleTimeout(TimerHandle handle, void * arg)
+{
+	KBE_ASSERT(handle == timerHandle_);
+
+	Bots& bots = Bots::getSingleton();
+	ENGINE_COMPONENT_INFO& infos = g_kbeSrvConfig.getBots();
+
+	// 等待所有的机器人创建完成
+	if (bots.reqCreateAndLoginTotalCount() == 0 || 
+		bots.clients().size() < bots.reqCreateAndLoginTotalCount())
+	{
+		stormTime_ = 0;
+		return;
+	}
+
+	if (stormTime_ == 0)
+	{
+		stormTime_ = timestamp() + (uint64)(infos.bots_reconnectStorm_delay * stampsPerSecondD());
+		return;
+	}
+
+	if (timestamp() < stormTime_)
+		return;
+
+	uint32 count = bots.reconnectClients();
+	++numStorms_;
+
+	INFO_MSG(fmt::format("ReconnectStormHandler::handleTimeout: storm {}, {} bots reconnecting!\n",
+		numStorms_, count));
+
+	if (infos.bots_reconnectStorm_interval > 0.f)
+	{
+		stormTime_ = timestamp() + (uint64)(infos.bots_reconnectStorm_interval * stampsPerSecondD());
+	}
+	else
+	{
+		timerHandle_.cancel();
+	}
+}
+
+//-------------------------------------------------------------------------------------
+
+}
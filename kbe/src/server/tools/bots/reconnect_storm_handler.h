@@ -0,0 +1,37 @@
+// Copyright 2008-2018 Yolo Technologies, Inc. All Rights Reserved. https://www.comblockengine.com
+
+#ifndef KBE_RECONNECT_STORM_HANDLER_H
+#define KBE_RECONNECT_STORM_HANDLER_H
+
+#include "common/common.h"
+#include "common/timer.h"
+#include "helper/debug_helper.h"
+
+namespace KBEngine { 
+
+/**
+	重连风暴(bots->reconnectStorm)
+	所有机器人创建完成并等待delay秒后同时断开所有连接， 下一个tick所有机器人同时重新登录，
+	用于重现大量客户端同时重连时loginapp与baseapp的监听队列压力(例如defaultAddBots->totalCount为10000)。
+	interval大于0时每隔interval秒重复一次。
+*/
+class ReconnectStormHandler : public TimerHandler
+{
+public:
+	ReconnectStormHandler();
+	virtual ~ReconnectStormHandler();
+
+protected:
+	virtual void handleTimeout(TimerHandle handle, void * arg);
+
+	TimerHandle timerHandle_;
+
+	// 下一次重连风暴的时间， 为0时等待所有机器人创建完成
+	uint64 stormTime_;
+
+	uint32 numStorms_;
+};
+
+}
+
+#endif // KBE_RECONNECT_STORM_HANDLER_H